@@ -26,6 +26,7 @@ PULSE_DEFINE_NULLABLE_HANDLE(PulseBackend);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseBuffer);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseCommandList);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseComputePipeline);
+PULSE_DEFINE_NULLABLE_HANDLE(PulseComputePipelineBatch);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseDevice);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseFence);
 PULSE_DEFINE_NULLABLE_HANDLE(PulseImage);
@@ -77,6 +78,7 @@ typedef enum PulseShaderFormatsBits
 	PULSE_SHADER_FORMAT_WGSL_BIT     = PULSE_BIT(4), // Can be used by WebGPU backend
 	PULSE_SHADER_FORMAT_GLSL_BIT     = PULSE_BIT(5), // Can be used by OpenGL / OpenGL_ES backend
 	PULSE_SHADER_FORMAT_DXBC_BIT      = PULSE_BIT(6), // Can be used by D3D11 backend
+	PULSE_SHADER_FORMAT_NATIVE_BIT   = PULSE_BIT(7), // Can be used by Software backend, see PulseNativeComputeShader
 	// More to come
 } PulseShaderFormatsBits;
 typedef PulseFlags PulseShaderFormatsFlags;
@@ -230,6 +232,36 @@ typedef struct PulseBufferRegion
 	PulseDeviceSize size;
 } PulseBufferRegion;
 
+/**
+ * Arguments given to a native compute function. The function is called once per
+ * workgroup and runs every local invocation in [local_id_begin, local_id_end) itself,
+ * so it owns what would be workgroup shared memory and barriers in a shader.
+ * Buffers and uniform data are the ones bound to the compute pass when the dispatch
+ * was recorded, indexed by binding slot.
+ */
+typedef struct PulseNativeComputeContext
+{
+	uint32_t workgroup_id[3];
+	uint32_t workgroup_count[3];
+	uint32_t local_id_begin[3];
+	uint32_t local_id_end[3];
+	void* const* readonly_storage_buffers;
+	const PulseDeviceSize* readonly_storage_buffer_sizes;
+	void* const* readwrite_storage_buffers;
+	const PulseDeviceSize* readwrite_storage_buffer_sizes;
+	const void* const* uniform_data;
+	const uint32_t* uniform_data_sizes;
+} PulseNativeComputeContext;
+
+typedef void (*PulseNativeComputeFunctionPFN)(const PulseNativeComputeContext* context);
+
+// Pointed to by PulseComputePipelineCreateInfo::code with code_size = sizeof(PulseNativeComputeShader) when using PULSE_SHADER_FORMAT_NATIVE_BIT
+typedef struct PulseNativeComputeShader
+{
+	PulseNativeComputeFunctionPFN function;
+	uint32_t workgroup_size[3];
+} PulseNativeComputeShader;
+
 typedef struct PulseComputePipelineCreateInfo
 {
 	uint64_t code_size;
@@ -243,6 +275,19 @@ typedef struct PulseComputePipelineCreateInfo
 	uint32_t num_uniform_buffers;
 } PulseComputePipelineCreateInfo;
 
+/**
+ * Execution counters of a compute pipeline, accumulated over its dispatches. They are only
+ * complete once every submission using the pipeline has finished. Backends leave to zero
+ * what they cannot measure, instruction counts are in the backend's own instruction set.
+ */
+typedef struct PulseComputePipelineStatistics
+{
+	uint64_t invocations_count;
+	uint64_t executed_instructions_count; // Summed over every invocation
+	uint32_t instructions_count; // Size of the program that runs, after the backend's optimisations
+	uint32_t source_instructions_count; // Same before them
+} PulseComputePipelineStatistics;
+
 typedef struct PulseImageCreateInfo
 {
 	PulseImageType type;
@@ -280,10 +325,14 @@ PULSE_API PulseBackendBits PulseGetBackendInUseByDevice(PulseDevice device);
 PULSE_API bool PulseDeviceSupportsShaderFormats(PulseDevice device, PulseShaderFormatsFlags shader_formats_used);
 PULSE_API void PulseDestroyDevice(PulseDevice device);
 
+PULSE_API bool PulseSetPipelineCachePath(PulseDevice device, const char* path); // Merges the cache stored at path and writes the cache back there on device destruction, NULL disables persistence
+PULSE_API bool PulseGetPipelineCacheData(PulseDevice device, void* data, size_t* data_size); // Only writes the required size to data_size when data is NULL
+PULSE_API bool PulseMergePipelineCacheData(PulseDevice device, const void* data, size_t data_size); // Data retrieved from other devices or processes, incompatible data is ignored
+
 PULSE_API PulseBuffer PulseCreateBuffer(PulseDevice device, const PulseBufferCreateInfo* create_infos);
 PULSE_API bool PulseMapBuffer(PulseBuffer buffer, PulseMapMode mode, void** data);
 PULSE_API void PulseUnmapBuffer(PulseBuffer buffer);
-PULSE_API bool PulseCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src, const PulseBufferRegion* dst);
+PULSE_API bool PulseCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src, const PulseBufferRegion* dst); // Regions of a same buffer may only overlap on the Software backend
 PULSE_API bool PulseCopyBufferToImage(PulseCommandList cmd, const PulseBufferRegion* src, const PulseImageRegion* dst);
 PULSE_API void PulseDestroyBuffer(PulseDevice device, PulseBuffer buffer);
 
@@ -303,6 +352,11 @@ PULSE_API bool PulseIsFenceReady(PulseDevice device, PulseFence fence);
 PULSE_API bool PulseWaitForFences(PulseDevice device, const PulseFence* fences, uint32_t fences_count, bool wait_for_all);
 
 PULSE_API PulseComputePipeline PulseCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info);
+PULSE_API bool PulseCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines); // Pipelines that could not be created are set to PULSE_NULL_HANDLE and make it return false
+PULSE_API PulseComputePipelineBatch PulseCreateComputePipelinesAsync(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines); // infos, their code and pipelines must stay valid until the batch is ready, pipelines is only written once it is
+PULSE_API bool PulseIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch);
+PULSE_API bool PulseWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch); // Also releases the batch, returns false if any pipeline could not be created
+PULSE_API bool PulseGetComputePipelineStatistics(PulseDevice device, PulseComputePipeline pipeline, PulseComputePipelineStatistics* statistics);
 PULSE_API void PulseDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline);
 
 PULSE_API PulseComputePass PulseBeginComputePass(PulseCommandList cmd);
@@ -311,7 +365,7 @@ PULSE_API void PulseBindUniformData(PulseComputePass pass, uint32_t slot, const
 PULSE_API void PulseBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images);
 PULSE_API void PulseBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline);
 PULSE_API void PulseDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z);
-PULSE_API void PulseDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset);
+PULSE_API void PulseDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset); // Reads three uint32 group counts at offset when the command runs, the buffer needs a storage usage
 PULSE_API void PulseEndComputePass(PulseComputePass pass);
 
 PULSE_API PulseErrorType PulseGetLastErrorType(); // Call to this function resets the internal last error variable
@@ -42,6 +42,7 @@
 #define GL_RG16_SNORM 0x8F99
 #define GL_RGB16_SNORM 0x8F9A
 #define GL_RGBA16_SNORM 0x8F9B
+#define GL_COMPLETION_STATUS_KHR 0x91B1
 
 typedef void(*GLFunction)(void);
 
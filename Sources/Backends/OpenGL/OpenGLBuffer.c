@@ -59,24 +59,18 @@ bool OpenGLCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src
 {
 	OpenGLCommand command = { 0 };
 	command.type = OPENGL_COMMAND_COPY_BUFFER_TO_BUFFER;
-	command.CopyBufferToBuffer.src = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	command.CopyBufferToBuffer.dst = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToBuffer.src, src, sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToBuffer.dst, dst, sizeof(PulseBufferRegion));
-	OpenGLQueueCommand(cmd, command);
-	return true;
+	command.CopyBufferToBuffer.src = *src;
+	command.CopyBufferToBuffer.dst = *dst;
+	return OpenGLQueueCommand(cmd, command);
 }
 
 bool OpenGLCopyBufferToImage(PulseCommandList cmd, const PulseBufferRegion* src, const PulseImageRegion* dst)
 {
 	OpenGLCommand command = { 0 };
 	command.type = OPENGL_COMMAND_COPY_BUFFER_TO_IMAGE;
-	command.CopyBufferToImage.src = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	command.CopyBufferToImage.dst = (PulseImageRegion*)malloc(sizeof(PulseImageRegion));
-	memcpy((void*)command.CopyBufferToImage.src, src, sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToImage.dst, dst, sizeof(PulseImageRegion));
-	OpenGLQueueCommand(cmd, command);
-	return true;
+	command.CopyBufferToImage.src = *src;
+	command.CopyBufferToImage.dst = *dst;
+	return OpenGLQueueCommand(cmd, command);
 }
 
 void OpenGLDestroyBuffer(PulseDevice device, PulseBuffer buffer)
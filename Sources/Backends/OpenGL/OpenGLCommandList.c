@@ -15,8 +15,8 @@
 
 static void OpenGLCommandCopyBufferToBuffer(PulseDevice device, OpenGLCommand* cmd)
 {
-	const PulseBufferRegion* src = cmd->CopyBufferToBuffer.src;
-	const PulseBufferRegion* dst = cmd->CopyBufferToBuffer.dst;
+	const PulseBufferRegion* src = &cmd->CopyBufferToBuffer.src;
+	const PulseBufferRegion* dst = &cmd->CopyBufferToBuffer.dst;
 	OpenGLBuffer* src_buffer = OPENGL_RETRIEVE_DRIVER_DATA_AS(src->buffer, OpenGLBuffer*);
 	OpenGLBuffer* dst_buffer = OPENGL_RETRIEVE_DRIVER_DATA_AS(dst->buffer, OpenGLBuffer*);
 
@@ -25,12 +25,10 @@ static void OpenGLCommandCopyBufferToBuffer(PulseDevice device, OpenGLCommand* c
 	opengl_device->glBindBuffer(device, GL_COPY_READ_BUFFER, src_buffer->buffer);
 	opengl_device->glBindBuffer(device, GL_COPY_WRITE_BUFFER, dst_buffer->buffer);
 	opengl_device->glCopyBufferSubData(device, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, src->offset, dst->offset, src->size);
-
-	free((void*)src);
-	free((void*)dst);
 }
 
-static void OpenGLCommandDispatch(PulseDevice device, OpenGLCommand* cmd)
+// Shared by direct and indirect dispatches, both commands start with the same fields
+static void OpenGLCommandBindDispatchResources(PulseDevice device, OpenGLCommand* cmd)
 {
 	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
 	OpenGLComputePipeline* opengl_pipeline = OPENGL_RETRIEVE_DRIVER_DATA_AS(cmd->Dispatch.pipeline, OpenGLComputePipeline*);
@@ -71,12 +69,26 @@ static void OpenGLCommandDispatch(PulseDevice device, OpenGLCommand* cmd)
 	if(cmd->Dispatch.uniform_group != PULSE_NULLPTR)
 	{
 	}
+}
 
+static void OpenGLCommandDispatch(PulseDevice device, OpenGLCommand* cmd)
+{
+	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+
+	OpenGLCommandBindDispatchResources(device, cmd);
 	opengl_device->glDispatchCompute(device, cmd->Dispatch.groupcount_x, cmd->Dispatch.groupcount_y, cmd->Dispatch.groupcount_z);
+}
 
-	free(cmd->Dispatch.read_only_group);
-	free(cmd->Dispatch.read_write_group);
-	free(cmd->Dispatch.uniform_group);
+static void OpenGLCommandDispatchIndirect(PulseDevice device, OpenGLCommand* cmd)
+{
+	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+	OpenGLBuffer* opengl_buffer = OPENGL_RETRIEVE_DRIVER_DATA_AS(cmd->DispatchIndirect.buffer, OpenGLBuffer*);
+
+	OpenGLCommandBindDispatchResources(device, cmd);
+	// Group counts may have been written by a previous dispatch of the list
+	opengl_device->glMemoryBarrier(device, GL_COMMAND_BARRIER_BIT);
+	opengl_device->glBindBuffer(device, GL_DISPATCH_INDIRECT_BUFFER, opengl_buffer->buffer);
+	opengl_device->glDispatchComputeIndirect(device, (GLintptr)cmd->DispatchIndirect.offset);
 }
 
 static void OpenGLCommandsRunner(PulseCommandList cmd)
@@ -95,7 +107,7 @@ static void OpenGLCommandsRunner(PulseCommandList cmd)
 			case OPENGL_COMMAND_COPY_BUFFER_TO_IMAGE: break;
 			case OPENGL_COMMAND_COPY_IMAGE_TO_BUFFER: break;
 			case OPENGL_COMMAND_DISPATCH: OpenGLCommandDispatch(cmd->device, command); break;
-			case OPENGL_COMMAND_DISPATCH_INDIRECT: break;
+			case OPENGL_COMMAND_DISPATCH_INDIRECT: OpenGLCommandDispatchIndirect(cmd->device, command); break;
 
 			default: break;
 		}
@@ -107,32 +119,65 @@ PulseCommandList OpenGLRequestCommandList(PulseDevice device, PulseCommandListUs
 {
 	PULSE_CHECK_HANDLE_RETVAL(device, PULSE_NULL_HANDLE);
 
-	PULSE_UNUSED(usage);
+	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+
+	// Released command lists keep their commands array and arena so that recording them again does not allocate
+	PulseCommandList cmd = PULSE_NULL_HANDLE;
+	for(uint32_t i = 0; i < opengl_device->available_command_lists_size; i++)
+	{
+		if(opengl_device->available_command_lists[i]->is_available)
+		{
+			cmd = opengl_device->available_command_lists[i];
+			break;
+		}
+	}
+
+	if(cmd == PULSE_NULL_HANDLE)
+	{
+		if(opengl_device->available_command_lists_size == opengl_device->available_command_lists_capacity)
+		{
+			PulseCommandList* command_lists = (PulseCommandList*)realloc(opengl_device->available_command_lists, sizeof(PulseCommandList) * (opengl_device->available_command_lists_capacity + 8));
+			PULSE_CHECK_ALLOCATION_RETVAL(command_lists, PULSE_NULL_HANDLE);
+			opengl_device->available_command_lists = command_lists;
+			opengl_device->available_command_lists_capacity += 8;
+		}
+
+		cmd = (PulseCommandList)calloc(1, sizeof(PulseCommandListHandler));
+		PULSE_CHECK_ALLOCATION_RETVAL(cmd, PULSE_NULL_HANDLE);
 
-	PulseCommandList cmd = (PulseCommandList)calloc(1, sizeof(PulseCommandListHandler));
-	PULSE_CHECK_ALLOCATION_RETVAL(cmd, PULSE_NULL_HANDLE);
+		OpenGLCommandList* opengl_cmd = (OpenGLCommandList*)calloc(1, sizeof(OpenGLCommandList));
+		PULSE_CHECK_ALLOCATION_RETVAL(opengl_cmd, PULSE_NULL_HANDLE);
 
-	OpenGLCommandList* opengl_cmd = (OpenGLCommandList*)calloc(1, sizeof(OpenGLCommandList));
-	PULSE_CHECK_ALLOCATION_RETVAL(opengl_cmd, PULSE_NULL_HANDLE);
+		cmd->device = device;
+		cmd->driver_data = opengl_cmd;
+		cmd->pass = OpenGLCreateComputePass(device, cmd);
+
+		opengl_device->available_command_lists[opengl_device->available_command_lists_size] = cmd;
+		opengl_device->available_command_lists_size++;
+	}
 
 	cmd->usage = usage;
-	cmd->device = device;
-	cmd->driver_data = opengl_cmd;
 	cmd->thread_id = PulseGetThreadID();
-
-	cmd->pass = OpenGLCreateComputePass(device, cmd);
 	cmd->state = PULSE_COMMAND_LIST_STATE_RECORDING;
 	cmd->is_available = false;
 
 	return cmd;
 }
 
-void OpenGLQueueCommand(PulseCommandList cmd, OpenGLCommand command)
+bool OpenGLQueueCommand(PulseCommandList cmd, OpenGLCommand command)
 {
 	OpenGLCommandList* opengl_cmd = OPENGL_RETRIEVE_DRIVER_DATA_AS(cmd, OpenGLCommandList*);
-	PULSE_EXPAND_ARRAY_IF_NEEDED(opengl_cmd->commands, OpenGLCommand, opengl_cmd->commands_count, opengl_cmd->commands_capacity, 8);
+	if(opengl_cmd->commands_count == opengl_cmd->commands_capacity)
+	{
+		uint32_t capacity = opengl_cmd->commands_capacity == 0 ? 64 : opengl_cmd->commands_capacity * 2;
+		OpenGLCommand* commands = (OpenGLCommand*)realloc(opengl_cmd->commands, sizeof(OpenGLCommand) * capacity);
+		PULSE_CHECK_ALLOCATION_RETVAL(commands, false);
+		opengl_cmd->commands = commands;
+		opengl_cmd->commands_capacity = capacity;
+	}
 	opengl_cmd->commands[opengl_cmd->commands_count] = command;
 	opengl_cmd->commands_count++;
+	return true;
 }
 
 bool OpenGLSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence fence)
@@ -147,7 +192,22 @@ bool OpenGLSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFenc
 
 void OpenGLReleaseCommandList(PulseDevice device, PulseCommandList cmd)
 {
+	PULSE_UNUSED(device);
+	OpenGLCommandList* opengl_cmd = OPENGL_RETRIEVE_DRIVER_DATA_AS(cmd, OpenGLCommandList*);
+	opengl_cmd->commands_count = 0;
+	PulseArenaReset(&opengl_cmd->arena);
+	cmd->pass->current_pipeline = PULSE_NULL_HANDLE;
+	cmd->pass->is_recording = false;
+	cmd->state = PULSE_COMMAND_LIST_STATE_INVALID;
+	cmd->is_available = true;
+}
+
+void OpenGLDestroyCommandList(PulseDevice device, PulseCommandList cmd)
+{
+	OpenGLCommandList* opengl_cmd = OPENGL_RETRIEVE_DRIVER_DATA_AS(cmd, OpenGLCommandList*);
 	OpenGLDestroyComputePass(device, cmd->pass);
-	free(cmd->driver_data);
+	free(opengl_cmd->commands);
+	PulseArenaFree(&opengl_cmd->arena);
+	free(opengl_cmd);
 	free(cmd);
 }
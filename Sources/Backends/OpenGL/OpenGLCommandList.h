@@ -20,26 +20,26 @@ typedef struct OpenGLCommand
 	{
 		struct
 		{
-			const PulseImageRegion* src;
-			const PulseImageRegion* dst;
+			PulseImageRegion src;
+			PulseImageRegion dst;
 		} BlitImages;
 
 		struct
 		{
-			const PulseBufferRegion* src;
-			const PulseBufferRegion* dst;
+			PulseBufferRegion src;
+			PulseBufferRegion dst;
 		} CopyBufferToBuffer;
 
 		struct
 		{
-			const PulseBufferRegion* src;
-			const PulseImageRegion* dst;
+			PulseBufferRegion src;
+			PulseImageRegion dst;
 		} CopyBufferToImage;
 
 		struct
 		{
-			const PulseImageRegion* src;
-			const PulseBufferRegion* dst;
+			PulseImageRegion src;
+			PulseBufferRegion dst;
 		} CopyImageToBuffer;
 
 		struct
@@ -70,12 +70,14 @@ typedef struct OpenGLCommandList
 	OpenGLCommand* commands;
 	uint32_t commands_count;
 	uint32_t commands_capacity;
+	PulseArena arena; // Command payloads, reset when the list is released
 } OpenGLCommandList;
 
 PulseCommandList OpenGLRequestCommandList(PulseDevice device, PulseCommandListUsage usage);
-void OpenGLQueueCommand(PulseCommandList cmd, OpenGLCommand command);
+bool OpenGLQueueCommand(PulseCommandList cmd, OpenGLCommand command);
 bool OpenGLSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence fence);
 void OpenGLReleaseCommandList(PulseDevice device, PulseCommandList cmd);
+void OpenGLDestroyCommandList(PulseDevice device, PulseCommandList cmd);
 
 #endif // PULSE_OPENGL_COMMAND_LIST_H_
 
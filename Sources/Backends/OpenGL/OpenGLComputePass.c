@@ -180,9 +180,28 @@ void OpenGLBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipel
 	opengl_pass->should_recreate_uniform_bind_group = true;
 }
 
-void OpenGLDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z)
+// Dispatches keep their own copy of the groups in the command list arena since the pass ones are returned to their pool
+static bool OpenGLCaptureBindsGroups(PulseComputePass pass, OpenGLBindsGroup** read_only_group, OpenGLBindsGroup** read_write_group, OpenGLBindsGroup** uniform_group)
 {
 	OpenGLComputePass* opengl_pass = OPENGL_RETRIEVE_DRIVER_DATA_AS(pass, OpenGLComputePass*);
+	OpenGLCommandList* opengl_cmd = OPENGL_RETRIEVE_DRIVER_DATA_AS(pass->cmd, OpenGLCommandList*);
+	const OpenGLBindsGroup* groups[3] = { opengl_pass->read_only_bind_group, opengl_pass->read_write_bind_group, opengl_pass->uniform_bind_group };
+	OpenGLBindsGroup** copies[3] = { read_only_group, read_write_group, uniform_group };
+	for(uint32_t i = 0; i < 3; i++)
+	{
+		*copies[i] = PULSE_NULLPTR;
+		if(groups[i] == PULSE_NULLPTR)
+			continue;
+		*copies[i] = (OpenGLBindsGroup*)PulseArenaAllocate(&opengl_cmd->arena, sizeof(OpenGLBindsGroup), _Alignof(OpenGLBindsGroup));
+		if(*copies[i] == PULSE_NULLPTR)
+			return false;
+		memcpy(*copies[i], groups[i], sizeof(OpenGLBindsGroup));
+	}
+	return true;
+}
+
+void OpenGLDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z)
+{
 	OpenGLBindBindsGroup(pass);
 
 	OpenGLCommand command = { 0 };
@@ -191,27 +210,23 @@ void OpenGLDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, ui
 	command.Dispatch.groupcount_y = groupcount_y;
 	command.Dispatch.groupcount_z = groupcount_z;
 	command.Dispatch.pipeline = pass->current_pipeline;
+	if(!OpenGLCaptureBindsGroups(pass, &command.Dispatch.read_only_group, &command.Dispatch.read_write_group, &command.Dispatch.uniform_group))
+		return;
 
-	if(opengl_pass->read_only_bind_group != PULSE_NULLPTR)
-	{
-		command.Dispatch.read_only_group = (OpenGLBindsGroup*)malloc(sizeof(OpenGLBindsGroup));
-		PULSE_CHECK_ALLOCATION(command.Dispatch.read_only_group);
-		memcpy(command.Dispatch.read_only_group, opengl_pass->read_only_bind_group, sizeof(OpenGLBindsGroup));
-	}
+	OpenGLQueueCommand(pass->cmd, command);
+}
 
-	if(opengl_pass->read_write_bind_group != PULSE_NULLPTR)
-	{
-		command.Dispatch.read_write_group = (OpenGLBindsGroup*)malloc(sizeof(OpenGLBindsGroup));
-		PULSE_CHECK_ALLOCATION(command.Dispatch.read_write_group);
-		memcpy(command.Dispatch.read_write_group, opengl_pass->read_write_bind_group, sizeof(OpenGLBindsGroup));
-	}
+void OpenGLDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset)
+{
+	OpenGLBindBindsGroup(pass);
 
-	if(opengl_pass->uniform_bind_group != PULSE_NULLPTR)
-	{
-		command.Dispatch.uniform_group = (OpenGLBindsGroup*)malloc(sizeof(OpenGLBindsGroup));
-		PULSE_CHECK_ALLOCATION(command.Dispatch.uniform_group);
-		memcpy(command.Dispatch.uniform_group, opengl_pass->uniform_bind_group, sizeof(OpenGLBindsGroup));
-	}
+	OpenGLCommand command = { 0 };
+	command.type = OPENGL_COMMAND_DISPATCH_INDIRECT;
+	command.DispatchIndirect.buffer = buffer;
+	command.DispatchIndirect.offset = offset;
+	command.DispatchIndirect.pipeline = pass->current_pipeline;
+	if(!OpenGLCaptureBindsGroups(pass, &command.DispatchIndirect.read_only_group, &command.DispatchIndirect.read_write_group, &command.DispatchIndirect.uniform_group))
+		return;
 
 	OpenGLQueueCommand(pass->cmd, command);
 }
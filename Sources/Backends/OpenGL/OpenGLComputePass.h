@@ -34,6 +34,7 @@ void OpenGLBindUniformData(PulseComputePass pass, uint32_t slot, const void* dat
 void OpenGLBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images);
 void OpenGLBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline);
 void OpenGLDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z);
+void OpenGLDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset);
 
 #endif // PULSE_OPENGL_COMPUTE_PASS_H_
 
@@ -12,7 +12,8 @@
 #include "OpenGLBindsGroup.h"
 #include "OpenGLComputePipeline.h"
 
-PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+// Only submits the program to the driver, with KHR_parallel_shader_compile it gets compiled in the background until its status is queried
+static PulseComputePipeline OpenGLBeginComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
 {
 	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
 
@@ -38,6 +39,19 @@ PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const Pulse
 	memcpy(code, info->code, info->code_size);
 
 	opengl_pipeline->program = opengl_device->glCreateShaderProgramv(device, GL_COMPUTE_SHADER, 1, (const GLchar**)(&code));
+	free(code);
+	return pipeline;
+}
+
+// Waits for the program to be linked, releases the pipeline and returns NULL if it failed
+static PulseComputePipeline OpenGLEndComputePipeline(PulseDevice device, PulseComputePipeline pipeline, const PulseComputePipelineCreateInfo* info)
+{
+	if(pipeline == PULSE_NULL_HANDLE)
+		return PULSE_NULL_HANDLE;
+
+	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+	OpenGLComputePipeline* opengl_pipeline = OPENGL_RETRIEVE_DRIVER_DATA_AS(pipeline, OpenGLComputePipeline*);
+
 	GLint linked = GL_FALSE;
 	opengl_device->glGetProgramiv(device, opengl_pipeline->program, GL_LINK_STATUS, &linked);
 	if(linked != GL_TRUE)
@@ -57,14 +71,11 @@ PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const Pulse
 		}
 
 		opengl_device->glDeleteProgram(device, opengl_pipeline->program);
-		free(code);
 		free(opengl_pipeline);
 		free(pipeline);
 		return PULSE_NULL_HANDLE;
 	}
 
-	free(code);
-
 	opengl_pipeline->readonly_group_layout  = OpenGLGetBindsGroupLayout(&opengl_device->binds_group_layout_manager, info->num_readonly_storage_images, info->num_readonly_storage_buffers, 0, 0, 0);
 	opengl_pipeline->readwrite_group_layout = OpenGLGetBindsGroupLayout(&opengl_device->binds_group_layout_manager, 0, 0, info->num_readwrite_storage_images, info->num_readwrite_storage_buffers, 0);
 	opengl_pipeline->uniform_group_layout   = OpenGLGetBindsGroupLayout(&opengl_device->binds_group_layout_manager, 0, 0, 0, 0, info->num_uniform_buffers);
@@ -74,6 +85,72 @@ PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const Pulse
 	return pipeline;
 }
 
+static bool OpenGLEndComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	bool success = true;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		pipelines[i] = OpenGLEndComputePipeline(device, pipelines[i], &infos[i]);
+		success = success && pipelines[i] != PULSE_NULL_HANDLE;
+	}
+	return success;
+}
+
+PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+{
+	return OpenGLEndComputePipeline(device, OpenGLBeginComputePipeline(device, info), info);
+}
+
+bool OpenGLCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	// All programs are submitted before any status is queried so that the driver can compile them in parallel
+	for(uint32_t i = 0; i < count; i++)
+		pipelines[i] = OpenGLBeginComputePipeline(device, &infos[i]);
+	return OpenGLEndComputePipelines(device, infos, count, pipelines);
+}
+
+bool OpenGLCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	OpenGLComputePipelineBatch* opengl_batch = (OpenGLComputePipelineBatch*)calloc(1, sizeof(OpenGLComputePipelineBatch));
+	PULSE_CHECK_ALLOCATION_RETVAL(opengl_batch, false);
+	opengl_batch->has_completion_status = OpenGLDeviceSupportsExtension(device, "GL_KHR_parallel_shader_compile");
+	batch->driver_data = opengl_batch;
+
+	for(uint32_t i = 0; i < batch->count; i++)
+		batch->pipelines[i] = OpenGLBeginComputePipeline(device, &batch->infos[i]);
+	return true;
+}
+
+bool OpenGLIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+	OpenGLComputePipelineBatch* opengl_batch = OPENGL_RETRIEVE_DRIVER_DATA_AS(batch, OpenGLComputePipelineBatch*);
+
+	// Without the extension querying the status would block so the batch is finished right away
+	if(opengl_batch->has_completion_status)
+	{
+		for(; opengl_batch->completed_count < batch->count; opengl_batch->completed_count++)
+		{
+			PulseComputePipeline pipeline = batch->pipelines[opengl_batch->completed_count];
+			if(pipeline == PULSE_NULL_HANDLE)
+				continue;
+			GLint completed = GL_FALSE;
+			opengl_device->glGetProgramiv(device, OPENGL_RETRIEVE_DRIVER_DATA_AS(pipeline, OpenGLComputePipeline*)->program, GL_COMPLETION_STATUS_KHR, &completed);
+			if(completed != GL_TRUE)
+				return false;
+		}
+	}
+	OpenGLWaitForComputePipelineBatch(device, batch);
+	return true;
+}
+
+void OpenGLWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	batch->succeeded = OpenGLEndComputePipelines(device, batch->infos, batch->count, batch->pipelines);
+	free(batch->driver_data);
+	batch->driver_data = PULSE_NULLPTR;
+}
+
 void OpenGLDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline)
 {
 	if(pipeline == PULSE_NULL_HANDLE)
@@ -19,8 +19,18 @@ typedef struct OpenGLComputePipeline
 	OpenGLBindsGroupLayout* uniform_group_layout;
 } OpenGLComputePipeline;
 
+typedef struct OpenGLComputePipelineBatch
+{
+	uint32_t completed_count; // Pipelines whose compilation is known to be over
+	bool has_completion_status;
+} OpenGLComputePipelineBatch;
+
 PulseComputePipeline OpenGLCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info);
 void OpenGLDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline);
+bool OpenGLCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines);
+bool OpenGLCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch);
+bool OpenGLIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch);
+void OpenGLWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch);
 
 #endif // PULSE_OPENGL_COMPUTE_PIPELINE_H_
 
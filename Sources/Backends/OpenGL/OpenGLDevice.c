@@ -284,6 +284,10 @@ PulseDevice OpenGLCreateDevice(PulseBackend backend, PulseDevice* forbiden_devic
 	}
 
 	PULSE_LOAD_DRIVER_DEVICE(OpenGL);
+	pulse_device->PFN_CreateComputePipelines = OpenGLCreateComputePipelines; // Optional, other backends leave them NULL
+	pulse_device->PFN_CreateComputePipelinesAsync = OpenGLCreateComputePipelinesAsync;
+	pulse_device->PFN_IsComputePipelineBatchReady = OpenGLIsComputePipelineBatchReady;
+	pulse_device->PFN_WaitForComputePipelineBatch = OpenGLWaitForComputePipelineBatch;
 
 	device->device_id = PulseHashString((const char*)device->glGetString(pulse_device, GL_VENDOR));
 	device->device_id = PulseHashCombine(device->device_id, PulseHashString((const char*)device->glGetString(pulse_device, GL_RENDERER)));
@@ -314,6 +318,9 @@ void OpenGLDestroyDevice(PulseDevice device)
 	if(device == PULSE_NULL_HANDLE || device->driver_data == PULSE_NULLPTR)
 		return;
 	OpenGLDevice* opengl_device = OPENGL_RETRIEVE_DRIVER_DATA_AS(device, OpenGLDevice*);
+	for(uint32_t i = 0; i < opengl_device->available_command_lists_size; i++)
+		OpenGLDestroyCommandList(device, opengl_device->available_command_lists[i]);
+	free(opengl_device->available_command_lists);
 	OpenGLDestroyBindsGroupPoolManager(&opengl_device->binds_group_pool_manager);
 	OpenGLDestroyBindsGroupLayoutManager(&opengl_device->binds_group_layout_manager);
 	#ifdef PULSE_PLAT_WINDOWS
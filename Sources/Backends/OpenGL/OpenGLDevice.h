@@ -37,6 +37,10 @@ typedef struct OpenGLDevice
 	#undef PULSE_OPENGL_WRAPPER
 	#undef PULSE_OPENGL_WRAPPER_RET
 
+	PulseCommandList* available_command_lists; // Every command list of the device, released ones are reused
+	uint32_t available_command_lists_capacity;
+	uint32_t available_command_lists_size;
+
 	const char** supported_extensions;
 	uint32_t supported_extensions_count;
 
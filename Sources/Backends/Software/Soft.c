@@ -2,6 +2,7 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <stdlib.h>
 #include <cpuinfo.h>
 
 #include <Pulse.h>
@@ -13,12 +14,14 @@
 
 #include "Soft.h"
 #include "SoftDevice.h"
+#include "SoftIR.h"
+#include "SoftCompiler.h"
 
 PulseBackendFlags SoftCheckSupport(PulseBackendFlags candidates, PulseShaderFormatsFlags shader_formats_used)
 {
 	if(candidates != PULSE_BACKEND_ANY && (candidates & PULSE_BACKEND_SOFTWARE) == 0)
 		return PULSE_BACKEND_INVALID;
-	if((shader_formats_used & PULSE_SHADER_FORMAT_SPIRV_BIT) == 0)
+	if((shader_formats_used & (PULSE_SHADER_FORMAT_SPIRV_BIT | PULSE_SHADER_FORMAT_NATIVE_BIT)) == 0)
 		return PULSE_BACKEND_INVALID;
 	return PULSE_BACKEND_SOFTWARE; // Software computer is always supported
 }
@@ -28,12 +31,33 @@ bool SoftLoadBackend(PulseBackend backend, PulseDebugLevel debug_level)
 	PULSE_UNUSED(backend);
 	PULSE_UNUSED(debug_level);
 	cpuinfo_initialize();
+	SoftDriverData* driver_data = (SoftDriverData*)calloc(1, sizeof(SoftDriverData));
+	PULSE_CHECK_ALLOCATION_RETVAL(driver_data, false);
+
+	// Widest ISA first, AVX-512 runs 16 invocations in lockstep, AVX2 8 and SSE/NEON 4
+	static const uint32_t lanes_counts[] = { 16, 8, 4 };
+	driver_data->lanes_count = 1;
+	for(uint32_t i = 0; i < sizeof(lanes_counts) / sizeof(lanes_counts[0]); i++)
+	{
+		if(SoftIRSupportsLanesCount(lanes_counts[i]))
+		{
+			driver_data->lanes_count = lanes_counts[i];
+			break;
+		}
+	}
+	driver_data->compiler = (SoftCompiler*)calloc(1, sizeof(SoftCompiler));
+	PULSE_CHECK_ALLOCATION_RETVAL(driver_data->compiler, false);
+	// Native compilation spawns the system compiler and writes to the user cache directory, it only runs when PULSE_SOFTWARE_CC names a compiler
+	SoftInitCompiler(driver_data->compiler, getenv("PULSE_SOFTWARE_CC"), PULSE_NULLPTR);
+
+	SoftwareDriver.driver_data = driver_data;
 	return true;
 }
 
 void SoftUnloadBackend(PulseBackend backend)
 {
 	cpuinfo_deinitialize();
+	free(SOFT_RETRIEVE_DRIVER_DATA_AS(backend, SoftDriverData*)->compiler);
 	free(backend->driver_data);
 }
 
@@ -42,6 +66,6 @@ PulseBackendHandler SoftwareDriver = {
 	.PFN_UnloadBackend = SoftUnloadBackend,
 	.PFN_CreateDevice = SoftCreateDevice,
 	.backend = PULSE_BACKEND_SOFTWARE,
-	.supported_shader_formats = PULSE_SHADER_FORMAT_SPIRV_BIT,
+	.supported_shader_formats = PULSE_SHADER_FORMAT_SPIRV_BIT | PULSE_SHADER_FORMAT_NATIVE_BIT,
 	.driver_data = PULSE_NULLPTR
 };
@@ -11,6 +11,12 @@
 
 #define SOFT_RETRIEVE_DRIVER_DATA_AS(handle, cast) ((cast)handle->driver_data)
 
+typedef struct SoftDriverData
+{
+	uint32_t lanes_count; // Widest lockstep execution the CPU supports, 1 when only the scalar path is available
+	struct SoftCompiler* compiler;
+} SoftDriverData;
+
 PulseBackendFlags SoftCheckSupport(PulseBackendFlags candidates, PulseShaderFormatsFlags shader_formats_used); // Return PULSE_BACKEND_SOFTWARE in case of success and PULSE_BACKEND_INVALID otherwise
 
 #endif // PULSE_SOFTWARE_H_
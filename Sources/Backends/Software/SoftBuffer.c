@@ -2,12 +2,11 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
-#include <string.h>
-
 #include <Pulse.h>
 #include "../../PulseInternal.h"
 #include "Soft.h"
 #include "SoftBuffer.h"
+#include "SoftDevice.h"
 #include "SoftCommandList.h"
 
 PulseBuffer SoftCreateBuffer(PulseDevice device, const PulseBufferCreateInfo* create_infos)
@@ -24,61 +23,67 @@ PulseBuffer SoftCreateBuffer(PulseDevice device, const PulseBufferCreateInfo* cr
 	buffer->usage = create_infos->usage;
 
 	soft_buffer->buffer = (uint8_t*)malloc(create_infos->size);
+	atomic_store(&soft_buffer->pending_uses, 0);
 
 	return buffer;
 }
 
 bool SoftMapBuffer(PulseBuffer buffer, PulseMapMode mode, void** data)
 {
+	PULSE_UNUSED(mode);
 	SoftBuffer* soft_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(buffer, SoftBuffer*);
+	if(soft_buffer->buffer == PULSE_NULLPTR)
+		return false;
 
-	if(mode == PULSE_MAP_WRITE)
+	if(atomic_load(&soft_buffer->pending_uses) != 0)
 	{
-		soft_buffer->map = calloc(1, buffer->size);
-		PULSE_CHECK_ALLOCATION_RETVAL(soft_buffer->map, false);
+		SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(buffer->device, SoftDevice*);
+		mtx_lock(&soft_device->buffers_mutex);
+			while(atomic_load(&soft_buffer->pending_uses) != 0)
+				cnd_wait(&soft_device->buffers_condition, &soft_device->buffers_mutex);
+		mtx_unlock(&soft_device->buffers_mutex);
 	}
-	else
-		soft_buffer->map = soft_buffer->buffer;
-	if(soft_buffer->map == PULSE_NULLPTR)
-		return false;
-	soft_buffer->current_map_mode = mode;
-	*data = soft_buffer->map;
+	*data = soft_buffer->buffer;
 	return true;
 }
 
 void SoftUnmapBuffer(PulseBuffer buffer)
 {
-	SoftBuffer* soft_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(buffer, SoftBuffer*);
-	if(soft_buffer->current_map_mode == PULSE_MAP_WRITE)
-	{
-		memcpy(soft_buffer->buffer, soft_buffer->map, buffer->size);
-		free(soft_buffer->map);
-	}
-	soft_buffer->map = PULSE_NULLPTR;
+	PULSE_UNUSED(buffer); // Writes already landed in the buffer
+}
+
+void SoftAcquireBufferUse(PulseBuffer buffer)
+{
+	atomic_fetch_add(&SOFT_RETRIEVE_DRIVER_DATA_AS(buffer, SoftBuffer*)->pending_uses, 1);
+}
+
+void SoftReleaseBufferUse(PulseBuffer buffer)
+{
+	if(atomic_fetch_sub(&SOFT_RETRIEVE_DRIVER_DATA_AS(buffer, SoftBuffer*)->pending_uses, 1) != 1)
+		return;
+	// Taking the lock orders the broadcast after a map that saw the buffer in use has started waiting
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(buffer->device, SoftDevice*);
+	mtx_lock(&soft_device->buffers_mutex);
+		cnd_broadcast(&soft_device->buffers_condition);
+	mtx_unlock(&soft_device->buffers_mutex);
 }
 
 bool SoftCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src, const PulseBufferRegion* dst)
 {
 	SoftCommand command = { 0 };
 	command.type = SOFT_COMMAND_COPY_BUFFER_TO_BUFFER;
-	command.CopyBufferToBuffer.src = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	command.CopyBufferToBuffer.dst = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToBuffer.src, src, sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToBuffer.dst, dst, sizeof(PulseBufferRegion));
-	SoftQueueCommand(cmd, command);
-	return true;
+	command.CopyBufferToBuffer.src = *src;
+	command.CopyBufferToBuffer.dst = *dst;
+	return SoftQueueCommand(cmd, command);
 }
 
 bool SoftCopyBufferToImage(PulseCommandList cmd, const PulseBufferRegion* src, const PulseImageRegion* dst)
 {
 	SoftCommand command = { 0 };
 	command.type = SOFT_COMMAND_COPY_BUFFER_TO_IMAGE;
-	command.CopyBufferToImage.src = (PulseBufferRegion*)malloc(sizeof(PulseBufferRegion));
-	command.CopyBufferToImage.dst = (PulseImageRegion*)malloc(sizeof(PulseImageRegion));
-	memcpy((void*)command.CopyBufferToImage.src, src, sizeof(PulseBufferRegion));
-	memcpy((void*)command.CopyBufferToImage.dst, dst, sizeof(PulseImageRegion));
-	SoftQueueCommand(cmd, command);
-	return true;
+	command.CopyBufferToImage.src = *src;
+	command.CopyBufferToImage.dst = *dst;
+	return SoftQueueCommand(cmd, command);
 }
 
 void SoftDestroyBuffer(PulseDevice device, PulseBuffer buffer)
@@ -9,13 +9,16 @@
 #ifndef PULSE_SOFTWARE_BUFFER_H_
 #define PULSE_SOFTWARE_BUFFER_H_
 
+#include <stdatomic.h>
+
 #include "Soft.h"
 
+// Mapping returns the storage itself. Only copies can touch mappable buffers,
+// so a map waits for the submitted copies that use the buffer and nothing else
 typedef struct SoftBuffer
 {
 	uint8_t* buffer;
-	void* map;
-	PulseMapMode current_map_mode;
+	atomic_uint pending_uses; // Submitted commands that still have to read or write the buffer
 } SoftBuffer;
 
 PulseBuffer SoftCreateBuffer(PulseDevice device, const PulseBufferCreateInfo* create_infos);
@@ -25,6 +28,9 @@ bool SoftCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src,
 bool SoftCopyBufferToImage(PulseCommandList cmd, const PulseBufferRegion* src, const PulseImageRegion* dst);
 void SoftDestroyBuffer(PulseDevice device, PulseBuffer buffer);
 
+void SoftAcquireBufferUse(PulseBuffer buffer); // On submission
+void SoftReleaseBufferUse(PulseBuffer buffer); // Once the command has been executed, wakes up waiting maps
+
 #endif // PULSE_SOFTWARE_BUFFER_H_
 
 #endif // PULSE_ENABLE_SOFTWARE_BACKEND
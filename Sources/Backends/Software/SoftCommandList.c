@@ -5,7 +5,6 @@
 #include <string.h>
 #include <stdatomic.h>
 #include <tinycthread.h>
-#include <spvm/ext/GLSL450.h>
 
 #include <Pulse.h>
 #include "../../PulseInternal.h"
@@ -16,136 +15,485 @@
 #include "SoftComputePass.h"
 #include "SoftComputePipeline.h"
 #include "SoftBuffer.h"
+#include "SoftImage.h"
+#include "SoftTransfer.h"
+#include "SoftWorkgroup.h"
 
-static void SoftCommandCopyBufferToBuffer(SoftCommand* cmd)
+static SoftTransferRange SoftGetCopyRange(const SoftCommand* command)
 {
-	const PulseBufferRegion* src = cmd->CopyBufferToBuffer.src;
-	const PulseBufferRegion* dst = cmd->CopyBufferToBuffer.dst;
-	SoftBuffer* src_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(src->buffer, SoftBuffer*);
-	SoftBuffer* dst_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(dst->buffer, SoftBuffer*);
-	memcpy(dst_buffer->buffer + dst->offset, src_buffer->buffer + src->offset, (src->size < dst->size ? src->size : dst->size));
-	free((void*)src);
-	free((void*)dst);
+	const PulseBufferRegion* src = &command->CopyBufferToBuffer.src;
+	const PulseBufferRegion* dst = &command->CopyBufferToBuffer.dst;
+	SoftTransferRange range;
+	range.src = SOFT_RETRIEVE_DRIVER_DATA_AS(src->buffer, SoftBuffer*)->buffer + src->offset;
+	range.dst = SOFT_RETRIEVE_DRIVER_DATA_AS(dst->buffer, SoftBuffer*)->buffer + dst->offset;
+	range.size = src->size < dst->size ? src->size : dst->size;
+	return range;
 }
 
-static int SoftCommandDispatchCore(void* arg)
+static bool SoftMemoryOverlaps(const uint8_t* a, size_t a_size, const uint8_t* b, size_t b_size)
 {
-	SoftCommand* cmd = (SoftCommand*)arg;
-	SoftComputePipeline* soft_pipeline = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd->Dispatch.pipeline, SoftComputePipeline*);
+	return (uintptr_t)a < (uintptr_t)b + b_size && (uintptr_t)b < (uintptr_t)a + a_size;
+}
 
-	mtx_lock(&cmd->Dispatch.dispatch_mutex);
-		spvm_state_t state = spvm_state_create(soft_pipeline->program);
-	mtx_unlock(&cmd->Dispatch.dispatch_mutex);
+// Consecutive copies are executed as one transfer until one of them reads or writes memory written by another,
+// returns the number of commands executed
+static uint32_t SoftCommandCopyBuffersToBuffers(SoftDevice* device, SoftCommandList* soft_cmd, uint32_t first)
+{
+	SoftTransferRange ranges[SOFT_TRANSFER_MAX_RANGES];
+	uint32_t count = 0;
+	while(first + count < soft_cmd->commands_count && count < SOFT_TRANSFER_MAX_RANGES && soft_cmd->commands[first + count].type == SOFT_COMMAND_COPY_BUFFER_TO_BUFFER)
+	{
+		SoftTransferRange range = SoftGetCopyRange(&soft_cmd->commands[first + count]);
+		if(SoftMemoryOverlaps(range.src, range.size, range.dst, range.size))
+		{
+			if(count != 0)
+				break;
+			memmove(range.dst, range.src, range.size); // Cannot be split
+			return 1;
+		}
+		bool hazard = false;
+		for(uint32_t i = 0; i < count && !hazard; i++)
+		{
+			hazard = SoftMemoryOverlaps(range.dst, range.size, ranges[i].dst, ranges[i].size) ||
+				SoftMemoryOverlaps(range.dst, range.size, ranges[i].src, ranges[i].size) ||
+				SoftMemoryOverlaps(range.src, range.size, ranges[i].dst, ranges[i].size);
+		}
+		if(hazard)
+			break;
+		ranges[count] = range;
+		count++;
+	}
+	SoftTransferCopyRanges(device, ranges, count);
+	return count;
+}
 
-	spvm_ext_opcode_func* glsl_ext_data = spvm_build_glsl450_ext();
-	spvm_result_t glsl_std_450 = spvm_state_get_result(state, "GLSL.std.450");
-	if(glsl_std_450)
-		glsl_std_450->extension = glsl_ext_data;
-	spvm_word main = spvm_state_get_result_location(state, (spvm_string)soft_pipeline->entry_point);
+static void SoftCommandCopyBufferToImage(SoftDevice* device, SoftCommand* cmd)
+{
+	const PulseBufferRegion* src = &cmd->CopyBufferToImage.src;
+	SoftBuffer* src_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(src->buffer, SoftBuffer*);
+	SoftTransferSwizzle(device, &cmd->CopyBufferToImage.dst, src_buffer->buffer + src->offset, src->size, true);
+}
 
-	spvm_word mem_count = 0;
-	spvm_member_t local_invocation_id = spvm_state_get_builtin(state, SpvBuiltInLocalInvocationId, &mem_count);
+static void SoftCommandCopyImageToBuffer(SoftDevice* device, SoftCommand* cmd)
+{
+	const PulseBufferRegion* dst = &cmd->CopyImageToBuffer.dst;
+	SoftBuffer* dst_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(dst->buffer, SoftBuffer*);
+	SoftTransferSwizzle(device, &cmd->CopyImageToBuffer.src, dst_buffer->buffer + dst->offset, dst->size, false);
+}
 
-	spvm_state_prepare(state, main);
-	spvm_state_call_function(state);
-	spvm_state_delete(state);
-	atomic_fetch_sub(&cmd->cmd_list->commands_running, 1);
-	return 0;
+static void SoftCommandBlitImages(SoftCommand* cmd)
+{
+	SoftBlitImageRegion(&cmd->BlitImages.src, &cmd->BlitImages.dst);
+}
+
+// Buffers a command touches that can be mapped, dispatches only bind storage buffers which cannot be
+static uint32_t SoftGetCommandMappableBuffers(const SoftCommand* command, PulseBuffer buffers[2])
+{
+	switch(command->type)
+	{
+		case SOFT_COMMAND_COPY_BUFFER_TO_BUFFER:
+			buffers[0] = command->CopyBufferToBuffer.src.buffer;
+			buffers[1] = command->CopyBufferToBuffer.dst.buffer;
+			return 2;
+		case SOFT_COMMAND_COPY_BUFFER_TO_IMAGE: buffers[0] = command->CopyBufferToImage.src.buffer; return 1;
+		case SOFT_COMMAND_COPY_IMAGE_TO_BUFFER: buffers[0] = command->CopyImageToBuffer.dst.buffer; return 1;
+
+		default: return 0;
+	}
 }
 
-static void SoftCommandDispatch(SoftCommand* cmd)
+typedef struct SoftDispatch
 {
-	SoftComputePipeline* soft_pipeline = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd->Dispatch.pipeline, SoftComputePipeline*);
-	uint32_t local_size = soft_pipeline->program->local_size_x * soft_pipeline->program->local_size_y * soft_pipeline->program->local_size_z;
-	uint32_t invocations_count = cmd->Dispatch.groupcount_x * cmd->Dispatch.groupcount_y * cmd->Dispatch.groupcount_z * local_size;
-	thrd_t* invocations = (thrd_t*)malloc(invocations_count * sizeof(thrd_t));
-	PULSE_CHECK_PTR(invocations);
+	SoftDevice* device;
+	SoftCommand* cmd;
+	SoftComputePipeline* pipeline;
+	uint32_t workgroup_count[3];
+	uint32_t workgroup_size[3];
+	uint32_t workgroup_id[3];
+	uint32_t worker_index;
+	const SoftIRRegion* resource_regions; // One per IR program resource
+} SoftDispatch;
 
-	uint32_t invocation_index = 0;
-	for(uint32_t z = 0; z < cmd->Dispatch.groupcount_z; z++)
+// Follows the Vulkan layouts, set 0 holds read only images then buffers, set 1 read-write images then buffers and set 2 uniforms.
+// Image regions point to the SoftImage itself
+static SoftIRRegion SoftResolveResourceRegion(PulseComputePipeline pipeline, const SoftDispatchBindings* bindings, const SoftIRResource* resource)
+{
+	SoftIRRegion region = { 0 };
+	PulseBuffer buffer = PULSE_NULL_HANDLE;
+	PulseImage image = PULSE_NULL_HANDLE;
+	switch(resource->set)
 	{
-		for(uint32_t y = 0; y < cmd->Dispatch.groupcount_y; y++)
+		case 0:
 		{
-			for(uint32_t x = 0; x < cmd->Dispatch.groupcount_x; x++)
+			uint32_t slot = resource->binding - pipeline->num_readonly_storage_images;
+			if(resource->binding < pipeline->num_readonly_storage_images && resource->binding < PULSE_MAX_READ_TEXTURES_BOUND)
+				image = bindings->readonly_images[resource->binding];
+			else if(resource->binding >= pipeline->num_readonly_storage_images && slot < PULSE_MAX_READ_BUFFERS_BOUND)
+				buffer = bindings->readonly_storage_buffers[slot];
+			break;
+		}
+		case 1:
+		{
+			uint32_t slot = resource->binding - pipeline->num_readwrite_storage_images;
+			if(resource->binding < pipeline->num_readwrite_storage_images && resource->binding < PULSE_MAX_WRITE_TEXTURES_BOUND)
+				image = bindings->readwrite_images[resource->binding];
+			else if(resource->binding >= pipeline->num_readwrite_storage_images && slot < PULSE_MAX_WRITE_BUFFERS_BOUND)
+				buffer = bindings->readwrite_storage_buffers[slot];
+			break;
+		}
+		case 2:
+		{
+			if(resource->binding < PULSE_MAX_UNIFORM_BUFFERS_BOUND)
 			{
-				for(uint32_t i = 0; i < local_size; i++)
-				{
-					atomic_fetch_add(&cmd->cmd_list->commands_running, 1);
-					thrd_create(&invocations[invocation_index], SoftCommandDispatchCore, cmd);
-					invocation_index++;
-				}
+				region.data = (uint8_t*)bindings->uniform_data[resource->binding];
+				region.size = bindings->uniform_data_sizes[resource->binding];
 			}
+			return region;
 		}
+
+		default: return region;
+	}
+	if(image != PULSE_NULL_HANDLE) // Image accesses go through the SoftImage, never through region offsets
+	{
+		region.data = (uint8_t*)SOFT_RETRIEVE_DRIVER_DATA_AS(image, SoftImage*);
+		region.size = sizeof(SoftImage);
+		return region;
+	}
+	if(buffer == PULSE_NULL_HANDLE)
+		return region;
+	region.data = SOFT_RETRIEVE_DRIVER_DATA_AS(buffer, SoftBuffer*)->buffer;
+	region.size = buffer->size > UINT32_MAX ? UINT32_MAX : (uint32_t)buffer->size;
+	return region;
+}
+
+// Runs one lockstep group of the workgroup, a single invocation when the pipeline uses the scalar path
+static void SoftCommandDispatchCore(void* userdata, uint32_t group_index)
+{
+	const SoftDispatch* dispatch = (const SoftDispatch*)userdata;
+	SoftComputePipeline* soft_pipeline = dispatch->pipeline;
+
+	SoftInterpreterState* interpreter = SoftAcquireInterpreterState(soft_pipeline, dispatch->worker_index, group_index);
+	if(interpreter == PULSE_NULLPTR)
+		return;
+	if(soft_pipeline->ir != PULSE_NULLPTR && soft_pipeline->ir->resources_count != 0) // Buffers are addressed in place, binding them is a pointer copy
+		memcpy(interpreter->ir.regions + SOFT_IR_REGION_RESOURCES, dispatch->resource_regions, soft_pipeline->ir->resources_count * sizeof(SoftIRRegion));
+
+	uint32_t first_invocation = group_index * soft_pipeline->lanes_count;
+	uint32_t active_lanes_count = soft_pipeline->invocations_per_workgroup - first_invocation;
+	if(active_lanes_count > soft_pipeline->lanes_count)
+		active_lanes_count = soft_pipeline->lanes_count;
+
+	for(uint32_t lane = 0; lane < active_lanes_count; lane++)
+	{
+		uint32_t local_invocation_index = first_invocation + lane;
+		uint32_t local_invocation_id[3];
+		local_invocation_id[0] = local_invocation_index % dispatch->workgroup_size[0];
+		local_invocation_id[1] = (local_invocation_index / dispatch->workgroup_size[0]) % dispatch->workgroup_size[1];
+		local_invocation_id[2] = local_invocation_index / (dispatch->workgroup_size[0] * dispatch->workgroup_size[1]);
+		uint32_t global_invocation_id[3];
+		for(uint32_t i = 0; i < 3; i++)
+			global_invocation_id[i] = dispatch->workgroup_id[i] * dispatch->workgroup_size[i] + local_invocation_id[i];
+
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_NUM_WORKGROUPS, dispatch->workgroup_count, 3);
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_WORKGROUP_SIZE, dispatch->workgroup_size, 3);
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_WORKGROUP_ID, dispatch->workgroup_id, 3);
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_LOCAL_INVOCATION_ID, local_invocation_id, 3);
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_GLOBAL_INVOCATION_ID, global_invocation_id, 3);
+		SoftSetInterpreterBuiltin(soft_pipeline, interpreter, lane, SOFT_IR_BUILTIN_LOCAL_INVOCATION_INDEX, &local_invocation_index, 1);
 	}
-	free(invocations);
+
+	SoftRunInterpreterState(soft_pipeline, interpreter, active_lanes_count);
 }
 
-static int SoftCommandsRunner(void* arg)
+// One task per workgroup, every invocation of the workgroup is run by the same worker
+static void SoftCommandDispatchWorkgroup(void* userdata, uint32_t task_index, uint32_t worker_index)
 {
-	PulseCommandList cmd = (PulseCommandList)arg;
-	PULSE_CHECK_PTR_RETVAL(cmd, 1);
+	SoftDispatch dispatch = *(const SoftDispatch*)userdata;
+	dispatch.worker_index = worker_index;
+
+	dispatch.workgroup_id[0] = task_index % dispatch.workgroup_count[0];
+	dispatch.workgroup_id[1] = (task_index / dispatch.workgroup_count[0]) % dispatch.workgroup_count[1];
+	dispatch.workgroup_id[2] = task_index / (dispatch.workgroup_count[0] * dispatch.workgroup_count[1]);
+
+	// Read-modify-writes of the spvm interpreter are not atomic, the other paths run them with C11 atomics
+	SoftComputePipeline* pipeline = dispatch.pipeline;
+	bool serialised = pipeline->ir == PULSE_NULLPTR && pipeline->uses_atomics;
+	if(serialised)
+		mtx_lock(&pipeline->interpreter_atomics_mutex);
+	uint32_t groups_count = (pipeline->invocations_per_workgroup + pipeline->lanes_count - 1) / pipeline->lanes_count;
+	if(!SoftRunWorkgroup(&dispatch.device->workgroups[worker_index], groups_count, pipeline->uses_control_barriers, SoftCommandDispatchCore, &dispatch))
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+	if(serialised)
+		mtx_unlock(&pipeline->interpreter_atomics_mutex);
+}
+
+typedef struct SoftNativeDispatch
+{
+	const SoftComputePipeline* pipeline;
+	PulseNativeComputeContext context;
+	void* readonly_storage_buffers[PULSE_MAX_READ_BUFFERS_BOUND];
+	PulseDeviceSize readonly_storage_buffer_sizes[PULSE_MAX_READ_BUFFERS_BOUND];
+	void* readwrite_storage_buffers[PULSE_MAX_WRITE_BUFFERS_BOUND];
+	PulseDeviceSize readwrite_storage_buffer_sizes[PULSE_MAX_WRITE_BUFFERS_BOUND];
+} SoftNativeDispatch;
+
+static void SoftCommandDispatchNativeWorkgroup(void* userdata, uint32_t task_index, uint32_t worker_index)
+{
+	PULSE_UNUSED(worker_index);
+	const SoftNativeDispatch* dispatch = (const SoftNativeDispatch*)userdata;
+	PulseNativeComputeContext context = dispatch->context;
+	context.workgroup_id[0] = task_index % context.workgroup_count[0];
+	context.workgroup_id[1] = (task_index / context.workgroup_count[0]) % context.workgroup_count[1];
+	context.workgroup_id[2] = task_index / (context.workgroup_count[0] * context.workgroup_count[1]);
+	dispatch->pipeline->native.function(&context);
+}
 
+static void SoftCommandDispatchNative(SoftDevice* soft_device, const SoftComputePipeline* soft_pipeline, const SoftDispatchBindings* bindings, const uint32_t workgroup_count[3])
+{
+	SoftNativeDispatch dispatch = { 0 };
+	dispatch.pipeline = soft_pipeline;
+	for(uint32_t i = 0; i < PULSE_MAX_READ_BUFFERS_BOUND; i++)
+	{
+		if(bindings->readonly_storage_buffers[i] == PULSE_NULL_HANDLE)
+			continue;
+		dispatch.readonly_storage_buffers[i] = SOFT_RETRIEVE_DRIVER_DATA_AS(bindings->readonly_storage_buffers[i], SoftBuffer*)->buffer;
+		dispatch.readonly_storage_buffer_sizes[i] = bindings->readonly_storage_buffers[i]->size;
+	}
+	for(uint32_t i = 0; i < PULSE_MAX_WRITE_BUFFERS_BOUND; i++)
+	{
+		if(bindings->readwrite_storage_buffers[i] == PULSE_NULL_HANDLE)
+			continue;
+		dispatch.readwrite_storage_buffers[i] = SOFT_RETRIEVE_DRIVER_DATA_AS(bindings->readwrite_storage_buffers[i], SoftBuffer*)->buffer;
+		dispatch.readwrite_storage_buffer_sizes[i] = bindings->readwrite_storage_buffers[i]->size;
+	}
+
+	PulseNativeComputeContext* context = &dispatch.context;
+	for(uint32_t i = 0; i < 3; i++)
+		context->workgroup_count[i] = workgroup_count[i];
+	for(uint32_t i = 0; i < 3; i++)
+		context->local_id_end[i] = soft_pipeline->native.workgroup_size[i];
+	context->readonly_storage_buffers = dispatch.readonly_storage_buffers;
+	context->readonly_storage_buffer_sizes = dispatch.readonly_storage_buffer_sizes;
+	context->readwrite_storage_buffers = dispatch.readwrite_storage_buffers;
+	context->readwrite_storage_buffer_sizes = dispatch.readwrite_storage_buffer_sizes;
+	context->uniform_data = bindings->uniform_data;
+	context->uniform_data_sizes = bindings->uniform_data_sizes;
+
+	uint32_t workgroups_count = context->workgroup_count[0] * context->workgroup_count[1] * context->workgroup_count[2];
+	SoftThreadPoolRunBatch(&soft_device->thread_pool, SoftCommandDispatchNativeWorkgroup, &dispatch, workgroups_count);
+}
+
+// Shared by direct and indirect dispatches
+static void SoftRunDispatch(PulseDevice device, SoftCommand* cmd, PulseComputePipeline pipeline, const SoftDispatchBindings* bindings, const uint32_t workgroup_count[3])
+{
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+	SoftComputePipeline* soft_pipeline = SOFT_RETRIEVE_DRIVER_DATA_AS(pipeline, SoftComputePipeline*);
+	atomic_fetch_add(&soft_pipeline->invocations_count, (uint64_t)workgroup_count[0] * workgroup_count[1] * workgroup_count[2] * soft_pipeline->invocations_per_workgroup);
+
+	if(soft_pipeline->native.function != PULSE_NULLPTR)
+	{
+		SoftCommandDispatchNative(soft_device, soft_pipeline, bindings, workgroup_count);
+		return;
+	}
+
+	SoftDispatch dispatch;
+	dispatch.device = soft_device;
+	dispatch.cmd = cmd;
+	dispatch.pipeline = soft_pipeline;
+	for(uint32_t i = 0; i < 3; i++)
+		dispatch.workgroup_count[i] = workgroup_count[i];
+	dispatch.workgroup_size[0] = soft_pipeline->program->local_size_x;
+	dispatch.workgroup_size[1] = soft_pipeline->program->local_size_y;
+	dispatch.workgroup_size[2] = soft_pipeline->program->local_size_z;
+	dispatch.resource_regions = PULSE_NULLPTR;
+
+	if(soft_pipeline->ir != PULSE_NULLPTR && soft_pipeline->ir->resources_count != 0)
+	{
+		// Only the queue thread touches the arena of a submitted list
+		SoftIRRegion* resource_regions = (SoftIRRegion*)PulseArenaAllocate(&cmd->cmd_list->arena, soft_pipeline->ir->resources_count * sizeof(SoftIRRegion), _Alignof(SoftIRRegion));
+		if(resource_regions == PULSE_NULLPTR)
+			return;
+		for(uint32_t i = 0; i < soft_pipeline->ir->resources_count; i++)
+			resource_regions[i] = SoftResolveResourceRegion(pipeline, bindings, &soft_pipeline->ir->resources[i]);
+		dispatch.resource_regions = resource_regions;
+	}
+
+	uint32_t workgroups_count = dispatch.workgroup_count[0] * dispatch.workgroup_count[1] * dispatch.workgroup_count[2];
+	SoftThreadPoolRunBatch(&soft_device->thread_pool, SoftCommandDispatchWorkgroup, &dispatch, workgroups_count);
+
+	// Large cooperative workgroups leave one fiber stack per invocation behind, workers are idle so they can drop them
+	for(uint32_t i = 0; i < soft_device->thread_pool.workers_count; i++)
+		SoftTrimWorkgroup(&soft_device->workgroups[i]);
+
+	// Workers are done with the states so their counters can be read without racing with the executors
+	if(soft_pipeline->ir == PULSE_NULLPTR || soft_pipeline->kernel.function != PULSE_NULLPTR)
+		return;
+	uint64_t executed_instructions_count = 0;
+	for(uint32_t i = 0; i < soft_pipeline->caches_count; i++)
+	{
+		SoftInterpreterCache* cache = &soft_pipeline->caches[i];
+		for(uint32_t j = 0; j < cache->states_count; j++)
+		{
+			executed_instructions_count += cache->states[j].ir.executed_instructions_count;
+			cache->states[j].ir.executed_instructions_count = 0;
+		}
+	}
+	atomic_fetch_add(&soft_pipeline->executed_instructions_count, executed_instructions_count);
+}
+
+static void SoftCommandDispatch(PulseDevice device, SoftCommand* cmd)
+{
+	const uint32_t workgroup_count[3] = { cmd->Dispatch.groupcount_x, cmd->Dispatch.groupcount_y, cmd->Dispatch.groupcount_z };
+	SoftRunDispatch(device, cmd, cmd->Dispatch.pipeline, cmd->Dispatch.bindings, workgroup_count);
+}
+
+// Group counts are read when the command runs so that a previous dispatch of the list can write them
+static void SoftCommandDispatchIndirect(PulseDevice device, SoftCommand* cmd)
+{
+	SoftBuffer* soft_buffer = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd->DispatchIndirect.buffer, SoftBuffer*);
+	uint32_t workgroup_count[3];
+	memcpy(workgroup_count, soft_buffer->buffer + cmd->DispatchIndirect.offset, sizeof(workgroup_count));
+	if((uint64_t)workgroup_count[0] * workgroup_count[1] * workgroup_count[2] > UINT32_MAX)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogErrorFmt(device->backend, "(Soft) indirect dispatch of %ux%ux%u workgroups is too large", workgroup_count[0], workgroup_count[1], workgroup_count[2]);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		return;
+	}
+	SoftRunDispatch(device, cmd, cmd->DispatchIndirect.pipeline, cmd->DispatchIndirect.bindings, workgroup_count);
+}
+
+void SoftRunCommandList(PulseCommandList cmd)
+{
 	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd, SoftCommandList*);
-	PULSE_CHECK_PTR_RETVAL(soft_cmd, 1);
 
-	for(uint32_t i = 0; i < soft_cmd->commands_count; i++)
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd->device, SoftDevice*);
+	for(uint32_t i = 0; i < soft_cmd->commands_count;)
 	{
 		SoftCommand* command = &soft_cmd->commands[i];
+		uint32_t executed_count = 1;
 		switch(command->type)
 		{
-			case SOFT_COMMAND_COPY_BUFFER_TO_BUFFER: SoftCommandCopyBufferToBuffer(command); break;
-			case SOFT_COMMAND_COPY_BUFFER_TO_IMAGE: break;
-			case SOFT_COMMAND_COPY_IMAGE_TO_BUFFER: break;
-			case SOFT_COMMAND_DISPATCH: SoftCommandDispatch(command); break;
-			case SOFT_COMMAND_DISPATCH_INDIRECT: break;
+			case SOFT_COMMAND_BLIT_IMAGES: SoftCommandBlitImages(command); break;
+			case SOFT_COMMAND_COPY_BUFFER_TO_BUFFER: executed_count = SoftCommandCopyBuffersToBuffers(soft_device, soft_cmd, i); break;
+			case SOFT_COMMAND_COPY_BUFFER_TO_IMAGE: SoftCommandCopyBufferToImage(soft_device, command); break;
+			case SOFT_COMMAND_COPY_IMAGE_TO_BUFFER: SoftCommandCopyImageToBuffer(soft_device, command); break;
+			case SOFT_COMMAND_DISPATCH: SoftCommandDispatch(cmd->device, command); break;
+			case SOFT_COMMAND_DISPATCH_INDIRECT: SoftCommandDispatchIndirect(cmd->device, command); break;
 
 			default: break;
 		}
-	}
 
-	atomic_fetch_sub(&soft_cmd->commands_running, 1); // Remove fence safety
+		// Released per command so that a map does not wait for the rest of the list
+		for(uint32_t j = i; j < i + executed_count; j++)
+		{
+			PulseBuffer buffers[2];
+			uint32_t buffers_count = SoftGetCommandMappableBuffers(&soft_cmd->commands[j], buffers);
+			for(uint32_t k = 0; k < buffers_count; k++)
+				SoftReleaseBufferUse(buffers[k]);
+		}
+		i += executed_count;
+	}
 
+	PulseFence fence = soft_cmd->fence;
 	cmd->state = PULSE_COMMAND_LIST_STATE_READY;
-	return 0;
+	if(fence != PULSE_NULL_HANDLE)
+		SoftSignalFence(cmd->device, fence);
+
+	// The list may be released and reused from here on, it must not be touched anymore
+	mtx_lock(&soft_device->command_lists_mutex);
+	soft_cmd->is_pending = false;
+	cnd_broadcast(&soft_device->command_lists_condition);
+	mtx_unlock(&soft_device->command_lists_mutex);
 }
 
 PulseCommandList SoftRequestCommandList(PulseDevice device, PulseCommandListUsage usage)
 {
 	PULSE_CHECK_HANDLE_RETVAL(device, PULSE_NULL_HANDLE);
 
-	PULSE_UNUSED(usage);
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+
+	// Released command lists keep their commands array and arena so that recording them again does not allocate
+	PulseCommandList cmd = PULSE_NULL_HANDLE;
+	mtx_lock(&soft_device->command_lists_mutex);
+	for(uint32_t i = 0; i < soft_device->available_command_lists_size; i++)
+	{
+		if(soft_device->available_command_lists[i]->is_available)
+		{
+			cmd = soft_device->available_command_lists[i];
+			cmd->is_available = false;
+			break;
+		}
+	}
+	mtx_unlock(&soft_device->command_lists_mutex);
+
+	if(cmd == PULSE_NULL_HANDLE)
+	{
+		cmd = (PulseCommandList)calloc(1, sizeof(PulseCommandListHandler));
+		PULSE_CHECK_ALLOCATION_RETVAL(cmd, PULSE_NULL_HANDLE);
 
-	PulseCommandList cmd = (PulseCommandList)calloc(1, sizeof(PulseCommandListHandler));
-	PULSE_CHECK_ALLOCATION_RETVAL(cmd, PULSE_NULL_HANDLE);
+		SoftCommandList* soft_cmd = (SoftCommandList*)calloc(1, sizeof(SoftCommandList));
+		PULSE_CHECK_ALLOCATION_RETVAL(soft_cmd, PULSE_NULL_HANDLE);
 
-	SoftCommandList* soft_cmd = (SoftCommandList*)calloc(1, sizeof(SoftCommandList));
-	PULSE_CHECK_ALLOCATION_RETVAL(soft_cmd, PULSE_NULL_HANDLE);
+		cmd->device = device;
+		cmd->driver_data = soft_cmd;
+		cmd->pass = SoftCreateComputePass(device, cmd);
+		cmd->is_available = false;
+
+		mtx_lock(&soft_device->command_lists_mutex);
+		bool registered = true;
+		if(soft_device->available_command_lists_size == soft_device->available_command_lists_capacity)
+		{
+			PulseCommandList* command_lists = (PulseCommandList*)realloc(soft_device->available_command_lists, sizeof(PulseCommandList) * (soft_device->available_command_lists_capacity + 8));
+			if(command_lists != PULSE_NULLPTR)
+			{
+				soft_device->available_command_lists = command_lists;
+				soft_device->available_command_lists_capacity += 8;
+			}
+			else
+				registered = false;
+		}
+		if(registered)
+		{
+			soft_device->available_command_lists[soft_device->available_command_lists_size] = cmd;
+			soft_device->available_command_lists_size++;
+		}
+		mtx_unlock(&soft_device->command_lists_mutex);
+		if(!registered)
+		{
+			SoftDestroyCommandList(device, cmd);
+			PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+			return PULSE_NULL_HANDLE;
+		}
+	}
 
 	cmd->usage = usage;
-	cmd->device = device;
-	cmd->driver_data = soft_cmd;
 	cmd->thread_id = PulseGetThreadID();
-
-	cmd->pass = SoftCreateComputePass(device, cmd);
 	cmd->state = PULSE_COMMAND_LIST_STATE_RECORDING;
-	cmd->is_available = false;
-	atomic_store(&soft_cmd->commands_running, 0);
 
 	return cmd;
 }
 
-void SoftQueueCommand(PulseCommandList cmd, SoftCommand command)
+bool SoftQueueCommand(PulseCommandList cmd, SoftCommand command)
 {
 	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd, SoftCommandList*);
 	command.cmd_list = soft_cmd;
-	PULSE_EXPAND_ARRAY_IF_NEEDED(soft_cmd->commands, SoftCommand, soft_cmd->commands_count, soft_cmd->commands_capacity, 8);
+	if(soft_cmd->commands_count == soft_cmd->commands_capacity)
+	{
+		uint32_t capacity = soft_cmd->commands_capacity == 0 ? 64 : soft_cmd->commands_capacity * 2;
+		SoftCommand* commands = (SoftCommand*)realloc(soft_cmd->commands, sizeof(SoftCommand) * capacity);
+		PULSE_CHECK_ALLOCATION_RETVAL(commands, false);
+		soft_cmd->commands = commands;
+		soft_cmd->commands_capacity = capacity;
+	}
 	soft_cmd->commands[soft_cmd->commands_count] = command;
 	soft_cmd->commands_count++;
+	return true;
 }
 
 bool SoftSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence fence)
 {
-	PULSE_UNUSED(device);
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
 	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd, SoftCommandList*);
 	cmd->state = PULSE_COMMAND_LIST_STATE_SENT;
 	if(fence != PULSE_NULL_HANDLE)
@@ -155,28 +503,51 @@ bool SoftSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence
 		fence->cmd = cmd;
 		atomic_store(&soft_fence->signal, false);
 	}
-	atomic_fetch_add(&soft_cmd->commands_running, 1); // Fence safety to avoid fence being signaled before first command being sumitted
-	return thrd_create(&soft_cmd->thread, SoftCommandsRunner, cmd) == thrd_success;
+	else
+		soft_cmd->fence = PULSE_NULL_HANDLE;
+	for(uint32_t i = 0; i < soft_cmd->commands_count; i++)
+	{
+		PulseBuffer buffers[2];
+		uint32_t buffers_count = SoftGetCommandMappableBuffers(&soft_cmd->commands[i], buffers);
+		for(uint32_t j = 0; j < buffers_count; j++)
+			SoftAcquireBufferUse(buffers[j]);
+	}
+	mtx_lock(&soft_device->command_lists_mutex);
+	soft_cmd->is_pending = true;
+	mtx_unlock(&soft_device->command_lists_mutex);
+	SoftQueueSubmit(&soft_device->queue, cmd);
+	return true;
 }
 
 void SoftReleaseCommandList(PulseDevice device, PulseCommandList cmd)
 {
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
 	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd, SoftCommandList*);
-	SoftDestroyComputePass(device, cmd->pass);
 
-	for(uint32_t i = 0; i < soft_cmd->commands_count; i++)
-	{
-		SoftCommand* command = &soft_cmd->commands[i];
-		switch(command->type)
-		{
-			// Lock/Unlock to make sure the mutex is not in use
-			case SOFT_COMMAND_DISPATCH: mtx_lock(&command->Dispatch.dispatch_mutex); mtx_unlock(&command->Dispatch.dispatch_mutex); break;
-			case SOFT_COMMAND_DISPATCH_INDIRECT: mtx_lock(&command->DispatchIndirect.dispatch_mutex); mtx_unlock(&command->DispatchIndirect.dispatch_mutex); break;
+	// Lists submitted without a fence, or released before it got waited on, may still be read by the queue thread
+	mtx_lock(&soft_device->command_lists_mutex);
+	while(soft_cmd->is_pending)
+		cnd_wait(&soft_device->command_lists_condition, &soft_device->command_lists_mutex);
+	mtx_unlock(&soft_device->command_lists_mutex);
+
+	soft_cmd->commands_count = 0;
+	soft_cmd->fence = PULSE_NULL_HANDLE;
+	PulseArenaReset(&soft_cmd->arena);
+	SoftResetComputePass(cmd->pass);
+	cmd->state = PULSE_COMMAND_LIST_STATE_INVALID;
+
+	mtx_lock(&soft_device->command_lists_mutex);
+	cmd->is_available = true;
+	mtx_unlock(&soft_device->command_lists_mutex);
+}
+
+void SoftDestroyCommandList(PulseDevice device, PulseCommandList cmd)
+{
+	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(cmd, SoftCommandList*);
+	SoftDestroyComputePass(device, cmd->pass);
 
-			default: break;
-		}
-	}
 	free(soft_cmd->commands);
+	PulseArenaFree(&soft_cmd->arena);
 	free(soft_cmd);
 	free(cmd);
 }
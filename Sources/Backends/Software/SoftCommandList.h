@@ -12,6 +12,7 @@
 #include <stdatomic.h>
 #include <tinycthread.h>
 
+#include "../../PulseInternal.h"
 #include "Soft.h"
 #include "SoftEnums.h"
 #include "SoftFence.h"
@@ -24,72 +25,64 @@ typedef struct SoftCommand
 	{
 		struct
 		{
-			const PulseImageRegion* src;
-			const PulseImageRegion* dst;
+			PulseImageRegion src;
+			PulseImageRegion dst;
 		} BlitImages;
 
 		struct
 		{
-			const PulseBufferRegion* src;
-			const PulseBufferRegion* dst;
+			PulseBufferRegion src;
+			PulseBufferRegion dst;
 		} CopyBufferToBuffer;
 
 		struct
 		{
-			const PulseBufferRegion* src;
-			const PulseImageRegion* dst;
+			PulseBufferRegion src;
+			PulseImageRegion dst;
 		} CopyBufferToImage;
 
 		struct
 		{
-			const PulseImageRegion* src;
-			const PulseBufferRegion* dst;
+			PulseImageRegion src;
+			PulseBufferRegion dst;
 		} CopyImageToBuffer;
 
 		struct
 		{
 			PulseComputePipeline pipeline;
+			const struct SoftDispatchBindings* bindings;
 			uint32_t groupcount_x;
 			uint32_t groupcount_y;
 			uint32_t groupcount_z;
-			mtx_t dispatch_mutex;
 		} Dispatch;
 
 		struct
 		{
 			PulseComputePipeline pipeline;
+			const struct SoftDispatchBindings* bindings;
 			PulseBuffer buffer;
 			uint32_t offset;
-			mtx_t dispatch_mutex;
 		} DispatchIndirect;
 	};
-	union
-	{
-		struct
-		{
-			uint32_t global_invocation_id[3];
-			uint32_t local_invocation_id[3];
-			uint32_t workgroup_count[3];
-			uint32_t workgroup_index[3];
-			uint32_t local_invocation_index;
-		} Dipsatch;
-	} Private;
 } SoftCommand;
 
 typedef struct SoftCommandList
 {
-	thrd_t thread;
 	PulseFence fence;
 	SoftCommand* commands;
 	uint32_t commands_count;
 	uint32_t commands_capacity;
-	atomic_ullong commands_running;
+	PulseArena arena; // Command payloads and uniform snapshots, reset when the list is released
+	bool is_pending; // Set on submission and cleared by the queue thread once it no longer reads the list, guarded by the device command lists mutex
 } SoftCommandList;
 
 PulseCommandList SoftRequestCommandList(PulseDevice device, PulseCommandListUsage usage);
-void SoftQueueCommand(PulseCommandList cmd, SoftCommand command);
+bool SoftQueueCommand(PulseCommandList cmd, SoftCommand command);
 bool SoftSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence fence);
 void SoftReleaseCommandList(PulseDevice device, PulseCommandList cmd);
+void SoftDestroyCommandList(PulseDevice device, PulseCommandList cmd);
+
+void SoftRunCommandList(PulseCommandList cmd); // Called by the device queue thread
 
 #endif // PULSE_SOFTWARE_COMMAND_LIST_H_
 
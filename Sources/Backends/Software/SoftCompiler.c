@@ -0,0 +1,673 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cpuinfo.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftIR.h"
+#include "SoftCompiler.h"
+#include "SoftWorkgroup.h"
+
+#ifdef PULSE_PLAT_WINDOWS
+	#include <windows.h>
+	#define SOFT_COMPILER_LIBRARY_EXTENSION ".dll"
+	#define SOFT_COMPILER_NULL_DEVICE "NUL"
+	#define SOFT_COMPILER_LIBRARY_FLAGS PULSE_NULLPTR
+#else
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <spawn.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+	#define SOFT_COMPILER_LIBRARY_EXTENSION ".so"
+	#define SOFT_COMPILER_NULL_DEVICE "/dev/null"
+	#define SOFT_COMPILER_LIBRARY_FLAGS "-fPIC"
+	extern char** environ;
+#endif
+
+// Covers the compiler command words, the ISA flags and the fixed arguments
+#define SOFT_COMPILER_MAX_ARGUMENTS 64
+
+// Bumped whenever the generated code changes so that stale cached objects are never loaded
+#define SOFT_COMPILER_VERSION 3
+#define SOFT_COMPILER_KERNEL_SYMBOL "PulseSoftKernel"
+
+// Mirrors SoftIRExecute, elementwise ops are macros named after their IR op so the emitter can use the op table directly
+static const char soft_compiler_prelude[] =
+	"#include <math.h>\n"
+	"#include <stdatomic.h>\n"
+	"#include <stdint.h>\n"
+	"#include <string.h>\n"
+	"typedef union { uint32_t u; int32_t i; float f; } W;\n"
+	"typedef struct { uint8_t* data; uint32_t size; } R;\n"
+	"static inline uint8_t* Resolve(R* g, uint32_t n, const W* p, uint64_t o, uint64_t s) { if(p[0].u >= n) return 0; const R* x = &g[p[0].u]; o += p[1].u; if(x->data == 0 || o + s > x->size) return 0; return x->data + o; }\n"
+	"static inline void Load(R* g, uint32_t n, const W* p, uint64_t o, void* d, uint32_t s) { uint8_t* m = Resolve(g, n, p, o, s); if(m) memcpy(d, m, s); else memset(d, 0, s); }\n"
+	"static inline void Store(R* g, uint32_t n, const W* p, uint64_t o, const void* v, uint32_t s) { uint8_t* m = Resolve(g, n, p, o, s); if(m) memcpy(m, v, s); }\n"
+	"static inline _Atomic uint32_t* AtomicWord(R* g, uint32_t n, const W* p) { uint8_t* m = Resolve(g, n, p, 0, 4); return m && ((uintptr_t)m & 3) == 0 ? (_Atomic uint32_t*)m : 0; }\n"
+	"#define ATOMIC_MIN_MAX(name, T, cmp) static inline uint32_t name(_Atomic uint32_t* m, uint32_t v, memory_order o) { uint32_t c = atomic_load_explicit(m, memory_order_relaxed); while(!atomic_compare_exchange_weak_explicit(m, &c, (T)v cmp (T)c ? v : c, o, memory_order_relaxed)); return c; }\n"
+	"ATOMIC_MIN_MAX(AtomicFetchSMin, int32_t, <)\n"
+	"ATOMIC_MIN_MAX(AtomicFetchUMin, uint32_t, <)\n"
+	"ATOMIC_MIN_MAX(AtomicFetchSMax, int32_t, >)\n"
+	"ATOMIC_MIN_MAX(AtomicFetchUMax, uint32_t, >)\n"
+	"static inline uint32_t ArrayLength(R* g, uint32_t n, const W* p, uint32_t o, uint32_t stride) { uint64_t start = (uint64_t)p[1].u + o; uint32_t size = p[0].u < n ? g[p[0].u].size : 0; return start < size ? (uint32_t)((size - start) / stride) : 0; }\n"
+	"static inline uint32_t FloatToUint(float f) { if(!(f > -1.0f)) return 0; if(f >= 4294967296.0f) return UINT32_MAX; return (uint32_t)f; }\n"
+	"static inline int32_t FloatToInt(float f) { if(isnan(f)) return 0; if(f <= -2147483648.0f) return INT32_MIN; if(f >= 2147483648.0f) return INT32_MAX; return (int32_t)f; }\n"
+	"static inline float FSign(float f) { return (float)((f > 0.0f) - (f < 0.0f)); }\n"
+	"static inline float SmoothStep(float e0, float e1, float x) { float t = (x - e0) / (e1 - e0); t = fminf(fmaxf(t, 0.0f), 1.0f); return t * t * (3.0f - 2.0f * t); }\n"
+	"static inline void Any(W* d, const W* a, uint32_t n) { uint32_t v = 0; for(uint32_t k = 0; k < n; k++) v |= a[k].u; d->u = v != 0; }\n"
+	"static inline void All(W* d, const W* a, uint32_t n) { uint32_t v = 1; for(uint32_t k = 0; k < n; k++) v &= a[k].u != 0; d->u = v; }\n"
+	"static inline void Dot(W* d, const W* a, const W* b, uint32_t n) { float v = 0.0f; for(uint32_t k = 0; k < n; k++) v += a[k].f * b[k].f; d->f = v; }\n"
+	"static inline void MatTimesVec(W* d, const W* m, const W* v, uint32_t cs, uint32_t rs) { for(uint32_t r = 0; r < rs; r++) { float x = 0.0f; for(uint32_t c = 0; c < cs; c++) x += m[c * rs + r].f * v[c].f; d[r].f = x; } }\n"
+	"static inline void VecTimesMat(W* d, const W* v, const W* m, uint32_t cs, uint32_t rs) { for(uint32_t c = 0; c < cs; c++) { float x = 0.0f; for(uint32_t r = 0; r < rs; r++) x += v[r].f * m[c * rs + r].f; d[c].f = x; } }\n"
+	"static inline void MatTimesMat(W* d, const W* a, const W* b, uint32_t ar, uint32_t ac, uint32_t bc) { for(uint32_t c = 0; c < bc; c++) for(uint32_t r = 0; r < ar; r++) { float x = 0.0f; for(uint32_t k = 0; k < ac; k++) x += a[k * ar + r].f * b[c * ac + k].f; d[c * ar + r].f = x; } }\n"
+	"static inline void Transpose(W* d, const W* m, uint32_t cs, uint32_t rs) { for(uint32_t c = 0; c < cs; c++) for(uint32_t r = 0; r < rs; r++) d[r * cs + c] = m[c * rs + r]; }\n"
+	"static inline void OuterProduct(W* d, const W* a, const W* b, uint32_t rs, uint32_t cs) { for(uint32_t c = 0; c < cs; c++) for(uint32_t r = 0; r < rs; r++) d[c * rs + r].f = a[r].f * b[c].f; }\n"
+	"static inline void VecExtract(W* d, const W* v, const W* i, uint32_t n) { uint32_t x = i->u; d->u = x < n ? v[x].u : 0; }\n"
+	"static inline void VecInsert(W* d, const W* v, const W* c, const W* i, uint32_t n) { uint32_t x = i->u; memmove(d, v, n * sizeof(W)); if(x < n) d[x] = *c; }\n"
+	"static inline void Length(W* d, const W* a, uint32_t n) { float v = 0.0f; for(uint32_t k = 0; k < n; k++) v += a[k].f * a[k].f; d->f = sqrtf(v); }\n"
+	"static inline void Distance(W* d, const W* a, const W* b, uint32_t n) { float v = 0.0f; for(uint32_t k = 0; k < n; k++) v += (a[k].f - b[k].f) * (a[k].f - b[k].f); d->f = sqrtf(v); }\n"
+	"static inline void Normalize(W* d, const W* a, uint32_t n) { float l = 0.0f; for(uint32_t k = 0; k < n; k++) l += a[k].f * a[k].f; l = sqrtf(l); for(uint32_t k = 0; k < n; k++) d[k].f = a[k].f / l; }\n"
+	"static inline void Cross(W* d, const W* a, const W* b) { float x = a[1].f * b[2].f - a[2].f * b[1].f; float y = a[2].f * b[0].f - a[0].f * b[2].f; float z = a[0].f * b[1].f - a[1].f * b[0].f; d[0].f = x; d[1].f = y; d[2].f = z; }\n"
+	"static inline void Reflect(W* d, const W* i, const W* nr, uint32_t n) { float v = 0.0f; for(uint32_t k = 0; k < n; k++) v += i[k].f * nr[k].f; for(uint32_t k = 0; k < n; k++) d[k].f = i[k].f - 2.0f * v * nr[k].f; }\n"
+	"#define FNEG(d, a) d.f = -a.f\n"
+	"#define SNEG(d, a) d.u = 0u - a.u\n"
+	"#define NOT(d, a) d.u = ~a.u\n"
+	"#define LNOT(d, a) d.u = !a.u\n"
+	"#define ISNAN(d, a) d.u = isnan(a.f) != 0\n"
+	"#define ISINF(d, a) d.u = isinf(a.f) != 0\n"
+	"#define F2U(d, a) d.u = FloatToUint(a.f)\n"
+	"#define F2S(d, a) d.i = FloatToInt(a.f)\n"
+	"#define U2F(d, a) d.f = (float)a.u\n"
+	"#define S2F(d, a) d.f = (float)a.i\n"
+	"#define FABS(d, a) d.f = fabsf(a.f)\n"
+	"#define SABS(d, a) d.u = a.i < 0 ? 0u - a.u : a.u\n"
+	"#define FSIGN(d, a) d.f = FSign(a.f)\n"
+	"#define SSIGN(d, a) d.i = (a.i > 0) - (a.i < 0)\n"
+	"#define FLOOR(d, a) d.f = floorf(a.f)\n"
+	"#define CEIL(d, a) d.f = ceilf(a.f)\n"
+	"#define TRUNC(d, a) d.f = truncf(a.f)\n"
+	"#define FRACT(d, a) d.f = a.f - floorf(a.f)\n"
+	"#define ROUND(d, a) d.f = roundf(a.f)\n"
+	"#define ROUND_EVEN(d, a) d.f = nearbyintf(a.f)\n"
+	"#define SQRT(d, a) d.f = sqrtf(a.f)\n"
+	"#define RSQRT(d, a) d.f = 1.0f / sqrtf(a.f)\n"
+	"#define EXP(d, a) d.f = expf(a.f)\n"
+	"#define EXP2(d, a) d.f = exp2f(a.f)\n"
+	"#define LOG(d, a) d.f = logf(a.f)\n"
+	"#define LOG2(d, a) d.f = log2f(a.f)\n"
+	"#define SIN(d, a) d.f = sinf(a.f)\n"
+	"#define COS(d, a) d.f = cosf(a.f)\n"
+	"#define TAN(d, a) d.f = tanf(a.f)\n"
+	"#define ASIN(d, a) d.f = asinf(a.f)\n"
+	"#define ACOS(d, a) d.f = acosf(a.f)\n"
+	"#define ATAN(d, a) d.f = atanf(a.f)\n"
+	"#define SINH(d, a) d.f = sinhf(a.f)\n"
+	"#define COSH(d, a) d.f = coshf(a.f)\n"
+	"#define TANH(d, a) d.f = tanhf(a.f)\n"
+	"#define IADD(d, a, b) d.u = a.u + b.u\n"
+	"#define ISUB(d, a, b) d.u = a.u - b.u\n"
+	"#define IMUL(d, a, b) d.u = a.u * b.u\n"
+	"#define SDIV(d, a, b) d.i = (b.i == 0 || (a.i == INT32_MIN && b.i == -1)) ? 0 : a.i / b.i\n"
+	"#define UDIV(d, a, b) d.u = b.u == 0 ? 0 : a.u / b.u\n"
+	"#define SREM(d, a, b) d.i = (b.i == 0 || b.i == -1) ? 0 : a.i % b.i\n"
+	"#define SMOD(d, a, b) do { int32_t t = (b.i == 0 || b.i == -1) ? 0 : a.i % b.i; d.i = (t != 0 && ((t < 0) != (b.i < 0))) ? t + b.i : t; } while(0)\n"
+	"#define UMOD(d, a, b) d.u = b.u == 0 ? 0 : a.u % b.u\n"
+	"#define FADD(d, a, b) d.f = a.f + b.f\n"
+	"#define FSUB(d, a, b) d.f = a.f - b.f\n"
+	"#define FMUL(d, a, b) d.f = a.f * b.f\n"
+	"#define FDIV(d, a, b) d.f = a.f / b.f\n"
+	"#define FREM(d, a, b) d.f = fmodf(a.f, b.f)\n"
+	"#define FMOD(d, a, b) d.f = a.f - b.f * floorf(a.f / b.f)\n"
+	"#define SHL(d, a, b) d.u = a.u << (b.u & 31)\n"
+	"#define SHR(d, a, b) d.u = a.u >> (b.u & 31)\n"
+	"#define SAR(d, a, b) d.u = a.i < 0 ? ~(~a.u >> (b.u & 31)) : a.u >> (b.u & 31)\n"
+	"#define AND(d, a, b) d.u = a.u & b.u\n"
+	"#define OR(d, a, b) d.u = a.u | b.u\n"
+	"#define XOR(d, a, b) d.u = a.u ^ b.u\n"
+	"#define IEQ(d, a, b) d.u = a.u == b.u\n"
+	"#define INE(d, a, b) d.u = a.u != b.u\n"
+	"#define ULT(d, a, b) d.u = a.u < b.u\n"
+	"#define ULE(d, a, b) d.u = a.u <= b.u\n"
+	"#define UGT(d, a, b) d.u = a.u > b.u\n"
+	"#define UGE(d, a, b) d.u = a.u >= b.u\n"
+	"#define SLT(d, a, b) d.u = a.i < b.i\n"
+	"#define SLE(d, a, b) d.u = a.i <= b.i\n"
+	"#define SGT(d, a, b) d.u = a.i > b.i\n"
+	"#define SGE(d, a, b) d.u = a.i >= b.i\n"
+	"#define FOEQ(d, a, b) d.u = a.f == b.f\n"
+	"#define FONE(d, a, b) d.u = a.f < b.f || a.f > b.f\n"
+	"#define FOLT(d, a, b) d.u = a.f < b.f\n"
+	"#define FOLE(d, a, b) d.u = a.f <= b.f\n"
+	"#define FOGT(d, a, b) d.u = a.f > b.f\n"
+	"#define FOGE(d, a, b) d.u = a.f >= b.f\n"
+	"#define FUEQ(d, a, b) d.u = !(a.f < b.f || a.f > b.f)\n"
+	"#define FUNE(d, a, b) d.u = a.f != b.f\n"
+	"#define FULT(d, a, b) d.u = !(a.f >= b.f)\n"
+	"#define FULE(d, a, b) d.u = !(a.f > b.f)\n"
+	"#define FUGT(d, a, b) d.u = !(a.f <= b.f)\n"
+	"#define FUGE(d, a, b) d.u = !(a.f < b.f)\n"
+	"#define POW(d, a, b) d.f = powf(a.f, b.f)\n"
+	"#define ATAN2(d, a, b) d.f = atan2f(a.f, b.f)\n"
+	"#define FMIN(d, a, b) d.f = fminf(a.f, b.f)\n"
+	"#define FMAX(d, a, b) d.f = fmaxf(a.f, b.f)\n"
+	"#define UMIN(d, a, b) d.u = a.u < b.u ? a.u : b.u\n"
+	"#define UMAX(d, a, b) d.u = a.u > b.u ? a.u : b.u\n"
+	"#define SMIN(d, a, b) d.i = a.i < b.i ? a.i : b.i\n"
+	"#define SMAX(d, a, b) d.i = a.i > b.i ? a.i : b.i\n"
+	"#define STEP(d, a, b) d.f = b.f < a.f ? 0.0f : 1.0f\n"
+	"#define FCLAMP(d, a, b, c) d.f = fminf(fmaxf(a.f, b.f), c.f)\n"
+	"#define UCLAMP(d, a, b, c) do { uint32_t t = a.u < b.u ? b.u : a.u; d.u = t > c.u ? c.u : t; } while(0)\n"
+	"#define SCLAMP(d, a, b, c) do { int32_t t = a.i < b.i ? b.i : a.i; d.i = t > c.i ? c.i : t; } while(0)\n"
+	"#define FMIX(d, a, b, c) d.f = a.f * (1.0f - c.f) + b.f * c.f\n"
+	"#define FMA(d, a, b, c) d.f = fmaf(a.f, b.f, c.f)\n"
+	"#define SMOOTHSTEP(d, a, b, c) d.f = SmoothStep(a.f, b.f, c.f)\n"
+	"#if defined(_WIN32)\n"
+	"__declspec(dllexport)\n"
+	"#else\n"
+	"__attribute__((visibility(\"default\")))\n"
+	"#endif\n"
+	"void " SOFT_COMPILER_KERNEL_SYMBOL "(W* r, R* g, uint32_t n, uint32_t* stack, void (*barrier)(void))\n"
+	"{\n"
+	"\tuint32_t depth = 0;\n";
+
+#define SOFT_COMPILER_OP_NAME(name, words) #name,
+static const char* const soft_compiler_op_names[] = { SOFT_IR_OPS(SOFT_COMPILER_OP_NAME) };
+#undef SOFT_COMPILER_OP_NAME
+
+#define SOFT_COMPILER_OP_WORDS(name, words) words,
+static const uint32_t soft_compiler_op_words[] = { SOFT_IR_OPS(SOFT_COMPILER_OP_WORDS) };
+
+static const char* soft_compiler_atomic_functions[SOFT_IR_ATOMIC_MAX_ENUM] = {
+	"atomic_exchange_explicit",
+	"atomic_fetch_add_explicit",
+	"atomic_fetch_sub_explicit",
+	"AtomicFetchSMin",
+	"AtomicFetchUMin",
+	"AtomicFetchSMax",
+	"AtomicFetchUMax",
+	"atomic_fetch_and_explicit",
+	"atomic_fetch_or_explicit",
+	"atomic_fetch_xor_explicit",
+};
+
+static const char* soft_compiler_memory_orders[SOFT_IR_MEMORY_ORDER_MAX_ENUM] = {
+	"memory_order_relaxed",
+	"memory_order_acquire",
+	"memory_order_release",
+	"memory_order_acq_rel",
+	"memory_order_seq_cst",
+};
+#undef SOFT_COMPILER_OP_WORDS
+
+typedef struct SoftCompilerSource
+{
+	char* data;
+	size_t size;
+	size_t capacity;
+	bool failed;
+} SoftCompilerSource;
+
+static void SoftCompilerAppend(SoftCompilerSource* source, const char* format, ...)
+{
+	if(source->failed)
+		return;
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(PULSE_NULLPTR, 0, format, args);
+	va_end(args);
+	if(length < 0)
+	{
+		source->failed = true;
+		return;
+	}
+	if(source->size + length + 1 > source->capacity)
+	{
+		size_t capacity = source->capacity == 0 ? 65536 : source->capacity;
+		while(source->size + length + 1 > capacity)
+			capacity *= 2;
+		char* data = (char*)realloc(source->data, capacity);
+		if(data == PULSE_NULLPTR)
+		{
+			source->failed = true;
+			return;
+		}
+		source->data = data;
+		source->capacity = capacity;
+	}
+	va_start(args, format);
+	vsnprintf(source->data + source->size, source->capacity - source->size, format, args);
+	va_end(args);
+	source->size += length;
+}
+
+// Returns the words count of the instruction, 0 if it cannot be translated
+static uint32_t SoftCompilerEmitInstruction(SoftCompilerSource* source, const SoftIRProgram* program, uint32_t pc)
+{
+	const uint32_t* code = program->code;
+	uint32_t op = code[pc];
+	if(op >= SOFT_IR_OP_MAX_ENUM)
+		return 0;
+	uint32_t words = soft_compiler_op_words[op] != 0 ? soft_compiler_op_words[op] : (pc + 1 < program->code_size ? code[pc + 1] : 0);
+	if(words == 0 || pc + words > program->code_size)
+		return 0;
+	const uint32_t* w = &code[pc];
+
+	SoftCompilerAppend(source, "L%u:\n\t", pc);
+	switch(op)
+	{
+		case SOFT_IR_OP_HALT: SoftCompilerAppend(source, "return;\n"); break;
+		case SOFT_IR_OP_MOV: SoftCompilerAppend(source, "memmove(&r[%u], &r[%u], %u);\n", w[1], w[2], w[3] * 4); break;
+		case SOFT_IR_OP_LOAD: SoftCompilerAppend(source, "Load(g, n, &r[%u], 0, &r[%u], %u);\n", w[2], w[1], w[3]); break;
+		case SOFT_IR_OP_STORE: SoftCompilerAppend(source, "Store(g, n, &r[%u], 0, &r[%u], %u);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_LOAD_PLAN:
+		case SOFT_IR_OP_STORE_PLAN:
+		{
+			if(w[3] >= program->copy_plans_count)
+				return 0;
+			const SoftIRCopyPlan* plan = &program->copy_plans[w[3]];
+			for(uint32_t i = 0; i < plan->chunks_count; i++)
+			{
+				const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+				if(op == SOFT_IR_OP_LOAD_PLAN)
+					SoftCompilerAppend(source, "Load(g, n, &r[%u], %u, (uint8_t*)&r[%u] + %u, %u); ", w[2], chunk->memory_offset, w[1], chunk->register_offset, chunk->size);
+				else
+					SoftCompilerAppend(source, "Store(g, n, &r[%u], %u, (const uint8_t*)&r[%u] + %u, %u); ", w[1], chunk->memory_offset, w[2], chunk->register_offset, chunk->size);
+			}
+			SoftCompilerAppend(source, "\n");
+			break;
+		}
+		case SOFT_IR_OP_ACCESS_CHAIN:
+		{
+			SoftCompilerAppend(source, "{ uint32_t o = r[%u].u + %uu;", w[3] + 1, w[4]);
+			for(uint32_t i = 0; i < w[5]; i++)
+				SoftCompilerAppend(source, " o += r[%u].u * %uu;", w[6 + i * 2], w[7 + i * 2]);
+			SoftCompilerAppend(source, " r[%u].u = r[%u].u; r[%u].u = o; }\n", w[2], w[3], w[2] + 1);
+			break;
+		}
+		case SOFT_IR_OP_ARRAY_LENGTH: SoftCompilerAppend(source, "r[%u].u = ArrayLength(g, n, &r[%u], %u, %u);\n", w[1], w[2], w[3], w[4]); break;
+		case SOFT_IR_OP_ATOMIC_LOAD:
+		{
+			if(w[3] >= SOFT_IR_MEMORY_ORDER_MAX_ENUM)
+				return 0;
+			SoftCompilerAppend(source, "{ _Atomic uint32_t* m = AtomicWord(g, n, &r[%u]); r[%u].u = m ? atomic_load_explicit(m, %s) : 0; }\n", w[2], w[1], soft_compiler_memory_orders[w[3]]);
+			break;
+		}
+		case SOFT_IR_OP_ATOMIC_STORE:
+		{
+			if(w[3] >= SOFT_IR_MEMORY_ORDER_MAX_ENUM)
+				return 0;
+			SoftCompilerAppend(source, "{ _Atomic uint32_t* m = AtomicWord(g, n, &r[%u]); if(m) atomic_store_explicit(m, r[%u].u, %s); }\n", w[1], w[2], soft_compiler_memory_orders[w[3]]);
+			break;
+		}
+		case SOFT_IR_OP_ATOMIC_RMW:
+		{
+			if(w[4] >= SOFT_IR_ATOMIC_MAX_ENUM || w[5] >= SOFT_IR_MEMORY_ORDER_MAX_ENUM)
+				return 0;
+			SoftCompilerAppend(source, "{ _Atomic uint32_t* m = AtomicWord(g, n, &r[%u]); r[%u].u = m ? %s(m, r[%u].u, %s) : 0; }\n", w[2], w[1], soft_compiler_atomic_functions[w[4]], w[3], soft_compiler_memory_orders[w[5]]);
+			break;
+		}
+		case SOFT_IR_OP_ATOMIC_CMPXCHG:
+		{
+			if(w[5] >= SOFT_IR_MEMORY_ORDER_MAX_ENUM || w[6] >= SOFT_IR_MEMORY_ORDER_MAX_ENUM)
+				return 0;
+			SoftCompilerAppend(source, "{ _Atomic uint32_t* m = AtomicWord(g, n, &r[%u]); uint32_t c = r[%u].u; if(m) atomic_compare_exchange_strong_explicit(m, &c, r[%u].u, %s, %s); else c = 0; r[%u].u = c; }\n",
+					w[2], w[4], w[3], soft_compiler_memory_orders[w[5]], soft_compiler_memory_orders[w[6]], w[1]);
+			break;
+		}
+		case SOFT_IR_OP_FMUL_SCALAR:
+		{
+			for(uint32_t k = 0; k < w[4]; k++)
+				SoftCompilerAppend(source, "FMUL(r[%u], r[%u], r[%u]); ", w[1] + k, w[2] + k, w[3]);
+			SoftCompilerAppend(source, "\n");
+			break;
+		}
+		case SOFT_IR_OP_ANY: SoftCompilerAppend(source, "Any(&r[%u], &r[%u], %u);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_ALL: SoftCompilerAppend(source, "All(&r[%u], &r[%u], %u);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_SELECT:
+		{
+			for(uint32_t k = 0; k < w[5]; k++)
+				SoftCompilerAppend(source, "r[%u] = r[%u].u ? r[%u] : r[%u]; ", w[1] + k, w[2] + k * w[6], w[3] + k, w[4] + k);
+			SoftCompilerAppend(source, "\n");
+			break;
+		}
+		case SOFT_IR_OP_DOT: SoftCompilerAppend(source, "Dot(&r[%u], &r[%u], &r[%u], %u);\n", w[1], w[2], w[3], w[4]); break;
+		case SOFT_IR_OP_MAT_TIMES_VEC: SoftCompilerAppend(source, "MatTimesVec(&r[%u], &r[%u], &r[%u], %u, %u);\n", w[1], w[2], w[3], w[4], w[5]); break;
+		case SOFT_IR_OP_VEC_TIMES_MAT: SoftCompilerAppend(source, "VecTimesMat(&r[%u], &r[%u], &r[%u], %u, %u);\n", w[1], w[2], w[3], w[4], w[5]); break;
+		case SOFT_IR_OP_MAT_TIMES_MAT: SoftCompilerAppend(source, "MatTimesMat(&r[%u], &r[%u], &r[%u], %u, %u, %u);\n", w[1], w[2], w[3], w[4], w[5], w[6]); break;
+		case SOFT_IR_OP_TRANSPOSE: SoftCompilerAppend(source, "Transpose(&r[%u], &r[%u], %u, %u);\n", w[1], w[2], w[3], w[4]); break;
+		case SOFT_IR_OP_OUTER_PRODUCT: SoftCompilerAppend(source, "OuterProduct(&r[%u], &r[%u], &r[%u], %u, %u);\n", w[1], w[2], w[3], w[4], w[5]); break;
+		case SOFT_IR_OP_VEC_EXTRACT_DYN: SoftCompilerAppend(source, "VecExtract(&r[%u], &r[%u], &r[%u], %u);\n", w[1], w[2], w[3], w[4]); break;
+		case SOFT_IR_OP_VEC_INSERT_DYN: SoftCompilerAppend(source, "VecInsert(&r[%u], &r[%u], &r[%u], &r[%u], %u);\n", w[1], w[2], w[3], w[4], w[5]); break;
+		case SOFT_IR_OP_LENGTH: SoftCompilerAppend(source, "Length(&r[%u], &r[%u], %u);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_DISTANCE: SoftCompilerAppend(source, "Distance(&r[%u], &r[%u], &r[%u], %u);\n", w[1], w[2], w[3], w[4]); break;
+		case SOFT_IR_OP_NORMALIZE: SoftCompilerAppend(source, "Normalize(&r[%u], &r[%u], %u);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_CROSS: SoftCompilerAppend(source, "Cross(&r[%u], &r[%u], &r[%u]);\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_REFLECT: SoftCompilerAppend(source, "Reflect(&r[%u], &r[%u], &r[%u], %u);\n", w[1], w[2], w[3], w[4]); break;
+
+		case SOFT_IR_OP_JMP: SoftCompilerAppend(source, "goto L%u;\n", w[1]); break;
+		case SOFT_IR_OP_BR: SoftCompilerAppend(source, "if(r[%u].u) goto L%u; goto L%u;\n", w[1], w[2], w[3]); break;
+		case SOFT_IR_OP_SWITCH:
+		{
+			SoftCompilerAppend(source, "switch(r[%u].u) {", w[2]);
+			for(uint32_t i = 4; i + 1 < words; i += 2)
+			{
+				bool duplicate = false; // First match wins, like in the interpreter
+				for(uint32_t j = 4; j < i && !duplicate; j += 2)
+					duplicate = w[j] == w[i];
+				if(!duplicate)
+					SoftCompilerAppend(source, " case %uu: goto L%u;", w[i], w[i + 1]);
+			}
+			SoftCompilerAppend(source, " default: goto L%u; }\n", w[3]);
+			break;
+		}
+		case SOFT_IR_OP_CALL: SoftCompilerAppend(source, "if(depth == %u) return; stack[depth++] = %u; goto L%u;\n", SOFT_IR_MAX_CALL_DEPTH, pc + 2, w[1]); break;
+		case SOFT_IR_OP_RET: SoftCompilerAppend(source, "goto Return;\n"); break;
+		case SOFT_IR_OP_BARRIER: SoftCompilerAppend(source, "barrier();\n"); break;
+
+		case SOFT_IR_OP_IMAGE_READ: // Texel formats are decoded by the backend, image pipelines stay on the interpreter
+		case SOFT_IR_OP_IMAGE_WRITE:
+		case SOFT_IR_OP_IMAGE_SIZE:
+			return 0;
+
+		default:
+		{
+			uint32_t operands = words - 2; // Destination, sources and components count
+			if(words < 4 || words > 6)
+				return 0;
+			for(uint32_t k = 0; k < w[words - 1]; k++)
+			{
+				SoftCompilerAppend(source, "%s(r[%u]", soft_compiler_op_names[op], w[1] + k);
+				for(uint32_t i = 1; i < operands; i++)
+					SoftCompilerAppend(source, ", r[%u]", w[1 + i] + k);
+				SoftCompilerAppend(source, "); ");
+			}
+			SoftCompilerAppend(source, "\n");
+			break;
+		}
+	}
+	return words;
+}
+
+static bool SoftCompilerGenerate(SoftCompilerSource* source, const SoftIRProgram* program)
+{
+	SoftCompilerAppend(source, "%s\tgoto L%u;\n", soft_compiler_prelude, program->entry_pc);
+
+	// Return addresses are only known at run time, they are dispatched back to the instruction following each call
+	uint32_t calls_count = 0;
+	for(uint32_t pc = 0; pc < program->code_size;)
+	{
+		if(program->code[pc] == SOFT_IR_OP_CALL)
+			calls_count++;
+		uint32_t words = SoftCompilerEmitInstruction(source, program, pc);
+		if(words == 0)
+			return false;
+		pc += words;
+	}
+
+	SoftCompilerAppend(source, "Return:\n\tif(depth == 0) return;\n\tswitch(stack[--depth]) {");
+	for(uint32_t pc = 0; pc < program->code_size && calls_count > 0; pc += soft_compiler_op_words[program->code[pc]] != 0 ? soft_compiler_op_words[program->code[pc]] : program->code[pc + 1])
+	{
+		if(program->code[pc] == SOFT_IR_OP_CALL)
+			SoftCompilerAppend(source, " case %uu: goto L%u;", pc + 2, pc + 2);
+	}
+	SoftCompilerAppend(source, " default: return; }\n}\n");
+	return !source->failed;
+}
+
+static uint64_t SoftCompilerHash(uint64_t hash, const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for(size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+// Splits in place on blanks, there is no quoting as no shell ever interprets the command
+static uint32_t SoftCompilerSplitArguments(char* line, char** arguments, uint32_t arguments_count, uint32_t capacity)
+{
+	for(char* c = line; *c != '\0';)
+	{
+		if(*c == ' ' || *c == '\t')
+		{
+			*c++ = '\0';
+			continue;
+		}
+		if(arguments_count == capacity)
+			return capacity + 1;
+		arguments[arguments_count++] = c;
+		while(*c != '\0' && *c != ' ' && *c != '\t')
+			c++;
+	}
+	return arguments_count;
+}
+
+// Runs the compiler without going through a shell so that neither the command nor the paths can inject anything,
+// its output is discarded. Arguments are NULL terminated and appended after the compiler command words
+static bool SoftCompilerRun(const SoftCompiler* compiler, const char* const* extra_arguments)
+{
+	char command[SOFT_COMPILER_PATH_MAX];
+	char isa_flags[64];
+	char* arguments[SOFT_COMPILER_MAX_ARGUMENTS + 1];
+	PulseStrlcpy(command, compiler->command, sizeof(command));
+	PulseStrlcpy(isa_flags, compiler->isa_flags != PULSE_NULLPTR ? compiler->isa_flags : "", sizeof(isa_flags));
+	uint32_t arguments_count = SoftCompilerSplitArguments(command, arguments, 0, SOFT_COMPILER_MAX_ARGUMENTS);
+	if(arguments_count == 0 || arguments_count > SOFT_COMPILER_MAX_ARGUMENTS)
+		return false;
+	for(uint32_t i = 0; extra_arguments[i] != PULSE_NULLPTR; i++)
+	{
+		// The ISA flags are a single entry that may hold several flags
+		if(extra_arguments[i] == compiler->isa_flags)
+			arguments_count = SoftCompilerSplitArguments(isa_flags, arguments, arguments_count, SOFT_COMPILER_MAX_ARGUMENTS);
+		else if(arguments_count < SOFT_COMPILER_MAX_ARGUMENTS)
+			arguments[arguments_count++] = (char*)extra_arguments[i];
+		else
+			return false;
+		if(arguments_count > SOFT_COMPILER_MAX_ARGUMENTS)
+			return false;
+	}
+	arguments[arguments_count] = PULSE_NULLPTR;
+
+	#ifdef PULSE_PLAT_WINDOWS
+		// CreateProcess takes a single command line, arguments are quoted and those that would break out of their quotes are rejected
+		char command_line[SOFT_COMPILER_PATH_MAX * 4];
+		size_t length = 0;
+		for(uint32_t i = 0; i < arguments_count; i++)
+		{
+			size_t argument_length = strlen(arguments[i]);
+			if(strchr(arguments[i], '"') != PULSE_NULLPTR || (argument_length != 0 && arguments[i][argument_length - 1] == '\\') || length + argument_length + 4 > sizeof(command_line))
+				return false;
+			length += snprintf(command_line + length, sizeof(command_line) - length, "%s\"%s\"", i == 0 ? "" : " ", arguments[i]);
+		}
+
+		SECURITY_ATTRIBUTES security_attributes = { sizeof(SECURITY_ATTRIBUTES), PULSE_NULLPTR, TRUE };
+		HANDLE null_device = CreateFileA(SOFT_COMPILER_NULL_DEVICE, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &security_attributes, OPEN_EXISTING, 0, PULSE_NULLPTR);
+		if(null_device == INVALID_HANDLE_VALUE)
+			return false;
+		STARTUPINFOA startup_info = { 0 };
+		startup_info.cb = sizeof(STARTUPINFOA);
+		startup_info.dwFlags = STARTF_USESTDHANDLES;
+		startup_info.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+		startup_info.hStdOutput = null_device;
+		startup_info.hStdError = null_device;
+		PROCESS_INFORMATION process_info = { 0 };
+		BOOL created = CreateProcessA(PULSE_NULLPTR, command_line, PULSE_NULLPTR, PULSE_NULLPTR, TRUE, CREATE_NO_WINDOW, PULSE_NULLPTR, PULSE_NULLPTR, &startup_info, &process_info);
+		CloseHandle(null_device);
+		if(!created)
+			return false;
+		WaitForSingleObject(process_info.hProcess, INFINITE);
+		DWORD exit_code = 1;
+		GetExitCodeProcess(process_info.hProcess, &exit_code);
+		CloseHandle(process_info.hThread);
+		CloseHandle(process_info.hProcess);
+		return exit_code == 0;
+	#else
+		posix_spawn_file_actions_t actions;
+		if(posix_spawn_file_actions_init(&actions) != 0)
+			return false;
+		posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, SOFT_COMPILER_NULL_DEVICE, O_WRONLY, 0);
+		posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+		pid_t pid;
+		int res = posix_spawnp(&pid, arguments[0], &actions, PULSE_NULLPTR, arguments, environ);
+		posix_spawn_file_actions_destroy(&actions);
+		if(res != 0)
+			return false;
+		int status;
+		while(waitpid(pid, &status, 0) < 0)
+		{
+			if(errno != EINTR)
+				return false;
+		}
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	#endif
+}
+
+void SoftInitCompiler(SoftCompiler* compiler, const char* command, const char* cache_directory)
+{
+	memset(compiler, 0, sizeof(SoftCompiler));
+
+	// The command is split on blanks and run without a shell
+	if(command == PULSE_NULLPTR || command[0] == '\0' || PulseStrlcpy(compiler->command, command, sizeof(compiler->command)) >= sizeof(compiler->command))
+		return;
+	if(cache_directory != PULSE_NULLPTR)
+	{
+		if(PulseStrlcpy(compiler->cache_directory, cache_directory, sizeof(compiler->cache_directory)) >= sizeof(compiler->cache_directory))
+			return;
+	}
+	else if(!PulseFindCacheDirectory("PULSE_SOFTWARE_CACHE_DIR", compiler->cache_directory, sizeof(compiler->cache_directory)))
+		return;
+
+	// Same choice as the lockstep executor, FMA stays disabled to produce the interpreter results
+	compiler->isa = "generic";
+	compiler->isa_flags = "";
+	if(cpuinfo_has_x86_avx512f())
+	{
+		compiler->isa = "avx512f";
+		compiler->isa_flags = "-mavx2 -mavx512f";
+	}
+	else if(cpuinfo_has_x86_avx2())
+	{
+		compiler->isa = "avx2";
+		compiler->isa_flags = "-mavx2";
+	}
+	else if(cpuinfo_has_x86_sse2())
+		compiler->isa = "sse2";
+	else if(cpuinfo_has_arm_neon())
+		compiler->isa = "neon";
+
+	const char* probe[] = { "--version", PULSE_NULLPTR };
+	compiler->available = SoftCompilerRun(compiler, probe);
+}
+
+static bool SoftLoadCompiledKernel(const char* path, SoftCompiledKernel* kernel)
+{
+	kernel->module = PulseLoadLibrary(path);
+	if(kernel->module == PULSE_NULL_LIB_MODULE)
+		return false;
+	kernel->function = (PFN_SoftCompiledKernel)PulseLoadSymbolFromLibModule(kernel->module, SOFT_COMPILER_KERNEL_SYMBOL);
+	if(kernel->function != PULSE_NULLPTR)
+		return true;
+	PulseUnloadLibrary(kernel->module);
+	kernel->module = PULSE_NULL_LIB_MODULE;
+	return false;
+}
+
+bool SoftCompileIRProgram(PulseBackend backend, const SoftCompiler* compiler, const SoftIRProgram* program, const uint32_t* code, size_t words_count, const char* entry_point, SoftCompiledKernel* kernel)
+{
+	memset(kernel, 0, sizeof(SoftCompiledKernel));
+	if(!compiler->available || program == PULSE_NULLPTR)
+		return false;
+
+	uint32_t version = SOFT_COMPILER_VERSION;
+	uint64_t hash = 0xCBF29CE484222325ull;
+	hash = SoftCompilerHash(hash, &version, sizeof(version));
+	hash = SoftCompilerHash(hash, code, words_count * sizeof(uint32_t));
+	hash = SoftCompilerHash(hash, entry_point, strlen(entry_point) + 1);
+	// Another compiler or set of flags may produce a different object
+	hash = SoftCompilerHash(hash, compiler->command, strlen(compiler->command) + 1);
+	hash = SoftCompilerHash(hash, compiler->isa_flags, strlen(compiler->isa_flags) + 1);
+
+	char path[SOFT_COMPILER_PATH_MAX];
+	int length = snprintf(path, sizeof(path), "%s/pulse_soft_%016llx_%s" SOFT_COMPILER_LIBRARY_EXTENSION, compiler->cache_directory, (unsigned long long)hash, compiler->isa);
+	if(length <= 0 || length >= (int)sizeof(path) - 32)
+		return false;
+
+	if(SoftLoadCompiledKernel(path, kernel))
+	{
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
+			PulseLogInfoFmt(backend, "(Soft) loaded cached native kernel %s", path);
+		return true;
+	}
+
+	SoftCompilerSource source = { 0 };
+	if(!SoftCompilerGenerate(&source, program))
+	{
+		free(source.data);
+		return false;
+	}
+
+	// Built under a unique name and renamed so that concurrent processes never load a partial object
+	char source_path[SOFT_COMPILER_PATH_MAX];
+	char object_path[SOFT_COMPILER_PATH_MAX];
+	if(!PulseMakeTemporaryPath(path, ".c", source_path, sizeof(source_path)) || !PulseMakeTemporaryPath(path, ".tmp", object_path, sizeof(object_path)))
+	{
+		free(source.data);
+		return false;
+	}
+
+	PulseCreateParentDirectories(path);
+	FILE* file = fopen(source_path, "wb");
+	bool written = file != PULSE_NULLPTR && fwrite(source.data, 1, source.size, file) == source.size;
+	if(file != PULSE_NULLPTR)
+		written = (fclose(file) == 0) && written;
+	free(source.data);
+
+	bool compiled = false;
+	if(written)
+	{
+		// The library flags come last as they are NULL where none are needed
+		const char* arguments[] = { "-std=c11", "-O2", "-ffp-contract=off", "-w", "-shared", compiler->isa_flags, "-o", object_path, source_path, "-lm", SOFT_COMPILER_LIBRARY_FLAGS, PULSE_NULLPTR };
+		compiled = SoftCompilerRun(compiler, arguments);
+	}
+	remove(source_path);
+
+	if(compiled && !PulseReplaceFile(object_path, path))
+		remove(object_path); // Another process won the race, its object is identical
+	if(!compiled || !SoftLoadCompiledKernel(path, kernel))
+	{
+		remove(object_path);
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogWarning(backend, "(Soft) native compilation failed, falling back to the interpreter");
+		return false;
+	}
+
+	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
+		PulseLogInfoFmt(backend, "(Soft) compiled native kernel %s", path);
+	return true;
+}
+
+static void SoftCompiledKernelBarrier(void)
+{
+	SoftWorkgroupBarrier(SoftGetCurrentWorkgroup());
+}
+
+void SoftRunCompiledKernel(const SoftCompiledKernel* kernel, SoftIRContext* context)
+{
+	kernel->function(context->registers, context->regions, context->regions_count, context->call_stack, SoftCompiledKernelBarrier);
+}
+
+void SoftDestroyCompiledKernel(SoftCompiledKernel* kernel)
+{
+	if(kernel->module != PULSE_NULL_LIB_MODULE)
+		PulseUnloadLibrary(kernel->module);
+	memset(kernel, 0, sizeof(SoftCompiledKernel));
+}
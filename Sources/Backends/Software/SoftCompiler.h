@@ -0,0 +1,46 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_COMPILER_H_
+#define PULSE_SOFTWARE_COMPILER_H_
+
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftIR.h"
+
+// Lowered programs can be translated to C and built by the system compiler into a shared
+// object that is cached on disk, keyed by the SPIR-V hash and the target ISA.
+// Kernels run scalar, one invocation per call, on the same contexts as SoftIRExecute.
+
+#define SOFT_COMPILER_PATH_MAX 1024
+
+typedef void (*PFN_SoftCompiledKernel)(SoftIRWord* registers, SoftIRRegion* regions, uint32_t regions_count, uint32_t* call_stack, void (*barrier)(void));
+
+typedef struct SoftCompiler
+{
+	char command[SOFT_COMPILER_PATH_MAX];
+	char cache_directory[SOFT_COMPILER_PATH_MAX];
+	const char* isa; // Part of the cache key
+	const char* isa_flags;
+	bool available;
+} SoftCompiler;
+
+typedef struct SoftCompiledKernel
+{
+	PulseLibModule module;
+	PFN_SoftCompiledKernel function; // NULL if the pipeline runs on the interpreter
+} SoftCompiledKernel;
+
+void SoftInitCompiler(SoftCompiler* compiler, const char* command, const char* cache_directory); // Requires cpuinfo to be initialized, leaves the compiler unavailable if command is NULL, empty or does not run. A NULL cache directory picks the user one
+bool SoftCompileIRProgram(PulseBackend backend, const SoftCompiler* compiler, const SoftIRProgram* program, const uint32_t* code, size_t words_count, const char* entry_point, SoftCompiledKernel* kernel);
+void SoftRunCompiledKernel(const SoftCompiledKernel* kernel, SoftIRContext* context);
+void SoftDestroyCompiledKernel(SoftCompiledKernel* kernel);
+
+#endif // PULSE_SOFTWARE_COMPILER_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
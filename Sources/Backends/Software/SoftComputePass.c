@@ -2,6 +2,8 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <string.h>
+
 #include <Pulse.h>
 #include "../../PulseInternal.h"
 #include "Soft.h"
@@ -14,7 +16,11 @@ PulseComputePass SoftCreateComputePass(PulseDevice device, PulseCommandList cmd)
 	PulseComputePass pass = (PulseComputePass)calloc(1, sizeof(PulseComputePassHandler));
 	PULSE_CHECK_ALLOCATION_RETVAL(pass, PULSE_NULL_HANDLE);
 
+	SoftComputePass* soft_pass = (SoftComputePass*)calloc(1, sizeof(SoftComputePass));
+	PULSE_CHECK_ALLOCATION_RETVAL(soft_pass, PULSE_NULL_HANDLE);
+
 	pass->cmd = cmd;
+	pass->driver_data = soft_pass;
 
 	return pass;
 }
@@ -22,7 +28,8 @@ PulseComputePass SoftCreateComputePass(PulseDevice device, PulseCommandList cmd)
 void SoftDestroyComputePass(PulseDevice device, PulseComputePass pass)
 {
 	PULSE_UNUSED(device);
-	free(pass->driver_data);
+	SoftComputePass* soft_pass = SOFT_RETRIEVE_DRIVER_DATA_AS(pass, SoftComputePass*);
+	free(soft_pass);
 	free(pass);
 }
 
@@ -66,10 +73,50 @@ void SoftBindStorageBuffers(PulseComputePass pass, const PulseBuffer* buffers, u
 
 void SoftBindUniformData(PulseComputePass pass, uint32_t slot, const void* data, uint32_t data_size)
 {
+	if(slot >= PULSE_MAX_UNIFORM_BUFFERS_BOUND)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+			PulseLogErrorFmt(pass->cmd->device->backend, "(Soft) uniform slot %u is out of range", slot);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		return;
+	}
+	SoftComputePass* soft_pass = SOFT_RETRIEVE_DRIVER_DATA_AS(pass, SoftComputePass*);
+	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(pass->cmd, SoftCommandList*);
+
+	// Snapshots live as long as the command list, dispatches only keep a pointer to them
+	void* snapshot = PulseArenaAllocate(&soft_cmd->arena, data_size == 0 ? 1 : data_size, SOFT_UNIFORM_DATA_ALIGNMENT);
+	PULSE_CHECK_ALLOCATION(snapshot);
+	memcpy(snapshot, data, data_size);
+	soft_pass->uniform_data[slot] = snapshot;
+	soft_pass->uniform_data_sizes[slot] = data_size;
 }
 
 void SoftBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images)
 {
+	PulseImageUsageFlags usage = images[0]->usage;
+	bool is_readwrite = (usage & PULSE_IMAGE_USAGE_STORAGE_WRITE) != 0;
+	PulseImage* array = is_readwrite ? pass->readwrite_images : pass->readonly_images;
+
+	for(uint32_t i = 0; i < num_images; i++)
+	{
+		if(is_readwrite && (images[i]->usage & PULSE_IMAGE_USAGE_STORAGE_WRITE) == 0)
+		{
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+				PulseLogError(pass->cmd->device->backend, "cannot bind a read only image with read-write images");
+			PulseSetInternalError(PULSE_ERROR_INVALID_IMAGE_USAGE);
+			return;
+		}
+		else if(!is_readwrite && (images[i]->usage & PULSE_IMAGE_USAGE_STORAGE_WRITE) != 0)
+		{
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+				PulseLogError(pass->cmd->device->backend, "cannot bind a read-write image with read only images");
+			PulseSetInternalError(PULSE_ERROR_INVALID_IMAGE_USAGE);
+			return;
+		}
+		if(array[i] == images[i])
+			continue;
+		array[i] = images[i];
+	}
 }
 
 void SoftBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline)
@@ -86,6 +133,45 @@ void SoftDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint
 	command.Dispatch.groupcount_y = groupcount_y;
 	command.Dispatch.groupcount_z = groupcount_z;
 	command.Dispatch.pipeline = pass->current_pipeline;
-	mtx_init(&command.Dispatch.dispatch_mutex, mtx_plain);
+	command.Dispatch.bindings = SoftCaptureDispatchBindings(pass);
+	if(command.Dispatch.bindings == PULSE_NULLPTR)
+		return;
+	SoftQueueCommand(pass->cmd, command);
+}
+
+void SoftDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset)
+{
+	SoftCommand command = { 0 };
+	command.type = SOFT_COMMAND_DISPATCH_INDIRECT;
+	command.DispatchIndirect.buffer = buffer;
+	command.DispatchIndirect.offset = offset;
+	command.DispatchIndirect.pipeline = pass->current_pipeline;
+	command.DispatchIndirect.bindings = SoftCaptureDispatchBindings(pass);
+	if(command.DispatchIndirect.bindings == PULSE_NULLPTR)
+		return;
 	SoftQueueCommand(pass->cmd, command);
 }
+
+void SoftResetComputePass(PulseComputePass pass)
+{
+	SoftComputePass* soft_pass = SOFT_RETRIEVE_DRIVER_DATA_AS(pass, SoftComputePass*);
+	memset(soft_pass, 0, sizeof(SoftComputePass));
+	pass->current_pipeline = PULSE_NULL_HANDLE;
+	pass->is_recording = false;
+}
+
+const SoftDispatchBindings* SoftCaptureDispatchBindings(PulseComputePass pass)
+{
+	SoftComputePass* soft_pass = SOFT_RETRIEVE_DRIVER_DATA_AS(pass, SoftComputePass*);
+	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(pass->cmd, SoftCommandList*);
+	SoftDispatchBindings* bindings = (SoftDispatchBindings*)PulseArenaAllocate(&soft_cmd->arena, sizeof(SoftDispatchBindings), _Alignof(SoftDispatchBindings));
+	if(bindings == PULSE_NULLPTR)
+		return PULSE_NULLPTR;
+	memcpy(bindings->readonly_storage_buffers, pass->readonly_storage_buffers, sizeof(bindings->readonly_storage_buffers));
+	memcpy(bindings->readwrite_storage_buffers, pass->readwrite_storage_buffers, sizeof(bindings->readwrite_storage_buffers));
+	memcpy(bindings->readonly_images, pass->readonly_images, sizeof(bindings->readonly_images));
+	memcpy(bindings->readwrite_images, pass->readwrite_images, sizeof(bindings->readwrite_images));
+	memcpy(bindings->uniform_data, soft_pass->uniform_data, sizeof(bindings->uniform_data));
+	memcpy(bindings->uniform_data_sizes, soft_pass->uniform_data_sizes, sizeof(bindings->uniform_data_sizes));
+	return bindings;
+}
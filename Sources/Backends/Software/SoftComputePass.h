@@ -9,8 +9,29 @@
 #ifndef PULSE_SOFTWARE_COMPUTE_PASS_H_
 #define PULSE_SOFTWARE_COMPUTE_PASS_H_
 
+#include "../../PulseInternal.h"
 #include "Soft.h"
 
+// Uniform snapshots are aligned like std140 uniform blocks inside the command list arena
+#define SOFT_UNIFORM_DATA_ALIGNMENT 16
+
+typedef struct SoftComputePass
+{
+	const void* uniform_data[PULSE_MAX_UNIFORM_BUFFERS_BOUND]; // Snapshots in the command list arena
+	uint32_t uniform_data_sizes[PULSE_MAX_UNIFORM_BUFFERS_BOUND];
+} SoftComputePass;
+
+// Resources a dispatch runs with, captured in the command list arena when it is recorded since the pass bindings can change before submission
+typedef struct SoftDispatchBindings
+{
+	PulseBuffer readonly_storage_buffers[PULSE_MAX_READ_BUFFERS_BOUND];
+	PulseBuffer readwrite_storage_buffers[PULSE_MAX_WRITE_BUFFERS_BOUND];
+	PulseImage readonly_images[PULSE_MAX_READ_TEXTURES_BOUND];
+	PulseImage readwrite_images[PULSE_MAX_WRITE_TEXTURES_BOUND];
+	const void* uniform_data[PULSE_MAX_UNIFORM_BUFFERS_BOUND];
+	uint32_t uniform_data_sizes[PULSE_MAX_UNIFORM_BUFFERS_BOUND];
+} SoftDispatchBindings;
+
 PulseComputePass SoftCreateComputePass(PulseDevice device, PulseCommandList cmd);
 void SoftDestroyComputePass(PulseDevice device, PulseComputePass pass);
 
@@ -21,6 +42,10 @@ void SoftBindUniformData(PulseComputePass pass, uint32_t slot, const void* data,
 void SoftBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images);
 void SoftBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline);
 void SoftDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z);
+void SoftDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset);
+
+void SoftResetComputePass(PulseComputePass pass);
+const SoftDispatchBindings* SoftCaptureDispatchBindings(PulseComputePass pass);
 
 #endif // PULSE_SOFTWARE_COMPUTE_PASS_H_
 
@@ -3,111 +3,221 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <string.h>
+#include <spvm/ext/GLSL450.h>
 
 #include <Pulse.h>
 #include "../../PulseInternal.h"
 #include "Soft.h"
 #include "SoftDevice.h"
 #include "SoftComputePipeline.h"
+#include "SoftWorkgroup.h"
 
-void SoftAllocateWorkgroupMemory(struct spvm_state* state, spvm_word result_id, spvm_word type_id)
-{
-	SoftComputePipeline* pipeline = (SoftComputePipeline*)state->owner->user_data;
-	mtx_lock(&pipeline->workgroup_memory_allocations_mutex);
-		spvm_result_t result = &state->results[result_id];
-		PULSE_EXPAND_ARRAY_IF_NEEDED(pipeline->workgroup_memory_allocations, SoftSharedMemoryEntry, pipeline->workgroup_memory_allocations_size, pipeline->workgroup_memory_allocations_capacity, 16);
-		SoftSharedMemoryEntry* entry = &pipeline->workgroup_memory_allocations[pipeline->workgroup_memory_allocations_size];
-		entry->destination = &state->results[result_id];
-		entry->slot = result_id;
-		memcpy(&entry->data, entry->destination, sizeof(spvm_result));
-		spvm_result_allocate_typed_value(result, state->results, type_id);
-		pipeline->workgroup_memory_allocations_size++;
-	mtx_unlock(&pipeline->workgroup_memory_allocations_mutex);
-}
-/*
-void SoftWriteWorkgroupMemory(struct spvm_state* state, spvm_word result_id, spvm_word val_id)
+// Set while a worker creates its interpreter states so that they all bind the same workgroup memory
+static _Thread_local SoftInterpreterCache* soft_binding_cache = PULSE_NULLPTR;
+
+static void SoftAllocateWorkgroupMemory(struct spvm_state* state, spvm_word result_id, spvm_word type_id)
 {
-	spvm_result_t ptr = &state->results[result_id];
-	if(ptr->source_location != PULSE_NULLPTR)
+	SoftInterpreterCache* cache = soft_binding_cache;
+	spvm_result_t result = &state->results[result_id];
+	if(cache != PULSE_NULLPTR)
 	{
-		spvm_word word_count = ptr->source_word_count;
-		spvm_source code = ptr->source_location;
+		for(uint32_t i = 0; i < cache->shared_memory_size; i++)
+		{
+			if(cache->shared_memory[i].slot != result_id)
+				continue;
+			result->members = cache->shared_memory[i].members;
+			result->member_count = cache->shared_memory[i].member_count;
+			return;
+		}
+	}
 
-		spvm_word var_type = SPVM_READ_WORD(code);
-		spvm_word id = SPVM_READ_WORD(code);
-		spvm_word memory_id = SPVM_READ_WORD(code);
+	spvm_result_allocate_typed_value(result, state->results, type_id);
+	if(cache == PULSE_NULLPTR) // Dummy state, it keeps ownership of its memory
+		return;
 
-		spvm_result_t sharedData = PULSE_NULLPTR;
+	PULSE_EXPAND_ARRAY_IF_NEEDED(cache->shared_memory, SoftSharedMemoryEntry, cache->shared_memory_size, cache->shared_memory_capacity, 8);
+	PULSE_CHECK_ALLOCATION(cache->shared_memory);
+	SoftSharedMemoryEntry* entry = &cache->shared_memory[cache->shared_memory_size];
+	entry->members = result->members;
+	entry->member_count = result->member_count;
+	entry->slot = result_id;
+	cache->shared_memory_size++;
+}
 
-		ed::DebugInformation* dbgr = (ed::DebugInformation*)state->owner->user_data;
+static void SoftControlBarrier(struct spvm_state* state, spvm_word exec, spvm_word mem, spvm_word sem)
+{
+	PULSE_UNUSED(state);
+	PULSE_UNUSED(exec);
+	PULSE_UNUSED(mem);
+	PULSE_UNUSED(sem);
+	SoftWorkgroupBarrier(SoftGetCurrentWorkgroup());
+}
 
-		for(int i = 0; i < dbgr->SharedMemory.size(); i++)
+static bool SoftParseSpirv(SoftComputePipeline* pipeline, const uint32_t* code, size_t words_count)
+{
+	for(size_t i = 5; i < words_count;) // Skip SPIR-V header
+	{
+		uint32_t word_count = code[i] >> 16;
+		if(word_count == 0 || i + word_count > words_count)
+			break;
+		switch(code[i] & 0xFFFF)
 		{
-			if(dbgr->SharedMemory[i].Slot == memory_id)
+			// Workgroups without barriers can run their invocations one after the other without switching fibers
+			case SpvOpControlBarrier: pipeline->uses_control_barriers = true; break;
+
+			// Reused states have to get their initialized variables back before each invocation
+			case SpvOpVariable:
 			{
-				sharedData = &dbgr->SharedMemory[i].Data;
+				if(word_count < 5 || (code[i + 3] != SpvStorageClassPrivate && code[i + 3] != SpvStorageClassFunction))
+					break;
+				SoftVariableInitializer* initializers = (SoftVariableInitializer*)realloc(pipeline->initializers, sizeof(SoftVariableInitializer) * (pipeline->initializers_count + 1));
+				PULSE_CHECK_ALLOCATION_RETVAL(initializers, false);
+				pipeline->initializers = initializers;
+				pipeline->initializers[pipeline->initializers_count].variable = code[i + 2];
+				pipeline->initializers[pipeline->initializers_count].initializer = code[i + 4];
+				pipeline->initializers_count++;
+				break;
+			}
+
+			default:
+			{
+				// OpAtomicFlagTestAndSet, OpAtomicFlagClear, OpAtomicFMinEXT, OpAtomicFMaxEXT and OpAtomicFAddEXT
+				uint32_t opcode = code[i] & 0xFFFF;
+				if((opcode >= SpvOpAtomicLoad && opcode <= SpvOpAtomicXor) || opcode == 318 || opcode == 319 || opcode == 5614 || opcode == 5615 || opcode == 6035)
+					pipeline->uses_atomics = true;
 				break;
 			}
 		}
+		i += word_count;
+	}
+	return true;
+}
 
-		if(sharedData == PULSE_NULLPTR)
-			return;
+static void SoftDestroyInterpreterCache(SoftInterpreterCache* cache)
+{
+	for(uint32_t i = 0; i < cache->states_count; i++)
+	{
+		SoftDestroyIRContext(&cache->states[i].ir);
+		spvm_state_t state = cache->states[i].state;
+		if(state == PULSE_NULLPTR)
+			continue;
+		for(uint32_t j = 0; j < cache->shared_memory_size; j++) // Workgroup memory is owned by the cache
+		{
+			state->results[cache->shared_memory[j].slot].members = PULSE_NULLPTR;
+			state->results[cache->shared_memory[j].slot].member_count = 0;
+		}
+		spvm_state_delete(state);
+	}
+	for(uint32_t i = 0; i < cache->shared_memory_size; i++)
+		spvm_member_free(cache->shared_memory[i].members, cache->shared_memory[i].member_count);
+	free(cache->shared_memory);
+	free(cache->workgroup_memory);
+	free(cache->states);
+	memset(cache, 0, sizeof(SoftInterpreterCache));
+}
 
-		spvm_word index_count = word_count - 4;
+static bool SoftInitIRState(const SoftIRProgram* program, uint32_t lanes_count, SoftInterpreterCache* cache, SoftInterpreterState* interpreter)
+{
+	if(cache->workgroup_memory == PULSE_NULLPTR)
+	{
+		cache->workgroup_memory = (uint8_t*)calloc(1, program->workgroup_memory_size + 1);
+		PULSE_CHECK_ALLOCATION_RETVAL(cache->workgroup_memory, false);
+	}
+	if(!SoftInitIRContext(program, &interpreter->ir, lanes_count))
+		return false;
+	interpreter->ir.regions[SOFT_IR_REGION_WORKGROUP].data = cache->workgroup_memory;
+	interpreter->ir.regions[SOFT_IR_REGION_WORKGROUP].size = program->workgroup_memory_size;
+	return true;
+}
 
-		spvm_word index_id = SPVM_READ_WORD(code);
-		spvm_word index = state->results[index_id].members[0].value.s;
+SoftInterpreterState* SoftAcquireInterpreterState(SoftComputePipeline* pipeline, uint32_t worker_index, uint32_t group_index)
+{
+	// Only groups that can be parked on a barrier need their own state
+	SoftInterpreterCache* cache = &pipeline->caches[worker_index];
+	if(cache->states == PULSE_NULLPTR)
+	{
+		uint32_t states_count = pipeline->uses_control_barriers ? (pipeline->invocations_per_workgroup + pipeline->lanes_count - 1) / pipeline->lanes_count : 1;
+		cache->states = (SoftInterpreterState*)calloc(states_count, sizeof(SoftInterpreterState));
+		PULSE_CHECK_ALLOCATION_RETVAL(cache->states, PULSE_NULLPTR);
+		cache->states_count = states_count;
+	}
 
-		spvm_member_t result = sharedData->members + MIN(index, sharedData->member_count - 1);
+	SoftInterpreterState* interpreter = &cache->states[pipeline->uses_control_barriers ? group_index : 0];
+	if(pipeline->ir != PULSE_NULLPTR)
+	{
+		if(interpreter->ir.registers == PULSE_NULLPTR && !SoftInitIRState(pipeline->ir, pipeline->lanes_count, cache, interpreter))
+			return PULSE_NULLPTR;
+		return interpreter; // Private initializers are part of the IR entry prologue
+	}
 
-		while(index_count)
-		{
-			index_id = SPVM_READ_WORD(code);
-			index = state->results[index_id].members[0].value.s;
+	spvm_state_t state = interpreter->state;
+	if(state == PULSE_NULLPTR)
+	{
+		mtx_lock(&pipeline->states_creation_mutex);
+			soft_binding_cache = cache;
+			state = spvm_state_create(pipeline->program);
+			soft_binding_cache = PULSE_NULLPTR;
+		mtx_unlock(&pipeline->states_creation_mutex);
+		PULSE_CHECK_ALLOCATION_RETVAL(state, PULSE_NULLPTR);
 
-			result = result->members + MIN(index, result->member_count - 1);
+		state->control_barrier = SoftControlBarrier;
+		if(pipeline->glsl_std_450_slot != 0)
+			state->results[pipeline->glsl_std_450_slot].extension = pipeline->glsl_std_450_ext;
 
-			index_count--;
-		}
+		static const SpvBuiltIn builtins[SOFT_IR_BUILTIN_MAX_ENUM] = {
+			SpvBuiltInNumWorkgroups,
+			SpvBuiltInWorkgroupSize,
+			SpvBuiltInWorkgroupId,
+			SpvBuiltInLocalInvocationId,
+			SpvBuiltInGlobalInvocationId,
+			SpvBuiltInLocalInvocationIndex,
+		};
+		for(uint32_t i = 0; i < SOFT_IR_BUILTIN_MAX_ENUM; i++)
+			interpreter->builtins[i] = spvm_state_get_builtin(state, builtins[i], &interpreter->builtins_count[i]);
+		interpreter->state = state;
+		return interpreter;
+	}
 
-		spvm_member* members = PULSE_NULLPTR;
-		spvm_word member_count = 0;
-		if(result->member_count != 0)
-		{
-			member_count = result->member_count;
-			members = result->members;
-		}
-		else
-		{
-			member_count = 1;
-			members = result;
-		}
-		spvm_member_memcpy(members, state->results[val_id].members, member_count);
+	for(uint32_t i = 0; i < pipeline->initializers_count; i++)
+	{
+		spvm_result_t variable = &state->results[pipeline->initializers[i].variable];
+		spvm_member_memcpy(variable->members, state->results[pipeline->initializers[i].initializer].members, variable->member_count);
 	}
+	return interpreter;
 }
 
-void SoftControlBarrier(struct spvm_state* state, spvm_word exec, spvm_word mem, spvm_word sem)
+void SoftSetInterpreterBuiltin(const SoftComputePipeline* pipeline, SoftInterpreterState* state, uint32_t lane, SoftIRBuiltin builtin, const uint32_t* values, uint32_t values_count)
 {
-	ed::DebugInformation* dbgr = (ed::DebugInformation*)state->owner->user_data;
-
-	// copy memory
-	for(int i = 0; i < dbgr->SharedMemory.size(); i++)
+	if(pipeline->ir != PULSE_NULLPTR)
 	{
-		const ed::DebugInformation::SharedMemoryEntry& entry = dbgr->SharedMemory[i];
-		spvm_member_memcpy(entry.Data.members, entry.Destination->members, entry.Data.member_count);
+		SoftIRSetBuiltin(pipeline->ir, &state->ir, lane, builtin, values, values_count);
+		return;
 	}
+	spvm_member_t members = state->builtins[builtin];
+	if(members == PULSE_NULLPTR)
+		return;
+	for(uint32_t i = 0; i < (uint32_t)state->builtins_count[builtin] && i < values_count; i++)
+		members[i].value.u = values[i];
+}
 
-	// synchronize threads
-	dbgr->SyncWorkgroup();
-
-	// copy memory
-	for(int i = 0; i < dbgr->SharedMemory.size(); i++)
+void SoftRunInterpreterState(const SoftComputePipeline* pipeline, SoftInterpreterState* state, uint32_t active_lanes_count)
+{
+	if(pipeline->kernel.function != PULSE_NULLPTR)
 	{
-		const ed::DebugInformation::SharedMemoryEntry& entry = dbgr->SharedMemory[i];
-		spvm_member_memcpy(entry.Destination->members, entry.Data.members, entry.Destination->member_count);
+		SoftRunCompiledKernel(&pipeline->kernel, &state->ir);
+		return;
 	}
+	if(pipeline->ir != PULSE_NULLPTR)
+	{
+		if(pipeline->lanes_count > 1)
+			SoftIRExecuteLanes(pipeline->ir, &state->ir, active_lanes_count);
+		else
+			SoftIRExecute(pipeline->ir, &state->ir);
+		return;
+	}
+	spvm_state_prepare(state->state, pipeline->entry_point_location);
+	spvm_state_call_function(state->state);
 }
-*/
 
 PulseComputePipeline SoftCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
 {
@@ -123,25 +233,92 @@ PulseComputePipeline SoftCreateComputePipeline(PulseDevice device, const PulseCo
 	{
 		if(info->code == PULSE_NULLPTR)
 			PulseLogError(device->backend, "invalid code pointer passed to PulseComputePipelineCreateInfo");
-		if(info->entrypoint == PULSE_NULLPTR)
+		if(info->entrypoint == PULSE_NULLPTR && info->format != PULSE_SHADER_FORMAT_NATIVE_BIT)
 			PulseLogError(device->backend, "invalid entrypoint pointer passed to PulseComputePipelineCreateInfo");
 		if(info->format == PULSE_SHADER_FORMAT_SPIRV_BIT && (device->backend->supported_shader_formats & PULSE_SHADER_FORMAT_SPIRV_BIT) == 0)
 			PulseLogError(device->backend, "invalid shader format passed to PulseComputePipelineCreateInfo");
 	}
 
+	if(info->format == PULSE_SHADER_FORMAT_NATIVE_BIT)
+	{
+		const PulseNativeComputeShader* native = (const PulseNativeComputeShader*)info->code;
+		if(native == PULSE_NULLPTR || info->code_size != sizeof(PulseNativeComputeShader) || native->function == PULSE_NULLPTR)
+		{
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+				PulseLogError(device->backend, "(Soft) native pipelines expect code to point to a PulseNativeComputeShader");
+			PulseSetInternalError(PULSE_ERROR_INVALID_INTERNAL_POINTER);
+			free(soft_pipeline);
+			free(pipeline);
+			return PULSE_NULL_HANDLE;
+		}
+		soft_pipeline->native = *native;
+		for(uint32_t i = 0; i < 3; i++)
+		{
+			if(soft_pipeline->native.workgroup_size[i] == 0)
+				soft_pipeline->native.workgroup_size[i] = 1;
+		}
+		soft_pipeline->invocations_per_workgroup = soft_pipeline->native.workgroup_size[0] * soft_pipeline->native.workgroup_size[1] * soft_pipeline->native.workgroup_size[2];
+		soft_pipeline->lanes_count = 1;
+		pipeline->driver_data = soft_pipeline;
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(Soft) created new native compute pipeline %p", pipeline);
+		return pipeline;
+	}
+
 	soft_pipeline->program = spvm_program_create(soft_device->spv_context, (spvm_source)info->code, info->code_size / sizeof(spvm_word));
-	soft_pipeline->entry_point = calloc(1, strlen(info->entrypoint));
+	soft_pipeline->entry_point = calloc(1, strlen(info->entrypoint) + 1);
 	PULSE_CHECK_ALLOCATION_RETVAL(soft_pipeline->entry_point, PULSE_NULL_HANDLE);
 	strcpy((char*)soft_pipeline->entry_point, info->entrypoint);
 
 	soft_pipeline->program->user_data = soft_pipeline;
 	soft_pipeline->program->allocate_workgroup_memory = SoftAllocateWorkgroupMemory;
 
+	if(!SoftParseSpirv(soft_pipeline, (const uint32_t*)info->code, info->code_size / sizeof(uint32_t)))
+	{
+		spvm_program_delete(soft_pipeline->program);
+		free((void*)soft_pipeline->entry_point);
+		free(soft_pipeline);
+		free(pipeline);
+		return PULSE_NULL_HANDLE;
+	}
+
+	soft_pipeline->ir = SoftLowerSpirv(device->backend, (const uint32_t*)info->code, info->code_size / sizeof(uint32_t), soft_pipeline->entry_point);
+	SoftOptimizeIRProgram(soft_pipeline->ir);
+	if(soft_pipeline->ir != PULSE_NULLPTR && PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+		PulseLogInfoFmt(device->backend, "(Soft) bytecode optimised from %u to %u instructions", soft_pipeline->ir->lowered_instructions_count, SoftGetIRInstructionsCount(soft_pipeline->ir));
+	SoftCompileIRProgram(device->backend, SOFT_RETRIEVE_DRIVER_DATA_AS(device->backend, SoftDriverData*)->compiler, soft_pipeline->ir, (const uint32_t*)info->code, info->code_size / sizeof(uint32_t), soft_pipeline->entry_point, &soft_pipeline->kernel);
+
 	// Create dummy state to retrieve informations from the spirv
 	spvm_state_t state = spvm_state_create(soft_pipeline->program);
+	soft_pipeline->entry_point_location = spvm_state_get_result_location(state, (spvm_string)soft_pipeline->entry_point);
+	spvm_result_t glsl_std_450 = spvm_state_get_result(state, "GLSL.std.450");
+	if(glsl_std_450 != PULSE_NULLPTR)
+	{
+		soft_pipeline->glsl_std_450_slot = (spvm_word)(glsl_std_450 - state->results);
+		soft_pipeline->glsl_std_450_ext = spvm_build_glsl450_ext();
+	}
 	spvm_state_delete(state);
 
-	mtx_init(&soft_pipeline->workgroup_memory_allocations_mutex, mtx_plain);
+	soft_pipeline->invocations_per_workgroup = soft_pipeline->program->local_size_x * soft_pipeline->program->local_size_y * soft_pipeline->program->local_size_z;
+
+	// Lockstep groups are never wider than the workgroup, narrower than 4 lanes the scalar path is faster.
+	// Native kernels are scalar and left to the system compiler's vectoriser
+	soft_pipeline->lanes_count = 1;
+	if(soft_pipeline->ir != PULSE_NULLPTR && soft_pipeline->kernel.function == PULSE_NULLPTR)
+	{
+		uint32_t lanes_count = SOFT_RETRIEVE_DRIVER_DATA_AS(device->backend, SoftDriverData*)->lanes_count;
+		while(lanes_count > 4 && lanes_count > soft_pipeline->invocations_per_workgroup)
+			lanes_count /= 2;
+		if(lanes_count <= soft_pipeline->invocations_per_workgroup)
+			soft_pipeline->lanes_count = lanes_count;
+	}
+	soft_pipeline->caches_count = soft_device->thread_pool.workers_count;
+	soft_pipeline->caches = (SoftInterpreterCache*)calloc(soft_pipeline->caches_count, sizeof(SoftInterpreterCache));
+	PULSE_CHECK_ALLOCATION_RETVAL(soft_pipeline->caches, PULSE_NULL_HANDLE);
+	mtx_init(&soft_pipeline->states_creation_mutex, mtx_plain);
+	mtx_init(&soft_pipeline->interpreter_atomics_mutex, mtx_plain);
+	if(soft_pipeline->ir == PULSE_NULLPTR && soft_pipeline->uses_atomics && PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+		PulseLogWarningFmt(device->backend, "(Soft) compute pipeline %p uses atomics the interpreter cannot run atomically, its workgroups will be serialised", pipeline);
 
 	pipeline->driver_data = soft_pipeline;
 
@@ -150,6 +327,83 @@ PulseComputePipeline SoftCreateComputePipeline(PulseDevice device, const PulseCo
 	return pipeline;
 }
 
+static void SoftCreateComputePipelineTask(void* userdata, uint32_t task_index, uint32_t worker_index)
+{
+	PULSE_UNUSED(worker_index);
+	SoftComputePipelineBatch* batch = (SoftComputePipelineBatch*)userdata;
+	batch->pipelines[task_index] = SoftCreateComputePipeline(batch->device, &batch->infos[task_index]);
+}
+
+static bool SoftAreComputePipelinesCreated(const PulseComputePipeline* pipelines, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(pipelines[i] == PULSE_NULL_HANDLE)
+			return false;
+	}
+	return true;
+}
+
+bool SoftCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+	SoftComputePipelineBatch batch = { .device = device, .infos = infos, .pipelines = pipelines };
+	SoftThreadPoolRunBatch(&soft_device->thread_pool, SoftCreateComputePipelineTask, &batch, count);
+	return SoftAreComputePipelinesCreated(pipelines, count);
+}
+
+bool SoftCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+
+	SoftComputePipelineBatch* soft_batch = (SoftComputePipelineBatch*)calloc(1, sizeof(SoftComputePipelineBatch));
+	PULSE_CHECK_ALLOCATION_RETVAL(soft_batch, false);
+	soft_batch->device = device;
+	soft_batch->infos = batch->infos;
+	soft_batch->pipelines = batch->pipelines;
+	batch->driver_data = soft_batch;
+
+	// Dispatches submitted meanwhile queue behind the compilations on the same workers
+	SoftThreadPoolSubmitBatch(&soft_device->thread_pool, &soft_batch->tasks, SoftCreateComputePipelineTask, soft_batch, batch->count);
+	return true;
+}
+
+bool SoftIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	PULSE_UNUSED(device);
+	SoftComputePipelineBatch* soft_batch = SOFT_RETRIEVE_DRIVER_DATA_AS(batch, SoftComputePipelineBatch*);
+	if(!SoftIsTaskBatchDone(&soft_batch->tasks))
+		return false;
+	batch->succeeded = SoftAreComputePipelinesCreated(batch->pipelines, batch->count);
+	return true;
+}
+
+void SoftWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	PULSE_UNUSED(device);
+	SoftComputePipelineBatch* soft_batch = SOFT_RETRIEVE_DRIVER_DATA_AS(batch, SoftComputePipelineBatch*);
+	SoftWaitForTaskBatch(&soft_batch->tasks);
+	batch->succeeded = SoftAreComputePipelinesCreated(batch->pipelines, batch->count);
+	free(soft_batch);
+	batch->driver_data = PULSE_NULLPTR;
+}
+
+bool SoftGetComputePipelineStatistics(PulseDevice device, PulseComputePipeline pipeline, PulseComputePipelineStatistics* statistics)
+{
+	PULSE_UNUSED(device);
+	const SoftComputePipeline* soft_pipeline = SOFT_RETRIEVE_DRIVER_DATA_AS(pipeline, SoftComputePipeline*);
+	memset(statistics, 0, sizeof(PulseComputePipelineStatistics));
+	statistics->invocations_count = atomic_load(&soft_pipeline->invocations_count);
+	if(soft_pipeline->ir == PULSE_NULLPTR)
+		return true;
+	statistics->instructions_count = SoftGetIRInstructionsCount(soft_pipeline->ir);
+	statistics->source_instructions_count = soft_pipeline->ir->lowered_instructions_count;
+
+	// Native kernels do not count what they run, pending dispatches are not accounted for yet
+	statistics->executed_instructions_count = atomic_load(&soft_pipeline->executed_instructions_count);
+	return true;
+}
+
 void SoftDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline)
 {
 	if(pipeline == PULSE_NULL_HANDLE)
@@ -160,9 +414,24 @@ void SoftDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipelin
 	}
 	PULSE_UNUSED(device);
 	SoftComputePipeline* soft_pipeline = SOFT_RETRIEVE_DRIVER_DATA_AS(pipeline, SoftComputePipeline*);
+	if(soft_pipeline->native.function != PULSE_NULLPTR)
+	{
+		free(soft_pipeline);
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(Soft) destroyed native compute pipeline %p", pipeline);
+		free(pipeline);
+		return;
+	}
+	for(uint32_t i = 0; i < soft_pipeline->caches_count; i++)
+		SoftDestroyInterpreterCache(&soft_pipeline->caches[i]);
+	free(soft_pipeline->caches);
+	mtx_destroy(&soft_pipeline->states_creation_mutex);
+	mtx_destroy(&soft_pipeline->interpreter_atomics_mutex);
 	spvm_program_delete(soft_pipeline->program);
-	mtx_destroy(&soft_pipeline->workgroup_memory_allocations_mutex);
-	free(soft_pipeline->workgroup_memory_allocations);
+	SoftDestroyCompiledKernel(&soft_pipeline->kernel);
+	SoftDestroyIRProgram(soft_pipeline->ir);
+	free(soft_pipeline->glsl_std_450_ext);
+	free(soft_pipeline->initializers);
 	free((void*)soft_pipeline->entry_point);
 	free(soft_pipeline);
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
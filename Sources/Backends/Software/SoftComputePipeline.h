@@ -9,31 +9,92 @@
 #ifndef PULSE_SOFTWARE_COMPUTE_PIPELINE_H_
 #define PULSE_SOFTWARE_COMPUTE_PIPELINE_H_
 
+#include <stdatomic.h>
 #include <tinycthread.h>
 
 #include "Soft.h"
+#include "SoftIR.h"
+#include "SoftCompiler.h"
+#include "SoftThreadPool.h"
 #include <spvm/state.h>
 #include <spvm/program.h>
 
+typedef struct SoftInterpreterState
+{
+	SoftIRContext ir; // Used when the pipeline could be lowered, the spvm state is left NULL
+	spvm_state_t state;
+	spvm_member_t builtins[SOFT_IR_BUILTIN_MAX_ENUM];
+	spvm_word builtins_count[SOFT_IR_BUILTIN_MAX_ENUM];
+} SoftInterpreterState;
+
 typedef struct SoftSharedMemoryEntry
 {
-	spvm_result data;
-	spvm_result_t destination;
+	spvm_member_t members;
+	spvm_word member_count;
 	spvm_word slot;
 } SoftSharedMemoryEntry;
 
+// Interpreter states kept alive by a worker between invocations, all of them see the same workgroup memory
+typedef struct SoftInterpreterCache
+{
+	SoftInterpreterState* states;
+	uint32_t states_count;
+	SoftSharedMemoryEntry* shared_memory;
+	uint32_t shared_memory_size;
+	uint32_t shared_memory_capacity;
+	uint8_t* workgroup_memory; // IR workgroup region
+} SoftInterpreterCache;
+
+typedef struct SoftVariableInitializer
+{
+	spvm_word variable;
+	spvm_word initializer;
+} SoftVariableInitializer;
+
 typedef struct SoftComputePipeline
 {
+	SoftIRProgram* ir; // NULL if the module needs the spvm interpreter
+	SoftCompiledKernel kernel; // Native translation of the IR, runs instead of SoftIRExecute when available
+	PulseNativeComputeShader native; // Host function pipelines, everything SPIR-V related is left empty
 	spvm_program_t program;
 	const char* entry_point;
-	SoftSharedMemoryEntry* workgroup_memory_allocations;
-	uint32_t workgroup_memory_allocations_size;
-	uint32_t workgroup_memory_allocations_capacity;
-	mtx_t workgroup_memory_allocations_mutex;
+	spvm_word entry_point_location;
+	spvm_ext_opcode_func* glsl_std_450_ext;
+	spvm_word glsl_std_450_slot; // 0 if the module does not import it
+	SoftVariableInitializer* initializers;
+	uint32_t initializers_count;
+	SoftInterpreterCache* caches; // One per device worker
+	uint32_t caches_count;
+	mtx_t states_creation_mutex;
+	mtx_t interpreter_atomics_mutex; // Runs the workgroups of spvm pipelines using atomics one at a time
+	uint32_t invocations_per_workgroup;
+	uint32_t lanes_count; // Invocations run in lockstep by one interpreter state, 1 for the scalar and spvm paths
+	atomic_uint_fast64_t invocations_count; // Added by the queue thread once per dispatch
+	atomic_uint_fast64_t executed_instructions_count; // Gathered from the worker states by the queue thread once a dispatch is done
+	bool uses_control_barriers;
+	bool uses_atomics;
 } SoftComputePipeline;
 
+// Every pipeline of a batch is created by its own task on the device workers
+typedef struct SoftComputePipelineBatch
+{
+	PulseDevice device;
+	const PulseComputePipelineCreateInfo* infos;
+	PulseComputePipeline* pipelines;
+	SoftTaskBatch tasks;
+} SoftComputePipelineBatch;
+
 PulseComputePipeline SoftCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info);
+bool SoftCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines);
+bool SoftCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch);
+bool SoftIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch);
+void SoftWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch);
 void SoftDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline);
+bool SoftGetComputePipelineStatistics(PulseDevice device, PulseComputePipeline pipeline, PulseComputePipelineStatistics* statistics);
+
+SoftInterpreterState* SoftAcquireInterpreterState(SoftComputePipeline* pipeline, uint32_t worker_index, uint32_t group_index); // A group is lanes_count consecutive invocations
+void SoftSetInterpreterBuiltin(const SoftComputePipeline* pipeline, SoftInterpreterState* state, uint32_t lane, SoftIRBuiltin builtin, const uint32_t* values, uint32_t values_count);
+void SoftRunInterpreterState(const SoftComputePipeline* pipeline, SoftInterpreterState* state, uint32_t active_lanes_count);
 
 #endif // PULSE_SOFTWARE_COMPUTE_PIPELINE_H_
 
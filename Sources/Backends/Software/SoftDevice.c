@@ -2,6 +2,8 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <stdlib.h>
+
 #include <cpuinfo.h>
 
 #include <Pulse.h>
@@ -15,28 +17,141 @@
 #include "SoftImage.h"
 #include "SoftComputePass.h"
 
-PulseDevice SoftCreateDevice(PulseBackend backend, PulseDevice* forbiden_devices, uint32_t forbiden_devices_count)
+static bool SoftIsPackageForbidden(const struct cpuinfo_package* package, PulseDevice* forbiden_devices, uint32_t forbiden_devices_count)
+{
+	for(uint32_t i = 0; i < forbiden_devices_count; i++)
+	{
+		if(package == ((SoftDevice*)forbiden_devices[i]->driver_data)->package)
+			return true;
+	}
+	return false;
+}
+
+// Prefers the package of the calling thread as that is where the application most likely touches its memory
+static const struct cpuinfo_package* SoftPickPackage(PulseDevice* forbiden_devices, uint32_t forbiden_devices_count)
 {
-	PULSE_UNUSED(forbiden_devices);
-	PULSE_UNUSED(forbiden_devices_count);
+	const struct cpuinfo_processor* current = cpuinfo_get_current_processor();
+	if(current != PULSE_NULLPTR && !SoftIsPackageForbidden(current->package, forbiden_devices, forbiden_devices_count))
+		return current->package;
+	for(uint32_t i = 0; i < cpuinfo_get_packages_count(); i++)
+	{
+		const struct cpuinfo_package* package = cpuinfo_get_package(i);
+		if(!SoftIsPackageForbidden(package, forbiden_devices, forbiden_devices_count))
+			return package;
+	}
+	return PULSE_NULLPTR;
+}
 
+static uint32_t SoftGetCacheKey(const struct cpuinfo_cache* cache)
+{
+	return cache != PULSE_NULLPTR ? cache->processor_start : 0;
+}
+
+static int SoftCompareProcessors(const void* a, const void* b)
+{
+	const struct cpuinfo_processor* lhs = *(const struct cpuinfo_processor* const*)a;
+	const struct cpuinfo_processor* rhs = *(const struct cpuinfo_processor* const*)b;
+	const uint32_t lhs_keys[] = { SoftGetCacheKey(lhs->cache.l3), SoftGetCacheKey(lhs->cache.l2), lhs->core->processor_start, lhs->smt_id };
+	const uint32_t rhs_keys[] = { SoftGetCacheKey(rhs->cache.l3), SoftGetCacheKey(rhs->cache.l2), rhs->core->processor_start, rhs->smt_id };
+	for(uint32_t i = 0; i < PULSE_SIZEOF_ARRAY(lhs_keys); i++)
+	{
+		if(lhs_keys[i] != rhs_keys[i])
+			return lhs_keys[i] < rhs_keys[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+// Processors of the package grouped by L3 slice, then L2, then core, so that neighbouring workers share caches
+static const struct cpuinfo_processor** SoftGatherPackageProcessors(const struct cpuinfo_package* package)
+{
+	const struct cpuinfo_processor** processors = (const struct cpuinfo_processor**)calloc(package->processor_count, sizeof(const struct cpuinfo_processor*));
+	PULSE_CHECK_ALLOCATION_RETVAL(processors, PULSE_NULLPTR);
+	for(uint32_t i = 0; i < package->processor_count; i++)
+		processors[i] = cpuinfo_get_processor(package->processor_start + i);
+	qsort(processors, package->processor_count, sizeof(const struct cpuinfo_processor*), SoftCompareProcessors);
+	return processors;
+}
+
+PulseDevice SoftCreateDevice(PulseBackend backend, PulseDevice* forbiden_devices, uint32_t forbiden_devices_count)
+{
 	PULSE_CHECK_HANDLE_RETVAL(backend, PULSE_NULLPTR);
 
+	const struct cpuinfo_package* package = SoftPickPackage(forbiden_devices, forbiden_devices_count);
+	if(package == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogError(backend, "(Soft) every CPU package is already used by a forbidden device");
+		PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+
 	PulseDevice pulse_device = (PulseDeviceHandler*)calloc(1, sizeof(PulseDeviceHandler));
 	PULSE_CHECK_ALLOCATION_RETVAL(pulse_device, PULSE_NULL_HANDLE);
 
 	SoftDevice* device = (SoftDevice*)calloc(1, sizeof(SoftDevice));
 	PULSE_CHECK_ALLOCATION_RETVAL(device, PULSE_NULL_HANDLE);
 
-	device->device = cpuinfo_get_current_processor();
+	device->package = package;
+	device->device = cpuinfo_get_processor(package->processor_start);
 	device->spv_context = spvm_context_initialize();
 
+	const struct cpuinfo_processor** processors = SoftGatherPackageProcessors(package);
+	if(processors == PULSE_NULLPTR || !SoftInitThreadPool(&device->thread_pool, processors, package->processor_count))
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogError(backend, "(Soft) could not create device worker threads");
+		free(processors);
+		spvm_context_deinitialize(device->spv_context);
+		free(device);
+		free(pulse_device);
+		PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+	free(processors); // Workers only keep the processor they are pinned to
+
+	device->workgroups = (SoftWorkgroup*)calloc(device->thread_pool.workers_count, sizeof(SoftWorkgroup));
+	PULSE_CHECK_ALLOCATION_RETVAL(device->workgroups, PULSE_NULL_HANDLE);
+	for(uint32_t i = 0; i < device->thread_pool.workers_count; i++)
+		SoftInitWorkgroup(&device->workgroups[i]);
+	mtx_init(&device->fences_mutex, mtx_plain);
+	cnd_init(&device->fences_condition);
+	mtx_init(&device->buffers_mutex, mtx_plain);
+	cnd_init(&device->buffers_condition);
+	mtx_init(&device->command_lists_mutex, mtx_plain);
+	cnd_init(&device->command_lists_condition);
+
+	if(!SoftInitQueue(&device->queue))
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogError(backend, "(Soft) could not create device queue thread");
+		cnd_destroy(&device->command_lists_condition);
+		mtx_destroy(&device->command_lists_mutex);
+		cnd_destroy(&device->buffers_condition);
+		mtx_destroy(&device->buffers_mutex);
+		cnd_destroy(&device->fences_condition);
+		mtx_destroy(&device->fences_mutex);
+		for(uint32_t i = 0; i < device->thread_pool.workers_count; i++)
+			SoftDestroyWorkgroup(&device->workgroups[i]);
+		free(device->workgroups);
+		SoftDestroyThreadPool(&device->thread_pool);
+		spvm_context_deinitialize(device->spv_context);
+		free(device);
+		free(pulse_device);
+		PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+
 	pulse_device->driver_data = device;
 	pulse_device->backend = backend;
 	PULSE_LOAD_DRIVER_DEVICE(Soft);
+	pulse_device->PFN_GetComputePipelineStatistics = SoftGetComputePipelineStatistics; // Optional, other backends leave it NULL
+	pulse_device->PFN_CreateComputePipelines = SoftCreateComputePipelines;
+	pulse_device->PFN_CreateComputePipelinesAsync = SoftCreateComputePipelinesAsync;
+	pulse_device->PFN_IsComputePipelineBatchReady = SoftIsComputePipelineBatchReady;
+	pulse_device->PFN_WaitForComputePipelineBatch = SoftWaitForComputePipelineBatch;
 
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
-		PulseLogInfoFmt(backend, "(Soft) created device from %s", device->device->package->name);
+		PulseLogInfoFmt(backend, "(Soft) created device from %s with %u worker threads", device->package->name, device->thread_pool.workers_count);
 	return pulse_device;
 }
 
@@ -45,9 +160,23 @@ void SoftDestroyDevice(PulseDevice device)
 	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
 	if(soft_device == PULSE_NULLPTR)
 		return;
+	SoftDestroyQueue(&soft_device->queue); // Still needs the workers for pending dispatches
+	for(uint32_t i = 0; i < soft_device->available_command_lists_size; i++)
+		SoftDestroyCommandList(device, soft_device->available_command_lists[i]);
+	free(soft_device->available_command_lists);
+	cnd_destroy(&soft_device->command_lists_condition);
+	mtx_destroy(&soft_device->command_lists_mutex);
+	for(uint32_t i = 0; i < soft_device->thread_pool.workers_count; i++)
+		SoftDestroyWorkgroup(&soft_device->workgroups[i]);
+	free(soft_device->workgroups);
+	SoftDestroyThreadPool(&soft_device->thread_pool);
+	cnd_destroy(&soft_device->buffers_condition);
+	mtx_destroy(&soft_device->buffers_mutex);
+	cnd_destroy(&soft_device->fences_condition);
+	mtx_destroy(&soft_device->fences_mutex);
 	spvm_context_deinitialize(soft_device->spv_context);
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
-		PulseLogInfoFmt(device->backend, "(Soft) destroyed device created from %s", soft_device->device->package->name);
+		PulseLogInfoFmt(device->backend, "(Soft) destroyed device created from %s", soft_device->package->name);
 	free(soft_device);
 	free(device);
 }
@@ -10,14 +10,31 @@
 #define PULSE_SOFTWARE_DEVICE_H_
 
 #include <cpuinfo.h>
+#include <tinycthread.h>
 #include <spvm/context.h>
 
 #include "Soft.h"
+#include "SoftThreadPool.h"
+#include "SoftWorkgroup.h"
+#include "SoftQueue.h"
 
 typedef struct SoftDevice
 {
 	const struct cpuinfo_processor* device;
+	const struct cpuinfo_package* package; // Each device runs on a single package so that workers never share data across sockets
 	spvm_context_t spv_context;
+	SoftThreadPool thread_pool;
+	SoftQueue queue;
+	SoftWorkgroup* workgroups; // One per worker thread
+	mtx_t fences_mutex;
+	cnd_t fences_condition; // Broadcast every time a fence of the device gets signaled
+	mtx_t buffers_mutex;
+	cnd_t buffers_condition; // Broadcast every time a buffer is no longer used by any submitted command
+	mtx_t command_lists_mutex;
+	cnd_t command_lists_condition; // Broadcast every time the queue thread is done with a command list
+	PulseCommandList* available_command_lists; // Every command list of the device, released ones are reused
+	uint32_t available_command_lists_capacity;
+	uint32_t available_command_lists_size;
 } SoftDevice;
 
 PulseDevice SoftCreateDevice(PulseBackend backend, PulseDevice* forbiden_devices, uint32_t forbiden_devices_count);
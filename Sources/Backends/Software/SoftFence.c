@@ -6,13 +6,14 @@
 #include "../../PulseInternal.h"
 #include "Soft.h"
 #include "SoftFence.h"
+#include "SoftDevice.h"
 #include "SoftCommandList.h"
 
 PulseFence SoftCreateFence(PulseDevice device)
 {
 	PULSE_UNUSED(device);
 
-	PulseFence fence = (PulseFence)calloc(1, sizeof(PulseFence));
+	PulseFence fence = (PulseFence)calloc(1, sizeof(PulseFenceHandler));
 	PULSE_CHECK_ALLOCATION_RETVAL(fence, PULSE_NULL_HANDLE);
 
 	SoftFence* soft_fence = (SoftFence*)calloc(1, sizeof(SoftFence));
@@ -36,28 +37,38 @@ bool SoftIsFenceReady(PulseDevice device, PulseFence fence)
 {
 	PULSE_UNUSED(device);
 	SoftFence* soft_fence = SOFT_RETRIEVE_DRIVER_DATA_AS(fence, SoftFence*);
-	SoftCommandList* soft_cmd = SOFT_RETRIEVE_DRIVER_DATA_AS(fence->cmd, SoftCommandList*);
-	if(atomic_load(&soft_cmd->commands_running) == 0)
-		atomic_store(&soft_fence->signal, true);
 	return atomic_load(&soft_fence->signal);
 }
 
 bool SoftWaitForFences(PulseDevice device, const PulseFence* fences, uint32_t fences_count, bool wait_for_all)
 {
-	PULSE_UNUSED(device);
 	if(fences_count == 0)
 		return true;
-	uint32_t fences_to_wait = fences_count;
-	while(fences_to_wait != 0)
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+
+	mtx_lock(&soft_device->fences_mutex);
+	for(;;)
 	{
+		uint32_t signaled_count = 0;
 		for(uint32_t i = 0; i < fences_count; i++)
 		{
 			if(SoftIsFenceReady(device, fences[i]))
-				fences_to_wait--;
+				signaled_count++;
 		}
-		if(!wait_for_all && fences_to_wait != fences_count)
-			return true;
-		PulseSleep(1); // 1ms
+		if(signaled_count == fences_count || (!wait_for_all && signaled_count != 0))
+			break;
+		cnd_wait(&soft_device->fences_condition, &soft_device->fences_mutex);
 	}
+	mtx_unlock(&soft_device->fences_mutex);
 	return true;
 }
+
+void SoftSignalFence(PulseDevice device, PulseFence fence)
+{
+	SoftDevice* soft_device = SOFT_RETRIEVE_DRIVER_DATA_AS(device, SoftDevice*);
+	SoftFence* soft_fence = SOFT_RETRIEVE_DRIVER_DATA_AS(fence, SoftFence*);
+	mtx_lock(&soft_device->fences_mutex);
+	atomic_store(&soft_fence->signal, true);
+	cnd_broadcast(&soft_device->fences_condition);
+	mtx_unlock(&soft_device->fences_mutex);
+}
@@ -16,7 +16,7 @@
 
 typedef struct SoftFence
 {
-	atomic_bool signal;
+	atomic_bool signal; // Only set under the device fences mutex so that waiters cannot miss a wake up
 } SoftFence;
 
 PulseFence SoftCreateFence(PulseDevice device);
@@ -24,6 +24,8 @@ void SoftDestroyFence(PulseDevice device, PulseFence fence);
 bool SoftIsFenceReady(PulseDevice device, PulseFence fence);
 bool SoftWaitForFences(PulseDevice device, const PulseFence* fences, uint32_t fences_count, bool wait_for_all);
 
+void SoftSignalFence(PulseDevice device, PulseFence fence); // Wakes up every waiter of the device
+
 #endif // PULSE_SOFTWARE_FENCE_H_
 
 #endif // PULSE_ENABLE_SOFTWARE_BACKEND
@@ -0,0 +1,133 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+	#define _XOPEN_SOURCE 600 // ucontext is deprecated on macOS but still available
+	#define _DARWIN_C_SOURCE // For MAP_ANON
+#elif defined(__linux__) && !defined(_DEFAULT_SOURCE)
+	#define _DEFAULT_SOURCE // For MAP_ANONYMOUS
+#endif
+
+#include <string.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftFiber.h"
+
+#ifdef PULSE_PLAT_WINDOWS
+	PULSE_IMPORT_API void* __stdcall ConvertThreadToFiber(void*);
+	PULSE_IMPORT_API void* __stdcall GetCurrentFiber(void);
+	PULSE_IMPORT_API void* __stdcall CreateFiberEx(size_t, size_t, unsigned long, void(__stdcall*)(void*), void*);
+	PULSE_IMPORT_API void __stdcall SwitchToFiber(void*);
+	PULSE_IMPORT_API void __stdcall DeleteFiber(void*);
+
+	static void __stdcall SoftFiberEntry(void* arg)
+	{
+		SoftFiber* fiber = (SoftFiber*)arg;
+		fiber->function(fiber->userdata);
+	}
+
+	bool SoftInitFiber(SoftFiber* fiber, SoftFiberFunction function, void* userdata)
+	{
+		fiber->function = function;
+		fiber->userdata = userdata;
+		// Only reserves the stack, pages are committed on demand behind the guard page Windows maintains
+		fiber->handle = CreateFiberEx(0, SOFT_FIBER_STACK_SIZE, 0, SoftFiberEntry, fiber);
+		PULSE_CHECK_ALLOCATION_RETVAL(fiber->handle, false);
+		return true;
+	}
+
+	bool SoftInitThreadFiber(SoftFiber* fiber)
+	{
+		memset(fiber, 0, sizeof(SoftFiber));
+		fiber->handle = ConvertThreadToFiber(PULSE_NULLPTR);
+		if(fiber->handle == PULSE_NULLPTR) // Thread may already be a fiber
+			fiber->handle = GetCurrentFiber();
+		return fiber->handle != PULSE_NULLPTR;
+	}
+
+	void SoftSwitchFiber(SoftFiber* from, SoftFiber* to)
+	{
+		PULSE_UNUSED(from);
+		SwitchToFiber(to->handle);
+	}
+
+	void SoftDestroyFiber(SoftFiber* fiber)
+	{
+		if(fiber->function != PULSE_NULLPTR && fiber->handle != PULSE_NULLPTR)
+			DeleteFiber(fiber->handle);
+		fiber->handle = PULSE_NULLPTR;
+	}
+#else
+	#include <sys/mman.h>
+	#include <ucontext.h>
+	#include <unistd.h>
+
+	#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+		#define MAP_ANONYMOUS MAP_ANON
+	#endif
+
+	static size_t SoftGetFiberGuardSize(void)
+	{
+		long page_size = sysconf(_SC_PAGESIZE);
+		return page_size > 0 ? (size_t)page_size : 4096;
+	}
+
+	// makecontext only forwards int arguments, so the fiber pointer is split in two halves
+	static void SoftFiberEntry(int high, int low)
+	{
+		uintptr_t ptr = ((uintptr_t)(uint32_t)high << 16 << 16) | (uintptr_t)(uint32_t)low;
+		SoftFiber* fiber = (SoftFiber*)ptr;
+		fiber->function(fiber->userdata);
+	}
+
+	bool SoftInitFiber(SoftFiber* fiber, SoftFiberFunction function, void* userdata)
+	{
+		fiber->function = function;
+		fiber->userdata = userdata;
+		fiber->stack = PULSE_NULLPTR;
+		fiber->handle = calloc(1, sizeof(ucontext_t));
+		PULSE_CHECK_ALLOCATION_RETVAL(fiber->handle, false);
+
+		// Stacks grow downwards on every supported target, an overflow faults on the lowest page instead of corrupting the heap
+		size_t guard_size = SoftGetFiberGuardSize();
+		void* mapping = mmap(PULSE_NULLPTR, guard_size + SOFT_FIBER_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(mapping != MAP_FAILED)
+			fiber->stack = mapping;
+		ucontext_t* context = (ucontext_t*)fiber->handle;
+		if(fiber->stack == PULSE_NULLPTR || mprotect(fiber->stack, guard_size, PROT_NONE) != 0 || getcontext(context) != 0)
+		{
+			SoftDestroyFiber(fiber);
+			return false;
+		}
+		context->uc_stack.ss_sp = (uint8_t*)fiber->stack + guard_size;
+		context->uc_stack.ss_size = SOFT_FIBER_STACK_SIZE;
+		context->uc_link = PULSE_NULLPTR;
+		uintptr_t ptr = (uintptr_t)fiber;
+		makecontext(context, (void(*)(void))SoftFiberEntry, 2, (int)(uint32_t)(ptr >> 16 >> 16), (int)(uint32_t)ptr);
+		return true;
+	}
+
+	bool SoftInitThreadFiber(SoftFiber* fiber)
+	{
+		memset(fiber, 0, sizeof(SoftFiber));
+		fiber->handle = calloc(1, sizeof(ucontext_t)); // Filled on the first switch away from the thread
+		return fiber->handle != PULSE_NULLPTR;
+	}
+
+	void SoftSwitchFiber(SoftFiber* from, SoftFiber* to)
+	{
+		swapcontext((ucontext_t*)from->handle, (ucontext_t*)to->handle);
+	}
+
+	void SoftDestroyFiber(SoftFiber* fiber)
+	{
+		if(fiber->stack != PULSE_NULLPTR)
+			munmap(fiber->stack, SoftGetFiberGuardSize() + SOFT_FIBER_STACK_SIZE);
+		free(fiber->handle);
+		fiber->stack = PULSE_NULLPTR;
+		fiber->handle = PULSE_NULLPTR;
+	}
+#endif
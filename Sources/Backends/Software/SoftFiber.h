@@ -0,0 +1,34 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_FIBER_H_
+#define PULSE_SOFTWARE_FIBER_H_
+
+#include "Soft.h"
+
+// Executors keep shader call frames in their own state, an invocation only needs room for a few native frames
+#define SOFT_FIBER_STACK_SIZE (64 * 1024)
+
+typedef void (*SoftFiberFunction)(void* userdata);
+
+typedef struct SoftFiber
+{
+	void* handle; // Fiber handle on Windows, ucontext_t elsewhere
+	void* stack; // Mapping starting with a guard page, unused on Windows where fiber stacks already have one
+	SoftFiberFunction function;
+	void* userdata;
+} SoftFiber;
+
+bool SoftInitFiber(SoftFiber* fiber, SoftFiberFunction function, void* userdata); // The function must never return, it has to switch back to another fiber instead
+bool SoftInitThreadFiber(SoftFiber* fiber); // Wraps the calling thread so that other fibers can switch back to it
+void SoftSwitchFiber(SoftFiber* from, SoftFiber* to);
+void SoftDestroyFiber(SoftFiber* fiber);
+
+#endif // PULSE_SOFTWARE_FIBER_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
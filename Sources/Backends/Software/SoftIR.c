@@ -0,0 +1,1800 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+#include <spvm/spirv.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftIR.h"
+
+#define SOFT_IR_NONE UINT32_MAX
+
+typedef enum SoftGLSLStd450
+{
+	SOFT_GLSL_STD_450_ROUND = 1,
+	SOFT_GLSL_STD_450_ROUND_EVEN = 2,
+	SOFT_GLSL_STD_450_TRUNC = 3,
+	SOFT_GLSL_STD_450_FABS = 4,
+	SOFT_GLSL_STD_450_SABS = 5,
+	SOFT_GLSL_STD_450_FSIGN = 6,
+	SOFT_GLSL_STD_450_SSIGN = 7,
+	SOFT_GLSL_STD_450_FLOOR = 8,
+	SOFT_GLSL_STD_450_CEIL = 9,
+	SOFT_GLSL_STD_450_FRACT = 10,
+	SOFT_GLSL_STD_450_RADIANS = 11,
+	SOFT_GLSL_STD_450_DEGREES = 12,
+	SOFT_GLSL_STD_450_SIN = 13,
+	SOFT_GLSL_STD_450_COS = 14,
+	SOFT_GLSL_STD_450_TAN = 15,
+	SOFT_GLSL_STD_450_ASIN = 16,
+	SOFT_GLSL_STD_450_ACOS = 17,
+	SOFT_GLSL_STD_450_ATAN = 18,
+	SOFT_GLSL_STD_450_SINH = 19,
+	SOFT_GLSL_STD_450_COSH = 20,
+	SOFT_GLSL_STD_450_TANH = 21,
+	SOFT_GLSL_STD_450_ATAN2 = 25,
+	SOFT_GLSL_STD_450_POW = 26,
+	SOFT_GLSL_STD_450_EXP = 27,
+	SOFT_GLSL_STD_450_LOG = 28,
+	SOFT_GLSL_STD_450_EXP2 = 29,
+	SOFT_GLSL_STD_450_LOG2 = 30,
+	SOFT_GLSL_STD_450_SQRT = 31,
+	SOFT_GLSL_STD_450_INVERSE_SQRT = 32,
+	SOFT_GLSL_STD_450_FMIN = 37,
+	SOFT_GLSL_STD_450_UMIN = 38,
+	SOFT_GLSL_STD_450_SMIN = 39,
+	SOFT_GLSL_STD_450_FMAX = 40,
+	SOFT_GLSL_STD_450_UMAX = 41,
+	SOFT_GLSL_STD_450_SMAX = 42,
+	SOFT_GLSL_STD_450_FCLAMP = 43,
+	SOFT_GLSL_STD_450_UCLAMP = 44,
+	SOFT_GLSL_STD_450_SCLAMP = 45,
+	SOFT_GLSL_STD_450_FMIX = 46,
+	SOFT_GLSL_STD_450_STEP = 48,
+	SOFT_GLSL_STD_450_SMOOTH_STEP = 49,
+	SOFT_GLSL_STD_450_FMA = 50,
+	SOFT_GLSL_STD_450_LENGTH = 66,
+	SOFT_GLSL_STD_450_DISTANCE = 67,
+	SOFT_GLSL_STD_450_CROSS = 68,
+	SOFT_GLSL_STD_450_NORMALIZE = 69,
+	SOFT_GLSL_STD_450_REFLECT = 71,
+	SOFT_GLSL_STD_450_NMIN = 79,
+	SOFT_GLSL_STD_450_NMAX = 80,
+	SOFT_GLSL_STD_450_NCLAMP = 81,
+} SoftGLSLStd450;
+
+typedef enum SoftIRTypeKind
+{
+	SOFT_IR_TYPE_NONE = 0,
+	SOFT_IR_TYPE_VOID,
+	SOFT_IR_TYPE_BOOL,
+	SOFT_IR_TYPE_INT,
+	SOFT_IR_TYPE_FLOAT,
+	SOFT_IR_TYPE_VECTOR,
+	SOFT_IR_TYPE_MATRIX,
+	SOFT_IR_TYPE_ARRAY,
+	SOFT_IR_TYPE_RUNTIME_ARRAY,
+	SOFT_IR_TYPE_STRUCT,
+	SOFT_IR_TYPE_POINTER,
+	SOFT_IR_TYPE_FUNCTION,
+	SOFT_IR_TYPE_IMAGE, // Storage images only, the register holds the region of the bound image
+} SoftIRTypeKind;
+
+typedef enum SoftIRImportKind
+{
+	SOFT_IR_IMPORT_UNKNOWN = 0,
+	SOFT_IR_IMPORT_GLSL_STD_450,
+	SOFT_IR_IMPORT_NON_SEMANTIC, // Debug informations, ignored
+} SoftIRImportKind;
+
+typedef struct SoftIRId
+{
+	uint32_t opcode;
+	uint32_t type; // Result type
+	uint32_t reg;
+	uint32_t pc; // Labels and functions
+
+	// Types
+	SoftIRTypeKind kind;
+	uint32_t element;
+	uint32_t count;
+	uint32_t first_member;
+	uint32_t array_stride;
+	uint32_t storage_class;
+
+	// Decorations
+	uint32_t builtin;
+	uint32_t set;
+	uint32_t binding;
+
+	uint32_t matrix_stride; // Pointers to matrices in explicitly laid out blocks
+
+	// Functions
+	uint32_t return_reg;
+	uint32_t first_param;
+	uint32_t params_count;
+
+	// Labels
+	uint32_t first_phi;
+	uint32_t phis_count;
+
+	SoftIRImportKind import_kind;
+} SoftIRId;
+
+typedef struct SoftIRMember
+{
+	uint32_t type;
+	uint32_t offset; // SOFT_IR_NONE without explicit layout
+	uint32_t matrix_stride;
+} SoftIRMember;
+
+typedef struct SoftIRMemberDecoration
+{
+	uint32_t structure;
+	uint32_t member;
+	uint32_t decoration;
+	uint32_t value;
+} SoftIRMemberDecoration;
+
+typedef struct SoftIRPhi
+{
+	const uint32_t* instruction;
+	uint32_t word_count;
+	uint32_t shadow;
+} SoftIRPhi;
+
+typedef struct SoftIRFixup
+{
+	uint32_t position;
+	uint32_t id;
+} SoftIRFixup;
+
+typedef struct SoftIRInitializer
+{
+	uint32_t variable;
+	uint32_t value;
+} SoftIRInitializer;
+
+typedef struct SoftIRBuilder
+{
+	PulseBackend backend;
+	SoftIRProgram* program;
+	SoftIRId* ids;
+	uint32_t bound;
+
+	SoftIRMember* members;
+	uint32_t members_count;
+	uint32_t members_capacity;
+
+	SoftIRMemberDecoration* member_decorations;
+	uint32_t member_decorations_count;
+	uint32_t member_decorations_capacity;
+
+	SoftIRPhi* phis;
+	uint32_t phis_count;
+	uint32_t phis_capacity;
+
+	uint32_t* params;
+	uint32_t params_count;
+	uint32_t params_capacity;
+
+	SoftIRFixup* fixups;
+	uint32_t fixups_count;
+	uint32_t fixups_capacity;
+
+	SoftIRInitializer* initializers;
+	uint32_t initializers_count;
+	uint32_t initializers_capacity;
+
+	uint32_t code_capacity;
+	uint32_t registers_capacity;
+	uint32_t copy_chunks_capacity;
+	uint32_t copy_plans_capacity;
+	uint32_t resources_capacity;
+
+	uint32_t entry_function;
+	uint32_t current_function;
+	uint32_t unsupported_opcode;
+	bool failed;
+} SoftIRBuilder;
+
+#define SOFT_IR_REQUIRE(builder, condition) \
+	do { \
+		if(!(condition)) \
+		{ \
+			(builder)->failed = true; \
+			return; \
+		} \
+	} while(0) \
+
+static bool SoftIRReserve(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+	if(needed <= *capacity)
+		return true;
+	uint32_t new_capacity = *capacity == 0 ? 16 : *capacity;
+	while(new_capacity < needed)
+		new_capacity *= 2;
+	void* new_array = realloc(*array, new_capacity * element_size);
+	PULSE_CHECK_ALLOCATION_RETVAL(new_array, false);
+	*array = new_array;
+	*capacity = new_capacity;
+	return true;
+}
+
+#define SOFT_IR_PUSH(builder, array, count, capacity, value) \
+	do { \
+		if(!SoftIRReserve((void**)&(array), &(capacity), (count) + 1, sizeof(*(array)))) \
+		{ \
+			(builder)->failed = true; \
+			break; \
+		} \
+		(array)[(count)++] = (value); \
+	} while(0) \
+
+static void SoftIREmitWords(SoftIRBuilder* builder, const uint32_t* words, uint32_t count)
+{
+	SoftIRProgram* program = builder->program;
+	if(!SoftIRReserve((void**)&program->code, &builder->code_capacity, program->code_size + count, sizeof(uint32_t)))
+	{
+		builder->failed = true;
+		return;
+	}
+	memcpy(program->code + program->code_size, words, count * sizeof(uint32_t));
+	program->code_size += count;
+}
+
+#define SOFT_IR_EMIT(builder, ...) SoftIREmitWords(builder, (const uint32_t[]){ __VA_ARGS__ }, sizeof((const uint32_t[]){ __VA_ARGS__ }) / sizeof(uint32_t))
+
+static void SoftIREmitTarget(SoftIRBuilder* builder, uint32_t id)
+{
+	SoftIRFixup fixup = { .position = builder->program->code_size, .id = id };
+	SOFT_IR_PUSH(builder, builder->fixups, builder->fixups_count, builder->fixups_capacity, fixup);
+	SOFT_IR_EMIT(builder, SOFT_IR_NONE);
+}
+
+static bool SoftIRIsScalar(const SoftIRId* type)
+{
+	return type->kind == SOFT_IR_TYPE_BOOL || type->kind == SOFT_IR_TYPE_INT || type->kind == SOFT_IR_TYPE_FLOAT;
+}
+
+// Size of the packed register form, in words
+static uint32_t SoftIRTypeWords(SoftIRBuilder* builder, uint32_t type_id)
+{
+	const SoftIRId* type = &builder->ids[type_id];
+	switch(type->kind)
+	{
+		case SOFT_IR_TYPE_BOOL:
+		case SOFT_IR_TYPE_INT:
+		case SOFT_IR_TYPE_FLOAT: return 1;
+		case SOFT_IR_TYPE_VECTOR: return type->count;
+		case SOFT_IR_TYPE_MATRIX:
+		case SOFT_IR_TYPE_ARRAY: return type->count * SoftIRTypeWords(builder, type->element);
+		case SOFT_IR_TYPE_POINTER: return 2;
+		case SOFT_IR_TYPE_IMAGE: return 1;
+		case SOFT_IR_TYPE_STRUCT:
+		{
+			uint32_t words = 0;
+			for(uint32_t i = 0; i < type->count; i++)
+				words += SoftIRTypeWords(builder, builder->members[type->first_member + i].type);
+			return words;
+		}
+
+		default: return 0;
+	}
+}
+
+static uint32_t SoftIRMemorySize(SoftIRBuilder* builder, uint32_t type_id, uint32_t matrix_stride);
+
+static uint32_t SoftIRArrayStride(SoftIRBuilder* builder, const SoftIRId* type, uint32_t matrix_stride)
+{
+	if(type->array_stride != 0)
+		return type->array_stride;
+	return SoftIRMemorySize(builder, type->element, matrix_stride);
+}
+
+static uint32_t SoftIRColumnStride(SoftIRBuilder* builder, const SoftIRId* type, uint32_t matrix_stride)
+{
+	if(matrix_stride != 0)
+		return matrix_stride;
+	return SoftIRTypeWords(builder, type->element) * sizeof(uint32_t);
+}
+
+static uint32_t SoftIRMemberOffset(SoftIRBuilder* builder, const SoftIRId* type, uint32_t member)
+{
+	const SoftIRMember* members = &builder->members[type->first_member];
+	if(members[member].offset != SOFT_IR_NONE)
+		return members[member].offset;
+	uint32_t offset = 0;
+	for(uint32_t i = 0; i < member; i++)
+		offset += SoftIRMemorySize(builder, members[i].type, members[i].matrix_stride);
+	return offset;
+}
+
+// Size of the object in memory, honoring Offset/ArrayStride/MatrixStride when present
+static uint32_t SoftIRMemorySize(SoftIRBuilder* builder, uint32_t type_id, uint32_t matrix_stride)
+{
+	const SoftIRId* type = &builder->ids[type_id];
+	switch(type->kind)
+	{
+		case SOFT_IR_TYPE_MATRIX: return type->count * SoftIRColumnStride(builder, type, matrix_stride);
+		case SOFT_IR_TYPE_ARRAY: return type->count * SoftIRArrayStride(builder, type, matrix_stride);
+		case SOFT_IR_TYPE_RUNTIME_ARRAY: return 0;
+		case SOFT_IR_TYPE_STRUCT:
+		{
+			uint32_t size = 0;
+			for(uint32_t i = 0; i < type->count; i++)
+			{
+				const SoftIRMember* member = &builder->members[type->first_member + i];
+				uint32_t end = SoftIRMemberOffset(builder, type, i) + SoftIRMemorySize(builder, member->type, member->matrix_stride);
+				if(end > size)
+					size = end;
+			}
+			return size;
+		}
+
+		default: return SoftIRTypeWords(builder, type_id) * sizeof(uint32_t);
+	}
+}
+
+static void SoftIRAppendChunk(SoftIRBuilder* builder, uint32_t memory_offset, uint32_t register_offset, uint32_t size)
+{
+	SoftIRProgram* program = builder->program;
+	if(program->copy_chunks_count > 0 && builder->copy_plans_capacity > 0)
+	{
+		SoftIRCopyPlan* plan = &program->copy_plans[program->copy_plans_count];
+		SoftIRCopyChunk* last = &program->copy_chunks[program->copy_chunks_count - 1];
+		if(plan->chunks_count > 0 && last->memory_offset + last->size == memory_offset && last->register_offset + last->size == register_offset)
+		{
+			last->size += size;
+			return;
+		}
+	}
+	SoftIRCopyChunk chunk = { .memory_offset = memory_offset, .register_offset = register_offset, .size = size };
+	SOFT_IR_PUSH(builder, program->copy_chunks, program->copy_chunks_count, builder->copy_chunks_capacity, chunk);
+	if(!builder->failed)
+		program->copy_plans[program->copy_plans_count].chunks_count++;
+}
+
+static void SoftIRBuildCopyPlan(SoftIRBuilder* builder, uint32_t type_id, uint32_t matrix_stride, uint32_t memory_offset, uint32_t register_offset)
+{
+	const SoftIRId* type = &builder->ids[type_id];
+	switch(type->kind)
+	{
+		case SOFT_IR_TYPE_MATRIX:
+		{
+			uint32_t column_size = SoftIRTypeWords(builder, type->element) * sizeof(uint32_t);
+			uint32_t stride = SoftIRColumnStride(builder, type, matrix_stride);
+			for(uint32_t i = 0; i < type->count; i++)
+				SoftIRAppendChunk(builder, memory_offset + i * stride, register_offset + i * column_size, column_size);
+			break;
+		}
+		case SOFT_IR_TYPE_ARRAY:
+		{
+			uint32_t element_size = SoftIRTypeWords(builder, type->element) * sizeof(uint32_t);
+			uint32_t stride = SoftIRArrayStride(builder, type, matrix_stride);
+			for(uint32_t i = 0; i < type->count; i++)
+				SoftIRBuildCopyPlan(builder, type->element, matrix_stride, memory_offset + i * stride, register_offset + i * element_size);
+			break;
+		}
+		case SOFT_IR_TYPE_STRUCT:
+		{
+			for(uint32_t i = 0; i < type->count; i++)
+			{
+				const SoftIRMember* member = &builder->members[type->first_member + i];
+				SoftIRBuildCopyPlan(builder, member->type, member->matrix_stride, memory_offset + SoftIRMemberOffset(builder, type, i), register_offset);
+				register_offset += SoftIRTypeWords(builder, member->type) * sizeof(uint32_t);
+			}
+			break;
+		}
+
+		default: SoftIRAppendChunk(builder, memory_offset, register_offset, SoftIRTypeWords(builder, type_id) * sizeof(uint32_t)); break;
+	}
+}
+
+// Returns SOFT_IR_NONE when memory and register layouts are identical
+static uint32_t SoftIRCopyPlanFor(SoftIRBuilder* builder, uint32_t type_id, uint32_t matrix_stride)
+{
+	SoftIRProgram* program = builder->program;
+	if(!SoftIRReserve((void**)&program->copy_plans, &builder->copy_plans_capacity, program->copy_plans_count + 1, sizeof(SoftIRCopyPlan)))
+	{
+		builder->failed = true;
+		return SOFT_IR_NONE;
+	}
+	SoftIRCopyPlan* plan = &program->copy_plans[program->copy_plans_count];
+	plan->first_chunk = program->copy_chunks_count;
+	plan->chunks_count = 0;
+	SoftIRBuildCopyPlan(builder, type_id, matrix_stride, 0, 0);
+
+	uint32_t size = SoftIRTypeWords(builder, type_id) * sizeof(uint32_t);
+	const SoftIRCopyChunk* first = &program->copy_chunks[plan->first_chunk];
+	if(plan->chunks_count == 1 && first->memory_offset == 0 && first->register_offset == 0 && first->size == size)
+	{
+		program->copy_chunks_count = plan->first_chunk;
+		return SOFT_IR_NONE;
+	}
+	return program->copy_plans_count++;
+}
+
+static uint32_t SoftIRAllocateRegisters(SoftIRBuilder* builder, uint32_t words)
+{
+	SoftIRProgram* program = builder->program;
+	if(!SoftIRReserve((void**)&program->initial_registers, &builder->registers_capacity, program->registers_count + words, sizeof(SoftIRWord)))
+	{
+		builder->failed = true;
+		return 0;
+	}
+	uint32_t reg = program->registers_count;
+	memset(program->initial_registers + reg, 0, words * sizeof(SoftIRWord));
+	program->registers_count += words;
+	return reg;
+}
+
+static uint32_t SoftIRRegister(SoftIRBuilder* builder, uint32_t id)
+{
+	if(id >= builder->bound)
+	{
+		builder->failed = true;
+		return 0;
+	}
+	SoftIRId* info = &builder->ids[id];
+	if(info->reg == SOFT_IR_NONE)
+	{
+		if(info->type >= builder->bound)
+		{
+			builder->failed = true;
+			return 0;
+		}
+		uint32_t words = SoftIRTypeWords(builder, info->type);
+		info->reg = SoftIRAllocateRegisters(builder, words == 0 ? 1 : words);
+	}
+	return info->reg;
+}
+
+static uint32_t SoftIRConstantRegister(SoftIRBuilder* builder, uint32_t value)
+{
+	uint32_t reg = SoftIRAllocateRegisters(builder, 1);
+	if(!builder->failed)
+		builder->program->initial_registers[reg].u = value;
+	return reg;
+}
+
+static uint32_t SoftIRReturnRegister(SoftIRBuilder* builder, uint32_t function)
+{
+	SoftIRId* info = &builder->ids[function];
+	if(info->return_reg == SOFT_IR_NONE)
+	{
+		uint32_t words = SoftIRTypeWords(builder, info->type);
+		info->return_reg = SoftIRAllocateRegisters(builder, words == 0 ? 1 : words);
+	}
+	return info->return_reg;
+}
+
+static uint32_t SoftIRComponents(SoftIRBuilder* builder, uint32_t id)
+{
+	return SoftIRTypeWords(builder, builder->ids[id].type);
+}
+
+static const SoftIRId* SoftIRTypeOf(SoftIRBuilder* builder, uint32_t id)
+{
+	return &builder->ids[builder->ids[id].type];
+}
+
+static bool SoftIRIsConstant(SoftIRBuilder* builder, uint32_t id)
+{
+	uint32_t opcode = builder->ids[id].opcode;
+	return opcode == SpvOpConstant || opcode == SpvOpSpecConstant;
+}
+
+static uint32_t SoftIRAllocateMemory(uint32_t* size, uint32_t bytes)
+{
+	uint32_t offset = (*size + 15) & ~15u;
+	*size = offset + bytes;
+	return offset;
+}
+
+static bool SoftIRHasResultType(uint32_t opcode)
+{
+	switch(opcode)
+	{
+		case SpvOpUndef: case SpvOpExtInst:
+		case SpvOpConstantTrue: case SpvOpConstantFalse: case SpvOpConstant: case SpvOpConstantComposite: case SpvOpConstantNull:
+		case SpvOpSpecConstantTrue: case SpvOpSpecConstantFalse: case SpvOpSpecConstant: case SpvOpSpecConstantComposite: case SpvOpSpecConstantOp:
+		case SpvOpFunction: case SpvOpFunctionParameter: case SpvOpFunctionCall:
+		case SpvOpVariable: case SpvOpImageTexelPointer: case SpvOpLoad: case SpvOpAccessChain: case SpvOpInBoundsAccessChain: case SpvOpPtrAccessChain: case SpvOpArrayLength:
+		case SpvOpVectorExtractDynamic: case SpvOpVectorInsertDynamic: case SpvOpVectorShuffle:
+		case SpvOpCompositeConstruct: case SpvOpCompositeExtract: case SpvOpCompositeInsert: case SpvOpCopyObject: case SpvOpTranspose:
+		case SpvOpSampledImage: case SpvOpImageSampleImplicitLod: case SpvOpImageFetch: case SpvOpImageRead: case SpvOpImage: case SpvOpImageQuerySizeLod: case SpvOpImageQuerySize:
+		case SpvOpPhi:
+			return true;
+
+		default: break;
+	}
+	return (opcode >= SpvOpConvertFToU && opcode <= SpvOpBitcast) || (opcode >= SpvOpSNegate && opcode <= SpvOpBitCount) || (opcode >= SpvOpAtomicLoad && opcode <= SpvOpAtomicXor && opcode != SpvOpAtomicStore);
+}
+
+static bool SoftIRHasResultOnly(uint32_t opcode)
+{
+	switch(opcode)
+	{
+		case SpvOpString: case SpvOpExtInstImport: case SpvOpLabel: case SpvOpDecorationGroup:
+			return true;
+
+		default: break;
+	}
+	return opcode >= SpvOpTypeVoid && opcode <= SpvOpTypeFunction;
+}
+
+// First pass, gathers everything that can be referenced before being defined
+static void SoftIRCollect(SoftIRBuilder* builder, const uint32_t* code, size_t words_count, const char* entry_point)
+{
+	uint32_t current_function = SOFT_IR_NONE;
+	uint32_t current_label = SOFT_IR_NONE;
+	for(size_t i = 5; i < words_count && !builder->failed;)
+	{
+		const uint32_t* w = code + i;
+		uint32_t word_count = w[0] >> 16;
+		uint32_t opcode = w[0] & 0xFFFF;
+		SOFT_IR_REQUIRE(builder, word_count != 0 && i + word_count <= words_count);
+		i += word_count;
+
+		if(SoftIRHasResultType(opcode))
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 3 && w[2] < builder->bound && w[1] < builder->bound);
+			builder->ids[w[2]].opcode = opcode;
+			builder->ids[w[2]].type = w[1];
+		}
+		else if(SoftIRHasResultOnly(opcode))
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 2 && w[1] < builder->bound);
+			builder->ids[w[1]].opcode = opcode;
+		}
+
+		switch(opcode)
+		{
+			case SpvOpEntryPoint:
+			{
+				SOFT_IR_REQUIRE(builder, word_count >= 4);
+				if(w[1] == SpvExecutionModelGLCompute && strncmp((const char*)(w + 3), entry_point, (word_count - 3) * sizeof(uint32_t)) == 0)
+					builder->entry_function = w[2];
+				break;
+			}
+			case SpvOpExecutionMode:
+			{
+				SOFT_IR_REQUIRE(builder, word_count >= 3);
+				if(w[2] == SpvExecutionModeLocalSize && word_count >= 6 && w[1] == builder->entry_function)
+				{
+					builder->program->local_size[0] = w[3];
+					builder->program->local_size[1] = w[4];
+					builder->program->local_size[2] = w[5];
+				}
+				break;
+			}
+			case SpvOpExtInstImport:
+			{
+				const char* name = (const char*)(w + 2);
+				size_t max_length = (word_count - 2) * sizeof(uint32_t);
+				if(strncmp(name, "GLSL.std.450", max_length) == 0)
+					builder->ids[w[1]].import_kind = SOFT_IR_IMPORT_GLSL_STD_450;
+				else if(strncmp(name, "NonSemantic.", strlen("NonSemantic.")) == 0)
+					builder->ids[w[1]].import_kind = SOFT_IR_IMPORT_NON_SEMANTIC;
+				break;
+			}
+			case SpvOpDecorate:
+			{
+				SOFT_IR_REQUIRE(builder, word_count >= 3 && w[1] < builder->bound);
+				SoftIRId* target = &builder->ids[w[1]];
+				switch(w[2])
+				{
+					case SpvDecorationBuiltIn: SOFT_IR_REQUIRE(builder, word_count >= 4); target->builtin = w[3]; break;
+					case SpvDecorationDescriptorSet: SOFT_IR_REQUIRE(builder, word_count >= 4); target->set = w[3]; break;
+					case SpvDecorationBinding: SOFT_IR_REQUIRE(builder, word_count >= 4); target->binding = w[3]; break;
+					case SpvDecorationArrayStride: SOFT_IR_REQUIRE(builder, word_count >= 4); target->array_stride = w[3]; break;
+					default: break;
+				}
+				break;
+			}
+			case SpvOpMemberDecorate:
+			{
+				SOFT_IR_REQUIRE(builder, word_count >= 4);
+				SoftIRMemberDecoration decoration = { .structure = w[1], .member = w[2], .decoration = w[3], .value = word_count >= 5 ? w[4] : 0 };
+				SOFT_IR_PUSH(builder, builder->member_decorations, builder->member_decorations_count, builder->member_decorations_capacity, decoration);
+				break;
+			}
+			case SpvOpFunction:
+			{
+				current_function = w[2];
+				builder->ids[current_function].first_param = builder->params_count;
+				break;
+			}
+			case SpvOpFunctionParameter:
+			{
+				SOFT_IR_REQUIRE(builder, current_function != SOFT_IR_NONE);
+				SOFT_IR_PUSH(builder, builder->params, builder->params_count, builder->params_capacity, w[2]);
+				builder->ids[current_function].params_count++;
+				break;
+			}
+			case SpvOpLabel: current_label = w[1]; builder->ids[current_label].first_phi = builder->phis_count; break;
+			case SpvOpPhi:
+			{
+				SOFT_IR_REQUIRE(builder, current_label != SOFT_IR_NONE);
+				SoftIRPhi phi = { .instruction = w, .word_count = word_count, .shadow = SOFT_IR_NONE };
+				SOFT_IR_PUSH(builder, builder->phis, builder->phis_count, builder->phis_capacity, phi);
+				builder->ids[current_label].phis_count++;
+				break;
+			}
+
+			default: break;
+		}
+	}
+	SOFT_IR_REQUIRE(builder, builder->entry_function != SOFT_IR_NONE);
+}
+
+static void SoftIRLowerType(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count, uint32_t opcode)
+{
+	SoftIRId* type = &builder->ids[w[1]];
+	switch(opcode)
+	{
+		case SpvOpTypeVoid: type->kind = SOFT_IR_TYPE_VOID; break;
+		case SpvOpTypeBool: type->kind = SOFT_IR_TYPE_BOOL; break;
+		case SpvOpTypeInt: SOFT_IR_REQUIRE(builder, word_count >= 3 && w[2] == 32); type->kind = SOFT_IR_TYPE_INT; break;
+		case SpvOpTypeFloat: SOFT_IR_REQUIRE(builder, word_count >= 3 && w[2] == 32); type->kind = SOFT_IR_TYPE_FLOAT; break;
+		case SpvOpTypeVector:
+		case SpvOpTypeMatrix:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[2] < builder->bound);
+			type->kind = opcode == SpvOpTypeVector ? SOFT_IR_TYPE_VECTOR : SOFT_IR_TYPE_MATRIX;
+			type->element = w[2];
+			type->count = w[3];
+			break;
+		}
+		case SpvOpTypeArray:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[2] < builder->bound && w[3] < builder->bound && SoftIRIsConstant(builder, w[3]));
+			type->kind = SOFT_IR_TYPE_ARRAY;
+			type->element = w[2];
+			type->count = builder->program->initial_registers[builder->ids[w[3]].reg].u;
+			break;
+		}
+		case SpvOpTypeRuntimeArray:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 3 && w[2] < builder->bound);
+			type->kind = SOFT_IR_TYPE_RUNTIME_ARRAY;
+			type->element = w[2];
+			break;
+		}
+		case SpvOpTypeStruct:
+		{
+			type->kind = SOFT_IR_TYPE_STRUCT;
+			type->first_member = builder->members_count;
+			type->count = word_count - 2;
+			for(uint32_t i = 2; i < word_count; i++)
+			{
+				SOFT_IR_REQUIRE(builder, w[i] < builder->bound);
+				SoftIRMember member = { .type = w[i], .offset = SOFT_IR_NONE, .matrix_stride = 0 };
+				for(uint32_t j = 0; j < builder->member_decorations_count; j++)
+				{
+					const SoftIRMemberDecoration* decoration = &builder->member_decorations[j];
+					if(decoration->structure != w[1] || decoration->member != i - 2)
+						continue;
+					if(decoration->decoration == SpvDecorationOffset)
+						member.offset = decoration->value;
+					else if(decoration->decoration == SpvDecorationMatrixStride)
+						member.matrix_stride = decoration->value;
+					else if(decoration->decoration == SpvDecorationRowMajor)
+						SOFT_IR_REQUIRE(builder, false);
+				}
+				SOFT_IR_PUSH(builder, builder->members, builder->members_count, builder->members_capacity, member);
+			}
+			break;
+		}
+		case SpvOpTypePointer:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			type->kind = SOFT_IR_TYPE_POINTER;
+			type->storage_class = w[2];
+			type->element = w[3];
+			break;
+		}
+		case SpvOpTypeFunction: type->kind = SOFT_IR_TYPE_FUNCTION; break;
+		case SpvOpTypeImage:
+		{
+			// Non multisampled storage images, sampling needs samplers the Software backend does not have
+			SOFT_IR_REQUIRE(builder, word_count >= 9 && w[2] < builder->bound);
+			SOFT_IR_REQUIRE(builder, w[3] == SpvDim2D || w[3] == SpvDim3D || w[3] == SpvDimCube);
+			SOFT_IR_REQUIRE(builder, w[6] == 0 && w[7] == 2);
+			type->kind = SOFT_IR_TYPE_IMAGE;
+			type->element = w[2];
+			break;
+		}
+
+		default: builder->failed = true; break;
+	}
+}
+
+static void SoftIRLowerConstant(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count, uint32_t opcode)
+{
+	const SoftIRId* type = &builder->ids[w[1]];
+	SOFT_IR_REQUIRE(builder, type->kind != SOFT_IR_TYPE_NONE && type->kind != SOFT_IR_TYPE_RUNTIME_ARRAY);
+	uint32_t reg = SoftIRRegister(builder, w[2]);
+	if(builder->failed)
+		return;
+	SoftIRWord* registers = builder->program->initial_registers;
+	switch(opcode)
+	{
+		case SpvOpConstantTrue:
+		case SpvOpSpecConstantTrue: registers[reg].u = 1; break;
+		case SpvOpConstantFalse:
+		case SpvOpSpecConstantFalse: registers[reg].u = 0; break;
+		case SpvOpConstant:
+		case SpvOpSpecConstant: SOFT_IR_REQUIRE(builder, word_count == 4 && SoftIRIsScalar(type)); registers[reg].u = w[3]; break;
+		case SpvOpConstantComposite:
+		case SpvOpSpecConstantComposite:
+		{
+			// The packed register form of a composite is the concatenation of its constituents
+			uint32_t offset = 0;
+			for(uint32_t i = 3; i < word_count; i++)
+			{
+				uint32_t words = SoftIRComponents(builder, w[i]);
+				uint32_t src = SoftIRRegister(builder, w[i]);
+				if(builder->failed)
+					return;
+				memcpy(builder->program->initial_registers + reg + offset, builder->program->initial_registers + src, words * sizeof(SoftIRWord));
+				offset += words;
+			}
+			break;
+		}
+
+		default: break; // OpConstantNull and OpUndef are zero filled
+	}
+}
+
+static void SoftIRLowerVariable(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count)
+{
+	SOFT_IR_REQUIRE(builder, word_count >= 4);
+	const SoftIRId* pointer_type = &builder->ids[w[1]];
+	SOFT_IR_REQUIRE(builder, pointer_type->kind == SOFT_IR_TYPE_POINTER);
+	SoftIRId* variable = &builder->ids[w[2]];
+	SoftIRProgram* program = builder->program;
+	uint32_t size = SoftIRMemorySize(builder, pointer_type->element, 0);
+	uint32_t region = SOFT_IR_REGION_PRIVATE;
+	uint32_t offset = 0;
+
+	switch(w[3])
+	{
+		case SpvStorageClassInput:
+		{
+			SOFT_IR_REQUIRE(builder, variable->builtin >= SpvBuiltInNumWorkgroups && variable->builtin <= SpvBuiltInLocalInvocationIndex);
+			offset = SoftIRAllocateMemory(&program->private_memory_size, size);
+			program->builtin_offsets[variable->builtin - SpvBuiltInNumWorkgroups] = offset;
+			break;
+		}
+		case SpvStorageClassPrivate:
+		case SpvStorageClassFunction: offset = SoftIRAllocateMemory(&program->private_memory_size, size); break;
+		case SpvStorageClassWorkgroup: region = SOFT_IR_REGION_WORKGROUP; offset = SoftIRAllocateMemory(&program->workgroup_memory_size, size); break;
+		case SpvStorageClassUniformConstant:
+			SOFT_IR_REQUIRE(builder, builder->ids[pointer_type->element].kind == SOFT_IR_TYPE_IMAGE);
+			// fallthrough
+		case SpvStorageClassUniform:
+		case SpvStorageClassStorageBuffer:
+		case SpvStorageClassPushConstant:
+		{
+			SoftIRResource resource = { .set = variable->set, .binding = variable->binding, .storage_class = w[3] };
+			region = SOFT_IR_REGION_RESOURCES + program->resources_count;
+			SOFT_IR_PUSH(builder, program->resources, program->resources_count, builder->resources_capacity, resource);
+			break;
+		}
+
+		default: builder->failed = true; return;
+	}
+
+	uint32_t reg = SoftIRRegister(builder, w[2]);
+	if(builder->failed)
+		return;
+	program->initial_registers[reg].u = region;
+	program->initial_registers[reg + 1].u = offset;
+
+	if(word_count >= 5)
+	{
+		SoftIRInitializer initializer = { .variable = w[2], .value = w[4] };
+		SOFT_IR_REQUIRE(builder, w[3] == SpvStorageClassPrivate || w[3] == SpvStorageClassFunction);
+		if(w[3] == SpvStorageClassPrivate)
+			SOFT_IR_PUSH(builder, builder->initializers, builder->initializers_count, builder->initializers_capacity, initializer);
+	}
+}
+
+static void SoftIREmitStore(SoftIRBuilder* builder, uint32_t pointer, uint32_t value)
+{
+	uint32_t value_type = builder->ids[value].type;
+	uint32_t plan = SoftIRCopyPlanFor(builder, value_type, builder->ids[pointer].matrix_stride);
+	uint32_t pointer_reg = SoftIRRegister(builder, pointer);
+	uint32_t value_reg = SoftIRRegister(builder, value);
+	if(plan == SOFT_IR_NONE)
+		SOFT_IR_EMIT(builder, SOFT_IR_OP_STORE, pointer_reg, value_reg, SoftIRTypeWords(builder, value_type) * (uint32_t)sizeof(uint32_t));
+	else
+		SOFT_IR_EMIT(builder, SOFT_IR_OP_STORE_PLAN, pointer_reg, value_reg, plan);
+}
+
+static void SoftIRLowerAccessChain(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count)
+{
+	SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+	const SoftIRId* base_type = SoftIRTypeOf(builder, w[3]);
+	SOFT_IR_REQUIRE(builder, base_type->kind == SOFT_IR_TYPE_POINTER);
+
+	uint32_t type_id = base_type->element;
+	uint32_t matrix_stride = builder->ids[w[3]].matrix_stride;
+	uint32_t constant_offset = 0;
+	uint32_t dynamic[64];
+	uint32_t dynamic_count = 0;
+
+	for(uint32_t i = 4; i < word_count; i++)
+	{
+		SOFT_IR_REQUIRE(builder, w[i] < builder->bound && dynamic_count + 2 <= 64);
+		const SoftIRId* type = &builder->ids[type_id];
+		bool is_constant = SoftIRIsConstant(builder, w[i]);
+		int32_t index = is_constant ? builder->program->initial_registers[builder->ids[w[i]].reg].i : 0;
+		uint32_t stride = 0;
+		switch(type->kind)
+		{
+			case SOFT_IR_TYPE_STRUCT:
+			{
+				SOFT_IR_REQUIRE(builder, is_constant && index >= 0 && (uint32_t)index < type->count);
+				const SoftIRMember* member = &builder->members[type->first_member + index];
+				constant_offset += SoftIRMemberOffset(builder, type, (uint32_t)index);
+				matrix_stride = member->matrix_stride;
+				type_id = member->type;
+				continue;
+			}
+			case SOFT_IR_TYPE_ARRAY:
+			case SOFT_IR_TYPE_RUNTIME_ARRAY: stride = SoftIRArrayStride(builder, type, matrix_stride); break;
+			case SOFT_IR_TYPE_MATRIX: stride = SoftIRColumnStride(builder, type, matrix_stride); matrix_stride = 0; break;
+			case SOFT_IR_TYPE_VECTOR: stride = sizeof(uint32_t); break;
+
+			default: builder->failed = true; return;
+		}
+		type_id = type->element;
+		if(is_constant)
+			constant_offset += (uint32_t)index * stride;
+		else
+		{
+			dynamic[dynamic_count++] = SoftIRRegister(builder, w[i]);
+			dynamic[dynamic_count++] = stride;
+		}
+	}
+
+	builder->ids[w[2]].matrix_stride = matrix_stride;
+	SOFT_IR_EMIT(builder, SOFT_IR_OP_ACCESS_CHAIN, 6 + dynamic_count, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), constant_offset, dynamic_count / 2);
+	SoftIREmitWords(builder, dynamic, dynamic_count);
+}
+
+// Word offset of a literal indexed element inside a packed composite
+static uint32_t SoftIRCompositeOffset(SoftIRBuilder* builder, uint32_t type_id, const uint32_t* indices, uint32_t indices_count)
+{
+	uint32_t offset = 0;
+	for(uint32_t i = 0; i < indices_count; i++)
+	{
+		const SoftIRId* type = &builder->ids[type_id];
+		switch(type->kind)
+		{
+			case SOFT_IR_TYPE_STRUCT:
+			{
+				if(indices[i] >= type->count)
+				{
+					builder->failed = true;
+					return 0;
+				}
+				for(uint32_t j = 0; j < indices[i]; j++)
+					offset += SoftIRTypeWords(builder, builder->members[type->first_member + j].type);
+				type_id = builder->members[type->first_member + indices[i]].type;
+				break;
+			}
+			case SOFT_IR_TYPE_VECTOR:
+			case SOFT_IR_TYPE_MATRIX:
+			case SOFT_IR_TYPE_ARRAY:
+			{
+				if(indices[i] >= type->count)
+				{
+					builder->failed = true;
+					return 0;
+				}
+				offset += indices[i] * SoftIRTypeWords(builder, type->element);
+				type_id = type->element;
+				break;
+			}
+
+			default: builder->failed = true; return 0;
+		}
+	}
+	return offset;
+}
+
+// Phi values are copied to shadow registers on each edge, the phi itself reads its shadow at the top of the block
+static bool SoftIRBlockHasPhis(SoftIRBuilder* builder, uint32_t label)
+{
+	return label < builder->bound && builder->ids[label].phis_count > 0;
+}
+
+static void SoftIREmitEdge(SoftIRBuilder* builder, uint32_t from, uint32_t to)
+{
+	SOFT_IR_REQUIRE(builder, to < builder->bound);
+	SoftIRId* target = &builder->ids[to];
+	for(uint32_t i = 0; i < target->phis_count; i++)
+	{
+		SoftIRPhi* phi = &builder->phis[target->first_phi + i];
+		uint32_t words = SoftIRTypeWords(builder, phi->instruction[1]);
+		if(phi->shadow == SOFT_IR_NONE)
+			phi->shadow = SoftIRAllocateRegisters(builder, words);
+		for(uint32_t j = 3; j + 1 < phi->word_count; j += 2)
+		{
+			if(phi->instruction[j + 1] != from)
+				continue;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, phi->shadow, SoftIRRegister(builder, phi->instruction[j]), words);
+			break;
+		}
+	}
+	SOFT_IR_EMIT(builder, SOFT_IR_OP_JMP);
+	SoftIREmitTarget(builder, to);
+}
+
+// Branch operand that goes through an edge stub when the target block starts with phis
+typedef struct SoftIRPendingEdge
+{
+	uint32_t position;
+	uint32_t target;
+} SoftIRPendingEdge;
+
+static void SoftIREmitBranchTarget(SoftIRBuilder* builder, uint32_t target, SoftIRPendingEdge* pending, uint32_t* pending_count)
+{
+	if(SoftIRBlockHasPhis(builder, target))
+	{
+		pending[*pending_count].position = builder->program->code_size;
+		pending[*pending_count].target = target;
+		(*pending_count)++;
+		SOFT_IR_EMIT(builder, SOFT_IR_NONE);
+	}
+	else
+		SoftIREmitTarget(builder, target);
+}
+
+static void SoftIREmitPendingEdges(SoftIRBuilder* builder, uint32_t from, const SoftIRPendingEdge* pending, uint32_t pending_count)
+{
+	for(uint32_t i = 0; i < pending_count && !builder->failed; i++)
+	{
+		builder->program->code[pending[i].position] = builder->program->code_size;
+		SoftIREmitEdge(builder, from, pending[i].target);
+	}
+}
+
+static void SoftIRLowerGLSL(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count)
+{
+	SOFT_IR_REQUIRE(builder, word_count >= 6);
+	uint32_t dst = SoftIRRegister(builder, w[2]);
+	uint32_t n = SoftIRComponents(builder, w[2]);
+	uint32_t operands[3] = { 0 };
+	uint32_t operands_count = word_count - 5;
+	SOFT_IR_REQUIRE(builder, operands_count <= 3);
+	for(uint32_t i = 0; i < operands_count; i++)
+		operands[i] = SoftIRRegister(builder, w[5 + i]);
+
+	static const struct { uint32_t instruction; SoftIROp op; uint32_t operands; } table[] = {
+		{ SOFT_GLSL_STD_450_ROUND, SOFT_IR_OP_ROUND, 1 }, { SOFT_GLSL_STD_450_ROUND_EVEN, SOFT_IR_OP_ROUND_EVEN, 1 },
+		{ SOFT_GLSL_STD_450_TRUNC, SOFT_IR_OP_TRUNC, 1 }, { SOFT_GLSL_STD_450_FABS, SOFT_IR_OP_FABS, 1 },
+		{ SOFT_GLSL_STD_450_SABS, SOFT_IR_OP_SABS, 1 }, { SOFT_GLSL_STD_450_FSIGN, SOFT_IR_OP_FSIGN, 1 },
+		{ SOFT_GLSL_STD_450_SSIGN, SOFT_IR_OP_SSIGN, 1 }, { SOFT_GLSL_STD_450_FLOOR, SOFT_IR_OP_FLOOR, 1 },
+		{ SOFT_GLSL_STD_450_CEIL, SOFT_IR_OP_CEIL, 1 }, { SOFT_GLSL_STD_450_FRACT, SOFT_IR_OP_FRACT, 1 },
+		{ SOFT_GLSL_STD_450_SIN, SOFT_IR_OP_SIN, 1 }, { SOFT_GLSL_STD_450_COS, SOFT_IR_OP_COS, 1 },
+		{ SOFT_GLSL_STD_450_TAN, SOFT_IR_OP_TAN, 1 }, { SOFT_GLSL_STD_450_ASIN, SOFT_IR_OP_ASIN, 1 },
+		{ SOFT_GLSL_STD_450_ACOS, SOFT_IR_OP_ACOS, 1 }, { SOFT_GLSL_STD_450_ATAN, SOFT_IR_OP_ATAN, 1 },
+		{ SOFT_GLSL_STD_450_SINH, SOFT_IR_OP_SINH, 1 }, { SOFT_GLSL_STD_450_COSH, SOFT_IR_OP_COSH, 1 },
+		{ SOFT_GLSL_STD_450_TANH, SOFT_IR_OP_TANH, 1 }, { SOFT_GLSL_STD_450_ATAN2, SOFT_IR_OP_ATAN2, 2 },
+		{ SOFT_GLSL_STD_450_POW, SOFT_IR_OP_POW, 2 }, { SOFT_GLSL_STD_450_EXP, SOFT_IR_OP_EXP, 1 },
+		{ SOFT_GLSL_STD_450_LOG, SOFT_IR_OP_LOG, 1 }, { SOFT_GLSL_STD_450_EXP2, SOFT_IR_OP_EXP2, 1 },
+		{ SOFT_GLSL_STD_450_LOG2, SOFT_IR_OP_LOG2, 1 }, { SOFT_GLSL_STD_450_SQRT, SOFT_IR_OP_SQRT, 1 },
+		{ SOFT_GLSL_STD_450_INVERSE_SQRT, SOFT_IR_OP_RSQRT, 1 }, { SOFT_GLSL_STD_450_FMIN, SOFT_IR_OP_FMIN, 2 },
+		{ SOFT_GLSL_STD_450_UMIN, SOFT_IR_OP_UMIN, 2 }, { SOFT_GLSL_STD_450_SMIN, SOFT_IR_OP_SMIN, 2 },
+		{ SOFT_GLSL_STD_450_FMAX, SOFT_IR_OP_FMAX, 2 }, { SOFT_GLSL_STD_450_UMAX, SOFT_IR_OP_UMAX, 2 },
+		{ SOFT_GLSL_STD_450_SMAX, SOFT_IR_OP_SMAX, 2 }, { SOFT_GLSL_STD_450_FCLAMP, SOFT_IR_OP_FCLAMP, 3 },
+		{ SOFT_GLSL_STD_450_UCLAMP, SOFT_IR_OP_UCLAMP, 3 }, { SOFT_GLSL_STD_450_SCLAMP, SOFT_IR_OP_SCLAMP, 3 },
+		{ SOFT_GLSL_STD_450_FMIX, SOFT_IR_OP_FMIX, 3 }, { SOFT_GLSL_STD_450_STEP, SOFT_IR_OP_STEP, 2 },
+		{ SOFT_GLSL_STD_450_SMOOTH_STEP, SOFT_IR_OP_SMOOTHSTEP, 3 }, { SOFT_GLSL_STD_450_FMA, SOFT_IR_OP_FMA, 3 },
+		{ SOFT_GLSL_STD_450_NMIN, SOFT_IR_OP_FMIN, 2 }, { SOFT_GLSL_STD_450_NMAX, SOFT_IR_OP_FMAX, 2 },
+		{ SOFT_GLSL_STD_450_NCLAMP, SOFT_IR_OP_FCLAMP, 3 },
+	};
+
+	uint32_t instruction = w[4];
+	for(uint32_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+	{
+		if(table[i].instruction != instruction)
+			continue;
+		SOFT_IR_REQUIRE(builder, operands_count == table[i].operands);
+		switch(table[i].operands)
+		{
+			case 1: SOFT_IR_EMIT(builder, table[i].op, dst, operands[0], n); break;
+			case 2: SOFT_IR_EMIT(builder, table[i].op, dst, operands[0], operands[1], n); break;
+			default: SOFT_IR_EMIT(builder, table[i].op, dst, operands[0], operands[1], operands[2], n); break;
+		}
+		return;
+	}
+
+	uint32_t operand_components = SoftIRComponents(builder, w[5]);
+	switch(instruction)
+	{
+		case SOFT_GLSL_STD_450_RADIANS: SOFT_IR_EMIT(builder, SOFT_IR_OP_FMUL_SCALAR, dst, operands[0], SoftIRConstantRegister(builder, 0x3C8EFA35), n); break; // pi / 180
+		case SOFT_GLSL_STD_450_DEGREES: SOFT_IR_EMIT(builder, SOFT_IR_OP_FMUL_SCALAR, dst, operands[0], SoftIRConstantRegister(builder, 0x42652EE1), n); break; // 180 / pi
+		case SOFT_GLSL_STD_450_LENGTH: SOFT_IR_EMIT(builder, SOFT_IR_OP_LENGTH, dst, operands[0], operand_components); break;
+		case SOFT_GLSL_STD_450_DISTANCE: SOFT_IR_EMIT(builder, SOFT_IR_OP_DISTANCE, dst, operands[0], operands[1], operand_components); break;
+		case SOFT_GLSL_STD_450_NORMALIZE: SOFT_IR_EMIT(builder, SOFT_IR_OP_NORMALIZE, dst, operands[0], n); break;
+		case SOFT_GLSL_STD_450_CROSS: SOFT_IR_EMIT(builder, SOFT_IR_OP_CROSS, dst, operands[0], operands[1]); break;
+		case SOFT_GLSL_STD_450_REFLECT: SOFT_IR_EMIT(builder, SOFT_IR_OP_REFLECT, dst, operands[0], operands[1], n); break;
+
+		default: builder->failed = true; break;
+	}
+}
+
+static SoftIROp SoftIRSimpleOp(uint32_t opcode, uint32_t* operands_count)
+{
+	*operands_count = 2;
+	switch(opcode)
+	{
+		case SpvOpIAdd: return SOFT_IR_OP_IADD;
+		case SpvOpISub: return SOFT_IR_OP_ISUB;
+		case SpvOpIMul: return SOFT_IR_OP_IMUL;
+		case SpvOpSDiv: return SOFT_IR_OP_SDIV;
+		case SpvOpUDiv: return SOFT_IR_OP_UDIV;
+		case SpvOpSRem: return SOFT_IR_OP_SREM;
+		case SpvOpSMod: return SOFT_IR_OP_SMOD;
+		case SpvOpUMod: return SOFT_IR_OP_UMOD;
+		case SpvOpFAdd: return SOFT_IR_OP_FADD;
+		case SpvOpFSub: return SOFT_IR_OP_FSUB;
+		case SpvOpFMul: return SOFT_IR_OP_FMUL;
+		case SpvOpFDiv: return SOFT_IR_OP_FDIV;
+		case SpvOpFRem: return SOFT_IR_OP_FREM;
+		case SpvOpFMod: return SOFT_IR_OP_FMOD;
+		case SpvOpShiftLeftLogical: return SOFT_IR_OP_SHL;
+		case SpvOpShiftRightLogical: return SOFT_IR_OP_SHR;
+		case SpvOpShiftRightArithmetic: return SOFT_IR_OP_SAR;
+		case SpvOpBitwiseAnd:
+		case SpvOpLogicalAnd: return SOFT_IR_OP_AND;
+		case SpvOpBitwiseOr:
+		case SpvOpLogicalOr: return SOFT_IR_OP_OR;
+		case SpvOpBitwiseXor: return SOFT_IR_OP_XOR;
+		case SpvOpIEqual:
+		case SpvOpLogicalEqual: return SOFT_IR_OP_IEQ;
+		case SpvOpINotEqual:
+		case SpvOpLogicalNotEqual: return SOFT_IR_OP_INE;
+		case SpvOpULessThan: return SOFT_IR_OP_ULT;
+		case SpvOpULessThanEqual: return SOFT_IR_OP_ULE;
+		case SpvOpUGreaterThan: return SOFT_IR_OP_UGT;
+		case SpvOpUGreaterThanEqual: return SOFT_IR_OP_UGE;
+		case SpvOpSLessThan: return SOFT_IR_OP_SLT;
+		case SpvOpSLessThanEqual: return SOFT_IR_OP_SLE;
+		case SpvOpSGreaterThan: return SOFT_IR_OP_SGT;
+		case SpvOpSGreaterThanEqual: return SOFT_IR_OP_SGE;
+		case SpvOpFOrdEqual: return SOFT_IR_OP_FOEQ;
+		case SpvOpFOrdNotEqual: return SOFT_IR_OP_FONE;
+		case SpvOpFOrdLessThan: return SOFT_IR_OP_FOLT;
+		case SpvOpFOrdLessThanEqual: return SOFT_IR_OP_FOLE;
+		case SpvOpFOrdGreaterThan: return SOFT_IR_OP_FOGT;
+		case SpvOpFOrdGreaterThanEqual: return SOFT_IR_OP_FOGE;
+		case SpvOpFUnordEqual: return SOFT_IR_OP_FUEQ;
+		case SpvOpFUnordNotEqual: return SOFT_IR_OP_FUNE;
+		case SpvOpFUnordLessThan: return SOFT_IR_OP_FULT;
+		case SpvOpFUnordLessThanEqual: return SOFT_IR_OP_FULE;
+		case SpvOpFUnordGreaterThan: return SOFT_IR_OP_FUGT;
+		case SpvOpFUnordGreaterThanEqual: return SOFT_IR_OP_FUGE;
+		default: break;
+	}
+	*operands_count = 1;
+	switch(opcode)
+	{
+		case SpvOpFNegate: return SOFT_IR_OP_FNEG;
+		case SpvOpSNegate: return SOFT_IR_OP_SNEG;
+		case SpvOpNot: return SOFT_IR_OP_NOT;
+		case SpvOpLogicalNot: return SOFT_IR_OP_LNOT;
+		case SpvOpIsNan: return SOFT_IR_OP_ISNAN;
+		case SpvOpIsInf: return SOFT_IR_OP_ISINF;
+		case SpvOpConvertFToU: return SOFT_IR_OP_F2U;
+		case SpvOpConvertFToS: return SOFT_IR_OP_F2S;
+		case SpvOpConvertUToF: return SOFT_IR_OP_U2F;
+		case SpvOpConvertSToF: return SOFT_IR_OP_S2F;
+		default: break;
+	}
+	*operands_count = 0;
+	return SOFT_IR_OP_MAX_ENUM;
+}
+
+// Scopes are ignored, every worker shares one coherent address space
+static SoftIRMemoryOrder SoftIRMemoryOrderOf(SoftIRBuilder* builder, uint32_t semantics_id, bool loads, bool stores)
+{
+	if(semantics_id < builder->bound && builder->ids[semantics_id].opcode == SpvOpConstantNull)
+		return SOFT_IR_MEMORY_ORDER_RELAXED;
+	if(semantics_id >= builder->bound || !SoftIRIsConstant(builder, semantics_id))
+	{
+		builder->failed = true;
+		return SOFT_IR_MEMORY_ORDER_SEQ_CST;
+	}
+	uint32_t semantics = builder->program->initial_registers[SoftIRRegister(builder, semantics_id)].u;
+	if(semantics & SpvMemorySemanticsSequentiallyConsistentMask)
+		return SOFT_IR_MEMORY_ORDER_SEQ_CST;
+	bool acquire = loads && (semantics & (SpvMemorySemanticsAcquireMask | SpvMemorySemanticsAcquireReleaseMask)) != 0;
+	bool release = stores && (semantics & (SpvMemorySemanticsReleaseMask | SpvMemorySemanticsAcquireReleaseMask)) != 0;
+	if(acquire && release)
+		return SOFT_IR_MEMORY_ORDER_ACQ_REL;
+	if(acquire)
+		return SOFT_IR_MEMORY_ORDER_ACQUIRE;
+	return release ? SOFT_IR_MEMORY_ORDER_RELEASE : SOFT_IR_MEMORY_ORDER_RELAXED;
+}
+
+static void SoftIRLowerAtomic(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count, uint32_t opcode)
+{
+	// Pointer, scope then semantics, after the result for everything but AtomicStore
+	uint32_t pointer_index = opcode == SpvOpAtomicStore ? 1 : 3;
+	SOFT_IR_REQUIRE(builder, word_count >= pointer_index + 3 && w[pointer_index] < builder->bound);
+	const SoftIRId* pointer_type = SoftIRTypeOf(builder, w[pointer_index]);
+	SOFT_IR_REQUIRE(builder, pointer_type->kind == SOFT_IR_TYPE_POINTER && builder->ids[pointer_type->element].kind == SOFT_IR_TYPE_INT);
+	uint32_t pointer = SoftIRRegister(builder, w[pointer_index]);
+	uint32_t semantics = w[pointer_index + 2];
+
+	SoftIRAtomicFunction function = SOFT_IR_ATOMIC_MAX_ENUM;
+	switch(opcode)
+	{
+		case SpvOpAtomicLoad:
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_ATOMIC_LOAD, SoftIRRegister(builder, w[2]), pointer, SoftIRMemoryOrderOf(builder, semantics, true, false));
+			return;
+		case SpvOpAtomicStore:
+			SOFT_IR_REQUIRE(builder, word_count >= 5 && w[4] < builder->bound);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_ATOMIC_STORE, pointer, SoftIRRegister(builder, w[4]), SoftIRMemoryOrderOf(builder, semantics, false, true));
+			return;
+		case SpvOpAtomicCompareExchange:
+		case SpvOpAtomicCompareExchangeWeak: // A strong exchange is a valid weak one
+			SOFT_IR_REQUIRE(builder, word_count >= 9 && w[7] < builder->bound && w[8] < builder->bound);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_ATOMIC_CMPXCHG, SoftIRRegister(builder, w[2]), pointer, SoftIRRegister(builder, w[7]), SoftIRRegister(builder, w[8]),
+				SoftIRMemoryOrderOf(builder, semantics, true, true), SoftIRMemoryOrderOf(builder, w[6], true, false));
+			return;
+		case SpvOpAtomicIIncrement:
+		case SpvOpAtomicIDecrement:
+		{
+			uint32_t one = SoftIRAllocateRegisters(builder, 1);
+			if(builder->failed)
+				return;
+			builder->program->initial_registers[one].u = 1;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_ATOMIC_RMW, SoftIRRegister(builder, w[2]), pointer, one, opcode == SpvOpAtomicIIncrement ? SOFT_IR_ATOMIC_IADD : SOFT_IR_ATOMIC_ISUB, SoftIRMemoryOrderOf(builder, semantics, true, true));
+			return;
+		}
+		case SpvOpAtomicExchange: function = SOFT_IR_ATOMIC_EXCHANGE; break;
+		case SpvOpAtomicIAdd: function = SOFT_IR_ATOMIC_IADD; break;
+		case SpvOpAtomicISub: function = SOFT_IR_ATOMIC_ISUB; break;
+		case SpvOpAtomicSMin: function = SOFT_IR_ATOMIC_SMIN; break;
+		case SpvOpAtomicUMin: function = SOFT_IR_ATOMIC_UMIN; break;
+		case SpvOpAtomicSMax: function = SOFT_IR_ATOMIC_SMAX; break;
+		case SpvOpAtomicUMax: function = SOFT_IR_ATOMIC_UMAX; break;
+		case SpvOpAtomicAnd: function = SOFT_IR_ATOMIC_AND; break;
+		case SpvOpAtomicOr: function = SOFT_IR_ATOMIC_OR; break;
+		case SpvOpAtomicXor: function = SOFT_IR_ATOMIC_XOR; break;
+
+		default: builder->failed = true; return;
+	}
+	SOFT_IR_REQUIRE(builder, word_count >= 7 && w[6] < builder->bound);
+	SOFT_IR_EMIT(builder, SOFT_IR_OP_ATOMIC_RMW, SoftIRRegister(builder, w[2]), pointer, SoftIRRegister(builder, w[6]), function, SoftIRMemoryOrderOf(builder, semantics, true, true));
+}
+
+static void SoftIRLowerInstruction(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count, uint32_t opcode)
+{
+	uint32_t operands_count;
+	SoftIROp simple = SoftIRSimpleOp(opcode, &operands_count);
+	if(simple != SOFT_IR_OP_MAX_ENUM)
+	{
+		SOFT_IR_REQUIRE(builder, word_count == 3 + operands_count);
+		uint32_t dst = SoftIRRegister(builder, w[2]);
+		uint32_t n = SoftIRComponents(builder, w[2]);
+		if(operands_count == 1)
+			SOFT_IR_EMIT(builder, simple, dst, SoftIRRegister(builder, w[3]), n);
+		else
+			SOFT_IR_EMIT(builder, simple, dst, SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), n);
+		return;
+	}
+
+	switch(opcode)
+	{
+		case SpvOpNop:
+		case SpvOpLine:
+		case SpvOpNoLine:
+		case SpvOpSelectionMerge:
+		case SpvOpLoopMerge:
+		case SpvOpMemoryBarrier: // Workers share one coherent address space
+		case SpvOpUndef:
+		case SpvOpFunctionParameter:
+			break;
+
+		case SpvOpFunction:
+		{
+			builder->current_function = w[2];
+			builder->ids[w[2]].pc = builder->program->code_size;
+			break;
+		}
+		case SpvOpFunctionEnd: builder->current_function = SOFT_IR_NONE; break;
+		case SpvOpLabel: builder->ids[w[1]].pc = builder->program->code_size; break;
+
+		case SpvOpVariable:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] == SpvStorageClassFunction);
+			SoftIRLowerVariable(builder, w, word_count);
+			if(word_count >= 5)
+				SoftIREmitStore(builder, w[2], w[4]);
+			break;
+		}
+
+		case SpvOpPhi:
+		{
+			SoftIRPhi* phi = PULSE_NULLPTR;
+			for(uint32_t i = 0; i < builder->phis_count; i++)
+			{
+				if(builder->phis[i].instruction == w)
+					phi = &builder->phis[i];
+			}
+			SOFT_IR_REQUIRE(builder, phi != PULSE_NULLPTR);
+			uint32_t words = SoftIRComponents(builder, w[2]);
+			if(phi->shadow == SOFT_IR_NONE)
+				phi->shadow = SoftIRAllocateRegisters(builder, words);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, w[2]), phi->shadow, words);
+			break;
+		}
+
+		case SpvOpLoad:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			SOFT_IR_REQUIRE(builder, builder->ids[w[1]].kind != SOFT_IR_TYPE_POINTER);
+			if(builder->ids[w[1]].kind == SOFT_IR_TYPE_IMAGE) // Loading an image only forwards its region
+			{
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), 1);
+				break;
+			}
+			uint32_t plan = SoftIRCopyPlanFor(builder, w[1], builder->ids[w[3]].matrix_stride);
+			if(plan == SOFT_IR_NONE)
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_LOAD, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRTypeWords(builder, w[1]) * (uint32_t)sizeof(uint32_t));
+			else
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_LOAD_PLAN, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), plan);
+			break;
+		}
+		case SpvOpStore:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 3 && w[1] < builder->bound && w[2] < builder->bound);
+			SOFT_IR_REQUIRE(builder, SoftIRTypeOf(builder, w[2])->kind != SOFT_IR_TYPE_POINTER);
+			SoftIREmitStore(builder, w[1], w[2]);
+			break;
+		}
+		case SpvOpAccessChain:
+		case SpvOpInBoundsAccessChain: SoftIRLowerAccessChain(builder, w, word_count); break;
+		case SpvOpArrayLength:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5 && w[3] < builder->bound);
+			const SoftIRId* pointer_type = SoftIRTypeOf(builder, w[3]);
+			SOFT_IR_REQUIRE(builder, pointer_type->kind == SOFT_IR_TYPE_POINTER);
+			const SoftIRId* structure = &builder->ids[pointer_type->element];
+			SOFT_IR_REQUIRE(builder, structure->kind == SOFT_IR_TYPE_STRUCT && w[4] < structure->count);
+			const SoftIRId* array = &builder->ids[builder->members[structure->first_member + w[4]].type];
+			SOFT_IR_REQUIRE(builder, array->kind == SOFT_IR_TYPE_RUNTIME_ARRAY);
+			uint32_t stride = SoftIRArrayStride(builder, array, 0);
+			SOFT_IR_REQUIRE(builder, stride != 0);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_ARRAY_LENGTH, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRMemberOffset(builder, structure, w[4]), stride);
+			break;
+		}
+
+		case SpvOpImageRead:
+		{
+			SOFT_IR_REQUIRE(builder, (word_count == 5 || (word_count == 6 && w[5] == SpvImageOperandsMaskNone)) && w[3] < builder->bound && w[4] < builder->bound);
+			SOFT_IR_REQUIRE(builder, SoftIRTypeOf(builder, w[3])->kind == SOFT_IR_TYPE_IMAGE);
+			uint32_t coords_count = SoftIRComponents(builder, w[4]);
+			uint32_t texel_count = SoftIRComponents(builder, w[2]);
+			SOFT_IR_REQUIRE(builder, coords_count <= 3 && texel_count <= 4);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_IMAGE_READ, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), coords_count, texel_count);
+			break;
+		}
+		case SpvOpImageWrite:
+		{
+			SOFT_IR_REQUIRE(builder, (word_count == 4 || (word_count == 5 && w[4] == SpvImageOperandsMaskNone)) && w[1] < builder->bound && w[2] < builder->bound && w[3] < builder->bound);
+			SOFT_IR_REQUIRE(builder, SoftIRTypeOf(builder, w[1])->kind == SOFT_IR_TYPE_IMAGE);
+			uint32_t coords_count = SoftIRComponents(builder, w[2]);
+			uint32_t texel_count = SoftIRComponents(builder, w[3]);
+			SOFT_IR_REQUIRE(builder, coords_count <= 3 && texel_count <= 4);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_IMAGE_WRITE, SoftIRRegister(builder, w[1]), SoftIRRegister(builder, w[2]), coords_count, SoftIRRegister(builder, w[3]), texel_count);
+			break;
+		}
+		case SpvOpImageQuerySize:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			SOFT_IR_REQUIRE(builder, SoftIRTypeOf(builder, w[3])->kind == SOFT_IR_TYPE_IMAGE);
+			uint32_t count = SoftIRComponents(builder, w[2]);
+			SOFT_IR_REQUIRE(builder, count <= 3);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_IMAGE_SIZE, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), count);
+			break;
+		}
+
+		case SpvOpCopyObject:
+		case SpvOpBitcast:
+		case SpvOpUConvert:
+		case SpvOpSConvert:
+		case SpvOpFConvert:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			uint32_t n = SoftIRComponents(builder, w[2]);
+			SOFT_IR_REQUIRE(builder, n == SoftIRComponents(builder, w[3]));
+			builder->ids[w[2]].matrix_stride = builder->ids[w[3]].matrix_stride;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), n);
+			break;
+		}
+
+		case SpvOpSelect:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 6);
+			bool vector_condition = SoftIRTypeOf(builder, w[3])->kind == SOFT_IR_TYPE_VECTOR;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_SELECT, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), SoftIRRegister(builder, w[5]), SoftIRComponents(builder, w[2]), vector_condition);
+			break;
+		}
+		case SpvOpAny:
+		case SpvOpAll:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4);
+			SOFT_IR_EMIT(builder, opcode == SpvOpAny ? SOFT_IR_OP_ANY : SOFT_IR_OP_ALL, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRComponents(builder, w[3]));
+			break;
+		}
+		case SpvOpDot:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_DOT, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), SoftIRComponents(builder, w[3]));
+			break;
+		}
+		case SpvOpVectorTimesScalar:
+		case SpvOpMatrixTimesScalar:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_FMUL_SCALAR, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), SoftIRComponents(builder, w[2]));
+			break;
+		}
+		case SpvOpMatrixTimesVector:
+		case SpvOpVectorTimesMatrix:
+		case SpvOpMatrixTimesMatrix:
+		case SpvOpTranspose:
+		case SpvOpOuterProduct:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4);
+			uint32_t dst = SoftIRRegister(builder, w[2]);
+			uint32_t a = SoftIRRegister(builder, w[3]);
+			if(opcode == SpvOpTranspose)
+			{
+				const SoftIRId* matrix = SoftIRTypeOf(builder, w[3]);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_TRANSPOSE, dst, a, matrix->count, builder->ids[matrix->element].count);
+				break;
+			}
+			SOFT_IR_REQUIRE(builder, word_count >= 5);
+			uint32_t b = SoftIRRegister(builder, w[4]);
+			if(opcode == SpvOpMatrixTimesVector)
+			{
+				const SoftIRId* matrix = SoftIRTypeOf(builder, w[3]);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MAT_TIMES_VEC, dst, a, b, matrix->count, builder->ids[matrix->element].count);
+			}
+			else if(opcode == SpvOpVectorTimesMatrix)
+			{
+				const SoftIRId* matrix = SoftIRTypeOf(builder, w[4]);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_VEC_TIMES_MAT, dst, a, b, matrix->count, builder->ids[matrix->element].count);
+			}
+			else if(opcode == SpvOpMatrixTimesMatrix)
+			{
+				const SoftIRId* left = SoftIRTypeOf(builder, w[3]);
+				const SoftIRId* right = SoftIRTypeOf(builder, w[4]);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MAT_TIMES_MAT, dst, a, b, builder->ids[left->element].count, left->count, right->count);
+			}
+			else
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_OUTER_PRODUCT, dst, a, b, SoftIRComponents(builder, w[3]), SoftIRComponents(builder, w[4]));
+			break;
+		}
+
+		case SpvOpCompositeConstruct:
+		{
+			uint32_t dst = SoftIRRegister(builder, w[2]);
+			uint32_t offset = 0;
+			for(uint32_t i = 3; i < word_count; i++)
+			{
+				uint32_t words = SoftIRComponents(builder, w[i]);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, dst + offset, SoftIRRegister(builder, w[i]), words);
+				offset += words;
+			}
+			break;
+		}
+		case SpvOpCompositeExtract:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			uint32_t offset = SoftIRCompositeOffset(builder, builder->ids[w[3]].type, w + 4, word_count - 4);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]) + offset, SoftIRComponents(builder, w[2]));
+			break;
+		}
+		case SpvOpCompositeInsert:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5 && w[4] < builder->bound);
+			uint32_t dst = SoftIRRegister(builder, w[2]);
+			uint32_t offset = SoftIRCompositeOffset(builder, builder->ids[w[4]].type, w + 5, word_count - 5);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, dst, SoftIRRegister(builder, w[4]), SoftIRComponents(builder, w[2]));
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, dst + offset, SoftIRRegister(builder, w[3]), SoftIRComponents(builder, w[3]));
+			break;
+		}
+		case SpvOpVectorShuffle:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5);
+			uint32_t dst = SoftIRRegister(builder, w[2]);
+			uint32_t first = SoftIRRegister(builder, w[3]);
+			uint32_t second = SoftIRRegister(builder, w[4]);
+			uint32_t first_count = SoftIRComponents(builder, w[3]);
+			for(uint32_t i = 5; i < word_count; i++)
+			{
+				if(w[i] == 0xFFFFFFFF) // Undefined component
+					continue;
+				uint32_t src = w[i] < first_count ? first + w[i] : second + (w[i] - first_count);
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, dst + (i - 5), src, 1);
+			}
+			break;
+		}
+		case SpvOpVectorExtractDynamic:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_VEC_EXTRACT_DYN, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), SoftIRComponents(builder, w[3]));
+			break;
+		}
+		case SpvOpVectorInsertDynamic:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 6);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_VEC_INSERT_DYN, SoftIRRegister(builder, w[2]), SoftIRRegister(builder, w[3]), SoftIRRegister(builder, w[4]), SoftIRRegister(builder, w[5]), SoftIRComponents(builder, w[2]));
+			break;
+		}
+
+		case SpvOpExtInst:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 5 && w[3] < builder->bound);
+			SoftIRImportKind kind = builder->ids[w[3]].import_kind;
+			if(kind == SOFT_IR_IMPORT_NON_SEMANTIC)
+				break;
+			SOFT_IR_REQUIRE(builder, kind == SOFT_IR_IMPORT_GLSL_STD_450);
+			SoftIRLowerGLSL(builder, w, word_count);
+			break;
+		}
+
+		case SpvOpFunctionCall:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4 && w[3] < builder->bound);
+			const SoftIRId* callee = &builder->ids[w[3]];
+			SOFT_IR_REQUIRE(builder, callee->params_count == word_count - 4);
+			for(uint32_t i = 0; i < callee->params_count; i++)
+			{
+				uint32_t param = builder->params[callee->first_param + i];
+				builder->ids[param].matrix_stride = builder->ids[w[4 + i]].matrix_stride;
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, param), SoftIRRegister(builder, w[4 + i]), SoftIRComponents(builder, param));
+			}
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_CALL);
+			SoftIREmitTarget(builder, w[3]);
+			if(builder->ids[w[1]].kind != SOFT_IR_TYPE_VOID)
+				SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRRegister(builder, w[2]), SoftIRReturnRegister(builder, w[3]), SoftIRComponents(builder, w[2]));
+			break;
+		}
+		case SpvOpReturn: SOFT_IR_EMIT(builder, SOFT_IR_OP_RET); break;
+		case SpvOpReturnValue:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 2 && builder->current_function != SOFT_IR_NONE);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_MOV, SoftIRReturnRegister(builder, builder->current_function), SoftIRRegister(builder, w[1]), SoftIRComponents(builder, w[1]));
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_RET);
+			break;
+		}
+		case SpvOpKill:
+		case SpvOpTerminateInvocation:
+		case SpvOpUnreachable: SOFT_IR_EMIT(builder, SOFT_IR_OP_HALT); break;
+
+		case SpvOpAtomicLoad:
+		case SpvOpAtomicStore:
+		case SpvOpAtomicExchange:
+		case SpvOpAtomicCompareExchange:
+		case SpvOpAtomicCompareExchangeWeak:
+		case SpvOpAtomicIIncrement:
+		case SpvOpAtomicIDecrement:
+		case SpvOpAtomicIAdd:
+		case SpvOpAtomicISub:
+		case SpvOpAtomicSMin:
+		case SpvOpAtomicUMin:
+		case SpvOpAtomicSMax:
+		case SpvOpAtomicUMax:
+		case SpvOpAtomicAnd:
+		case SpvOpAtomicOr:
+		case SpvOpAtomicXor: SoftIRLowerAtomic(builder, w, word_count, opcode); break;
+
+		case SpvOpControlBarrier:
+		{
+			builder->program->uses_control_barriers = true;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_BARRIER);
+			break;
+		}
+
+		default: builder->failed = true; builder->unsupported_opcode = opcode; break;
+	}
+}
+
+static void SoftIRLowerBranch(SoftIRBuilder* builder, const uint32_t* w, uint32_t word_count, uint32_t opcode, uint32_t current_label)
+{
+	SoftIRPendingEdge pending[64];
+	uint32_t pending_count = 0;
+	switch(opcode)
+	{
+		case SpvOpBranch:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 2);
+			SoftIREmitEdge(builder, current_label, w[1]);
+			break;
+		}
+		case SpvOpBranchConditional:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 4);
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_BR, SoftIRRegister(builder, w[1]));
+			SoftIREmitBranchTarget(builder, w[2], pending, &pending_count);
+			SoftIREmitBranchTarget(builder, w[3], pending, &pending_count);
+			SoftIREmitPendingEdges(builder, current_label, pending, pending_count);
+			break;
+		}
+		case SpvOpSwitch:
+		{
+			SOFT_IR_REQUIRE(builder, word_count >= 3 && (word_count - 3) % 2 == 0 && (word_count - 3) / 2 + 1 <= 64);
+			SOFT_IR_REQUIRE(builder, SoftIRComponents(builder, w[1]) == 1);
+			uint32_t cases_count = (word_count - 3) / 2;
+			SOFT_IR_EMIT(builder, SOFT_IR_OP_SWITCH, 4 + cases_count * 2, SoftIRRegister(builder, w[1]));
+			SoftIREmitBranchTarget(builder, w[2], pending, &pending_count);
+			for(uint32_t i = 0; i < cases_count; i++)
+			{
+				SOFT_IR_EMIT(builder, w[3 + i * 2]);
+				SoftIREmitBranchTarget(builder, w[4 + i * 2], pending, &pending_count);
+			}
+			SoftIREmitPendingEdges(builder, current_label, pending, pending_count);
+			break;
+		}
+
+		default: break;
+	}
+}
+
+static void SoftIRLower(SoftIRBuilder* builder, const uint32_t* code, size_t words_count)
+{
+	uint32_t current_label = SOFT_IR_NONE;
+	for(size_t i = 5; i < words_count && !builder->failed;)
+	{
+		const uint32_t* w = code + i;
+		uint32_t word_count = w[0] >> 16;
+		uint32_t opcode = w[0] & 0xFFFF;
+		i += word_count;
+
+		switch(opcode)
+		{
+			case SpvOpCapability:
+			case SpvOpExtension:
+			case SpvOpExtInstImport:
+			case SpvOpMemoryModel:
+			case SpvOpEntryPoint:
+			case SpvOpExecutionMode:
+			case SpvOpExecutionModeId:
+			case SpvOpSource:
+			case SpvOpSourceContinued:
+			case SpvOpSourceExtension:
+			case SpvOpName:
+			case SpvOpMemberName:
+			case SpvOpString:
+			case SpvOpModuleProcessed:
+			case SpvOpDecorate:
+			case SpvOpMemberDecorate:
+			case SpvOpDecorateString:
+			case SpvOpMemberDecorateString:
+			case SpvOpDecorationGroup:
+			case SpvOpGroupDecorate:
+			case SpvOpGroupMemberDecorate:
+				continue;
+
+			case SpvOpLine:
+			case SpvOpNoLine:
+				if(builder->current_function == SOFT_IR_NONE)
+					continue;
+				break;
+
+			case SpvOpExtInst:
+				if(builder->current_function == SOFT_IR_NONE && word_count >= 4 && w[3] < builder->bound && builder->ids[w[3]].import_kind == SOFT_IR_IMPORT_NON_SEMANTIC)
+					continue;
+				break;
+
+			case SpvOpTypeVoid:
+			case SpvOpTypeBool:
+			case SpvOpTypeInt:
+			case SpvOpTypeFloat:
+			case SpvOpTypeVector:
+			case SpvOpTypeMatrix:
+			case SpvOpTypeArray:
+			case SpvOpTypeRuntimeArray:
+			case SpvOpTypeStruct:
+			case SpvOpTypePointer:
+			case SpvOpTypeFunction:
+			case SpvOpTypeImage:
+				SoftIRLowerType(builder, w, word_count, opcode);
+				continue;
+
+			case SpvOpConstantTrue:
+			case SpvOpConstantFalse:
+			case SpvOpConstant:
+			case SpvOpConstantComposite:
+			case SpvOpConstantNull:
+			case SpvOpSpecConstantTrue:
+			case SpvOpSpecConstantFalse:
+			case SpvOpSpecConstant:
+			case SpvOpSpecConstantComposite:
+				SoftIRLowerConstant(builder, w, word_count, opcode);
+				continue;
+
+			case SpvOpUndef:
+				if(builder->current_function == SOFT_IR_NONE)
+					SoftIRLowerConstant(builder, w, word_count, opcode);
+				continue;
+
+			case SpvOpVariable:
+				if(builder->current_function == SOFT_IR_NONE)
+				{
+					SoftIRLowerVariable(builder, w, word_count);
+					continue;
+				}
+				break;
+
+			case SpvOpLabel: current_label = w[1]; break;
+			case SpvOpBranch:
+			case SpvOpBranchConditional:
+			case SpvOpSwitch:
+				SoftIRLowerBranch(builder, w, word_count, opcode, current_label);
+				continue;
+
+			default: break;
+		}
+
+		if(builder->current_function == SOFT_IR_NONE && opcode != SpvOpFunction)
+		{
+			builder->failed = true;
+			builder->unsupported_opcode = opcode;
+			break;
+		}
+		SoftIRLowerInstruction(builder, w, word_count, opcode);
+	}
+}
+
+static void SoftIRFinalize(SoftIRBuilder* builder)
+{
+	SoftIRProgram* program = builder->program;
+
+	// Entry prologue, private variables get their initializers back for every invocation
+	program->entry_pc = program->code_size;
+	for(uint32_t i = 0; i < builder->initializers_count; i++)
+		SoftIREmitStore(builder, builder->initializers[i].variable, builder->initializers[i].value);
+	SOFT_IR_EMIT(builder, SOFT_IR_OP_CALL);
+	SoftIREmitTarget(builder, builder->entry_function);
+	SOFT_IR_EMIT(builder, SOFT_IR_OP_HALT);
+
+	for(uint32_t i = 0; i < builder->fixups_count && !builder->failed; i++)
+	{
+		uint32_t pc = builder->ids[builder->fixups[i].id].pc;
+		SOFT_IR_REQUIRE(builder, pc != SOFT_IR_NONE);
+		program->code[builder->fixups[i].position] = pc;
+	}
+}
+
+SoftIRProgram* SoftLowerSpirv(PulseBackend backend, const uint32_t* code, size_t words_count, const char* entry_point)
+{
+	if(code == PULSE_NULLPTR || words_count < 5 || code[0] != SpvMagicNumber)
+		return PULSE_NULLPTR;
+
+	SoftIRBuilder builder = { 0 };
+	builder.backend = backend;
+	builder.bound = code[3];
+	builder.entry_function = SOFT_IR_NONE;
+	builder.current_function = SOFT_IR_NONE;
+	builder.unsupported_opcode = SOFT_IR_NONE;
+
+	builder.program = (SoftIRProgram*)calloc(1, sizeof(SoftIRProgram));
+	PULSE_CHECK_ALLOCATION_RETVAL(builder.program, PULSE_NULLPTR);
+	for(uint32_t i = 0; i < SOFT_IR_BUILTIN_MAX_ENUM; i++)
+		builder.program->builtin_offsets[i] = SOFT_IR_NONE;
+
+	builder.ids = (SoftIRId*)calloc(builder.bound, sizeof(SoftIRId));
+	if(builder.ids == PULSE_NULLPTR)
+	{
+		free(builder.program);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULLPTR;
+	}
+	for(uint32_t i = 0; i < builder.bound; i++)
+	{
+		builder.ids[i].reg = SOFT_IR_NONE;
+		builder.ids[i].pc = SOFT_IR_NONE;
+		builder.ids[i].builtin = SOFT_IR_NONE;
+		builder.ids[i].return_reg = SOFT_IR_NONE;
+	}
+
+	SoftIRCollect(&builder, code, words_count, entry_point);
+	if(!builder.failed)
+		SoftIRLower(&builder, code, words_count);
+	if(!builder.failed)
+		SoftIRFinalize(&builder);
+
+	if(builder.failed)
+	{
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
+		{
+			if(builder.unsupported_opcode != SOFT_IR_NONE)
+				PulseLogInfoFmt(backend, "(Soft) SPIR-V opcode %u is not supported by the bytecode executor, falling back to the interpreter", builder.unsupported_opcode);
+			else
+				PulseLogInfo(backend, "(Soft) SPIR-V module could not be lowered to the bytecode executor, falling back to the interpreter");
+		}
+		SoftDestroyIRProgram(builder.program);
+		builder.program = PULSE_NULLPTR;
+	}
+
+	free(builder.ids);
+	free(builder.members);
+	free(builder.member_decorations);
+	free(builder.phis);
+	free(builder.params);
+	free(builder.fixups);
+	free(builder.initializers);
+	return builder.program;
+}
+
+void SoftDestroyIRProgram(SoftIRProgram* program)
+{
+	if(program == PULSE_NULLPTR)
+		return;
+	free(program->code);
+	free(program->initial_registers);
+	free(program->copy_chunks);
+	free(program->copy_plans);
+	free(program->resources);
+	free(program);
+}
+
+bool SoftInitIRContext(const SoftIRProgram* program, SoftIRContext* context, uint32_t lanes_count)
+{
+	memset(context, 0, sizeof(SoftIRContext));
+	context->lanes_count = lanes_count;
+	context->private_memory_stride = (program->private_memory_size + 15) & ~15u;
+	context->registers = (SoftIRWord*)malloc(program->registers_count * lanes_count * sizeof(SoftIRWord) + 1);
+	context->private_memory = (uint8_t*)calloc(1, context->private_memory_stride * lanes_count + 1);
+	context->regions = (SoftIRRegion*)calloc(SOFT_IR_REGION_RESOURCES + program->resources_count, sizeof(SoftIRRegion));
+	context->call_stack = (uint32_t*)malloc(SOFT_IR_MAX_CALL_DEPTH * lanes_count * sizeof(uint32_t));
+	if(context->registers == PULSE_NULLPTR || context->private_memory == PULSE_NULLPTR || context->regions == PULSE_NULLPTR || context->call_stack == PULSE_NULLPTR)
+	{
+		SoftDestroyIRContext(context);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return false;
+	}
+	for(uint32_t i = 0; i < program->registers_count; i++)
+	{
+		for(uint32_t lane = 0; lane < lanes_count; lane++)
+			context->registers[i * lanes_count + lane] = program->initial_registers[i];
+	}
+	context->regions_count = SOFT_IR_REGION_RESOURCES + program->resources_count;
+	context->regions[SOFT_IR_REGION_PRIVATE].data = context->private_memory; // Lanes are offset by private_memory_stride
+	context->regions[SOFT_IR_REGION_PRIVATE].size = program->private_memory_size;
+	return true;
+}
+
+void SoftIRSetBuiltin(const SoftIRProgram* program, SoftIRContext* context, uint32_t lane, SoftIRBuiltin builtin, const uint32_t* values, uint32_t values_count)
+{
+	uint32_t offset = program->builtin_offsets[builtin];
+	if(offset == SOFT_IR_NONE)
+		return;
+	memcpy(context->private_memory + lane * context->private_memory_stride + offset, values, values_count * sizeof(uint32_t));
+}
+
+void SoftDestroyIRContext(SoftIRContext* context)
+{
+	free(context->registers);
+	free(context->private_memory);
+	free(context->regions);
+	free(context->call_stack);
+	memset(context, 0, sizeof(SoftIRContext));
+}
@@ -0,0 +1,204 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_IR_H_
+#define PULSE_SOFTWARE_IR_H_
+
+#include "Soft.h"
+
+// Pre-decoded form of a SPIR-V compute module.
+// Every result id is lowered to a fixed range of 32 bits registers, constants are
+// baked into the initial register file and memory is addressed through regions
+// (pointer = region index + byte offset) so that every access can be bounds checked.
+
+#define SOFT_IR_MAX_CALL_DEPTH 64
+#define SOFT_IR_MAX_LANES 16
+
+#define SOFT_IR_REGION_PRIVATE 0
+#define SOFT_IR_REGION_WORKGROUP 1
+#define SOFT_IR_REGION_RESOURCES 2
+
+// X(name, words count including the opcode, 0 means variable length)
+#define SOFT_IR_OPS(X) \
+	X(HALT, 1) \
+	X(MOV, 4) \
+	X(LOAD, 4) \
+	X(STORE, 4) \
+	X(LOAD_PLAN, 4) \
+	X(STORE_PLAN, 4) \
+	X(ACCESS_CHAIN, 0) \
+	X(ARRAY_LENGTH, 5) \
+	X(ATOMIC_LOAD, 4) X(ATOMIC_STORE, 4) X(ATOMIC_RMW, 6) X(ATOMIC_CMPXCHG, 7) \
+	X(IADD, 5) X(ISUB, 5) X(IMUL, 5) X(SDIV, 5) X(UDIV, 5) X(SREM, 5) X(SMOD, 5) X(UMOD, 5) \
+	X(FADD, 5) X(FSUB, 5) X(FMUL, 5) X(FDIV, 5) X(FREM, 5) X(FMOD, 5) \
+	X(FMUL_SCALAR, 5) \
+	X(FNEG, 4) X(SNEG, 4) X(NOT, 4) X(LNOT, 4) \
+	X(SHL, 5) X(SHR, 5) X(SAR, 5) X(AND, 5) X(OR, 5) X(XOR, 5) \
+	X(IEQ, 5) X(INE, 5) X(ULT, 5) X(ULE, 5) X(UGT, 5) X(UGE, 5) X(SLT, 5) X(SLE, 5) X(SGT, 5) X(SGE, 5) \
+	X(FOEQ, 5) X(FONE, 5) X(FOLT, 5) X(FOLE, 5) X(FOGT, 5) X(FOGE, 5) \
+	X(FUEQ, 5) X(FUNE, 5) X(FULT, 5) X(FULE, 5) X(FUGT, 5) X(FUGE, 5) \
+	X(ISNAN, 4) X(ISINF, 4) X(ANY, 4) X(ALL, 4) \
+	X(SELECT, 7) \
+	X(F2U, 4) X(F2S, 4) X(U2F, 4) X(S2F, 4) \
+	X(DOT, 5) \
+	X(MAT_TIMES_VEC, 6) X(VEC_TIMES_MAT, 6) X(MAT_TIMES_MAT, 7) X(TRANSPOSE, 5) X(OUTER_PRODUCT, 6) \
+	X(VEC_EXTRACT_DYN, 5) X(VEC_INSERT_DYN, 6) \
+	X(FABS, 4) X(SABS, 4) X(FSIGN, 4) X(SSIGN, 4) X(FLOOR, 4) X(CEIL, 4) X(TRUNC, 4) X(FRACT, 4) X(ROUND, 4) X(ROUND_EVEN, 4) \
+	X(SQRT, 4) X(RSQRT, 4) X(EXP, 4) X(EXP2, 4) X(LOG, 4) X(LOG2, 4) \
+	X(SIN, 4) X(COS, 4) X(TAN, 4) X(ASIN, 4) X(ACOS, 4) X(ATAN, 4) X(SINH, 4) X(COSH, 4) X(TANH, 4) \
+	X(POW, 5) X(ATAN2, 5) X(FMIN, 5) X(FMAX, 5) X(UMIN, 5) X(UMAX, 5) X(SMIN, 5) X(SMAX, 5) X(STEP, 5) \
+	X(FCLAMP, 6) X(UCLAMP, 6) X(SCLAMP, 6) X(FMIX, 6) X(FMA, 6) X(SMOOTHSTEP, 6) \
+	X(LENGTH, 4) X(DISTANCE, 5) X(NORMALIZE, 4) X(CROSS, 4) X(REFLECT, 5) \
+	X(IMAGE_READ, 6) X(IMAGE_WRITE, 6) X(IMAGE_SIZE, 4) \
+	X(JMP, 2) \
+	X(BR, 4) \
+	X(SWITCH, 0) \
+	X(CALL, 2) \
+	X(RET, 1) \
+	X(BARRIER, 1)
+
+// Atomics operate on 32 bits words, dst, pointer, value, function then memory order for ATOMIC_RMW
+// and dst, pointer, value, comparator, equal order then unequal order for ATOMIC_CMPXCHG
+typedef enum SoftIRAtomicFunction
+{
+	SOFT_IR_ATOMIC_EXCHANGE = 0,
+	SOFT_IR_ATOMIC_IADD,
+	SOFT_IR_ATOMIC_ISUB,
+	SOFT_IR_ATOMIC_SMIN,
+	SOFT_IR_ATOMIC_UMIN,
+	SOFT_IR_ATOMIC_SMAX,
+	SOFT_IR_ATOMIC_UMAX,
+	SOFT_IR_ATOMIC_AND,
+	SOFT_IR_ATOMIC_OR,
+	SOFT_IR_ATOMIC_XOR,
+
+	SOFT_IR_ATOMIC_MAX_ENUM
+} SoftIRAtomicFunction;
+
+// Already valid for the operation that uses it, loads never release and stores never acquire
+typedef enum SoftIRMemoryOrder
+{
+	SOFT_IR_MEMORY_ORDER_RELAXED = 0,
+	SOFT_IR_MEMORY_ORDER_ACQUIRE,
+	SOFT_IR_MEMORY_ORDER_RELEASE,
+	SOFT_IR_MEMORY_ORDER_ACQ_REL,
+	SOFT_IR_MEMORY_ORDER_SEQ_CST,
+
+	SOFT_IR_MEMORY_ORDER_MAX_ENUM
+} SoftIRMemoryOrder;
+
+#define SOFT_IR_OP_ENUM(name, words) SOFT_IR_OP_##name,
+
+typedef enum SoftIROp
+{
+	SOFT_IR_OPS(SOFT_IR_OP_ENUM)
+
+	SOFT_IR_OP_MAX_ENUM
+} SoftIROp;
+
+typedef enum SoftIRBuiltin
+{
+	SOFT_IR_BUILTIN_NUM_WORKGROUPS = 0,
+	SOFT_IR_BUILTIN_WORKGROUP_SIZE,
+	SOFT_IR_BUILTIN_WORKGROUP_ID,
+	SOFT_IR_BUILTIN_LOCAL_INVOCATION_ID,
+	SOFT_IR_BUILTIN_GLOBAL_INVOCATION_ID,
+	SOFT_IR_BUILTIN_LOCAL_INVOCATION_INDEX,
+
+	SOFT_IR_BUILTIN_MAX_ENUM
+} SoftIRBuiltin;
+
+typedef union SoftIRWord
+{
+	uint32_t u;
+	int32_t i;
+	float f;
+} SoftIRWord;
+
+typedef struct SoftIRRegion
+{
+	uint8_t* data;
+	uint32_t size;
+} SoftIRRegion;
+
+// Scattered copy between an explicitly laid out memory object and its packed register form
+typedef struct SoftIRCopyChunk
+{
+	uint32_t memory_offset;
+	uint32_t register_offset; // In bytes
+	uint32_t size;
+} SoftIRCopyChunk;
+
+typedef struct SoftIRCopyPlan
+{
+	uint32_t first_chunk;
+	uint32_t chunks_count;
+} SoftIRCopyPlan;
+
+typedef struct SoftIRResource
+{
+	uint32_t set;
+	uint32_t binding;
+	uint32_t storage_class;
+} SoftIRResource;
+
+typedef struct SoftIRProgram
+{
+	uint32_t* code;
+	uint32_t code_size;
+	uint32_t entry_pc;
+
+	SoftIRWord* initial_registers; // Constants and variable pointers, everything else is zero
+	uint32_t registers_count;
+
+	SoftIRCopyChunk* copy_chunks;
+	uint32_t copy_chunks_count;
+	SoftIRCopyPlan* copy_plans;
+	uint32_t copy_plans_count;
+
+	SoftIRResource* resources; // Region SOFT_IR_REGION_RESOURCES + i
+	uint32_t resources_count;
+
+	uint32_t private_memory_size;
+	uint32_t workgroup_memory_size;
+	uint32_t builtin_offsets[SOFT_IR_BUILTIN_MAX_ENUM]; // Offsets in private memory, UINT32_MAX when unused
+	uint32_t local_size[3];
+	uint32_t lowered_instructions_count; // Before SoftOptimizeIRProgram, 0 if it never ran
+	bool uses_control_barriers;
+} SoftIRProgram;
+
+// A context runs lanes_count invocations in lockstep, registers are stored structure of arrays
+// (register r of lane l lives at r * lanes_count + l) and each lane gets its own private memory block
+typedef struct SoftIRContext
+{
+	SoftIRWord* registers;
+	uint8_t* private_memory;
+	uint32_t private_memory_stride;
+	SoftIRRegion* regions; // Private, workgroup then one per program resource
+	uint32_t regions_count;
+	uint32_t* call_stack; // SOFT_IR_MAX_CALL_DEPTH entries per lane
+	uint32_t lanes_count;
+	uint64_t executed_instructions_count; // Accumulated by the executors over a dispatch, once per instruction and lane, then gathered by the queue thread
+} SoftIRContext;
+
+SoftIRProgram* SoftLowerSpirv(PulseBackend backend, const uint32_t* code, size_t words_count, const char* entry_point); // Returns NULL when the module uses something the IR does not cover
+void SoftDestroyIRProgram(SoftIRProgram* program);
+void SoftOptimizeIRProgram(SoftIRProgram* program); // Constant folding, load/store forwarding of private variables, inlining and dead code removal
+uint32_t SoftGetIRInstructionsCount(const SoftIRProgram* program);
+
+bool SoftInitIRContext(const SoftIRProgram* program, SoftIRContext* context, uint32_t lanes_count); // lanes_count is 1 or a width SoftIRSupportsLanesCount accepts
+void SoftIRSetBuiltin(const SoftIRProgram* program, SoftIRContext* context, uint32_t lane, SoftIRBuiltin builtin, const uint32_t* values, uint32_t values_count);
+void SoftIRExecute(const SoftIRProgram* program, SoftIRContext* context); // Scalar path, single lane contexts only
+void SoftIRExecuteLanes(const SoftIRProgram* program, SoftIRContext* context, uint32_t active_lanes_count); // Runs lanes [0, active_lanes_count) in lockstep
+void SoftDestroyIRContext(SoftIRContext* context);
+
+bool SoftIRSupportsLanesCount(uint32_t lanes_count); // Requires cpuinfo to be initialized
+
+#endif // PULSE_SOFTWARE_IR_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
@@ -0,0 +1,742 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <math.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <cpuinfo.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftIR.h"
+#include "SoftImage.h"
+#include "SoftWorkgroup.h"
+
+#if defined(PULSE_COMPILER_GCC) || defined(PULSE_COMPILER_CLANG)
+	#define SOFT_IR_COMPUTED_GOTO
+	#if defined(__x86_64__) || defined(__i386__)
+		#define SOFT_IR_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
+#ifndef SOFT_IR_TARGET
+	#define SOFT_IR_TARGET(isa)
+#endif
+
+// Out of bounds accesses never touch memory, loads read zeros and stores are dropped
+static inline uint8_t* SoftIRResolve(SoftIRContext* context, const SoftIRWord* pointer, uint64_t offset, uint64_t size)
+{
+	if(pointer[0].u >= context->regions_count)
+		return PULSE_NULLPTR;
+	const SoftIRRegion* region = &context->regions[pointer[0].u];
+	offset += pointer[1].u;
+	if(region->data == PULSE_NULLPTR || offset + size > region->size)
+		return PULSE_NULLPTR;
+	return region->data + offset;
+}
+
+// Image regions point to the SoftImage, NULL if nothing is bound
+static inline SoftImage* SoftIRImage(SoftIRContext* context, uint32_t region_index)
+{
+	if(region_index < SOFT_IR_REGION_RESOURCES || region_index >= context->regions_count)
+		return PULSE_NULLPTR;
+	return (SoftImage*)context->regions[region_index].data;
+}
+
+static const memory_order soft_ir_memory_orders[SOFT_IR_MEMORY_ORDER_MAX_ENUM] = {
+	memory_order_relaxed,
+	memory_order_acquire,
+	memory_order_release,
+	memory_order_acq_rel,
+	memory_order_seq_cst,
+};
+
+// Atomics need naturally aligned words, misaligned accesses are dropped like out of bounds ones
+static inline _Atomic uint32_t* SoftIRAtomicWord(uint8_t* memory)
+{
+	if(memory == PULSE_NULLPTR || ((uintptr_t)memory & (sizeof(uint32_t) - 1)) != 0)
+		return PULSE_NULLPTR;
+	return (_Atomic uint32_t*)memory;
+}
+
+static inline uint32_t SoftIRAtomicRMW(_Atomic uint32_t* word, uint32_t function, uint32_t value, uint32_t order)
+{
+	memory_order success = soft_ir_memory_orders[order];
+	switch(function)
+	{
+		case SOFT_IR_ATOMIC_EXCHANGE: return atomic_exchange_explicit(word, value, success);
+		case SOFT_IR_ATOMIC_IADD: return atomic_fetch_add_explicit(word, value, success);
+		case SOFT_IR_ATOMIC_ISUB: return atomic_fetch_sub_explicit(word, value, success);
+		case SOFT_IR_ATOMIC_AND: return atomic_fetch_and_explicit(word, value, success);
+		case SOFT_IR_ATOMIC_OR: return atomic_fetch_or_explicit(word, value, success);
+		case SOFT_IR_ATOMIC_XOR: return atomic_fetch_xor_explicit(word, value, success);
+		default: break;
+	}
+
+	// No fetch min or max in C11, a failed exchange reloads the current value
+	uint32_t current = atomic_load_explicit(word, memory_order_relaxed);
+	for(;;)
+	{
+		uint32_t desired = current;
+		switch(function)
+		{
+			case SOFT_IR_ATOMIC_SMIN: desired = (int32_t)value < (int32_t)current ? value : current; break;
+			case SOFT_IR_ATOMIC_UMIN: desired = value < current ? value : current; break;
+			case SOFT_IR_ATOMIC_SMAX: desired = (int32_t)value > (int32_t)current ? value : current; break;
+			case SOFT_IR_ATOMIC_UMAX: desired = value > current ? value : current; break;
+			default: break;
+		}
+		if(atomic_compare_exchange_weak_explicit(word, &current, desired, success, memory_order_relaxed))
+			return current;
+	}
+}
+
+static inline uint32_t SoftIRAtomicCompareExchange(_Atomic uint32_t* word, uint32_t value, uint32_t comparator, uint32_t equal_order, uint32_t unequal_order)
+{
+	atomic_compare_exchange_strong_explicit(word, &comparator, value, soft_ir_memory_orders[equal_order], soft_ir_memory_orders[unequal_order]);
+	return comparator;
+}
+
+static inline uint32_t SoftIRFloatToUint(float f)
+{
+	if(!(f > -1.0f))
+		return 0;
+	if(f >= 4294967296.0f)
+		return UINT32_MAX;
+	return (uint32_t)f;
+}
+
+static inline int32_t SoftIRFloatToInt(float f)
+{
+	if(isnan(f))
+		return 0;
+	if(f <= -2147483648.0f)
+		return INT32_MIN;
+	if(f >= 2147483648.0f)
+		return INT32_MAX;
+	return (int32_t)f;
+}
+
+static inline float SoftIRFloatSign(float f)
+{
+	return (float)((f > 0.0f) - (f < 0.0f));
+}
+
+static inline float SoftIRSmoothStep(float edge0, float edge1, float x)
+{
+	float t = (x - edge0) / (edge1 - edge0);
+	t = fminf(fmaxf(t, 0.0f), 1.0f);
+	return t * t * (3.0f - 2.0f * t);
+}
+
+#define SOFT_IR_REG(i) (&registers[code[pc + (i)]])
+
+#ifdef SOFT_IR_COMPUTED_GOTO
+	#define SOFT_IR_CASE(name) soft_ir_op_##name:
+	#define SOFT_IR_NEXT(words) do { pc += (words); executed++; goto *soft_ir_labels[code[pc]]; } while(0)
+	#define SOFT_IR_JUMP(target) do { pc = (target); executed++; goto *soft_ir_labels[code[pc]]; } while(0)
+#else
+	#define SOFT_IR_CASE(name) case SOFT_IR_OP_##name:
+	#define SOFT_IR_NEXT(words) do { pc += (words); executed++; goto soft_ir_dispatch; } while(0)
+	#define SOFT_IR_JUMP(target) do { pc = (target); executed++; goto soft_ir_dispatch; } while(0)
+#endif
+
+#define SOFT_IR_UNARY(name, expression) \
+	SOFT_IR_CASE(name) \
+	{ \
+		SoftIRWord* d = SOFT_IR_REG(1); \
+		const SoftIRWord* a = SOFT_IR_REG(2); \
+		for(uint32_t k = 0, n = code[pc + 3]; k < n; k++) \
+			expression; \
+		SOFT_IR_NEXT(4); \
+	}
+
+#define SOFT_IR_BINARY(name, expression) \
+	SOFT_IR_CASE(name) \
+	{ \
+		SoftIRWord* d = SOFT_IR_REG(1); \
+		const SoftIRWord* a = SOFT_IR_REG(2); \
+		const SoftIRWord* b = SOFT_IR_REG(3); \
+		for(uint32_t k = 0, n = code[pc + 4]; k < n; k++) \
+			expression; \
+		SOFT_IR_NEXT(5); \
+	}
+
+#define SOFT_IR_TERNARY(name, expression) \
+	SOFT_IR_CASE(name) \
+	{ \
+		SoftIRWord* d = SOFT_IR_REG(1); \
+		const SoftIRWord* a = SOFT_IR_REG(2); \
+		const SoftIRWord* b = SOFT_IR_REG(3); \
+		const SoftIRWord* c = SOFT_IR_REG(4); \
+		for(uint32_t k = 0, n = code[pc + 5]; k < n; k++) \
+			expression; \
+		SOFT_IR_NEXT(6); \
+	}
+
+void SoftIRExecute(const SoftIRProgram* program, SoftIRContext* context)
+{
+	const uint32_t* code = program->code;
+	SoftIRWord* registers = context->registers;
+	uint32_t pc = program->entry_pc;
+	uint32_t depth = 0;
+	uint64_t executed = 1;
+
+	#ifdef SOFT_IR_COMPUTED_GOTO
+		#define SOFT_IR_LABEL(name, words) &&soft_ir_op_##name,
+		static const void* const soft_ir_labels[] = { SOFT_IR_OPS(SOFT_IR_LABEL) };
+		#undef SOFT_IR_LABEL
+		goto *soft_ir_labels[code[pc]];
+	#else
+		soft_ir_dispatch:
+		switch(code[pc])
+	#endif
+	{
+		SOFT_IR_CASE(HALT) goto soft_ir_exit;
+
+		SOFT_IR_CASE(MOV)
+		{
+			memmove(SOFT_IR_REG(1), SOFT_IR_REG(2), code[pc + 3] * sizeof(SoftIRWord));
+			SOFT_IR_NEXT(4);
+		}
+
+		SOFT_IR_CASE(LOAD)
+		{
+			uint8_t* memory = SoftIRResolve(context, SOFT_IR_REG(2), 0, code[pc + 3]);
+			if(memory != PULSE_NULLPTR)
+				memcpy(SOFT_IR_REG(1), memory, code[pc + 3]);
+			else
+				memset(SOFT_IR_REG(1), 0, code[pc + 3]);
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(STORE)
+		{
+			uint8_t* memory = SoftIRResolve(context, SOFT_IR_REG(1), 0, code[pc + 3]);
+			if(memory != PULSE_NULLPTR)
+				memcpy(memory, SOFT_IR_REG(2), code[pc + 3]);
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(LOAD_PLAN)
+		{
+			const SoftIRCopyPlan* plan = &program->copy_plans[code[pc + 3]];
+			uint8_t* destination = (uint8_t*)SOFT_IR_REG(1);
+			for(uint32_t i = 0; i < plan->chunks_count; i++)
+			{
+				const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+				uint8_t* memory = SoftIRResolve(context, SOFT_IR_REG(2), chunk->memory_offset, chunk->size);
+				if(memory != PULSE_NULLPTR)
+					memcpy(destination + chunk->register_offset, memory, chunk->size);
+				else
+					memset(destination + chunk->register_offset, 0, chunk->size);
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(STORE_PLAN)
+		{
+			const SoftIRCopyPlan* plan = &program->copy_plans[code[pc + 3]];
+			const uint8_t* source = (const uint8_t*)SOFT_IR_REG(2);
+			for(uint32_t i = 0; i < plan->chunks_count; i++)
+			{
+				const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+				uint8_t* memory = SoftIRResolve(context, SOFT_IR_REG(1), chunk->memory_offset, chunk->size);
+				if(memory != PULSE_NULLPTR)
+					memcpy(memory, source + chunk->register_offset, chunk->size);
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ACCESS_CHAIN)
+		{
+			SoftIRWord* d = SOFT_IR_REG(2);
+			const SoftIRWord* base = SOFT_IR_REG(3);
+			uint32_t offset = base[1].u + code[pc + 4];
+			for(uint32_t i = 0; i < code[pc + 5]; i++)
+				offset += registers[code[pc + 6 + i * 2]].u * code[pc + 7 + i * 2];
+			d[0].u = base[0].u;
+			d[1].u = offset;
+			SOFT_IR_NEXT(code[pc + 1]);
+		}
+		SOFT_IR_CASE(ARRAY_LENGTH)
+		{
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			uint64_t start = (uint64_t)pointer[1].u + code[pc + 3];
+			uint32_t size = pointer[0].u < context->regions_count ? context->regions[pointer[0].u].size : 0;
+			SOFT_IR_REG(1)->u = start < size ? (uint32_t)((size - start) / code[pc + 4]) : 0;
+			SOFT_IR_NEXT(5);
+		}
+
+		SOFT_IR_CASE(ATOMIC_LOAD)
+		{
+			_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolve(context, SOFT_IR_REG(2), 0, sizeof(uint32_t)));
+			SOFT_IR_REG(1)->u = word != PULSE_NULLPTR ? atomic_load_explicit(word, soft_ir_memory_orders[code[pc + 3]]) : 0;
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ATOMIC_STORE)
+		{
+			_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolve(context, SOFT_IR_REG(1), 0, sizeof(uint32_t)));
+			if(word != PULSE_NULLPTR)
+				atomic_store_explicit(word, SOFT_IR_REG(2)->u, soft_ir_memory_orders[code[pc + 3]]);
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ATOMIC_RMW)
+		{
+			_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolve(context, SOFT_IR_REG(2), 0, sizeof(uint32_t)));
+			SOFT_IR_REG(1)->u = word != PULSE_NULLPTR ? SoftIRAtomicRMW(word, code[pc + 4], SOFT_IR_REG(3)->u, code[pc + 5]) : 0;
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(ATOMIC_CMPXCHG)
+		{
+			_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolve(context, SOFT_IR_REG(2), 0, sizeof(uint32_t)));
+			SOFT_IR_REG(1)->u = word != PULSE_NULLPTR ? SoftIRAtomicCompareExchange(word, SOFT_IR_REG(3)->u, SOFT_IR_REG(4)->u, code[pc + 5], code[pc + 6]) : 0;
+			SOFT_IR_NEXT(7);
+		}
+
+		SOFT_IR_CASE(IMAGE_READ)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftImage* image = SoftIRImage(context, SOFT_IR_REG(2)->u);
+			const SoftIRWord* coords = SOFT_IR_REG(3);
+			uint32_t texel_coords[3] = { 0 };
+			uint32_t values[4] = { 0 };
+			for(uint32_t k = 0; k < code[pc + 4]; k++)
+				texel_coords[k] = coords[k].u;
+			if(image != PULSE_NULLPTR)
+				SoftReadImageTexel(image, texel_coords, values);
+			for(uint32_t k = 0; k < code[pc + 5]; k++)
+				d[k].u = values[k];
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(IMAGE_WRITE)
+		{
+			SoftImage* image = SoftIRImage(context, SOFT_IR_REG(1)->u);
+			const SoftIRWord* coords = SOFT_IR_REG(2);
+			const SoftIRWord* texel = SOFT_IR_REG(4);
+			uint32_t texel_coords[3] = { 0 };
+			uint32_t values[4] = { 0 };
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				texel_coords[k] = coords[k].u;
+			for(uint32_t k = 0; k < code[pc + 5]; k++)
+				values[k] = texel[k].u;
+			if(image != PULSE_NULLPTR)
+				SoftWriteImageTexel(image, texel_coords, values);
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(IMAGE_SIZE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftImage* image = SoftIRImage(context, SOFT_IR_REG(2)->u);
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				d[k].u = image != PULSE_NULLPTR ? image->query_size[k] : 0;
+			SOFT_IR_NEXT(4);
+		}
+
+		SOFT_IR_BINARY(IADD, d[k].u = a[k].u + b[k].u)
+		SOFT_IR_BINARY(ISUB, d[k].u = a[k].u - b[k].u)
+		SOFT_IR_BINARY(IMUL, d[k].u = a[k].u * b[k].u)
+		SOFT_IR_BINARY(SDIV, d[k].i = (b[k].i == 0 || (a[k].i == INT32_MIN && b[k].i == -1)) ? 0 : a[k].i / b[k].i)
+		SOFT_IR_BINARY(UDIV, d[k].u = b[k].u == 0 ? 0 : a[k].u / b[k].u)
+		SOFT_IR_BINARY(SREM, d[k].i = (b[k].i == 0 || b[k].i == -1) ? 0 : a[k].i % b[k].i)
+		SOFT_IR_BINARY(SMOD, { int32_t r = (b[k].i == 0 || b[k].i == -1) ? 0 : a[k].i % b[k].i; d[k].i = (r != 0 && ((r < 0) != (b[k].i < 0))) ? r + b[k].i : r; })
+		SOFT_IR_BINARY(UMOD, d[k].u = b[k].u == 0 ? 0 : a[k].u % b[k].u)
+
+		SOFT_IR_BINARY(FADD, d[k].f = a[k].f + b[k].f)
+		SOFT_IR_BINARY(FSUB, d[k].f = a[k].f - b[k].f)
+		SOFT_IR_BINARY(FMUL, d[k].f = a[k].f * b[k].f)
+		SOFT_IR_BINARY(FDIV, d[k].f = a[k].f / b[k].f)
+		SOFT_IR_BINARY(FREM, d[k].f = fmodf(a[k].f, b[k].f))
+		SOFT_IR_BINARY(FMOD, d[k].f = a[k].f - b[k].f * floorf(a[k].f / b[k].f))
+		SOFT_IR_BINARY(FMUL_SCALAR, d[k].f = a[k].f * b[0].f)
+
+		SOFT_IR_UNARY(FNEG, d[k].f = -a[k].f)
+		SOFT_IR_UNARY(SNEG, d[k].u = 0u - a[k].u)
+		SOFT_IR_UNARY(NOT, d[k].u = ~a[k].u)
+		SOFT_IR_UNARY(LNOT, d[k].u = !a[k].u)
+
+		SOFT_IR_BINARY(SHL, d[k].u = a[k].u << (b[k].u & 31))
+		SOFT_IR_BINARY(SHR, d[k].u = a[k].u >> (b[k].u & 31))
+		SOFT_IR_BINARY(SAR, d[k].u = a[k].i < 0 ? ~(~a[k].u >> (b[k].u & 31)) : a[k].u >> (b[k].u & 31))
+		SOFT_IR_BINARY(AND, d[k].u = a[k].u & b[k].u)
+		SOFT_IR_BINARY(OR, d[k].u = a[k].u | b[k].u)
+		SOFT_IR_BINARY(XOR, d[k].u = a[k].u ^ b[k].u)
+
+		SOFT_IR_BINARY(IEQ, d[k].u = a[k].u == b[k].u)
+		SOFT_IR_BINARY(INE, d[k].u = a[k].u != b[k].u)
+		SOFT_IR_BINARY(ULT, d[k].u = a[k].u < b[k].u)
+		SOFT_IR_BINARY(ULE, d[k].u = a[k].u <= b[k].u)
+		SOFT_IR_BINARY(UGT, d[k].u = a[k].u > b[k].u)
+		SOFT_IR_BINARY(UGE, d[k].u = a[k].u >= b[k].u)
+		SOFT_IR_BINARY(SLT, d[k].u = a[k].i < b[k].i)
+		SOFT_IR_BINARY(SLE, d[k].u = a[k].i <= b[k].i)
+		SOFT_IR_BINARY(SGT, d[k].u = a[k].i > b[k].i)
+		SOFT_IR_BINARY(SGE, d[k].u = a[k].i >= b[k].i)
+
+		SOFT_IR_BINARY(FOEQ, d[k].u = a[k].f == b[k].f)
+		SOFT_IR_BINARY(FONE, d[k].u = a[k].f < b[k].f || a[k].f > b[k].f)
+		SOFT_IR_BINARY(FOLT, d[k].u = a[k].f < b[k].f)
+		SOFT_IR_BINARY(FOLE, d[k].u = a[k].f <= b[k].f)
+		SOFT_IR_BINARY(FOGT, d[k].u = a[k].f > b[k].f)
+		SOFT_IR_BINARY(FOGE, d[k].u = a[k].f >= b[k].f)
+		SOFT_IR_BINARY(FUEQ, d[k].u = !(a[k].f < b[k].f || a[k].f > b[k].f))
+		SOFT_IR_BINARY(FUNE, d[k].u = a[k].f != b[k].f)
+		SOFT_IR_BINARY(FULT, d[k].u = !(a[k].f >= b[k].f))
+		SOFT_IR_BINARY(FULE, d[k].u = !(a[k].f > b[k].f))
+		SOFT_IR_BINARY(FUGT, d[k].u = !(a[k].f <= b[k].f))
+		SOFT_IR_BINARY(FUGE, d[k].u = !(a[k].f < b[k].f))
+
+		SOFT_IR_UNARY(ISNAN, d[k].u = isnan(a[k].f) != 0)
+		SOFT_IR_UNARY(ISINF, d[k].u = isinf(a[k].f) != 0)
+
+		SOFT_IR_CASE(ANY)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			uint32_t result = 0;
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				result |= a[k].u;
+			SOFT_IR_REG(1)->u = result != 0;
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ALL)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			uint32_t result = 1;
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				result &= a[k].u != 0;
+			SOFT_IR_REG(1)->u = result;
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(SELECT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* condition = SOFT_IR_REG(2);
+			const SoftIRWord* a = SOFT_IR_REG(3);
+			const SoftIRWord* b = SOFT_IR_REG(4);
+			uint32_t condition_step = code[pc + 6];
+			for(uint32_t k = 0; k < code[pc + 5]; k++)
+				d[k] = condition[k * condition_step].u ? a[k] : b[k];
+			SOFT_IR_NEXT(7);
+		}
+
+		SOFT_IR_UNARY(F2U, d[k].u = SoftIRFloatToUint(a[k].f))
+		SOFT_IR_UNARY(F2S, d[k].i = SoftIRFloatToInt(a[k].f))
+		SOFT_IR_UNARY(U2F, d[k].f = (float)a[k].u)
+		SOFT_IR_UNARY(S2F, d[k].f = (float)a[k].i)
+
+		SOFT_IR_CASE(DOT)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			float result = 0.0f;
+			for(uint32_t k = 0; k < code[pc + 4]; k++)
+				result += a[k].f * b[k].f;
+			SOFT_IR_REG(1)->f = result;
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(MAT_TIMES_VEC)
+		{
+			const SoftIRWord* m = SOFT_IR_REG(2);
+			const SoftIRWord* v = SOFT_IR_REG(3);
+			uint32_t columns = code[pc + 4];
+			uint32_t rows = code[pc + 5];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			for(uint32_t r = 0; r < rows; r++)
+			{
+				float result = 0.0f;
+				for(uint32_t c = 0; c < columns; c++)
+					result += m[c * rows + r].f * v[c].f;
+				d[r].f = result;
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(VEC_TIMES_MAT)
+		{
+			const SoftIRWord* v = SOFT_IR_REG(2);
+			const SoftIRWord* m = SOFT_IR_REG(3);
+			uint32_t columns = code[pc + 4];
+			uint32_t rows = code[pc + 5];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			for(uint32_t c = 0; c < columns; c++)
+			{
+				float result = 0.0f;
+				for(uint32_t r = 0; r < rows; r++)
+					result += v[r].f * m[c * rows + r].f;
+				d[c].f = result;
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(MAT_TIMES_MAT)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			uint32_t a_rows = code[pc + 4];
+			uint32_t a_columns = code[pc + 5];
+			uint32_t b_columns = code[pc + 6];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			for(uint32_t c = 0; c < b_columns; c++)
+			{
+				for(uint32_t r = 0; r < a_rows; r++)
+				{
+					float result = 0.0f;
+					for(uint32_t k = 0; k < a_columns; k++)
+						result += a[k * a_rows + r].f * b[c * a_columns + k].f;
+					d[c * a_rows + r].f = result;
+				}
+			}
+			SOFT_IR_NEXT(7);
+		}
+		SOFT_IR_CASE(TRANSPOSE)
+		{
+			const SoftIRWord* m = SOFT_IR_REG(2);
+			uint32_t columns = code[pc + 3];
+			uint32_t rows = code[pc + 4];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			for(uint32_t c = 0; c < columns; c++)
+			{
+				for(uint32_t r = 0; r < rows; r++)
+					d[r * columns + c] = m[c * rows + r];
+			}
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(OUTER_PRODUCT)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			uint32_t rows = code[pc + 4];
+			uint32_t columns = code[pc + 5];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			for(uint32_t c = 0; c < columns; c++)
+			{
+				for(uint32_t r = 0; r < rows; r++)
+					d[c * rows + r].f = a[r].f * b[c].f;
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(VEC_EXTRACT_DYN)
+		{
+			uint32_t index = SOFT_IR_REG(3)->u;
+			SOFT_IR_REG(1)->u = index < code[pc + 4] ? SOFT_IR_REG(2)[index].u : 0;
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(VEC_INSERT_DYN)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			uint32_t index = SOFT_IR_REG(4)->u;
+			memmove(d, SOFT_IR_REG(2), code[pc + 5] * sizeof(SoftIRWord));
+			if(index < code[pc + 5])
+				d[index] = *SOFT_IR_REG(3);
+			SOFT_IR_NEXT(6);
+		}
+
+		SOFT_IR_UNARY(FABS, d[k].f = fabsf(a[k].f))
+		SOFT_IR_UNARY(SABS, d[k].u = a[k].i < 0 ? 0u - a[k].u : a[k].u)
+		SOFT_IR_UNARY(FSIGN, d[k].f = SoftIRFloatSign(a[k].f))
+		SOFT_IR_UNARY(SSIGN, d[k].i = (a[k].i > 0) - (a[k].i < 0))
+		SOFT_IR_UNARY(FLOOR, d[k].f = floorf(a[k].f))
+		SOFT_IR_UNARY(CEIL, d[k].f = ceilf(a[k].f))
+		SOFT_IR_UNARY(TRUNC, d[k].f = truncf(a[k].f))
+		SOFT_IR_UNARY(FRACT, d[k].f = a[k].f - floorf(a[k].f))
+		SOFT_IR_UNARY(ROUND, d[k].f = roundf(a[k].f))
+		SOFT_IR_UNARY(ROUND_EVEN, d[k].f = nearbyintf(a[k].f))
+		SOFT_IR_UNARY(SQRT, d[k].f = sqrtf(a[k].f))
+		SOFT_IR_UNARY(RSQRT, d[k].f = 1.0f / sqrtf(a[k].f))
+		SOFT_IR_UNARY(EXP, d[k].f = expf(a[k].f))
+		SOFT_IR_UNARY(EXP2, d[k].f = exp2f(a[k].f))
+		SOFT_IR_UNARY(LOG, d[k].f = logf(a[k].f))
+		SOFT_IR_UNARY(LOG2, d[k].f = log2f(a[k].f))
+		SOFT_IR_UNARY(SIN, d[k].f = sinf(a[k].f))
+		SOFT_IR_UNARY(COS, d[k].f = cosf(a[k].f))
+		SOFT_IR_UNARY(TAN, d[k].f = tanf(a[k].f))
+		SOFT_IR_UNARY(ASIN, d[k].f = asinf(a[k].f))
+		SOFT_IR_UNARY(ACOS, d[k].f = acosf(a[k].f))
+		SOFT_IR_UNARY(ATAN, d[k].f = atanf(a[k].f))
+		SOFT_IR_UNARY(SINH, d[k].f = sinhf(a[k].f))
+		SOFT_IR_UNARY(COSH, d[k].f = coshf(a[k].f))
+		SOFT_IR_UNARY(TANH, d[k].f = tanhf(a[k].f))
+
+		SOFT_IR_BINARY(POW, d[k].f = powf(a[k].f, b[k].f))
+		SOFT_IR_BINARY(ATAN2, d[k].f = atan2f(a[k].f, b[k].f))
+		SOFT_IR_BINARY(FMIN, d[k].f = fminf(a[k].f, b[k].f))
+		SOFT_IR_BINARY(FMAX, d[k].f = fmaxf(a[k].f, b[k].f))
+		SOFT_IR_BINARY(UMIN, d[k].u = a[k].u < b[k].u ? a[k].u : b[k].u)
+		SOFT_IR_BINARY(UMAX, d[k].u = a[k].u > b[k].u ? a[k].u : b[k].u)
+		SOFT_IR_BINARY(SMIN, d[k].i = a[k].i < b[k].i ? a[k].i : b[k].i)
+		SOFT_IR_BINARY(SMAX, d[k].i = a[k].i > b[k].i ? a[k].i : b[k].i)
+		SOFT_IR_BINARY(STEP, d[k].f = b[k].f < a[k].f ? 0.0f : 1.0f)
+
+		SOFT_IR_TERNARY(FCLAMP, d[k].f = fminf(fmaxf(a[k].f, b[k].f), c[k].f))
+		SOFT_IR_TERNARY(UCLAMP, { uint32_t v = a[k].u < b[k].u ? b[k].u : a[k].u; d[k].u = v > c[k].u ? c[k].u : v; })
+		SOFT_IR_TERNARY(SCLAMP, { int32_t v = a[k].i < b[k].i ? b[k].i : a[k].i; d[k].i = v > c[k].i ? c[k].i : v; })
+		SOFT_IR_TERNARY(FMIX, d[k].f = a[k].f * (1.0f - c[k].f) + b[k].f * c[k].f)
+		SOFT_IR_TERNARY(FMA, d[k].f = fmaf(a[k].f, b[k].f, c[k].f))
+		SOFT_IR_TERNARY(SMOOTHSTEP, d[k].f = SoftIRSmoothStep(a[k].f, b[k].f, c[k].f))
+
+		SOFT_IR_CASE(LENGTH)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			float result = 0.0f;
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				result += a[k].f * a[k].f;
+			SOFT_IR_REG(1)->f = sqrtf(result);
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(DISTANCE)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			float result = 0.0f;
+			for(uint32_t k = 0; k < code[pc + 4]; k++)
+				result += (a[k].f - b[k].f) * (a[k].f - b[k].f);
+			SOFT_IR_REG(1)->f = sqrtf(result);
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(NORMALIZE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			float length = 0.0f;
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				length += a[k].f * a[k].f;
+			length = sqrtf(length);
+			for(uint32_t k = 0; k < code[pc + 3]; k++)
+				d[k].f = a[k].f / length;
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(CROSS)
+		{
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			float x = a[1].f * b[2].f - a[2].f * b[1].f;
+			float y = a[2].f * b[0].f - a[0].f * b[2].f;
+			float z = a[0].f * b[1].f - a[1].f * b[0].f;
+			SoftIRWord* d = SOFT_IR_REG(1);
+			d[0].f = x;
+			d[1].f = y;
+			d[2].f = z;
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(REFLECT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* incident = SOFT_IR_REG(2);
+			const SoftIRWord* normal = SOFT_IR_REG(3);
+			float dot = 0.0f;
+			for(uint32_t k = 0; k < code[pc + 4]; k++)
+				dot += incident[k].f * normal[k].f;
+			for(uint32_t k = 0; k < code[pc + 4]; k++)
+				d[k].f = incident[k].f - 2.0f * dot * normal[k].f;
+			SOFT_IR_NEXT(5);
+		}
+
+		SOFT_IR_CASE(JMP) SOFT_IR_JUMP(code[pc + 1]);
+		SOFT_IR_CASE(BR) SOFT_IR_JUMP(SOFT_IR_REG(1)->u ? code[pc + 2] : code[pc + 3]);
+		SOFT_IR_CASE(SWITCH)
+		{
+			uint32_t selector = SOFT_IR_REG(2)->u;
+			uint32_t target = code[pc + 3];
+			for(uint32_t i = pc + 4; i + 1 < pc + code[pc + 1]; i += 2)
+			{
+				if(code[i] == selector)
+				{
+					target = code[i + 1];
+					break;
+				}
+			}
+			SOFT_IR_JUMP(target);
+		}
+		SOFT_IR_CASE(CALL)
+		{
+			if(depth == SOFT_IR_MAX_CALL_DEPTH)
+				goto soft_ir_exit;
+			context->call_stack[depth++] = pc + 2;
+			SOFT_IR_JUMP(code[pc + 1]);
+		}
+		SOFT_IR_CASE(RET)
+		{
+			if(depth == 0)
+				goto soft_ir_exit;
+			SOFT_IR_JUMP(context->call_stack[--depth]);
+		}
+		SOFT_IR_CASE(BARRIER)
+		{
+			SoftWorkgroupBarrier(SoftGetCurrentWorkgroup());
+			SOFT_IR_NEXT(1);
+		}
+
+		#ifndef SOFT_IR_COMPUTED_GOTO
+			default: goto soft_ir_exit;
+		#endif
+	}
+
+soft_ir_exit:
+	context->executed_instructions_count += executed;
+}
+
+#undef SOFT_IR_REG
+#undef SOFT_IR_CASE
+#undef SOFT_IR_NEXT
+#undef SOFT_IR_JUMP
+#undef SOFT_IR_UNARY
+#undef SOFT_IR_BINARY
+#undef SOFT_IR_TERNARY
+
+static inline uint8_t* SoftIRResolveLane(SoftIRContext* context, uint32_t region_index, uint32_t pointer_offset, uint64_t offset, uint64_t size, uint32_t lane)
+{
+	if(region_index >= context->regions_count)
+		return PULSE_NULLPTR;
+	const SoftIRRegion* region = &context->regions[region_index];
+	offset += pointer_offset;
+	if(region->data == PULSE_NULLPTR || offset + size > region->size)
+		return PULSE_NULLPTR;
+	if(region_index == SOFT_IR_REGION_PRIVATE)
+		return region->data + lane * context->private_memory_stride + offset;
+	return region->data + offset;
+}
+
+#define SOFT_IR_LANES 4
+#define SOFT_IR_LANES_FUNCTION SoftIRExecuteLanes4
+#define SOFT_IR_LANES_TARGET
+#include "SoftIRExecutorLanes.inl"
+#undef SOFT_IR_LANES
+#undef SOFT_IR_LANES_FUNCTION
+#undef SOFT_IR_LANES_TARGET
+
+#define SOFT_IR_LANES 8
+#define SOFT_IR_LANES_FUNCTION SoftIRExecuteLanes8
+#define SOFT_IR_LANES_TARGET SOFT_IR_TARGET("avx2")
+#include "SoftIRExecutorLanes.inl"
+#undef SOFT_IR_LANES
+#undef SOFT_IR_LANES_FUNCTION
+#undef SOFT_IR_LANES_TARGET
+
+#define SOFT_IR_LANES 16
+#define SOFT_IR_LANES_FUNCTION SoftIRExecuteLanes16
+#define SOFT_IR_LANES_TARGET SOFT_IR_TARGET("avx512f")
+#include "SoftIRExecutorLanes.inl"
+#undef SOFT_IR_LANES
+#undef SOFT_IR_LANES_FUNCTION
+#undef SOFT_IR_LANES_TARGET
+
+void SoftIRExecuteLanes(const SoftIRProgram* program, SoftIRContext* context, uint32_t active_lanes_count)
+{
+	switch(context->lanes_count)
+	{
+		case 4: SoftIRExecuteLanes4(program, context, active_lanes_count); break;
+		case 8: SoftIRExecuteLanes8(program, context, active_lanes_count); break;
+		case 16: SoftIRExecuteLanes16(program, context, active_lanes_count); break;
+
+		default: SoftIRExecute(program, context); break;
+	}
+}
+
+bool SoftIRSupportsLanesCount(uint32_t lanes_count)
+{
+	switch(lanes_count)
+	{
+		case 1: return true;
+		case 4: return cpuinfo_has_x86_sse2() || cpuinfo_has_arm_neon();
+		case 8: return cpuinfo_has_x86_avx2();
+		case 16: return cpuinfo_has_x86_avx512f();
+
+		default: return false;
+	}
+}
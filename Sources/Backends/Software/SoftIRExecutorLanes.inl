@@ -0,0 +1,784 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+// Lockstep executor body, included once per lanes count by SoftIRExecutorSIMD.c with
+// SOFT_IR_LANES, SOFT_IR_LANES_FUNCTION and SOFT_IR_LANES_TARGET defined.
+// Lanes that diverge keep their own program counter, the group that runs is always made of
+// the lanes sitting on the lowest one so that they meet again at merge blocks.
+
+#define L SOFT_IR_LANES
+#define SOFT_IR_FULL_MASK ((uint32_t)((1ull << L) - 1))
+
+#define SOFT_IR_REG(i) (&registers[code[pc + (i)] * L])
+#define SOFT_IR_FOR_EACH_LANE(lane) for(uint32_t lane = 0; lane < L; lane++) if(mask & (1u << lane))
+
+#define SOFT_IR_SCHEDULE() goto soft_ir_schedule
+
+#ifdef SOFT_IR_COMPUTED_GOTO
+	#define SOFT_IR_CASE(name) soft_ir_op_##name:
+	#define SOFT_IR_NEXT(words) do { pc += (words); executed += group_size; goto *soft_ir_labels[code[pc]]; } while(0)
+#else
+	#define SOFT_IR_CASE(name) case SOFT_IR_OP_##name:
+	#define SOFT_IR_NEXT(words) do { pc += (words); executed += group_size; goto soft_ir_dispatch; } while(0)
+#endif
+
+// Uniform jump of the whole group, waiting lanes may be sitting on the target
+#define SOFT_IR_GROUP_JUMP(target) \
+	do { \
+		pc = (target); \
+		if(mask == active) \
+			SOFT_IR_NEXT(0); \
+		SOFT_IR_FOR_EACH_LANE(lane) \
+			lane_pc[lane] = pc; \
+		SOFT_IR_SCHEDULE(); \
+	} while(0)
+
+// Elementwise ops work on whole SoA rows so that they vectorize, masked out lanes keep their old value
+#define SOFT_IR_ELEMENTWISE(words, components_word, expression) \
+	{ \
+		SoftIRWord* d = SOFT_IR_REG(1); \
+		const SoftIRWord* a = SOFT_IR_REG(2); \
+		const SoftIRWord* b = SOFT_IR_REG((words) > 4 ? 3 : 2); \
+		const SoftIRWord* c = SOFT_IR_REG((words) > 5 ? 4 : 2); \
+		(void)b; \
+		(void)c; \
+		uint32_t count = code[pc + (components_word)] * L; \
+		if(mask == SOFT_IR_FULL_MASK) \
+		{ \
+			for(uint32_t i = 0; i < count; i++) \
+			{ \
+				SoftIRWord t; \
+				expression; \
+				d[i] = t; \
+			} \
+		} \
+		else \
+		{ \
+			for(uint32_t i = 0; i < count; i++) \
+			{ \
+				SoftIRWord t; \
+				expression; \
+				d[i].u = (t.u & lane_mask[i % L]) | (d[i].u & ~lane_mask[i % L]); \
+			} \
+		} \
+		SOFT_IR_NEXT(words); \
+	}
+
+#define SOFT_IR_UNARY(name, expression) SOFT_IR_CASE(name) SOFT_IR_ELEMENTWISE(4, 3, expression)
+#define SOFT_IR_BINARY(name, expression) SOFT_IR_CASE(name) SOFT_IR_ELEMENTWISE(5, 4, expression)
+#define SOFT_IR_TERNARY(name, expression) SOFT_IR_CASE(name) SOFT_IR_ELEMENTWISE(6, 5, expression)
+
+// Component k of a register for the current lane
+#define SOFT_IR_AT(base, k) ((base)[(k) * L + lane])
+
+SOFT_IR_LANES_TARGET static void SOFT_IR_LANES_FUNCTION(const SoftIRProgram* program, SoftIRContext* context, uint32_t active_lanes_count)
+{
+	const uint32_t* code = program->code;
+	SoftIRWord* registers = context->registers;
+	uint32_t lane_pc[L];
+	uint32_t lane_depth[L];
+	uint32_t lane_mask[L];
+	uint32_t active = active_lanes_count >= L ? SOFT_IR_FULL_MASK : (uint32_t)((1u << active_lanes_count) - 1);
+	uint32_t mask = active;
+	uint32_t pc = program->entry_pc;
+	uint32_t group_size = 0; // Lanes in mask, instructions are counted once per lane that runs them
+
+	for(uint32_t lane = 0; lane < L; lane++)
+	{
+		lane_pc[lane] = pc;
+		lane_depth[lane] = 0;
+		lane_mask[lane] = (mask & (1u << lane)) ? UINT32_MAX : 0;
+		group_size += (mask >> lane) & 1u;
+	}
+	uint64_t executed = group_size;
+
+	#ifdef SOFT_IR_COMPUTED_GOTO
+		#define SOFT_IR_LABEL(name, words) &&soft_ir_op_##name,
+		static const void* const soft_ir_labels[] = { SOFT_IR_OPS(SOFT_IR_LABEL) };
+		#undef SOFT_IR_LABEL
+		goto *soft_ir_labels[code[pc]];
+	#else
+		soft_ir_dispatch:
+		switch(code[pc])
+	#endif
+	{
+		SOFT_IR_CASE(HALT)
+		{
+			active &= ~mask;
+			SOFT_IR_SCHEDULE();
+		}
+
+		SOFT_IR_CASE(MOV) SOFT_IR_ELEMENTWISE(4, 3, t = a[i])
+
+		SOFT_IR_CASE(LOAD)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			uint32_t words = code[pc + 3] / sizeof(uint32_t);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				const uint8_t* memory = SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, code[pc + 3], lane);
+				for(uint32_t k = 0; k < words; k++)
+				{
+					if(memory != PULSE_NULLPTR)
+						memcpy(&SOFT_IR_AT(d, k), memory + k * sizeof(uint32_t), sizeof(uint32_t));
+					else
+						SOFT_IR_AT(d, k).u = 0;
+				}
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(STORE)
+		{
+			const SoftIRWord* pointer = SOFT_IR_REG(1);
+			const SoftIRWord* source = SOFT_IR_REG(2);
+			uint32_t words = code[pc + 3] / sizeof(uint32_t);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint8_t* memory = SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, code[pc + 3], lane);
+				if(memory == PULSE_NULLPTR)
+					continue;
+				for(uint32_t k = 0; k < words; k++)
+					memcpy(memory + k * sizeof(uint32_t), &SOFT_IR_AT(source, k), sizeof(uint32_t));
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(LOAD_PLAN)
+		{
+			const SoftIRCopyPlan* plan = &program->copy_plans[code[pc + 3]];
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t i = 0; i < plan->chunks_count; i++)
+				{
+					const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+					const uint8_t* memory = SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, chunk->memory_offset, chunk->size, lane);
+					uint32_t first = chunk->register_offset / sizeof(uint32_t);
+					for(uint32_t k = 0; k < chunk->size / sizeof(uint32_t); k++)
+					{
+						if(memory != PULSE_NULLPTR)
+							memcpy(&SOFT_IR_AT(d, first + k), memory + k * sizeof(uint32_t), sizeof(uint32_t));
+						else
+							SOFT_IR_AT(d, first + k).u = 0;
+					}
+				}
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(STORE_PLAN)
+		{
+			const SoftIRCopyPlan* plan = &program->copy_plans[code[pc + 3]];
+			const SoftIRWord* pointer = SOFT_IR_REG(1);
+			const SoftIRWord* source = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t i = 0; i < plan->chunks_count; i++)
+				{
+					const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+					uint8_t* memory = SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, chunk->memory_offset, chunk->size, lane);
+					if(memory == PULSE_NULLPTR)
+						continue;
+					uint32_t first = chunk->register_offset / sizeof(uint32_t);
+					for(uint32_t k = 0; k < chunk->size / sizeof(uint32_t); k++)
+						memcpy(memory + k * sizeof(uint32_t), &SOFT_IR_AT(source, first + k), sizeof(uint32_t));
+				}
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ACCESS_CHAIN)
+		{
+			SoftIRWord* d = SOFT_IR_REG(2);
+			const SoftIRWord* base = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t offset = SOFT_IR_AT(base, 1).u + code[pc + 4];
+				for(uint32_t i = 0; i < code[pc + 5]; i++)
+					offset += registers[code[pc + 6 + i * 2] * L + lane].u * code[pc + 7 + i * 2];
+				SOFT_IR_AT(d, 0).u = SOFT_IR_AT(base, 0).u;
+				SOFT_IR_AT(d, 1).u = offset;
+			}
+			SOFT_IR_NEXT(code[pc + 1]);
+		}
+		SOFT_IR_CASE(ARRAY_LENGTH)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t region = SOFT_IR_AT(pointer, 0).u;
+				uint64_t start = (uint64_t)SOFT_IR_AT(pointer, 1).u + code[pc + 3];
+				uint32_t size = region < context->regions_count ? context->regions[region].size : 0;
+				SOFT_IR_AT(d, 0).u = start < size ? (uint32_t)((size - start) / code[pc + 4]) : 0;
+			}
+			SOFT_IR_NEXT(5);
+		}
+
+		// Lanes run their atomics in order, as if they were separate invocations
+		SOFT_IR_CASE(ATOMIC_LOAD)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			memory_order order = soft_ir_memory_orders[code[pc + 3]];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, sizeof(uint32_t), lane));
+				SOFT_IR_AT(d, 0).u = word != PULSE_NULLPTR ? atomic_load_explicit(word, order) : 0;
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ATOMIC_STORE)
+		{
+			const SoftIRWord* pointer = SOFT_IR_REG(1);
+			const SoftIRWord* value = SOFT_IR_REG(2);
+			memory_order order = soft_ir_memory_orders[code[pc + 3]];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, sizeof(uint32_t), lane));
+				if(word != PULSE_NULLPTR)
+					atomic_store_explicit(word, SOFT_IR_AT(value, 0).u, order);
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ATOMIC_RMW)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			const SoftIRWord* value = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, sizeof(uint32_t), lane));
+				SOFT_IR_AT(d, 0).u = word != PULSE_NULLPTR ? SoftIRAtomicRMW(word, code[pc + 4], SOFT_IR_AT(value, 0).u, code[pc + 5]) : 0;
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(ATOMIC_CMPXCHG)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* pointer = SOFT_IR_REG(2);
+			const SoftIRWord* value = SOFT_IR_REG(3);
+			const SoftIRWord* comparator = SOFT_IR_REG(4);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				_Atomic uint32_t* word = SoftIRAtomicWord(SoftIRResolveLane(context, SOFT_IR_AT(pointer, 0).u, SOFT_IR_AT(pointer, 1).u, 0, sizeof(uint32_t), lane));
+				SOFT_IR_AT(d, 0).u = word != PULSE_NULLPTR ? SoftIRAtomicCompareExchange(word, SOFT_IR_AT(value, 0).u, SOFT_IR_AT(comparator, 0).u, code[pc + 5], code[pc + 6]) : 0;
+			}
+			SOFT_IR_NEXT(7);
+		}
+
+		SOFT_IR_CASE(IMAGE_READ)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* image_region = SOFT_IR_REG(2);
+			const SoftIRWord* coords = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				const SoftImage* image = SoftIRImage(context, SOFT_IR_AT(image_region, 0).u);
+				uint32_t texel_coords[3] = { 0 };
+				uint32_t values[4] = { 0 };
+				for(uint32_t k = 0; k < code[pc + 4]; k++)
+					texel_coords[k] = SOFT_IR_AT(coords, k).u;
+				if(image != PULSE_NULLPTR)
+					SoftReadImageTexel(image, texel_coords, values);
+				for(uint32_t k = 0; k < code[pc + 5]; k++)
+					SOFT_IR_AT(d, k).u = values[k];
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(IMAGE_WRITE)
+		{
+			const SoftIRWord* image_region = SOFT_IR_REG(1);
+			const SoftIRWord* coords = SOFT_IR_REG(2);
+			const SoftIRWord* texel = SOFT_IR_REG(4);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				SoftImage* image = SoftIRImage(context, SOFT_IR_AT(image_region, 0).u);
+				if(image == PULSE_NULLPTR)
+					continue;
+				uint32_t texel_coords[3] = { 0 };
+				uint32_t values[4] = { 0 };
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					texel_coords[k] = SOFT_IR_AT(coords, k).u;
+				for(uint32_t k = 0; k < code[pc + 5]; k++)
+					values[k] = SOFT_IR_AT(texel, k).u;
+				SoftWriteImageTexel(image, texel_coords, values);
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(IMAGE_SIZE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* image_region = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				const SoftImage* image = SoftIRImage(context, SOFT_IR_AT(image_region, 0).u);
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					SOFT_IR_AT(d, k).u = image != PULSE_NULLPTR ? image->query_size[k] : 0;
+			}
+			SOFT_IR_NEXT(4);
+		}
+
+		SOFT_IR_BINARY(IADD, t.u = a[i].u + b[i].u)
+		SOFT_IR_BINARY(ISUB, t.u = a[i].u - b[i].u)
+		SOFT_IR_BINARY(IMUL, t.u = a[i].u * b[i].u)
+		SOFT_IR_BINARY(SDIV, t.i = (b[i].i == 0 || (a[i].i == INT32_MIN && b[i].i == -1)) ? 0 : a[i].i / b[i].i)
+		SOFT_IR_BINARY(UDIV, t.u = b[i].u == 0 ? 0 : a[i].u / b[i].u)
+		SOFT_IR_BINARY(SREM, t.i = (b[i].i == 0 || b[i].i == -1) ? 0 : a[i].i % b[i].i)
+		SOFT_IR_BINARY(SMOD, { int32_t r = (b[i].i == 0 || b[i].i == -1) ? 0 : a[i].i % b[i].i; t.i = (r != 0 && ((r < 0) != (b[i].i < 0))) ? r + b[i].i : r; })
+		SOFT_IR_BINARY(UMOD, t.u = b[i].u == 0 ? 0 : a[i].u % b[i].u)
+
+		SOFT_IR_BINARY(FADD, t.f = a[i].f + b[i].f)
+		SOFT_IR_BINARY(FSUB, t.f = a[i].f - b[i].f)
+		SOFT_IR_BINARY(FMUL, t.f = a[i].f * b[i].f)
+		SOFT_IR_BINARY(FDIV, t.f = a[i].f / b[i].f)
+		SOFT_IR_BINARY(FREM, t.f = fmodf(a[i].f, b[i].f))
+		SOFT_IR_BINARY(FMOD, t.f = a[i].f - b[i].f * floorf(a[i].f / b[i].f))
+		SOFT_IR_BINARY(FMUL_SCALAR, t.f = a[i].f * b[i % L].f)
+
+		SOFT_IR_UNARY(FNEG, t.f = -a[i].f)
+		SOFT_IR_UNARY(SNEG, t.u = 0u - a[i].u)
+		SOFT_IR_UNARY(NOT, t.u = ~a[i].u)
+		SOFT_IR_UNARY(LNOT, t.u = !a[i].u)
+
+		SOFT_IR_BINARY(SHL, t.u = a[i].u << (b[i].u & 31))
+		SOFT_IR_BINARY(SHR, t.u = a[i].u >> (b[i].u & 31))
+		SOFT_IR_BINARY(SAR, t.u = a[i].i < 0 ? ~(~a[i].u >> (b[i].u & 31)) : a[i].u >> (b[i].u & 31))
+		SOFT_IR_BINARY(AND, t.u = a[i].u & b[i].u)
+		SOFT_IR_BINARY(OR, t.u = a[i].u | b[i].u)
+		SOFT_IR_BINARY(XOR, t.u = a[i].u ^ b[i].u)
+
+		SOFT_IR_BINARY(IEQ, t.u = a[i].u == b[i].u)
+		SOFT_IR_BINARY(INE, t.u = a[i].u != b[i].u)
+		SOFT_IR_BINARY(ULT, t.u = a[i].u < b[i].u)
+		SOFT_IR_BINARY(ULE, t.u = a[i].u <= b[i].u)
+		SOFT_IR_BINARY(UGT, t.u = a[i].u > b[i].u)
+		SOFT_IR_BINARY(UGE, t.u = a[i].u >= b[i].u)
+		SOFT_IR_BINARY(SLT, t.u = a[i].i < b[i].i)
+		SOFT_IR_BINARY(SLE, t.u = a[i].i <= b[i].i)
+		SOFT_IR_BINARY(SGT, t.u = a[i].i > b[i].i)
+		SOFT_IR_BINARY(SGE, t.u = a[i].i >= b[i].i)
+
+		SOFT_IR_BINARY(FOEQ, t.u = a[i].f == b[i].f)
+		SOFT_IR_BINARY(FONE, t.u = a[i].f < b[i].f || a[i].f > b[i].f)
+		SOFT_IR_BINARY(FOLT, t.u = a[i].f < b[i].f)
+		SOFT_IR_BINARY(FOLE, t.u = a[i].f <= b[i].f)
+		SOFT_IR_BINARY(FOGT, t.u = a[i].f > b[i].f)
+		SOFT_IR_BINARY(FOGE, t.u = a[i].f >= b[i].f)
+		SOFT_IR_BINARY(FUEQ, t.u = !(a[i].f < b[i].f || a[i].f > b[i].f))
+		SOFT_IR_BINARY(FUNE, t.u = a[i].f != b[i].f)
+		SOFT_IR_BINARY(FULT, t.u = !(a[i].f >= b[i].f))
+		SOFT_IR_BINARY(FULE, t.u = !(a[i].f > b[i].f))
+		SOFT_IR_BINARY(FUGT, t.u = !(a[i].f <= b[i].f))
+		SOFT_IR_BINARY(FUGE, t.u = !(a[i].f < b[i].f))
+
+		SOFT_IR_UNARY(ISNAN, t.u = isnan(a[i].f) != 0)
+		SOFT_IR_UNARY(ISINF, t.u = isinf(a[i].f) != 0)
+
+		SOFT_IR_CASE(ANY)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t result = 0;
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					result |= SOFT_IR_AT(a, k).u;
+				SOFT_IR_AT(d, 0).u = result != 0;
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(ALL)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t result = 1;
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					result &= SOFT_IR_AT(a, k).u != 0;
+				SOFT_IR_AT(d, 0).u = result;
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(SELECT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* condition = SOFT_IR_REG(2);
+			const SoftIRWord* a = SOFT_IR_REG(3);
+			const SoftIRWord* b = SOFT_IR_REG(4);
+			uint32_t condition_step = code[pc + 6];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t k = 0; k < code[pc + 5]; k++)
+					SOFT_IR_AT(d, k) = SOFT_IR_AT(condition, k * condition_step).u ? SOFT_IR_AT(a, k) : SOFT_IR_AT(b, k);
+			}
+			SOFT_IR_NEXT(7);
+		}
+
+		SOFT_IR_UNARY(F2U, t.u = SoftIRFloatToUint(a[i].f))
+		SOFT_IR_UNARY(F2S, t.i = SoftIRFloatToInt(a[i].f))
+		SOFT_IR_UNARY(U2F, t.f = (float)a[i].u)
+		SOFT_IR_UNARY(S2F, t.f = (float)a[i].i)
+
+		SOFT_IR_CASE(DOT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float result = 0.0f;
+				for(uint32_t k = 0; k < code[pc + 4]; k++)
+					result += SOFT_IR_AT(a, k).f * SOFT_IR_AT(b, k).f;
+				SOFT_IR_AT(d, 0).f = result;
+			}
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(MAT_TIMES_VEC)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* m = SOFT_IR_REG(2);
+			const SoftIRWord* v = SOFT_IR_REG(3);
+			uint32_t columns = code[pc + 4];
+			uint32_t rows = code[pc + 5];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t r = 0; r < rows; r++)
+				{
+					float result = 0.0f;
+					for(uint32_t col = 0; col < columns; col++)
+						result += SOFT_IR_AT(m, col * rows + r).f * SOFT_IR_AT(v, col).f;
+					SOFT_IR_AT(d, r).f = result;
+				}
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(VEC_TIMES_MAT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* v = SOFT_IR_REG(2);
+			const SoftIRWord* m = SOFT_IR_REG(3);
+			uint32_t columns = code[pc + 4];
+			uint32_t rows = code[pc + 5];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t col = 0; col < columns; col++)
+				{
+					float result = 0.0f;
+					for(uint32_t r = 0; r < rows; r++)
+						result += SOFT_IR_AT(v, r).f * SOFT_IR_AT(m, col * rows + r).f;
+					SOFT_IR_AT(d, col).f = result;
+				}
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(MAT_TIMES_MAT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			uint32_t a_rows = code[pc + 4];
+			uint32_t a_columns = code[pc + 5];
+			uint32_t b_columns = code[pc + 6];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t col = 0; col < b_columns; col++)
+				{
+					for(uint32_t r = 0; r < a_rows; r++)
+					{
+						float result = 0.0f;
+						for(uint32_t k = 0; k < a_columns; k++)
+							result += SOFT_IR_AT(a, k * a_rows + r).f * SOFT_IR_AT(b, col * a_columns + k).f;
+						SOFT_IR_AT(d, col * a_rows + r).f = result;
+					}
+				}
+			}
+			SOFT_IR_NEXT(7);
+		}
+		SOFT_IR_CASE(TRANSPOSE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* m = SOFT_IR_REG(2);
+			uint32_t columns = code[pc + 3];
+			uint32_t rows = code[pc + 4];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t col = 0; col < columns; col++)
+				{
+					for(uint32_t r = 0; r < rows; r++)
+						SOFT_IR_AT(d, r * columns + col) = SOFT_IR_AT(m, col * rows + r);
+				}
+			}
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(OUTER_PRODUCT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			uint32_t rows = code[pc + 4];
+			uint32_t columns = code[pc + 5];
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				for(uint32_t col = 0; col < columns; col++)
+				{
+					for(uint32_t r = 0; r < rows; r++)
+						SOFT_IR_AT(d, col * rows + r).f = SOFT_IR_AT(a, r).f * SOFT_IR_AT(b, col).f;
+				}
+			}
+			SOFT_IR_NEXT(6);
+		}
+		SOFT_IR_CASE(VEC_EXTRACT_DYN)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* vector = SOFT_IR_REG(2);
+			const SoftIRWord* index = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t k = SOFT_IR_AT(index, 0).u;
+				SOFT_IR_AT(d, 0).u = k < code[pc + 4] ? SOFT_IR_AT(vector, k).u : 0;
+			}
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(VEC_INSERT_DYN)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* vector = SOFT_IR_REG(2);
+			const SoftIRWord* component = SOFT_IR_REG(3);
+			const SoftIRWord* index = SOFT_IR_REG(4);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t target = SOFT_IR_AT(index, 0).u;
+				for(uint32_t k = 0; k < code[pc + 5]; k++)
+					SOFT_IR_AT(d, k) = k == target ? SOFT_IR_AT(component, 0) : SOFT_IR_AT(vector, k);
+			}
+			SOFT_IR_NEXT(6);
+		}
+
+		SOFT_IR_UNARY(FABS, t.f = fabsf(a[i].f))
+		SOFT_IR_UNARY(SABS, t.u = a[i].i < 0 ? 0u - a[i].u : a[i].u)
+		SOFT_IR_UNARY(FSIGN, t.f = SoftIRFloatSign(a[i].f))
+		SOFT_IR_UNARY(SSIGN, t.i = (a[i].i > 0) - (a[i].i < 0))
+		SOFT_IR_UNARY(FLOOR, t.f = floorf(a[i].f))
+		SOFT_IR_UNARY(CEIL, t.f = ceilf(a[i].f))
+		SOFT_IR_UNARY(TRUNC, t.f = truncf(a[i].f))
+		SOFT_IR_UNARY(FRACT, t.f = a[i].f - floorf(a[i].f))
+		SOFT_IR_UNARY(ROUND, t.f = roundf(a[i].f))
+		SOFT_IR_UNARY(ROUND_EVEN, t.f = nearbyintf(a[i].f))
+		SOFT_IR_UNARY(SQRT, t.f = sqrtf(a[i].f))
+		SOFT_IR_UNARY(RSQRT, t.f = 1.0f / sqrtf(a[i].f))
+		SOFT_IR_UNARY(EXP, t.f = expf(a[i].f))
+		SOFT_IR_UNARY(EXP2, t.f = exp2f(a[i].f))
+		SOFT_IR_UNARY(LOG, t.f = logf(a[i].f))
+		SOFT_IR_UNARY(LOG2, t.f = log2f(a[i].f))
+		SOFT_IR_UNARY(SIN, t.f = sinf(a[i].f))
+		SOFT_IR_UNARY(COS, t.f = cosf(a[i].f))
+		SOFT_IR_UNARY(TAN, t.f = tanf(a[i].f))
+		SOFT_IR_UNARY(ASIN, t.f = asinf(a[i].f))
+		SOFT_IR_UNARY(ACOS, t.f = acosf(a[i].f))
+		SOFT_IR_UNARY(ATAN, t.f = atanf(a[i].f))
+		SOFT_IR_UNARY(SINH, t.f = sinhf(a[i].f))
+		SOFT_IR_UNARY(COSH, t.f = coshf(a[i].f))
+		SOFT_IR_UNARY(TANH, t.f = tanhf(a[i].f))
+
+		SOFT_IR_BINARY(POW, t.f = powf(a[i].f, b[i].f))
+		SOFT_IR_BINARY(ATAN2, t.f = atan2f(a[i].f, b[i].f))
+		SOFT_IR_BINARY(FMIN, t.f = fminf(a[i].f, b[i].f))
+		SOFT_IR_BINARY(FMAX, t.f = fmaxf(a[i].f, b[i].f))
+		SOFT_IR_BINARY(UMIN, t.u = a[i].u < b[i].u ? a[i].u : b[i].u)
+		SOFT_IR_BINARY(UMAX, t.u = a[i].u > b[i].u ? a[i].u : b[i].u)
+		SOFT_IR_BINARY(SMIN, t.i = a[i].i < b[i].i ? a[i].i : b[i].i)
+		SOFT_IR_BINARY(SMAX, t.i = a[i].i > b[i].i ? a[i].i : b[i].i)
+		SOFT_IR_BINARY(STEP, t.f = b[i].f < a[i].f ? 0.0f : 1.0f)
+
+		SOFT_IR_TERNARY(FCLAMP, t.f = fminf(fmaxf(a[i].f, b[i].f), c[i].f))
+		SOFT_IR_TERNARY(UCLAMP, { uint32_t v = a[i].u < b[i].u ? b[i].u : a[i].u; t.u = v > c[i].u ? c[i].u : v; })
+		SOFT_IR_TERNARY(SCLAMP, { int32_t v = a[i].i < b[i].i ? b[i].i : a[i].i; t.i = v > c[i].i ? c[i].i : v; })
+		SOFT_IR_TERNARY(FMIX, t.f = a[i].f * (1.0f - c[i].f) + b[i].f * c[i].f)
+		SOFT_IR_TERNARY(FMA, t.f = fmaf(a[i].f, b[i].f, c[i].f))
+		SOFT_IR_TERNARY(SMOOTHSTEP, t.f = SoftIRSmoothStep(a[i].f, b[i].f, c[i].f))
+
+		SOFT_IR_CASE(LENGTH)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float result = 0.0f;
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					result += SOFT_IR_AT(a, k).f * SOFT_IR_AT(a, k).f;
+				SOFT_IR_AT(d, 0).f = sqrtf(result);
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(DISTANCE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float result = 0.0f;
+				for(uint32_t k = 0; k < code[pc + 4]; k++)
+					result += (SOFT_IR_AT(a, k).f - SOFT_IR_AT(b, k).f) * (SOFT_IR_AT(a, k).f - SOFT_IR_AT(b, k).f);
+				SOFT_IR_AT(d, 0).f = sqrtf(result);
+			}
+			SOFT_IR_NEXT(5);
+		}
+		SOFT_IR_CASE(NORMALIZE)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float length = 0.0f;
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					length += SOFT_IR_AT(a, k).f * SOFT_IR_AT(a, k).f;
+				length = sqrtf(length);
+				for(uint32_t k = 0; k < code[pc + 3]; k++)
+					SOFT_IR_AT(d, k).f = SOFT_IR_AT(a, k).f / length;
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(CROSS)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* a = SOFT_IR_REG(2);
+			const SoftIRWord* b = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float x = SOFT_IR_AT(a, 1).f * SOFT_IR_AT(b, 2).f - SOFT_IR_AT(a, 2).f * SOFT_IR_AT(b, 1).f;
+				float y = SOFT_IR_AT(a, 2).f * SOFT_IR_AT(b, 0).f - SOFT_IR_AT(a, 0).f * SOFT_IR_AT(b, 2).f;
+				float z = SOFT_IR_AT(a, 0).f * SOFT_IR_AT(b, 1).f - SOFT_IR_AT(a, 1).f * SOFT_IR_AT(b, 0).f;
+				SOFT_IR_AT(d, 0).f = x;
+				SOFT_IR_AT(d, 1).f = y;
+				SOFT_IR_AT(d, 2).f = z;
+			}
+			SOFT_IR_NEXT(4);
+		}
+		SOFT_IR_CASE(REFLECT)
+		{
+			SoftIRWord* d = SOFT_IR_REG(1);
+			const SoftIRWord* incident = SOFT_IR_REG(2);
+			const SoftIRWord* normal = SOFT_IR_REG(3);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				float dot = 0.0f;
+				for(uint32_t k = 0; k < code[pc + 4]; k++)
+					dot += SOFT_IR_AT(incident, k).f * SOFT_IR_AT(normal, k).f;
+				for(uint32_t k = 0; k < code[pc + 4]; k++)
+					SOFT_IR_AT(d, k).f = SOFT_IR_AT(incident, k).f - 2.0f * dot * SOFT_IR_AT(normal, k).f;
+			}
+			SOFT_IR_NEXT(5);
+		}
+
+		SOFT_IR_CASE(JMP) SOFT_IR_GROUP_JUMP(code[pc + 1]);
+		SOFT_IR_CASE(BR)
+		{
+			const SoftIRWord* condition = SOFT_IR_REG(1);
+			uint32_t taken = 0;
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				if(SOFT_IR_AT(condition, 0).u)
+					taken |= 1u << lane;
+			}
+			if(taken == mask)
+				SOFT_IR_GROUP_JUMP(code[pc + 2]);
+			if(taken == 0)
+				SOFT_IR_GROUP_JUMP(code[pc + 3]);
+			SOFT_IR_FOR_EACH_LANE(lane)
+				lane_pc[lane] = (taken & (1u << lane)) ? code[pc + 2] : code[pc + 3];
+			SOFT_IR_SCHEDULE();
+		}
+		SOFT_IR_CASE(SWITCH)
+		{
+			const SoftIRWord* selector = SOFT_IR_REG(2);
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				uint32_t target = code[pc + 3];
+				for(uint32_t i = pc + 4; i + 1 < pc + code[pc + 1]; i += 2)
+				{
+					if(code[i] == SOFT_IR_AT(selector, 0).u)
+					{
+						target = code[i + 1];
+						break;
+					}
+				}
+				lane_pc[lane] = target;
+			}
+			SOFT_IR_SCHEDULE();
+		}
+		SOFT_IR_CASE(CALL)
+		{
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				if(lane_depth[lane] == SOFT_IR_MAX_CALL_DEPTH)
+				{
+					active &= ~(1u << lane);
+					continue;
+				}
+				context->call_stack[lane * SOFT_IR_MAX_CALL_DEPTH + lane_depth[lane]++] = pc + 2;
+				lane_pc[lane] = code[pc + 1];
+			}
+			SOFT_IR_SCHEDULE();
+		}
+		SOFT_IR_CASE(RET)
+		{
+			SOFT_IR_FOR_EACH_LANE(lane)
+			{
+				if(lane_depth[lane] == 0)
+					active &= ~(1u << lane);
+				else
+					lane_pc[lane] = context->call_stack[lane * SOFT_IR_MAX_CALL_DEPTH + --lane_depth[lane]];
+			}
+			SOFT_IR_SCHEDULE();
+		}
+		SOFT_IR_CASE(BARRIER)
+		{
+			SoftWorkgroupBarrier(SoftGetCurrentWorkgroup());
+			SOFT_IR_NEXT(1);
+		}
+
+		#ifndef SOFT_IR_COMPUTED_GOTO
+			default: active = 0; break;
+		#endif
+	}
+
+soft_ir_schedule:
+	if(active == 0)
+	{
+		context->executed_instructions_count += executed;
+		return;
+	}
+	pc = UINT32_MAX;
+	for(uint32_t lane = 0; lane < L; lane++)
+	{
+		if((active & (1u << lane)) && lane_pc[lane] < pc)
+			pc = lane_pc[lane];
+	}
+	mask = 0;
+	group_size = 0;
+	for(uint32_t lane = 0; lane < L; lane++)
+	{
+		bool in_group = (active & (1u << lane)) && lane_pc[lane] == pc;
+		mask |= in_group ? 1u << lane : 0;
+		lane_mask[lane] = in_group ? UINT32_MAX : 0;
+		group_size += in_group;
+	}
+	SOFT_IR_NEXT(0);
+}
+
+#undef L
+#undef SOFT_IR_FULL_MASK
+#undef SOFT_IR_REG
+#undef SOFT_IR_FOR_EACH_LANE
+#undef SOFT_IR_SCHEDULE
+#undef SOFT_IR_CASE
+#undef SOFT_IR_NEXT
+#undef SOFT_IR_GROUP_JUMP
+#undef SOFT_IR_ELEMENTWISE
+#undef SOFT_IR_UNARY
+#undef SOFT_IR_BINARY
+#undef SOFT_IR_TERNARY
+#undef SOFT_IR_AT
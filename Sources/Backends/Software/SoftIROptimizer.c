@@ -0,0 +1,1220 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftIR.h"
+
+// Clean up of the lowered bytecode, shader compilers running without optimisations keep every
+// local in memory and every helper behind a call, all of which would otherwise be paid per invocation.
+// Registers that no instruction writes are constants, instructions are only marked as removed
+// (or rewritten in place to an instruction of the same size) until the code is rebuilt.
+
+#define SOFT_IR_NONE UINT32_MAX
+#define SOFT_IR_MANY (UINT32_MAX - 1)
+#define SOFT_IR_MAX_OPERANDS 40
+#define SOFT_IR_MAX_AVAILABLE_VALUES 32
+#define SOFT_IR_INLINE_MAX_WORDS 256 // Callees with more than one call site are only inlined below this size
+#define SOFT_IR_MAX_PASSES 8
+
+#define SOFT_IR_OPTIMIZER_WORDS(name, words) words,
+static const uint32_t soft_ir_optimizer_words[] = { SOFT_IR_OPS(SOFT_IR_OPTIMIZER_WORDS) };
+#undef SOFT_IR_OPTIMIZER_WORDS
+
+typedef struct SoftIROperand
+{
+	uint32_t reg;
+	uint32_t count;
+	uint32_t word; // Position in the instruction
+	bool written;
+} SoftIROperand;
+
+// Code positions holding jump targets, [begin, end) by step
+typedef struct SoftIRTargets
+{
+	uint32_t begin;
+	uint32_t end;
+	uint32_t step;
+} SoftIRTargets;
+
+typedef struct SoftIROptimizer
+{
+	SoftIRProgram* program;
+	uint32_t* starts; // Instruction pcs in code order
+	uint32_t* indices; // Instruction index of every code word that starts one
+	bool* removed;
+	bool* leaders; // Instructions that can be reached from somewhere else than the previous one
+	uint32_t instructions_count;
+	uint32_t* writes; // Per register, number of live instructions writing it
+	uint32_t* reads;
+	bool* escaped; // Registers read by something else than a LOAD or STORE address
+} SoftIROptimizer;
+
+typedef struct SoftIRAvailableValue
+{
+	uint32_t pointer;
+	uint32_t bytes;
+	uint32_t value; // First register holding the memory content
+	uint32_t store; // Instruction that wrote the memory in the current block, SOFT_IR_NONE once something may read it
+} SoftIRAvailableValue;
+
+typedef struct SoftIRAvailableValues
+{
+	SoftIRAvailableValue values[SOFT_IR_MAX_AVAILABLE_VALUES];
+	uint32_t count;
+} SoftIRAvailableValues;
+
+typedef struct SoftIRCodeBuffer
+{
+	uint32_t* code;
+	uint32_t size;
+	uint32_t capacity;
+	uint32_t* fixups; // Positions holding old pcs
+	uint32_t fixups_count;
+	uint32_t fixups_capacity;
+	bool failed;
+} SoftIRCodeBuffer;
+
+static uint32_t SoftIRInstructionWords(const uint32_t* code, uint32_t pc)
+{
+	return soft_ir_optimizer_words[code[pc]] != 0 ? soft_ir_optimizer_words[code[pc]] : code[pc + 1];
+}
+
+static uint32_t SoftIRPlanRegisters(const SoftIRProgram* program, uint32_t plan_index)
+{
+	if(plan_index >= program->copy_plans_count)
+		return 0;
+	const SoftIRCopyPlan* plan = &program->copy_plans[plan_index];
+	uint32_t bytes = 0;
+	for(uint32_t i = 0; i < plan->chunks_count; i++)
+	{
+		const SoftIRCopyChunk* chunk = &program->copy_chunks[plan->first_chunk + i];
+		if(chunk->register_offset + chunk->size > bytes)
+			bytes = chunk->register_offset + chunk->size;
+	}
+	return (bytes + 3) / 4;
+}
+
+#define SOFT_IR_OPERAND(position, registers_count, is_written) \
+	do { \
+		operands[count].reg = code[pc + (position)]; \
+		operands[count].count = (registers_count); \
+		operands[count].word = (position); \
+		operands[count].written = (is_written); \
+		count++; \
+	} while(0)
+
+// Register ranges read and written by an instruction, mirrors SoftIRExecute
+static uint32_t SoftIRGetOperands(const SoftIRProgram* program, uint32_t pc, SoftIROperand* operands)
+{
+	const uint32_t* code = program->code;
+	const uint32_t* w = &code[pc];
+	uint32_t count = 0;
+	switch(w[0])
+	{
+		case SOFT_IR_OP_HALT:
+		case SOFT_IR_OP_JMP:
+		case SOFT_IR_OP_CALL:
+		case SOFT_IR_OP_RET:
+		case SOFT_IR_OP_BARRIER:
+			break;
+
+		case SOFT_IR_OP_LOAD: SOFT_IR_OPERAND(1, w[3] / 4, true); SOFT_IR_OPERAND(2, 2, false); break;
+		case SOFT_IR_OP_STORE: SOFT_IR_OPERAND(1, 2, false); SOFT_IR_OPERAND(2, w[3] / 4, false); break;
+		case SOFT_IR_OP_LOAD_PLAN: SOFT_IR_OPERAND(1, SoftIRPlanRegisters(program, w[3]), true); SOFT_IR_OPERAND(2, 2, false); break;
+		case SOFT_IR_OP_STORE_PLAN: SOFT_IR_OPERAND(1, 2, false); SOFT_IR_OPERAND(2, SoftIRPlanRegisters(program, w[3]), false); break;
+		case SOFT_IR_OP_ACCESS_CHAIN:
+		{
+			SOFT_IR_OPERAND(2, 2, true);
+			SOFT_IR_OPERAND(3, 2, false);
+			for(uint32_t i = 0; i < w[5] && 7 + i * 2 < w[1] && count < SOFT_IR_MAX_OPERANDS; i++)
+				SOFT_IR_OPERAND(6 + i * 2, 1, false);
+			break;
+		}
+		case SOFT_IR_OP_ARRAY_LENGTH: SOFT_IR_OPERAND(1, 1, true); SOFT_IR_OPERAND(2, 2, false); break;
+		case SOFT_IR_OP_ATOMIC_LOAD: SOFT_IR_OPERAND(1, 1, true); SOFT_IR_OPERAND(2, 2, false); break;
+		case SOFT_IR_OP_ATOMIC_STORE: SOFT_IR_OPERAND(1, 2, false); SOFT_IR_OPERAND(2, 1, false); break;
+		case SOFT_IR_OP_ATOMIC_RMW: SOFT_IR_OPERAND(1, 1, true); SOFT_IR_OPERAND(2, 2, false); SOFT_IR_OPERAND(3, 1, false); break;
+		case SOFT_IR_OP_ATOMIC_CMPXCHG: SOFT_IR_OPERAND(1, 1, true); SOFT_IR_OPERAND(2, 2, false); SOFT_IR_OPERAND(3, 1, false); SOFT_IR_OPERAND(4, 1, false); break;
+
+		case SOFT_IR_OP_IMAGE_READ: SOFT_IR_OPERAND(1, w[5], true); SOFT_IR_OPERAND(2, 1, false); SOFT_IR_OPERAND(3, w[4], false); break;
+		case SOFT_IR_OP_IMAGE_WRITE: SOFT_IR_OPERAND(1, 1, false); SOFT_IR_OPERAND(2, w[3], false); SOFT_IR_OPERAND(4, w[5], false); break;
+		case SOFT_IR_OP_IMAGE_SIZE: SOFT_IR_OPERAND(1, w[3], true); SOFT_IR_OPERAND(2, 1, false); break;
+
+		case SOFT_IR_OP_FMUL_SCALAR: SOFT_IR_OPERAND(1, w[4], true); SOFT_IR_OPERAND(2, w[4], false); SOFT_IR_OPERAND(3, 1, false); break;
+		case SOFT_IR_OP_ANY:
+		case SOFT_IR_OP_ALL:
+		case SOFT_IR_OP_LENGTH:
+			SOFT_IR_OPERAND(1, 1, true);
+			SOFT_IR_OPERAND(2, w[3], false);
+			break;
+		case SOFT_IR_OP_SELECT:
+		{
+			SOFT_IR_OPERAND(1, w[5], true);
+			SOFT_IR_OPERAND(2, w[6] != 0 && w[5] != 0 ? (w[5] - 1) * w[6] + 1 : 1, false);
+			SOFT_IR_OPERAND(3, w[5], false);
+			SOFT_IR_OPERAND(4, w[5], false);
+			break;
+		}
+		case SOFT_IR_OP_DOT:
+		case SOFT_IR_OP_DISTANCE:
+			SOFT_IR_OPERAND(1, 1, true);
+			SOFT_IR_OPERAND(2, w[4], false);
+			SOFT_IR_OPERAND(3, w[4], false);
+			break;
+		case SOFT_IR_OP_MAT_TIMES_VEC: SOFT_IR_OPERAND(1, w[5], true); SOFT_IR_OPERAND(2, w[4] * w[5], false); SOFT_IR_OPERAND(3, w[4], false); break;
+		case SOFT_IR_OP_VEC_TIMES_MAT: SOFT_IR_OPERAND(1, w[4], true); SOFT_IR_OPERAND(2, w[5], false); SOFT_IR_OPERAND(3, w[4] * w[5], false); break;
+		case SOFT_IR_OP_MAT_TIMES_MAT: SOFT_IR_OPERAND(1, w[4] * w[6], true); SOFT_IR_OPERAND(2, w[4] * w[5], false); SOFT_IR_OPERAND(3, w[5] * w[6], false); break;
+		case SOFT_IR_OP_TRANSPOSE: SOFT_IR_OPERAND(1, w[3] * w[4], true); SOFT_IR_OPERAND(2, w[3] * w[4], false); break;
+		case SOFT_IR_OP_OUTER_PRODUCT: SOFT_IR_OPERAND(1, w[4] * w[5], true); SOFT_IR_OPERAND(2, w[4], false); SOFT_IR_OPERAND(3, w[5], false); break;
+		case SOFT_IR_OP_VEC_EXTRACT_DYN: SOFT_IR_OPERAND(1, 1, true); SOFT_IR_OPERAND(2, w[4], false); SOFT_IR_OPERAND(3, 1, false); break;
+		case SOFT_IR_OP_VEC_INSERT_DYN: SOFT_IR_OPERAND(1, w[5], true); SOFT_IR_OPERAND(2, w[5], false); SOFT_IR_OPERAND(3, 1, false); SOFT_IR_OPERAND(4, 1, false); break;
+		case SOFT_IR_OP_CROSS: SOFT_IR_OPERAND(1, 3, true); SOFT_IR_OPERAND(2, 3, false); SOFT_IR_OPERAND(3, 3, false); break;
+
+		case SOFT_IR_OP_BR: SOFT_IR_OPERAND(1, 1, false); break;
+		case SOFT_IR_OP_SWITCH: SOFT_IR_OPERAND(2, 1, false); break;
+
+		// Component-wise ops, dst, sources then the components count
+		default:
+		{
+			uint32_t words = soft_ir_optimizer_words[w[0]];
+			SOFT_IR_OPERAND(1, w[words - 1], true);
+			for(uint32_t i = 2; i + 1 < words; i++)
+				SOFT_IR_OPERAND(i, w[words - 1], false);
+			break;
+		}
+	}
+	return count;
+}
+
+#undef SOFT_IR_OPERAND
+
+static SoftIRTargets SoftIRGetTargets(const uint32_t* code, uint32_t pc)
+{
+	SoftIRTargets targets = { .begin = 0, .end = 0, .step = 1 };
+	switch(code[pc])
+	{
+		case SOFT_IR_OP_JMP:
+		case SOFT_IR_OP_CALL: targets.begin = pc + 1; targets.end = pc + 2; break;
+		case SOFT_IR_OP_BR: targets.begin = pc + 2; targets.end = pc + 4; break;
+		case SOFT_IR_OP_SWITCH: targets.begin = pc + 3; targets.end = pc + code[pc + 1]; targets.step = 2; break;
+
+		default: break;
+	}
+	return targets;
+}
+
+static bool SoftIRIsTerminator(uint32_t op)
+{
+	return op == SOFT_IR_OP_HALT || op == SOFT_IR_OP_JMP || op == SOFT_IR_OP_BR || op == SOFT_IR_OP_SWITCH || op == SOFT_IR_OP_RET;
+}
+
+// Branches whose targets have all been folded to the same one are rebuilt as jumps
+static uint32_t SoftIRUniformTarget(const uint32_t* code, uint32_t pc)
+{
+	SoftIRTargets targets = SoftIRGetTargets(code, pc);
+	if(code[pc] == SOFT_IR_OP_CALL || targets.begin == targets.end)
+		return SOFT_IR_NONE;
+	for(uint32_t position = targets.begin + targets.step; position < targets.end; position += targets.step)
+	{
+		if(code[position] != code[targets.begin])
+			return SOFT_IR_NONE;
+	}
+	return code[targets.begin];
+}
+
+static bool SoftIRHasSideEffects(uint32_t op)
+{
+	switch(op)
+	{
+		case SOFT_IR_OP_STORE:
+		case SOFT_IR_OP_STORE_PLAN:
+		case SOFT_IR_OP_IMAGE_WRITE:
+		case SOFT_IR_OP_BARRIER:
+		case SOFT_IR_OP_ATOMIC_LOAD: // Acquires order the loads after it
+		case SOFT_IR_OP_ATOMIC_STORE:
+		case SOFT_IR_OP_ATOMIC_RMW:
+		case SOFT_IR_OP_ATOMIC_CMPXCHG:
+			return true;
+
+		default: return SoftIRIsTerminator(op) || op == SOFT_IR_OP_CALL;
+	}
+}
+
+// Ops whose result is bit exact whatever runs them, transcendentals and anything a C compiler could contract are left alone
+static bool SoftIRIsFoldable(uint32_t op)
+{
+	switch(op)
+	{
+		case SOFT_IR_OP_MOV:
+		case SOFT_IR_OP_IADD: case SOFT_IR_OP_ISUB: case SOFT_IR_OP_IMUL: case SOFT_IR_OP_SDIV: case SOFT_IR_OP_UDIV: case SOFT_IR_OP_SREM: case SOFT_IR_OP_SMOD: case SOFT_IR_OP_UMOD:
+		case SOFT_IR_OP_FADD: case SOFT_IR_OP_FSUB: case SOFT_IR_OP_FMUL: case SOFT_IR_OP_FDIV: case SOFT_IR_OP_FMUL_SCALAR:
+		case SOFT_IR_OP_FNEG: case SOFT_IR_OP_SNEG: case SOFT_IR_OP_NOT: case SOFT_IR_OP_LNOT:
+		case SOFT_IR_OP_SHL: case SOFT_IR_OP_SHR: case SOFT_IR_OP_SAR: case SOFT_IR_OP_AND: case SOFT_IR_OP_OR: case SOFT_IR_OP_XOR:
+		case SOFT_IR_OP_IEQ: case SOFT_IR_OP_INE: case SOFT_IR_OP_ULT: case SOFT_IR_OP_ULE: case SOFT_IR_OP_UGT: case SOFT_IR_OP_UGE:
+		case SOFT_IR_OP_SLT: case SOFT_IR_OP_SLE: case SOFT_IR_OP_SGT: case SOFT_IR_OP_SGE:
+		case SOFT_IR_OP_FOEQ: case SOFT_IR_OP_FONE: case SOFT_IR_OP_FOLT: case SOFT_IR_OP_FOLE: case SOFT_IR_OP_FOGT: case SOFT_IR_OP_FOGE:
+		case SOFT_IR_OP_FUEQ: case SOFT_IR_OP_FUNE: case SOFT_IR_OP_FULT: case SOFT_IR_OP_FULE: case SOFT_IR_OP_FUGT: case SOFT_IR_OP_FUGE:
+		case SOFT_IR_OP_ISNAN: case SOFT_IR_OP_ISINF: case SOFT_IR_OP_ANY: case SOFT_IR_OP_ALL: case SOFT_IR_OP_SELECT:
+		case SOFT_IR_OP_F2U: case SOFT_IR_OP_F2S: case SOFT_IR_OP_U2F: case SOFT_IR_OP_S2F:
+		case SOFT_IR_OP_TRANSPOSE: case SOFT_IR_OP_VEC_EXTRACT_DYN: case SOFT_IR_OP_VEC_INSERT_DYN:
+		case SOFT_IR_OP_FABS: case SOFT_IR_OP_SABS: case SOFT_IR_OP_FSIGN: case SOFT_IR_OP_SSIGN:
+		case SOFT_IR_OP_FLOOR: case SOFT_IR_OP_CEIL: case SOFT_IR_OP_TRUNC: case SOFT_IR_OP_FRACT: case SOFT_IR_OP_ROUND:
+		case SOFT_IR_OP_FMIN: case SOFT_IR_OP_FMAX: case SOFT_IR_OP_UMIN: case SOFT_IR_OP_UMAX: case SOFT_IR_OP_SMIN: case SOFT_IR_OP_SMAX: case SOFT_IR_OP_STEP:
+		case SOFT_IR_OP_FCLAMP: case SOFT_IR_OP_UCLAMP: case SOFT_IR_OP_SCLAMP:
+			return true;
+
+		default: return false;
+	}
+}
+
+static void SoftIRReleaseIndex(SoftIROptimizer* optimizer)
+{
+	free(optimizer->starts);
+	free(optimizer->indices);
+	free(optimizer->removed);
+	free(optimizer->leaders);
+	optimizer->starts = PULSE_NULLPTR;
+	optimizer->indices = PULSE_NULLPTR;
+	optimizer->removed = PULSE_NULLPTR;
+	optimizer->leaders = PULSE_NULLPTR;
+	optimizer->instructions_count = 0;
+}
+
+// Also validates the code, anything the optimizer would not understand makes it leave the program alone
+static bool SoftIRIndexInstructions(SoftIROptimizer* optimizer)
+{
+	const SoftIRProgram* program = optimizer->program;
+	const uint32_t* code = program->code;
+	SoftIRReleaseIndex(optimizer);
+
+	uint32_t count = 0;
+	for(uint32_t pc = 0; pc < program->code_size; count++)
+	{
+		if(code[pc] >= SOFT_IR_OP_MAX_ENUM || (soft_ir_optimizer_words[code[pc]] == 0 && pc + 1 >= program->code_size))
+			return false;
+		uint32_t words = SoftIRInstructionWords(code, pc);
+		if(words == 0 || pc + words > program->code_size)
+			return false;
+		pc += words;
+	}
+
+	optimizer->starts = (uint32_t*)malloc(count * sizeof(uint32_t) + 1);
+	optimizer->indices = (uint32_t*)malloc(program->code_size * sizeof(uint32_t) + 1);
+	optimizer->removed = (bool*)calloc(count + 1, sizeof(bool));
+	optimizer->leaders = (bool*)calloc(count + 1, sizeof(bool));
+	if(optimizer->starts == PULSE_NULLPTR || optimizer->indices == PULSE_NULLPTR || optimizer->removed == PULSE_NULLPTR || optimizer->leaders == PULSE_NULLPTR)
+	{
+		SoftIRReleaseIndex(optimizer);
+		return false;
+	}
+	optimizer->instructions_count = count;
+
+	for(uint32_t pc = 0; pc < program->code_size; pc++)
+		optimizer->indices[pc] = SOFT_IR_NONE;
+	for(uint32_t i = 0, pc = 0; i < count; i++)
+	{
+		optimizer->starts[i] = pc;
+		optimizer->indices[pc] = i;
+		pc += SoftIRInstructionWords(code, pc);
+	}
+
+	if(program->entry_pc >= program->code_size || optimizer->indices[program->entry_pc] == SOFT_IR_NONE)
+		return false;
+	optimizer->leaders[optimizer->indices[program->entry_pc]] = true;
+
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t pc = optimizer->starts[i];
+		SoftIRTargets targets = SoftIRGetTargets(code, pc);
+		for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+		{
+			if(code[position] >= program->code_size || optimizer->indices[code[position]] == SOFT_IR_NONE)
+				return false;
+			optimizer->leaders[optimizer->indices[code[position]]] = true;
+		}
+		if(code[pc] == SOFT_IR_OP_CALL && i + 1 < count)
+			optimizer->leaders[i + 1] = true;
+
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			if((uint64_t)operands[j].reg + operands[j].count > program->registers_count)
+				return false;
+		}
+	}
+	return true;
+}
+
+static uint32_t SoftIRNextLiveInstruction(const SoftIROptimizer* optimizer, uint32_t index)
+{
+	while(index < optimizer->instructions_count && optimizer->removed[index])
+		index++;
+	return index;
+}
+
+static void SoftIRCountAccesses(SoftIROptimizer* optimizer)
+{
+	const SoftIRProgram* program = optimizer->program;
+	memset(optimizer->writes, 0, program->registers_count * sizeof(uint32_t));
+	memset(optimizer->reads, 0, program->registers_count * sizeof(uint32_t));
+	memset(optimizer->escaped, 0, program->registers_count * sizeof(bool));
+
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t i = 0; i < optimizer->instructions_count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		uint32_t op = program->code[pc];
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			bool is_address = (op == SOFT_IR_OP_LOAD && operands[j].word == 2) || (op == SOFT_IR_OP_STORE && operands[j].word == 1);
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count; reg++)
+			{
+				if(operands[j].written)
+					optimizer->writes[reg]++;
+				else
+					optimizer->reads[reg]++;
+				if(!operands[j].written && !is_address)
+					optimizer->escaped[reg] = true;
+			}
+		}
+	}
+}
+
+static bool SoftIRRemoveUnreachable(SoftIROptimizer* optimizer)
+{
+	const uint32_t* code = optimizer->program->code;
+	uint32_t count = optimizer->instructions_count;
+	bool* reached = (bool*)calloc(count + 1, sizeof(bool));
+	uint32_t* stack = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+	if(reached == PULSE_NULLPTR || stack == PULSE_NULLPTR)
+	{
+		free(reached);
+		free(stack);
+		return false;
+	}
+
+	// Instructions are marked when pushed so that the stack never holds more than all of them
+	uint32_t stack_size = 0;
+	uint32_t entry = optimizer->indices[optimizer->program->entry_pc];
+	reached[entry] = true;
+	stack[stack_size++] = entry;
+	while(stack_size > 0)
+	{
+		uint32_t i = stack[--stack_size];
+		uint32_t pc = optimizer->starts[i];
+		if(!optimizer->removed[i])
+		{
+			SoftIRTargets targets = SoftIRGetTargets(code, pc);
+			for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+			{
+				uint32_t target = optimizer->indices[code[position]];
+				if(!reached[target])
+				{
+					reached[target] = true;
+					stack[stack_size++] = target;
+				}
+			}
+			if(SoftIRIsTerminator(code[pc]))
+				continue;
+		}
+		if(i + 1 < count && !reached[i + 1])
+		{
+			reached[i + 1] = true;
+			stack[stack_size++] = i + 1;
+		}
+	}
+
+	bool changed = false;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(!reached[i] && !optimizer->removed[i])
+		{
+			optimizer->removed[i] = true;
+			changed = true;
+		}
+	}
+	free(reached);
+	free(stack);
+	return changed;
+}
+
+// Instructions whose inputs are all constants are run once here and their results become constants.
+// Branches on constants keep their size, every target is set to the taken one
+static bool SoftIRFoldConstants(SoftIROptimizer* optimizer)
+{
+	SoftIRProgram* program = optimizer->program;
+	uint32_t* code = program->code;
+	bool changed = false;
+
+	SoftIRContext context = { 0 };
+	context.registers = program->initial_registers;
+	context.lanes_count = 1;
+
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t i = 0; i < optimizer->instructions_count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		uint32_t op = code[pc];
+
+		if(op == SOFT_IR_OP_BR || op == SOFT_IR_OP_SWITCH)
+		{
+			uint32_t selector = code[pc + (op == SOFT_IR_OP_BR ? 1 : 2)];
+			if(optimizer->writes[selector] != 0 || SoftIRUniformTarget(code, pc) != SOFT_IR_NONE)
+				continue;
+			uint32_t value = program->initial_registers[selector].u;
+			uint32_t target = op == SOFT_IR_OP_BR ? (value ? code[pc + 2] : code[pc + 3]) : code[pc + 3];
+			for(uint32_t position = pc + 4; op == SOFT_IR_OP_SWITCH && position + 1 < pc + code[pc + 1]; position += 2)
+			{
+				if(code[position] == value)
+				{
+					target = code[position + 1];
+					break;
+				}
+			}
+			SoftIRTargets targets = SoftIRGetTargets(code, pc);
+			for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+				code[position] = target;
+			changed = true;
+			continue;
+		}
+
+		if(!SoftIRIsFoldable(op))
+			continue;
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		bool foldable = true;
+		for(uint32_t j = 0; j < operands_count && foldable; j++)
+		{
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count && foldable; reg++)
+				foldable = optimizer->writes[reg] == (operands[j].written ? 1 : 0);
+		}
+		if(!foldable)
+			continue;
+
+		uint32_t words[8];
+		uint32_t words_count = SoftIRInstructionWords(code, pc);
+		memcpy(words, code + pc, words_count * sizeof(uint32_t));
+		words[words_count] = SOFT_IR_OP_HALT;
+		SoftIRProgram scratch = { 0 };
+		scratch.code = words;
+		scratch.code_size = words_count + 1;
+		SoftIRExecute(&scratch, &context);
+
+		optimizer->removed[i] = true;
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			if(!operands[j].written)
+				continue;
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count; reg++)
+				optimizer->writes[reg] = 0;
+		}
+		changed = true;
+	}
+	return changed;
+}
+
+// Variables of the private region whose address is only ever used by LOAD and STORE cannot be reached by
+// any other pointer, inside a block their loads reuse the registers of the last store or load
+static bool SoftIRIsLocalPointer(const SoftIROptimizer* optimizer, uint32_t reg)
+{
+	const SoftIRProgram* program = optimizer->program;
+	return optimizer->writes[reg] == 0 && optimizer->writes[reg + 1] == 0 && !optimizer->escaped[reg] && !optimizer->escaped[reg + 1] && program->initial_registers[reg].u == SOFT_IR_REGION_PRIVATE;
+}
+
+static bool SoftIRRangesOverlap(uint32_t a, uint32_t a_count, uint32_t b, uint32_t b_count)
+{
+	return a < b + b_count && b < a + a_count;
+}
+
+static void SoftIRForgetValue(SoftIRAvailableValues* available, uint32_t index)
+{
+	available->values[index] = available->values[--available->count];
+}
+
+// Records the only instruction of a kind for an entry, SOFT_IR_MANY once there are several
+static void SoftIRAddPredecessor(uint32_t* predecessors, uint32_t index, uint32_t predecessor)
+{
+	if(predecessors[index] == SOFT_IR_NONE || predecessors[index] == predecessor)
+		predecessors[index] = predecessor;
+	else
+		predecessors[index] = SOFT_IR_MANY;
+}
+
+// Single predecessor of every live instruction, SOFT_IR_MANY when it has several or is reached from a call or a return
+static void SoftIRFindPredecessors(const SoftIROptimizer* optimizer, uint32_t* predecessors)
+{
+	const uint32_t* code = optimizer->program->code;
+	uint32_t count = optimizer->instructions_count;
+	for(uint32_t i = 0; i < count; i++)
+		predecessors[i] = SOFT_IR_NONE;
+	uint32_t entry = SoftIRNextLiveInstruction(optimizer, optimizer->indices[optimizer->program->entry_pc]);
+	if(entry < count)
+		predecessors[entry] = SOFT_IR_MANY;
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		SoftIRTargets targets = SoftIRGetTargets(code, pc);
+		for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+		{
+			uint32_t target = SoftIRNextLiveInstruction(optimizer, optimizer->indices[code[position]]);
+			if(target < count)
+				SoftIRAddPredecessor(predecessors, target, code[pc] == SOFT_IR_OP_CALL ? SOFT_IR_MANY : i);
+		}
+		uint32_t next = SoftIRNextLiveInstruction(optimizer, i + 1);
+		if(next < count && !SoftIRIsTerminator(code[pc]))
+			SoftIRAddPredecessor(predecessors, next, code[pc] == SOFT_IR_OP_CALL ? SOFT_IR_MANY : i);
+	}
+}
+
+// Blocks with a single predecessor start from the values available at its end, without the stores
+// as the other successors of that predecessor may read them
+static bool SoftIRForwardMemory(SoftIROptimizer* optimizer)
+{
+	SoftIRProgram* program = optimizer->program;
+	uint32_t* code = program->code;
+	uint32_t count = optimizer->instructions_count;
+	uint32_t* predecessors = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+	uint32_t* snapshot_indices = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+	uint32_t snapshots_count = 0;
+	for(uint32_t i = 0; i < count && snapshot_indices != PULSE_NULLPTR; i++)
+	{
+		uint32_t op = code[optimizer->starts[i]];
+		snapshot_indices[i] = !optimizer->removed[i] && (op == SOFT_IR_OP_JMP || op == SOFT_IR_OP_BR || op == SOFT_IR_OP_SWITCH) ? snapshots_count++ : SOFT_IR_NONE;
+	}
+	SoftIRAvailableValues* snapshots = (SoftIRAvailableValues*)malloc((snapshots_count + 1) * sizeof(SoftIRAvailableValues));
+	uint32_t* stores = (uint32_t*)malloc(program->registers_count * sizeof(uint32_t) + 1); // Single store of each address
+	if(predecessors == PULSE_NULLPTR || snapshot_indices == PULSE_NULLPTR || snapshots == PULSE_NULLPTR || stores == PULSE_NULLPTR)
+	{
+		free(predecessors);
+		free(snapshot_indices);
+		free(snapshots);
+		free(stores);
+		return false;
+	}
+	SoftIRFindPredecessors(optimizer, predecessors);
+
+	SoftIRAvailableValues available = { .count = 0 };
+	uint32_t previous = SOFT_IR_NONE;
+	bool block_start = false;
+	bool changed = false;
+
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t i = 0; i < count; i++)
+	{
+		block_start = block_start || optimizer->leaders[i];
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		uint32_t op = code[pc];
+
+		if(block_start)
+		{
+			uint32_t predecessor = predecessors[i];
+			if(predecessor == SOFT_IR_NONE || predecessor == SOFT_IR_MANY || predecessor > i)
+				available.count = 0;
+			else if(snapshot_indices[predecessor] != SOFT_IR_NONE)
+			{
+				available = snapshots[snapshot_indices[predecessor]];
+				for(uint32_t j = 0; j < available.count; j++)
+					available.values[j].store = SOFT_IR_NONE;
+			}
+			else if(predecessor != previous)
+				available.count = 0;
+			block_start = false;
+		}
+		previous = i;
+
+		uint32_t pointer = SOFT_IR_NONE;
+		if(op == SOFT_IR_OP_LOAD && SoftIRIsLocalPointer(optimizer, code[pc + 2]) && code[pc + 3] % 4 == 0)
+			pointer = code[pc + 2];
+		else if(op == SOFT_IR_OP_STORE && SoftIRIsLocalPointer(optimizer, code[pc + 1]) && code[pc + 3] % 4 == 0)
+			pointer = code[pc + 1];
+
+		uint32_t found = SOFT_IR_NONE;
+		for(uint32_t j = 0; j < available.count && pointer != SOFT_IR_NONE; j++)
+		{
+			if(available.values[j].pointer == pointer)
+				found = j;
+		}
+
+		if(op == SOFT_IR_OP_LOAD && found != SOFT_IR_NONE)
+		{
+			SoftIRAvailableValue* value = &available.values[found];
+			uint32_t components = code[pc + 3] / 4;
+			bool disjoint = !SoftIRRangesOverlap(code[pc + 1], components, value->value, components);
+			if(value->bytes == code[pc + 3] && (disjoint || code[pc + 1] == value->value))
+			{
+				code[pc] = SOFT_IR_OP_MOV;
+				code[pc + 2] = value->value;
+				code[pc + 3] = components;
+				pointer = SOFT_IR_NONE; // The value stays available from where it already is
+				changed = true;
+			}
+			else
+				SoftIRForgetValue(&available, found); // Its store is needed
+		}
+		else if(op == SOFT_IR_OP_STORE && found != SOFT_IR_NONE)
+		{
+			// Overwritten before anything read it
+			if(available.values[found].store != SOFT_IR_NONE && available.values[found].bytes <= code[pc + 3])
+			{
+				optimizer->removed[available.values[found].store] = true;
+				changed = true;
+			}
+			SoftIRForgetValue(&available, found);
+		}
+
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			if(!operands[j].written)
+				continue;
+			for(uint32_t k = 0; k < available.count;)
+			{
+				if(SoftIRRangesOverlap(operands[j].reg, operands[j].count, available.values[k].value, available.values[k].bytes / 4))
+					SoftIRForgetValue(&available, k);
+				else
+					k++;
+			}
+		}
+
+		if(snapshot_indices[i] != SOFT_IR_NONE)
+			snapshots[snapshot_indices[i]] = available;
+		if(op == SOFT_IR_OP_CALL || SoftIRIsTerminator(op))
+			available.count = 0;
+		else if(pointer != SOFT_IR_NONE && available.count < SOFT_IR_MAX_AVAILABLE_VALUES)
+		{
+			SoftIRAvailableValue* value = &available.values[available.count++];
+			value->pointer = pointer;
+			value->bytes = code[pc + 3];
+			value->value = code[pc + (op == SOFT_IR_OP_LOAD ? 1 : 2)];
+			value->store = op == SOFT_IR_OP_STORE ? i : SOFT_IR_NONE;
+		}
+	}
+
+	// Variables stored once with a constant, a load that does not follow the store reads an undefined value
+	// which may as well be that constant
+	for(uint32_t reg = 0; reg < program->registers_count; reg++)
+		stores[reg] = SOFT_IR_NONE;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t pc = optimizer->starts[i];
+		if(!optimizer->removed[i] && code[pc] == SOFT_IR_OP_STORE)
+			SoftIRAddPredecessor(stores, code[pc + 1], i);
+	}
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t pc = optimizer->starts[i];
+		if(optimizer->removed[i] || code[pc] != SOFT_IR_OP_LOAD || code[pc + 3] % 4 != 0 || !SoftIRIsLocalPointer(optimizer, code[pc + 2]))
+			continue;
+		uint32_t store = stores[code[pc + 2]];
+		if(store == SOFT_IR_NONE || store == SOFT_IR_MANY || code[optimizer->starts[store] + 3] != code[pc + 3])
+			continue;
+		uint32_t value = code[optimizer->starts[store] + 2];
+		bool constant = true;
+		for(uint32_t k = 0; k < code[pc + 3] / 4 && constant; k++)
+			constant = optimizer->writes[value + k] == 0;
+		if(!constant)
+			continue;
+		code[pc] = SOFT_IR_OP_MOV;
+		code[pc + 2] = value;
+		code[pc + 3] /= 4;
+		changed = true;
+	}
+	free(predecessors);
+	free(snapshot_indices);
+	free(snapshots);
+	free(stores);
+
+	// Stores to variables nothing loads anymore, reads is reused to count the loads of each address
+	SoftIRCountAccesses(optimizer);
+	memset(optimizer->reads, 0, program->registers_count * sizeof(uint32_t));
+	for(uint32_t i = 0; i < optimizer->instructions_count; i++)
+	{
+		if(!optimizer->removed[i] && code[optimizer->starts[i]] == SOFT_IR_OP_LOAD)
+			optimizer->reads[code[optimizer->starts[i] + 2]]++;
+	}
+	for(uint32_t i = 0; i < optimizer->instructions_count; i++)
+	{
+		uint32_t pc = optimizer->starts[i];
+		if(optimizer->removed[i] || code[pc] != SOFT_IR_OP_STORE || !SoftIRIsLocalPointer(optimizer, code[pc + 1]) || optimizer->reads[code[pc + 1]] != 0)
+			continue;
+		optimizer->removed[i] = true;
+		changed = true;
+	}
+	return changed;
+}
+
+// Registers written once by a MOV are read from its source instead when that source is a constant or is
+// written once in the same function, SPIR-V dominance rules then make both hold the same value wherever the copy is read.
+// Return and parameter registers cross functions, copies of them are only propagated once the callee has been inlined
+static bool SoftIRPropagateCopies(SoftIROptimizer* optimizer)
+{
+	SoftIRProgram* program = optimizer->program;
+	uint32_t* code = program->code;
+	uint32_t count = optimizer->instructions_count;
+	uint32_t* functions = (uint32_t*)malloc((count + 1) * sizeof(uint32_t)); // First instruction of the function of each instruction
+	bool* blocked = (bool*)calloc(count + 1, sizeof(bool));
+	uint32_t* writers = (uint32_t*)malloc(program->registers_count * sizeof(uint32_t) + 1);
+	uint32_t* copies = (uint32_t*)malloc(program->registers_count * sizeof(uint32_t) + 1); // MOV writing each register
+	if(functions == PULSE_NULLPTR || blocked == PULSE_NULLPTR || writers == PULSE_NULLPTR || copies == PULSE_NULLPTR)
+	{
+		free(functions);
+		free(blocked);
+		free(writers);
+		free(copies);
+		return false;
+	}
+
+	for(uint32_t i = 0; i < count; i++)
+		functions[i] = SOFT_IR_NONE;
+	functions[optimizer->indices[program->entry_pc]] = optimizer->indices[program->entry_pc];
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(!optimizer->removed[i] && code[optimizer->starts[i]] == SOFT_IR_OP_CALL)
+			functions[optimizer->indices[code[optimizer->starts[i] + 1]]] = optimizer->indices[code[optimizer->starts[i] + 1]];
+	}
+	for(uint32_t i = 0, function = 0; i < count; i++)
+	{
+		if(functions[i] == i)
+			function = i;
+		functions[i] = function;
+	}
+
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t reg = 0; reg < program->registers_count; reg++)
+	{
+		writers[reg] = SOFT_IR_NONE;
+		copies[reg] = SOFT_IR_NONE;
+	}
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t operands_count = SoftIRGetOperands(program, optimizer->starts[i], operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count && operands[j].written; reg++)
+				writers[reg] = i;
+		}
+	}
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t pc = optimizer->starts[i];
+		if(optimizer->removed[i] || code[pc] != SOFT_IR_OP_MOV || SoftIRRangesOverlap(code[pc + 1], code[pc + 3], code[pc + 2], code[pc + 3]))
+			continue;
+		bool propagable = true;
+		for(uint32_t k = 0; k < code[pc + 3] && propagable; k++)
+		{
+			uint32_t source = code[pc + 2] + k;
+			propagable = optimizer->writes[code[pc + 1] + k] == 1 && (optimizer->writes[source] == 0 || (optimizer->writes[source] == 1 && functions[writers[source]] == functions[i]));
+		}
+		for(uint32_t k = 0; k < code[pc + 3] && propagable; k++)
+			copies[code[pc + 1] + k] = i;
+	}
+
+	// Copies read partially or from another function are kept
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t operands_count = SoftIRGetOperands(program, optimizer->starts[i], operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count && !operands[j].written; reg++)
+			{
+				uint32_t copy = copies[reg];
+				if(copy == SOFT_IR_NONE)
+					continue;
+				const uint32_t* mov = &code[optimizer->starts[copy]];
+				if(operands[j].reg < mov[1] || operands[j].reg + operands[j].count > mov[1] + mov[3] || functions[i] != functions[copy])
+					blocked[copy] = true;
+			}
+		}
+	}
+
+	bool changed = false;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			if(operands[j].written)
+				continue;
+			uint32_t reg = operands[j].reg;
+			for(uint32_t depth = 0; depth < count && copies[reg] != SOFT_IR_NONE && !blocked[copies[reg]]; depth++)
+			{
+				const uint32_t* mov = &code[optimizer->starts[copies[reg]]];
+				reg = mov[2] + reg - mov[1];
+			}
+			if(reg != operands[j].reg)
+			{
+				code[pc + operands[j].word] = reg;
+				changed = true;
+			}
+		}
+	}
+
+	free(functions);
+	free(blocked);
+	free(writers);
+	free(copies);
+	return changed;
+}
+
+static bool SoftIRRemoveDeadCode(SoftIROptimizer* optimizer)
+{
+	const SoftIRProgram* program = optimizer->program;
+	bool changed = false;
+	SoftIROperand operands[SOFT_IR_MAX_OPERANDS];
+	for(uint32_t i = optimizer->instructions_count; i-- > 0;) // Backward so that chains go in one pass
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		if(SoftIRHasSideEffects(program->code[pc]))
+			continue;
+		uint32_t operands_count = SoftIRGetOperands(program, pc, operands);
+		bool dead = true;
+		for(uint32_t j = 0; j < operands_count && dead; j++)
+		{
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count && dead; reg++)
+				dead = !operands[j].written || optimizer->reads[reg] == 0;
+		}
+		if(!dead)
+			continue;
+		optimizer->removed[i] = true;
+		for(uint32_t j = 0; j < operands_count; j++)
+		{
+			if(operands[j].written)
+				continue;
+			for(uint32_t reg = operands[j].reg; reg < operands[j].reg + operands[j].count; reg++)
+				optimizer->reads[reg]--;
+		}
+		changed = true;
+	}
+	return changed;
+}
+
+static bool SoftIRRemoveJumpsToNext(SoftIROptimizer* optimizer)
+{
+	const uint32_t* code = optimizer->program->code;
+	bool changed = false;
+	for(uint32_t i = 0; i < optimizer->instructions_count; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t target = SoftIRUniformTarget(code, optimizer->starts[i]);
+		if(target != SOFT_IR_NONE && SoftIRNextLiveInstruction(optimizer, optimizer->indices[target]) == SoftIRNextLiveInstruction(optimizer, i + 1))
+		{
+			optimizer->removed[i] = true;
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+static void SoftIREmit(SoftIRCodeBuffer* buffer, const uint32_t* words, uint32_t count)
+{
+	if(buffer->failed)
+		return;
+	if(buffer->size + count > buffer->capacity)
+	{
+		uint32_t capacity = buffer->capacity == 0 ? 256 : buffer->capacity;
+		while(buffer->size + count > capacity)
+			capacity *= 2;
+		uint32_t* code = (uint32_t*)realloc(buffer->code, capacity * sizeof(uint32_t));
+		if(code == PULSE_NULLPTR)
+		{
+			buffer->failed = true;
+			return;
+		}
+		buffer->code = code;
+		buffer->capacity = capacity;
+	}
+	memcpy(buffer->code + buffer->size, words, count * sizeof(uint32_t));
+	buffer->size += count;
+}
+
+static void SoftIRAddFixup(SoftIRCodeBuffer* buffer, uint32_t position)
+{
+	if(buffer->failed)
+		return;
+	if(buffer->fixups_count == buffer->fixups_capacity)
+	{
+		uint32_t capacity = buffer->fixups_capacity == 0 ? 64 : buffer->fixups_capacity * 2;
+		uint32_t* fixups = (uint32_t*)realloc(buffer->fixups, capacity * sizeof(uint32_t));
+		if(fixups == PULSE_NULLPTR)
+		{
+			buffer->failed = true;
+			return;
+		}
+		buffer->fixups = fixups;
+		buffer->fixups_capacity = capacity;
+	}
+	buffer->fixups[buffer->fixups_count++] = position;
+}
+
+// Copies a live instruction, targets are left as old pcs and recorded as fixups.
+// Inlined RETs become jumps whose target is set once the continuation is known
+static void SoftIREmitInstruction(SoftIRCodeBuffer* buffer, const uint32_t* code, uint32_t pc, bool inlined)
+{
+	uint32_t target = SoftIRUniformTarget(code, pc);
+	if(code[pc] == SOFT_IR_OP_RET && inlined)
+	{
+		uint32_t words[2] = { SOFT_IR_OP_JMP, SOFT_IR_NONE };
+		SoftIREmit(buffer, words, 2);
+		return;
+	}
+	if(target != SOFT_IR_NONE)
+	{
+		uint32_t words[2] = { SOFT_IR_OP_JMP, target };
+		SoftIREmit(buffer, words, 2);
+		SoftIRAddFixup(buffer, buffer->size - 1);
+		return;
+	}
+	uint32_t start = buffer->size;
+	SoftIREmit(buffer, code + pc, SoftIRInstructionWords(code, pc));
+	SoftIRTargets targets = SoftIRGetTargets(code, pc);
+	for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+		SoftIRAddFixup(buffer, start + position - pc);
+}
+
+// Fills the new pcs of removed instructions with the one of the next emitted instruction
+static void SoftIRFillRemovedPcs(const bool* emitted, uint32_t* new_pcs, uint32_t first, uint32_t end, uint32_t next_pc)
+{
+	for(uint32_t i = end; i-- > first;)
+	{
+		if(emitted[i])
+			next_pc = new_pcs[i];
+		else
+			new_pcs[i] = next_pc;
+	}
+}
+
+typedef struct SoftIRFunction
+{
+	uint32_t first; // Instruction indices
+	uint32_t end;
+	uint32_t calls_count;
+	uint32_t words; // Live words
+	bool inlinable;
+} SoftIRFunction;
+
+// Functions are found from the call targets, each one runs until the next one or the entry prologue.
+// Leaves are inlined when they are small or called once, their RETs jump back to the instruction following the call
+static bool SoftIRFindInlinableFunctions(SoftIROptimizer* optimizer, SoftIRFunction* functions)
+{
+	const uint32_t* code = optimizer->program->code;
+	uint32_t count = optimizer->instructions_count;
+	bool found = false;
+	memset(functions, 0, count * sizeof(SoftIRFunction));
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(!optimizer->removed[i] && code[optimizer->starts[i]] == SOFT_IR_OP_CALL)
+			functions[optimizer->indices[code[optimizer->starts[i] + 1]]].calls_count++;
+	}
+
+	uint32_t prologue = optimizer->indices[optimizer->program->entry_pc];
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(functions[i].calls_count == 0 || i == prologue)
+			continue;
+		SoftIRFunction* function = &functions[i];
+		function->first = i;
+		function->end = i + 1;
+		while(function->end < count && function->end != prologue && functions[function->end].calls_count == 0)
+			function->end++;
+
+		function->words = 0;
+		function->inlinable = true;
+		for(uint32_t j = function->first; j < function->end && function->inlinable; j++)
+		{
+			if(optimizer->removed[j])
+				continue;
+			uint32_t pc = optimizer->starts[j];
+			function->words += SoftIRInstructionWords(code, pc);
+			if(code[pc] == SOFT_IR_OP_CALL || code[pc] == SOFT_IR_OP_HALT)
+				function->inlinable = false;
+			SoftIRTargets targets = SoftIRGetTargets(code, pc);
+			for(uint32_t position = targets.begin; position < targets.end; position += targets.step)
+			{
+				uint32_t target = optimizer->indices[code[position]];
+				if(target < function->first || target >= function->end)
+					function->inlinable = false;
+			}
+		}
+		function->inlinable = function->inlinable && (function->calls_count == 1 || function->words <= SOFT_IR_INLINE_MAX_WORDS);
+		found = found || function->inlinable;
+	}
+	return found;
+}
+
+// Writes the live instructions into a new code array and remaps every target, optionally inlining leaf functions
+static bool SoftIRRebuild(SoftIROptimizer* optimizer, bool inline_calls, bool* inlined)
+{
+	SoftIRProgram* program = optimizer->program;
+	const uint32_t* code = program->code;
+	uint32_t count = optimizer->instructions_count;
+	SoftIRCodeBuffer buffer = { 0 };
+	SoftIRCodeBuffer body = { 0 };
+	uint32_t* new_pcs = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+	uint32_t* body_pcs = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+	bool* emitted = (bool*)calloc(count + 1, sizeof(bool));
+	bool* body_emitted = (bool*)calloc(count + 1, sizeof(bool));
+	SoftIRFunction* functions = inline_calls ? (SoftIRFunction*)malloc((count + 1) * sizeof(SoftIRFunction)) : PULSE_NULLPTR;
+	bool success = new_pcs != PULSE_NULLPTR && body_pcs != PULSE_NULLPTR && emitted != PULSE_NULLPTR && body_emitted != PULSE_NULLPTR && (!inline_calls || functions != PULSE_NULLPTR);
+	if(inlined != PULSE_NULLPTR)
+		*inlined = false;
+	if(success && inline_calls)
+		inline_calls = SoftIRFindInlinableFunctions(optimizer, functions);
+
+	for(uint32_t i = 0; i < count && success; i++)
+	{
+		if(optimizer->removed[i])
+			continue;
+		uint32_t pc = optimizer->starts[i];
+		new_pcs[i] = buffer.size;
+		emitted[i] = true;
+
+		const SoftIRFunction* callee = inline_calls && code[pc] == SOFT_IR_OP_CALL ? &functions[optimizer->indices[code[pc + 1]]] : PULSE_NULLPTR;
+		if(callee == PULSE_NULLPTR || !callee->inlinable)
+		{
+			SoftIREmitInstruction(&buffer, code, pc, false);
+			continue;
+		}
+
+		// The body is built apart with its own pcs, it is relocated once its size is known
+		body.size = 0;
+		body.fixups_count = 0;
+		for(uint32_t j = callee->first; j < callee->end; j++)
+		{
+			body_emitted[j] = !optimizer->removed[j];
+			if(!body_emitted[j])
+				continue;
+			body_pcs[j] = buffer.size + body.size;
+			SoftIREmitInstruction(&body, code, optimizer->starts[j], true);
+		}
+		uint32_t continuation = buffer.size + body.size;
+		SoftIRFillRemovedPcs(body_emitted, body_pcs, callee->first, callee->end, continuation);
+		for(uint32_t j = callee->first; j < callee->end && !body.failed; j++)
+		{
+			if(!body_emitted[j])
+				continue;
+			uint32_t start = body_pcs[j] - buffer.size;
+			if(code[optimizer->starts[j]] == SOFT_IR_OP_RET)
+				body.code[start + 1] = continuation;
+		}
+		for(uint32_t j = 0; j < body.fixups_count && !body.failed; j++)
+			body.code[body.fixups[j]] = body_pcs[optimizer->indices[body.code[body.fixups[j]]]];
+		SoftIREmit(&buffer, body.code, body.size);
+		success = !body.failed && !buffer.failed;
+		if(inlined != PULSE_NULLPTR)
+			*inlined = true;
+	}
+
+	success = success && !buffer.failed;
+	if(success)
+	{
+		SoftIRFillRemovedPcs(emitted, new_pcs, 0, count, buffer.size);
+		for(uint32_t i = 0; i < buffer.fixups_count && success; i++)
+		{
+			buffer.code[buffer.fixups[i]] = new_pcs[optimizer->indices[buffer.code[buffer.fixups[i]]]];
+			success = buffer.code[buffer.fixups[i]] < buffer.size;
+		}
+		success = success && new_pcs[optimizer->indices[program->entry_pc]] < buffer.size;
+	}
+	if(success)
+	{
+		program->entry_pc = new_pcs[optimizer->indices[program->entry_pc]];
+		free(program->code);
+		program->code = buffer.code;
+		program->code_size = buffer.size;
+		buffer.code = PULSE_NULLPTR;
+	}
+
+	free(buffer.code);
+	free(buffer.fixups);
+	free(body.code);
+	free(body.fixups);
+	free(new_pcs);
+	free(body_pcs);
+	free(emitted);
+	free(body_emitted);
+	free(functions);
+	return success && SoftIRIndexInstructions(optimizer);
+}
+
+uint32_t SoftGetIRInstructionsCount(const SoftIRProgram* program)
+{
+	uint32_t count = 0;
+	for(uint32_t pc = 0; pc < program->code_size; pc += SoftIRInstructionWords(program->code, pc))
+		count++;
+	return count;
+}
+
+void SoftOptimizeIRProgram(SoftIRProgram* program)
+{
+	if(program == PULSE_NULLPTR)
+		return;
+	program->lowered_instructions_count = SoftGetIRInstructionsCount(program);
+
+	SoftIROptimizer optimizer = { 0 };
+	optimizer.program = program;
+	optimizer.writes = (uint32_t*)malloc(program->registers_count * sizeof(uint32_t) + 1);
+	optimizer.reads = (uint32_t*)malloc(program->registers_count * sizeof(uint32_t) + 1);
+	optimizer.escaped = (bool*)malloc(program->registers_count * sizeof(bool) + 1);
+	if(optimizer.writes == PULSE_NULLPTR || optimizer.reads == PULSE_NULLPTR || optimizer.escaped == PULSE_NULLPTR || !SoftIRIndexInstructions(&optimizer))
+		goto end;
+
+	// Inlining works from the leaves up, callers become leaves once their callees are gone
+	for(uint32_t round = 0; round < SOFT_IR_MAX_CALL_DEPTH; round++)
+	{
+		bool inlined = false;
+		SoftIRRemoveUnreachable(&optimizer);
+		if(!SoftIRRebuild(&optimizer, true, &inlined))
+			goto end;
+		if(!inlined)
+			break;
+	}
+
+	for(uint32_t pass = 0; pass < SOFT_IR_MAX_PASSES; pass++)
+	{
+		SoftIRCountAccesses(&optimizer);
+		bool changed = SoftIRFoldConstants(&optimizer);
+		SoftIRCountAccesses(&optimizer);
+		changed = SoftIRForwardMemory(&optimizer) || changed;
+		SoftIRCountAccesses(&optimizer);
+		changed = SoftIRPropagateCopies(&optimizer) || changed;
+		SoftIRCountAccesses(&optimizer);
+		changed = SoftIRRemoveDeadCode(&optimizer) || changed;
+		changed = SoftIRRemoveUnreachable(&optimizer) || changed;
+		changed = SoftIRRemoveJumpsToNext(&optimizer) || changed;
+		if(!changed)
+			break;
+	}
+	SoftIRRebuild(&optimizer, false, PULSE_NULLPTR);
+
+end:
+	SoftIRReleaseIndex(&optimizer);
+	free(optimizer.writes);
+	free(optimizer.reads);
+	free(optimizer.escaped);
+}
@@ -2,27 +2,366 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <string.h>
+
 #include <Pulse.h>
 #include "../../PulseInternal.h"
 #include "Soft.h"
 #include "SoftImage.h"
+#include "SoftPixelFormat.h"
+#include "SoftCommandList.h"
+
+// 8x8 tiles interleave x and y bits, 4x4x4 tiles interleave x, y and z bits
+static const uint8_t SoftMorton2DX[8] = { 0, 1, 4, 5, 16, 17, 20, 21 };
+static const uint8_t SoftMorton2DY[8] = { 0, 2, 8, 10, 32, 34, 40, 42 };
+static const uint8_t SoftMorton3DX[4] = { 0, 1, 8, 9 };
+static const uint8_t SoftMorton3DY[4] = { 0, 2, 16, 18 };
+static const uint8_t SoftMorton3DZ[4] = { 0, 4, 32, 36 };
+static const uint8_t SoftMortonLayer[1] = { 0 };
 
 PulseImage SoftCreateImage(PulseDevice device, const PulseImageCreateInfo* create_infos)
 {
+	const SoftPixelFormatInfo* info = SoftGetPixelFormatInfo(create_infos->format);
+	if(info->block_size == 0)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "(Soft) unsupported image format");
+		PulseSetInternalError(PULSE_ERROR_INVALID_IMAGE_FORMAT);
+		return PULSE_NULL_HANDLE;
+	}
+
+	PulseImageHandler* image = (PulseImageHandler*)calloc(1, sizeof(PulseImageHandler));
+	PULSE_CHECK_ALLOCATION_RETVAL(image, PULSE_NULL_HANDLE);
+
+	SoftImage* soft_image = (SoftImage*)calloc(1, sizeof(SoftImage));
+	if(soft_image == PULSE_NULLPTR)
+	{
+		free(image);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+
+	image->driver_data = soft_image;
+
+	soft_image->type = create_infos->type;
+	soft_image->format = create_infos->format;
+	soft_image->block_size = info->block_size;
+	soft_image->block_extent = info->block_extent;
+	soft_image->extent[0] = (create_infos->width + info->block_extent - 1) / info->block_extent;
+	soft_image->extent[1] = (create_infos->height + info->block_extent - 1) / info->block_extent;
+	soft_image->extent[2] = create_infos->layer_count_or_depth;
+	soft_image->query_size[0] = create_infos->width;
+	soft_image->query_size[1] = create_infos->height;
+	soft_image->query_size[2] = create_infos->type == PULSE_IMAGE_TYPE_CUBE_ARRAY ? create_infos->layer_count_or_depth / 6 : create_infos->layer_count_or_depth;
+
+	if(create_infos->type == PULSE_IMAGE_TYPE_3D)
+	{
+		for(uint32_t i = 0; i < 3; i++)
+		{
+			soft_image->tile_shift[i] = 2;
+			soft_image->tile_mask[i] = 3;
+		}
+		soft_image->morton[0] = SoftMorton3DX;
+		soft_image->morton[1] = SoftMorton3DY;
+		soft_image->morton[2] = SoftMorton3DZ;
+	}
+	else
+	{
+		soft_image->tile_shift[0] = soft_image->tile_shift[1] = 3;
+		soft_image->tile_mask[0] = soft_image->tile_mask[1] = 7;
+		soft_image->morton[0] = SoftMorton2DX;
+		soft_image->morton[1] = SoftMorton2DY;
+		soft_image->morton[2] = SoftMortonLayer;
+	}
+	soft_image->tiles_count[0] = (soft_image->extent[0] + soft_image->tile_mask[0]) >> soft_image->tile_shift[0];
+	soft_image->tiles_count[1] = (soft_image->extent[1] + soft_image->tile_mask[1]) >> soft_image->tile_shift[1];
+	size_t tiles_z = (soft_image->extent[2] + soft_image->tile_mask[2]) >> soft_image->tile_shift[2];
+
+	soft_image->size = (size_t)soft_image->tiles_count[0] * soft_image->tiles_count[1] * tiles_z * SOFT_IMAGE_TILE_TEXELS * soft_image->block_size;
+	soft_image->data = (uint8_t*)calloc(1, soft_image->size);
+	if(soft_image->data == PULSE_NULLPTR)
+	{
+		free(soft_image);
+		free(image);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+	return image;
 }
 
 bool SoftIsImageFormatValid(PulseDevice device, PulseImageFormat format, PulseImageType type, PulseImageUsageFlags usage)
 {
+	PULSE_UNUSED(device);
+	if(format == PULSE_IMAGE_FORMAT_INVALID || format >= PULSE_IMAGE_FORMAT_MAX_ENUM || type >= PULSE_IMAGE_TYPE_MAX_ENUM)
+		return false;
+	if(SoftGetPixelFormatInfo(format)->encoding == SOFT_PIXEL_ENCODING_COMPRESSED) // Block compressed images can only be copied and blitted
+		return type != PULSE_IMAGE_TYPE_3D && (usage & (PULSE_IMAGE_USAGE_STORAGE_READ | PULSE_IMAGE_USAGE_STORAGE_WRITE | PULSE_IMAGE_USAGE_STORAGE_SIMULTANEOUS_READWRITE)) == 0;
+	return true;
 }
 
 bool SoftCopyImageToBuffer(PulseCommandList cmd, const PulseImageRegion* src, const PulseBufferRegion* dst)
 {
+	SoftCommand command = { 0 };
+	command.type = SOFT_COMMAND_COPY_IMAGE_TO_BUFFER;
+	command.CopyImageToBuffer.src = *src;
+	command.CopyImageToBuffer.dst = *dst;
+	return SoftQueueCommand(cmd, command);
 }
 
 bool SoftBlitImage(PulseCommandList cmd, const PulseImageRegion* src, const PulseImageRegion* dst)
 {
+	SoftCommand command = { 0 };
+	command.type = SOFT_COMMAND_BLIT_IMAGES;
+	command.BlitImages.src = *src;
+	command.BlitImages.dst = *dst;
+	return SoftQueueCommand(cmd, command);
 }
 
 void SoftDestroyImage(PulseDevice device, PulseImage image)
 {
+	PULSE_UNUSED(device);
+	SoftImage* soft_image = SOFT_RETRIEVE_DRIVER_DATA_AS(image, SoftImage*);
+	free(soft_image->data);
+	free(soft_image);
+	free(image);
+}
+
+// Converts a region to blocks, the layer and z offsets both select slices. Returns false if nothing is left once clamped to the image
+static bool SoftGetRegionBlocks(const SoftImage* image, const PulseImageRegion* region, uint32_t origin[3], uint32_t extent[3], uint32_t requested[3])
+{
+	requested[0] = (region->width + image->block_extent - 1) / image->block_extent;
+	requested[1] = (region->height + image->block_extent - 1) / image->block_extent;
+	requested[2] = region->depth == 0 ? 1 : region->depth;
+	origin[0] = region->x / image->block_extent;
+	origin[1] = region->y / image->block_extent;
+	origin[2] = region->layer + region->z;
+	for(uint32_t i = 0; i < 3; i++)
+	{
+		if(origin[i] >= image->extent[i] || requested[i] == 0)
+			return false;
+		extent[i] = image->extent[i] - origin[i];
+		if(extent[i] > requested[i])
+			extent[i] = requested[i];
+	}
+	return true;
+}
+
+#define SOFT_SWIZZLE_SPAN(size) \
+	for(; x < span_end; x++, linear += (size)) \
+	{ \
+		uint8_t* texel = tile + morton_x[x & mask_x] * (size); \
+		if(to_image) \
+			memcpy(texel, linear, (size)); \
+		else \
+			memcpy(linear, texel, (size)); \
+	}
+
+// Walks a row one tile at a time so the y and z Morton bits are only computed once per tile,
+// constant block sizes let the copies compile down to plain moves
+static void SoftSwizzleRow(const SoftImage* image, uint32_t x, uint32_t y, uint32_t z, uint32_t count, uint8_t* linear, bool to_image)
+{
+	const uint8_t* morton_x = image->morton[0];
+	uint32_t mask_x = image->tile_mask[0];
+	uint32_t end = x + count;
+	while(x < end)
+	{
+		uint32_t span_end = ((x >> image->tile_shift[0]) + 1) << image->tile_shift[0];
+		if(span_end > end)
+			span_end = end;
+		uint8_t* tile = image->data + SoftGetImageBlockOffset(image, x & ~mask_x, y, z);
+		switch(image->block_size)
+		{
+			case 1:  SOFT_SWIZZLE_SPAN(1); break;
+			case 2:  SOFT_SWIZZLE_SPAN(2); break;
+			case 4:  SOFT_SWIZZLE_SPAN(4); break;
+			case 8:  SOFT_SWIZZLE_SPAN(8); break;
+			case 16: SOFT_SWIZZLE_SPAN(16); break;
+
+			default: SOFT_SWIZZLE_SPAN(image->block_size); break;
+		}
+	}
+}
+
+#undef SOFT_SWIZZLE_SPAN
+
+uint32_t SoftGetSwizzleRowsCount(const PulseImageRegion* region, size_t* row_size)
+{
+	const SoftImage* image = SOFT_RETRIEVE_DRIVER_DATA_AS(region->image, SoftImage*);
+	uint32_t origin[3];
+	uint32_t extent[3];
+	uint32_t requested[3];
+	*row_size = 0;
+	if(!SoftGetRegionBlocks(image, region, origin, extent, requested))
+		return 0;
+	*row_size = (size_t)extent[0] * image->block_size;
+	return extent[1] * extent[2];
+}
+
+void SoftSwizzleRows(const PulseImageRegion* region, uint8_t* linear, size_t linear_size, bool to_image, uint32_t first_row, uint32_t rows_count)
+{
+	const SoftImage* image = SOFT_RETRIEVE_DRIVER_DATA_AS(region->image, SoftImage*);
+	uint32_t origin[3];
+	uint32_t extent[3];
+	uint32_t requested[3];
+	if(!SoftGetRegionBlocks(image, region, origin, extent, requested))
+		return;
+
+	size_t row_pitch = (size_t)requested[0] * image->block_size;
+	size_t slice_pitch = row_pitch * requested[1];
+	size_t row_size = (size_t)extent[0] * image->block_size;
+	for(uint32_t row = first_row; row < first_row + rows_count && row < extent[1] * extent[2]; row++)
+	{
+		uint32_t y = row % extent[1];
+		uint32_t z = row / extent[1];
+		size_t offset = z * slice_pitch + y * row_pitch;
+		if(offset + row_size > linear_size)
+			return;
+		SoftSwizzleRow(image, origin[0], origin[1] + y, origin[2] + z, extent[0], linear + offset, to_image);
+	}
+}
+
+// Compressed sources are addressed in texels, x and y of the region are converted back from blocks
+static bool SoftGetRegionTexels(const SoftImage* image, const PulseImageRegion* region, uint32_t origin[3], uint32_t extent[3], uint32_t requested[3])
+{
+	if(!SoftGetRegionBlocks(image, region, origin, extent, requested))
+		return false;
+	origin[0] = region->x;
+	origin[1] = region->y;
+	requested[0] = region->width;
+	requested[1] = region->height;
+	for(uint32_t i = 0; i < 2; i++)
+	{
+		if(origin[i] >= image->query_size[i])
+			return false;
+		extent[i] = image->query_size[i] - origin[i];
+		if(extent[i] > requested[i])
+			extent[i] = requested[i];
+	}
+	return true;
+}
+
+// Decodes a row of texels from a compressed image, consecutive texels of the same block only decode it once
+static void SoftGatherCompressedRow(const SoftImage* image, const uint32_t* xs, uint32_t y, uint32_t z, uint32_t count, uint32_t* values)
+{
+	uint32_t block_values[SOFT_PIXEL_BLOCK_TEXELS * 4];
+	uint32_t decoded_block = UINT32_MAX;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t block_x = xs[i] / image->block_extent;
+		if(block_x != decoded_block)
+		{
+			SoftDecodeBlock(image->format, image->data + SoftGetImageBlockOffset(image, block_x, y / image->block_extent, z), block_values);
+			decoded_block = block_x;
+		}
+		memcpy(values + i * 4, block_values + ((y % image->block_extent) * image->block_extent + xs[i] % image->block_extent) * 4, 4 * sizeof(uint32_t));
+	}
+}
+
+// Nearest filtering. Each destination row is gathered from the source, converted through the row
+// decoders and encoders when the formats differ, then written back to the destination tiles
+void SoftBlitImageRegion(const PulseImageRegion* src, const PulseImageRegion* dst)
+{
+	const SoftImage* src_image = SOFT_RETRIEVE_DRIVER_DATA_AS(src->image, SoftImage*);
+	SoftImage* dst_image = SOFT_RETRIEVE_DRIVER_DATA_AS(dst->image, SoftImage*);
+
+	bool raw_copy = src_image->format == dst_image->format;
+	bool decode_blocks = false;
+	if(!raw_copy)
+	{
+		if(SoftGetPixelFormatInfo(dst_image->format)->encoding == SOFT_PIXEL_ENCODING_COMPRESSED)
+			return;
+		if(SoftIsPixelFormatInteger(src_image->format) != SoftIsPixelFormatInteger(dst_image->format))
+			return;
+		decode_blocks = SoftGetPixelFormatInfo(src_image->format)->encoding == SOFT_PIXEL_ENCODING_COMPRESSED;
+	}
+
+	uint32_t src_origin[3], src_extent[3], src_requested[3];
+	uint32_t dst_origin[3], dst_extent[3], dst_requested[3];
+	bool src_valid = decode_blocks ? SoftGetRegionTexels(src_image, src, src_origin, src_extent, src_requested) : SoftGetRegionBlocks(src_image, src, src_origin, src_extent, src_requested);
+	if(!src_valid || !SoftGetRegionBlocks(dst_image, dst, dst_origin, dst_extent, dst_requested))
+		return;
+
+	// The nearest source column only grows with x so the texels that land in the source region are a prefix of the row
+	uint32_t row_count = 0;
+	while(row_count < dst_extent[0] && ((uint64_t)row_count * src_requested[0]) / dst_requested[0] < src_extent[0])
+		row_count++;
+	if(row_count == 0)
+		return;
+	bool is_scaled = src_requested[0] != dst_requested[0];
+
+	size_t values_size = raw_copy ? 0 : (size_t)row_count * 4 * sizeof(uint32_t);
+	size_t xs_size = (size_t)row_count * sizeof(uint32_t);
+	size_t src_row_size = (size_t)row_count * src_image->block_size;
+	uint8_t* scratch = (uint8_t*)malloc(values_size + xs_size + src_row_size + (size_t)row_count * dst_image->block_size);
+	if(scratch == PULSE_NULLPTR)
+	{
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return;
+	}
+	uint32_t* values = (uint32_t*)scratch;
+	uint32_t* xs = (uint32_t*)(scratch + values_size);
+	uint8_t* src_row = scratch + values_size + xs_size;
+	uint8_t* dst_row = src_row + src_row_size;
+	for(uint32_t x = 0; x < row_count; x++)
+		xs[x] = src_origin[0] + (uint32_t)(((uint64_t)x * src_requested[0]) / dst_requested[0]);
+
+	for(uint32_t z = 0; z < dst_extent[2]; z++)
+	{
+		uint32_t src_z = (uint32_t)(((uint64_t)z * src_requested[2]) / dst_requested[2]);
+		if(src_z >= src_extent[2])
+			continue;
+		for(uint32_t y = 0; y < dst_extent[1]; y++)
+		{
+			uint32_t src_y = (uint32_t)(((uint64_t)y * src_requested[1]) / dst_requested[1]);
+			if(src_y >= src_extent[1])
+				continue;
+
+			if(decode_blocks)
+				SoftGatherCompressedRow(src_image, xs, src_origin[1] + src_y, src_origin[2] + src_z, row_count, values);
+			else
+			{
+				if(!is_scaled)
+					SoftSwizzleRow(src_image, src_origin[0], src_origin[1] + src_y, src_origin[2] + src_z, row_count, src_row, false);
+				else
+				{
+					for(uint32_t x = 0; x < row_count; x++)
+						memcpy(src_row + (size_t)x * src_image->block_size, src_image->data + SoftGetImageBlockOffset(src_image, xs[x], src_origin[1] + src_y, src_origin[2] + src_z), src_image->block_size);
+				}
+				if(!raw_copy)
+					SoftDecodeTexels(src_image->format, src_row, values, row_count);
+			}
+
+			if(raw_copy)
+				SoftSwizzleRow(dst_image, dst_origin[0], dst_origin[1] + y, dst_origin[2] + z, row_count, src_row, true);
+			else
+			{
+				SoftEncodeTexels(dst_image->format, values, dst_row, row_count);
+				SoftSwizzleRow(dst_image, dst_origin[0], dst_origin[1] + y, dst_origin[2] + z, row_count, dst_row, true);
+			}
+		}
+	}
+	free(scratch);
+}
+
+// Coordinates are in texels, compressed images decode the whole block holding the texel
+void SoftReadImageTexel(const SoftImage* image, const uint32_t coords[3], uint32_t values[4])
+{
+	if(coords[0] >= image->query_size[0] || coords[1] >= image->query_size[1] || coords[2] >= image->extent[2])
+	{
+		memset(values, 0, 4 * sizeof(uint32_t));
+		return;
+	}
+	if(image->block_extent != 1)
+	{
+		SoftGatherCompressedRow(image, coords, coords[1], coords[2], 1, values);
+		return;
+	}
+	SoftDecodeTexel(image->format, image->data + SoftGetImageBlockOffset(image, coords[0], coords[1], coords[2]), values);
+}
+
+void SoftWriteImageTexel(SoftImage* image, const uint32_t coords[3], const uint32_t values[4])
+{
+	if(coords[0] >= image->extent[0] || coords[1] >= image->extent[1] || coords[2] >= image->extent[2])
+		return;
+	SoftEncodeTexel(image->format, values, image->data + SoftGetImageBlockOffset(image, coords[0], coords[1], coords[2]));
 }
@@ -11,17 +11,50 @@
 
 #include "Soft.h"
 
+// Images are stored as tiles of 64 texels (or blocks for compressed formats), 8x8 for 2D,
+// layered and cube images and 4x4x4 for 3D images, with texels in Morton order inside a tile.
+// Layers and cube faces are addressed as the z coordinate.
+#define SOFT_IMAGE_TILE_TEXELS 64
+
 typedef struct SoftImage
 {
-	int dummy;
+	uint8_t* data;
+	size_t size;
+	PulseImageType type;
+	PulseImageFormat format;
+	uint32_t block_size;
+	uint32_t block_extent;
+	uint32_t extent[3]; // In blocks, z is the depth or the number of layers
+	uint32_t query_size[3]; // What shaders get from image size queries
+	uint32_t tiles_count[2];
+	uint32_t tile_shift[3];
+	uint32_t tile_mask[3];
+	const uint8_t* morton[3]; // Per axis Morton bits of a coordinate inside a tile
 } SoftImage;
 
+static inline size_t SoftGetImageBlockOffset(const SoftImage* image, uint32_t x, uint32_t y, uint32_t z)
+{
+	size_t tile = ((size_t)(z >> image->tile_shift[2]) * image->tiles_count[1] + (y >> image->tile_shift[1])) * image->tiles_count[0] + (x >> image->tile_shift[0]);
+	uint32_t morton = image->morton[0][x & image->tile_mask[0]] | image->morton[1][y & image->tile_mask[1]] | image->morton[2][z & image->tile_mask[2]];
+	return (tile * SOFT_IMAGE_TILE_TEXELS + morton) * image->block_size;
+}
+
 PulseImage SoftCreateImage(PulseDevice device, const PulseImageCreateInfo* create_infos);
 bool SoftIsImageFormatValid(PulseDevice device, PulseImageFormat format, PulseImageType type, PulseImageUsageFlags usage);
 bool SoftCopyImageToBuffer(PulseCommandList cmd, const PulseImageRegion* src, const PulseBufferRegion* dst);
 bool SoftBlitImage(PulseCommandList cmd, const PulseImageRegion* src, const PulseImageRegion* dst);
 void SoftDestroyImage(PulseDevice device, PulseImage image);
 
+// Buffers are tightly packed for the region, regions are clamped to the image and the buffer.
+// Rows are counted slice after slice so that a copy can be split across workers
+uint32_t SoftGetSwizzleRowsCount(const PulseImageRegion* region, size_t* row_size);
+void SoftSwizzleRows(const PulseImageRegion* region, uint8_t* linear, size_t linear_size, bool to_image, uint32_t first_row, uint32_t rows_count);
+void SoftBlitImageRegion(const PulseImageRegion* src, const PulseImageRegion* dst);
+
+// Storage image accesses, texels use the SoftDecodeTexel layout. Out of bounds reads return zeros and writes are dropped
+void SoftReadImageTexel(const SoftImage* image, const uint32_t coords[3], uint32_t values[4]);
+void SoftWriteImageTexel(SoftImage* image, const uint32_t coords[3], const uint32_t values[4]);
+
 #endif // PULSE_SOFTWARE_IMAGE_H_
 
 #endif // PULSE_ENABLE_SOFTWARE_BACKEND
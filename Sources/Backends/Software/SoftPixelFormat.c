@@ -0,0 +1,271 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+#include <cpuinfo.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftPixelFormat.h"
+
+#if (defined(PULSE_COMPILER_GCC) || defined(PULSE_COMPILER_CLANG)) && (defined(__x86_64__) || defined(__i386__))
+	#define SOFT_PIXEL_FORMAT_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define SOFT_PIXEL_FORMAT_TARGET(isa)
+#endif
+
+static const SoftPixelFormatInfo SoftPixelFormatInfos[] = {
+	{ 0,  1, 0, 0,  SOFT_PIXEL_ENCODING_UNORM },      // INVALID
+	{ 1,  1, 1, 8,  SOFT_PIXEL_ENCODING_UNORM },      // A8_UNORM
+	{ 1,  1, 1, 8,  SOFT_PIXEL_ENCODING_UNORM },      // R8_UNORM
+	{ 2,  1, 2, 8,  SOFT_PIXEL_ENCODING_UNORM },      // R8G8_UNORM
+	{ 4,  1, 4, 8,  SOFT_PIXEL_ENCODING_UNORM },      // R8G8B8A8_UNORM
+	{ 2,  1, 1, 16, SOFT_PIXEL_ENCODING_UNORM },      // R16_UNORM
+	{ 4,  1, 2, 16, SOFT_PIXEL_ENCODING_UNORM },      // R16G16_UNORM
+	{ 8,  1, 4, 16, SOFT_PIXEL_ENCODING_UNORM },      // R16G16B16A16_UNORM
+	{ 4,  1, 4, 0,  SOFT_PIXEL_ENCODING_PACKED },     // R10G10B10A2_UNORM
+	{ 2,  1, 3, 0,  SOFT_PIXEL_ENCODING_PACKED },     // B5G6R5_UNORM
+	{ 2,  1, 4, 0,  SOFT_PIXEL_ENCODING_PACKED },     // B5G5R5A1_UNORM
+	{ 2,  1, 4, 0,  SOFT_PIXEL_ENCODING_PACKED },     // B4G4R4A4_UNORM
+	{ 4,  1, 4, 8,  SOFT_PIXEL_ENCODING_UNORM },      // B8G8R8A8_UNORM
+	{ 8,  4, 4, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC1_RGBA_UNORM
+	{ 16, 4, 4, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC2_RGBA_UNORM
+	{ 16, 4, 4, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC3_RGBA_UNORM
+	{ 8,  4, 1, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC4_R_UNORM
+	{ 16, 4, 2, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC5_RG_UNORM
+	{ 16, 4, 4, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC7_RGBA_UNORM
+	{ 16, 4, 3, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC6H_RGB_FLOAT
+	{ 16, 4, 3, 0,  SOFT_PIXEL_ENCODING_COMPRESSED }, // BC6H_RGB_UFLOAT
+	{ 1,  1, 1, 8,  SOFT_PIXEL_ENCODING_SNORM },      // R8_SNORM
+	{ 2,  1, 2, 8,  SOFT_PIXEL_ENCODING_SNORM },      // R8G8_SNORM
+	{ 4,  1, 4, 8,  SOFT_PIXEL_ENCODING_SNORM },      // R8G8B8A8_SNORM
+	{ 2,  1, 1, 16, SOFT_PIXEL_ENCODING_SNORM },      // R16_SNORM
+	{ 4,  1, 2, 16, SOFT_PIXEL_ENCODING_SNORM },      // R16G16_SNORM
+	{ 8,  1, 4, 16, SOFT_PIXEL_ENCODING_SNORM },      // R16G16B16A16_SNORM
+	{ 2,  1, 1, 16, SOFT_PIXEL_ENCODING_FLOAT },      // R16_FLOAT
+	{ 4,  1, 2, 16, SOFT_PIXEL_ENCODING_FLOAT },      // R16G16_FLOAT
+	{ 8,  1, 4, 16, SOFT_PIXEL_ENCODING_FLOAT },      // R16G16B16A16_FLOAT
+	{ 4,  1, 1, 32, SOFT_PIXEL_ENCODING_FLOAT },      // R32_FLOAT
+	{ 8,  1, 2, 32, SOFT_PIXEL_ENCODING_FLOAT },      // R32G32_FLOAT
+	{ 16, 1, 4, 32, SOFT_PIXEL_ENCODING_FLOAT },      // R32G32B32A32_FLOAT
+	{ 4,  1, 3, 0,  SOFT_PIXEL_ENCODING_PACKED },     // R11G11B10_UFLOAT
+	{ 1,  1, 1, 8,  SOFT_PIXEL_ENCODING_UINT },       // R8_UINT
+	{ 2,  1, 2, 8,  SOFT_PIXEL_ENCODING_UINT },       // R8G8_UINT
+	{ 4,  1, 4, 8,  SOFT_PIXEL_ENCODING_UINT },       // R8G8B8A8_UINT
+	{ 2,  1, 1, 16, SOFT_PIXEL_ENCODING_UINT },       // R16_UINT
+	{ 4,  1, 2, 16, SOFT_PIXEL_ENCODING_UINT },       // R16G16_UINT
+	{ 8,  1, 4, 16, SOFT_PIXEL_ENCODING_UINT },       // R16G16B16A16_UINT
+	{ 4,  1, 1, 32, SOFT_PIXEL_ENCODING_UINT },       // R32_UINT
+	{ 8,  1, 2, 32, SOFT_PIXEL_ENCODING_UINT },       // R32G32_UINT
+	{ 16, 1, 4, 32, SOFT_PIXEL_ENCODING_UINT },       // R32G32B32A32_UINT
+	{ 1,  1, 1, 8,  SOFT_PIXEL_ENCODING_SINT },       // R8_INT
+	{ 2,  1, 2, 8,  SOFT_PIXEL_ENCODING_SINT },       // R8G8_INT
+	{ 4,  1, 4, 8,  SOFT_PIXEL_ENCODING_SINT },       // R8G8B8A8_INT
+	{ 2,  1, 1, 16, SOFT_PIXEL_ENCODING_SINT },       // R16_INT
+	{ 4,  1, 2, 16, SOFT_PIXEL_ENCODING_SINT },       // R16G16_INT
+	{ 8,  1, 4, 16, SOFT_PIXEL_ENCODING_SINT },       // R16G16B16A16_INT
+	{ 4,  1, 1, 32, SOFT_PIXEL_ENCODING_SINT },       // R32_INT
+	{ 8,  1, 2, 32, SOFT_PIXEL_ENCODING_SINT },       // R32G32_INT
+	{ 16, 1, 4, 32, SOFT_PIXEL_ENCODING_SINT },       // R32G32B32A32_INT
+};
+PULSE_STATIC_ASSERT(SoftPixelFormatInfos, PULSE_SIZEOF_ARRAY(SoftPixelFormatInfos) == PULSE_IMAGE_FORMAT_MAX_ENUM);
+
+const SoftPixelFormatInfo* SoftGetPixelFormatInfo(PulseImageFormat format)
+{
+	if((uint32_t)format >= PULSE_IMAGE_FORMAT_MAX_ENUM)
+		return &SoftPixelFormatInfos[PULSE_IMAGE_FORMAT_INVALID];
+	return &SoftPixelFormatInfos[format];
+}
+
+bool SoftIsPixelFormatInteger(PulseImageFormat format)
+{
+	SoftPixelEncoding encoding = SoftGetPixelFormatInfo(format)->encoding;
+	return encoding == SOFT_PIXEL_ENCODING_UINT || encoding == SOFT_PIXEL_ENCODING_SINT;
+}
+
+static inline uint32_t SoftFloatBits(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(uint32_t));
+	return bits;
+}
+
+static inline float SoftBitsFloat(uint32_t bits)
+{
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+// Floats with a 5 bits exponent, halves are signed with 10 bits of mantissa, the R11G11B10 channels are unsigned with 6 and 5
+static uint32_t SoftPackMinifloat(uint32_t bits, uint32_t mantissa_bits, bool is_signed)
+{
+	uint32_t sign = bits >> 31;
+	uint32_t exponent = (bits >> 23) & 0xFF;
+	uint32_t mantissa = bits & 0x7FFFFF;
+	uint32_t sign_bit = is_signed ? sign << (mantissa_bits + 5) : 0;
+
+	if(exponent == 0xFF)
+	{
+		if(!is_signed && sign && mantissa == 0)
+			return 0;
+		return sign_bit | (0x1Fu << mantissa_bits) | (mantissa != 0 ? 1u << (mantissa_bits - 1) : 0);
+	}
+	if(!is_signed && sign)
+		return 0;
+
+	int32_t biased = (int32_t)exponent - 127 + 15;
+	if(biased >= 31)
+		return sign_bit | (0x1Fu << mantissa_bits);
+
+	uint32_t shift;
+	uint32_t value;
+	if(biased <= 0)
+	{
+		if(biased < -(int32_t)mantissa_bits)
+			return sign_bit;
+		mantissa |= 0x800000;
+		shift = (23 - mantissa_bits) + 1 - biased;
+		value = mantissa >> shift;
+	}
+	else
+	{
+		shift = 23 - mantissa_bits;
+		value = ((uint32_t)biased << mantissa_bits) | (mantissa >> shift);
+	}
+	// Round to nearest even, a carry out of the mantissa correctly bumps the exponent
+	uint32_t remainder = mantissa & ((1u << shift) - 1);
+	uint32_t halfway = 1u << (shift - 1);
+	if(remainder > halfway || (remainder == halfway && (value & 1)))
+		value++;
+	return sign_bit | value;
+}
+
+static uint32_t SoftUnpackMinifloat(uint32_t value, uint32_t mantissa_bits, bool is_signed)
+{
+	uint32_t sign = is_signed ? ((value >> (mantissa_bits + 5)) & 1) << 31 : 0;
+	int32_t exponent = (int32_t)((value >> mantissa_bits) & 0x1F);
+	uint32_t mantissa = value & ((1u << mantissa_bits) - 1);
+
+	if(exponent == 0x1F)
+		return sign | (0xFFu << 23) | (mantissa << (23 - mantissa_bits));
+	if(exponent == 0)
+	{
+		if(mantissa == 0)
+			return sign;
+		exponent = 1;
+		while((mantissa & (1u << mantissa_bits)) == 0)
+		{
+			mantissa <<= 1;
+			exponent--;
+		}
+		mantissa &= (1u << mantissa_bits) - 1;
+	}
+	return sign | ((uint32_t)(exponent - 15 + 127) << 23) | (mantissa << (23 - mantissa_bits));
+}
+
+// Halves are converted with masks instead of branches so that rows vectorize, rounding matches SoftPackMinifloat
+static inline uint32_t SoftHalfToFloatBits(uint32_t half)
+{
+	uint32_t bits = (half & 0x7FFF) << 13;
+	uint32_t exponent = bits & (0x7C00 << 13);
+	uint32_t is_special = 0u - (uint32_t)(exponent == (0x7C00 << 13)); // Infinities and NaNs
+	uint32_t is_subnormal = 0u - (uint32_t)(exponent == 0);
+	bits += (127 - 15) << 23;
+	bits += is_special & ((128 - 16) << 23);
+	uint32_t subnormal = SoftFloatBits(SoftBitsFloat(bits + (1 << 23)) - SoftBitsFloat(113 << 23));
+	bits = (bits & ~is_subnormal) | (subnormal & is_subnormal);
+	return bits | ((half & 0x8000) << 16);
+}
+
+static inline uint32_t SoftFloatBitsToHalf(uint32_t bits)
+{
+	uint32_t sign = bits & 0x80000000;
+	bits ^= sign;
+	uint32_t is_nan = 0u - (uint32_t)(bits > (255u << 23));
+	uint32_t is_overflow = 0u - (uint32_t)(bits >= ((127u + 16) << 23));
+	uint32_t is_subnormal = 0u - (uint32_t)(bits < (113u << 23));
+	// Adding the magic value lets the FPU do the round to nearest even of subnormals
+	uint32_t subnormal = SoftFloatBits(SoftBitsFloat(bits) + SoftBitsFloat(((127 - 15) + (23 - 10) + 1) << 23)) - (((127 - 15) + (23 - 10) + 1) << 23);
+	uint32_t normal = (bits + ((uint32_t)(15 - 127) << 23) + 0xFFF + ((bits >> 13) & 1)) >> 13;
+	uint32_t half = (normal & ~is_subnormal) | (subnormal & is_subnormal);
+	half = (half & ~is_overflow) | ((0x7C00 | (is_nan & 0x200)) & is_overflow);
+	return half | (sign >> 16);
+}
+
+// Clamping is done on the bits as float compares are seen as control flow by the vectorizer.
+// NaNs pack to 0 and values are rounded to nearest, away from zero for ties
+static inline uint32_t SoftPackUnorm(uint32_t bits, uint32_t max)
+{
+	uint32_t is_zero = 0u - (uint32_t)(((int32_t)bits <= 0) | (bits > 0x7F800000));
+	uint32_t is_one = 0u - (uint32_t)(bits >= 0x3F800000);
+	bits = ((bits & ~is_one) | (0x3F800000 & is_one)) & ~is_zero;
+	return (uint32_t)(int32_t)(SoftBitsFloat(bits) * (float)max + 0.5f);
+}
+
+static inline uint32_t SoftPackSnorm(uint32_t bits, int32_t max)
+{
+	uint32_t sign = 0u - (bits >> 31);
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+	uint32_t is_one = 0u - (uint32_t)(magnitude >= 0x3F800000);
+	uint32_t is_nan = 0u - (uint32_t)(magnitude > 0x7F800000);
+	magnitude = ((magnitude & ~is_one) | (0x3F800000 & is_one)) & ~is_nan;
+	uint32_t value = (uint32_t)(int32_t)(SoftBitsFloat(magnitude) * (float)max + 0.5f);
+	return (value ^ sign) - sign;
+}
+
+static inline uint32_t SoftUnpackUnorm(uint32_t value, uint32_t max)
+{
+	return SoftFloatBits((float)(int32_t)value / (float)max);
+}
+
+static inline uint32_t SoftUnpackSnorm(int32_t value, int32_t max)
+{
+	float result = (float)value / (float)max;
+	return SoftFloatBits(result < -1.0f ? -1.0f : result);
+}
+
+#define SOFT_PIXEL_ROWS_DECODE SoftDecodeTexelsDefault
+#define SOFT_PIXEL_ROWS_ENCODE SoftEncodeTexelsDefault
+#define SOFT_PIXEL_ROWS_TARGET
+#include "SoftPixelFormatRows.inl"
+#undef SOFT_PIXEL_ROWS_DECODE
+#undef SOFT_PIXEL_ROWS_ENCODE
+#undef SOFT_PIXEL_ROWS_TARGET
+
+#define SOFT_PIXEL_ROWS_DECODE SoftDecodeTexelsAVX2
+#define SOFT_PIXEL_ROWS_ENCODE SoftEncodeTexelsAVX2
+#define SOFT_PIXEL_ROWS_TARGET SOFT_PIXEL_FORMAT_TARGET("avx2")
+#include "SoftPixelFormatRows.inl"
+#undef SOFT_PIXEL_ROWS_DECODE
+#undef SOFT_PIXEL_ROWS_ENCODE
+#undef SOFT_PIXEL_ROWS_TARGET
+
+// Single texels skip the dispatch, the baseline variant is already vectorized for SSE2 and NEON
+void SoftDecodeTexel(PulseImageFormat format, const uint8_t* texel, uint32_t values[4])
+{
+	SoftDecodeTexelsDefault(format, texel, values, 1);
+}
+
+void SoftEncodeTexel(PulseImageFormat format, const uint32_t values[4], uint8_t* texel)
+{
+	SoftEncodeTexelsDefault(format, values, texel, 1);
+}
+
+void SoftDecodeTexels(PulseImageFormat format, const uint8_t* src, uint32_t* values, uint32_t count)
+{
+	if(cpuinfo_has_x86_avx2())
+		SoftDecodeTexelsAVX2(format, src, values, count);
+	else
+		SoftDecodeTexelsDefault(format, src, values, count);
+}
+
+void SoftEncodeTexels(PulseImageFormat format, const uint32_t* values, uint8_t* dst, uint32_t count)
+{
+	if(cpuinfo_has_x86_avx2())
+		SoftEncodeTexelsAVX2(format, values, dst, count);
+	else
+		SoftEncodeTexelsDefault(format, values, dst, count);
+}
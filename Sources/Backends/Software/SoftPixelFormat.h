@@ -0,0 +1,54 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_PIXEL_FORMAT_H_
+#define PULSE_SOFTWARE_PIXEL_FORMAT_H_
+
+#include "Soft.h"
+
+#define SOFT_PIXEL_BLOCK_TEXELS 16
+
+typedef enum SoftPixelEncoding
+{
+	SOFT_PIXEL_ENCODING_UNORM = 0,
+	SOFT_PIXEL_ENCODING_SNORM,
+	SOFT_PIXEL_ENCODING_UINT,
+	SOFT_PIXEL_ENCODING_SINT,
+	SOFT_PIXEL_ENCODING_FLOAT,
+	SOFT_PIXEL_ENCODING_PACKED, // Sub byte channels, always normalized or float
+	SOFT_PIXEL_ENCODING_COMPRESSED,
+} SoftPixelEncoding;
+
+typedef struct SoftPixelFormatInfo
+{
+	uint8_t block_size; // Bytes per texel, or per block for compressed formats
+	uint8_t block_extent; // Texels per block side, 1 for uncompressed formats
+	uint8_t channels_count;
+	uint8_t channel_bits; // 8, 16 or 32 bits per channel, 0 for packed and compressed formats
+	SoftPixelEncoding encoding;
+} SoftPixelFormatInfo;
+
+const SoftPixelFormatInfo* SoftGetPixelFormatInfo(PulseImageFormat format);
+bool SoftIsPixelFormatInteger(PulseImageFormat format);
+
+// Texels are exchanged as four 32 bits words, floats for normalized and float formats and
+// integers otherwise. Missing channels read as 0 and missing alpha as 1
+void SoftDecodeTexel(PulseImageFormat format, const uint8_t* texel, uint32_t values[4]);
+void SoftEncodeTexel(PulseImageFormat format, const uint32_t values[4], uint8_t* texel);
+
+// Same as above for tightly packed rows, picks the widest instruction set the CPU supports.
+// Compressed texels decode to the defaults and are never encoded, see SoftDecodeBlock
+void SoftDecodeTexels(PulseImageFormat format, const uint8_t* src, uint32_t* values, uint32_t count);
+void SoftEncodeTexels(PulseImageFormat format, const uint32_t* values, uint8_t* dst, uint32_t count);
+
+// Decodes the 4x4 texels of a BC1 to BC7 block in row major order. Malformed blocks decode to zeros
+void SoftDecodeBlock(PulseImageFormat format, const uint8_t* block, uint32_t values[SOFT_PIXEL_BLOCK_TEXELS * 4]);
+
+#endif // PULSE_SOFTWARE_PIXEL_FORMAT_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
@@ -0,0 +1,477 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftPixelFormat.h"
+
+// BC7 partitions, one bit per texel for two subsets and two bits per texel for three subsets.
+// BC6H uses the first 32 two subsets partitions
+static const uint16_t SoftBC7Partitions2[64] = {
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+static const uint32_t SoftBC7Partitions3[64] = {
+	0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+	0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+	0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+	0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+	0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+	0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+	0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+	0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// Texels whose index drops its most significant bit, the first subset always anchors on texel 0
+static const uint8_t SoftBC7Anchors2[64] = {
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+	6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+static const uint8_t SoftBC7Anchors3Second[64] = {
+	3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+	3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+	8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+	3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+};
+
+static const uint8_t SoftBC7Anchors3Third[64] = {
+	15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+	15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+	15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+	15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+};
+
+static const uint8_t SoftBCWeights2[4] = { 0, 21, 43, 64 };
+static const uint8_t SoftBCWeights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t SoftBCWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+typedef struct SoftBC7Mode
+{
+	uint8_t subsets_count;
+	uint8_t partition_bits;
+	uint8_t rotation_bits;
+	uint8_t index_selection_bits;
+	uint8_t color_bits;
+	uint8_t alpha_bits;
+	uint8_t endpoint_pbits;
+	uint8_t shared_pbits;
+	uint8_t index_bits;
+	uint8_t secondary_index_bits;
+} SoftBC7Mode;
+
+static const SoftBC7Mode SoftBC7Modes[8] = {
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+// BC6H endpoint bits in stream order as endpoint, channel, lowest bit and bits count.
+// Reversed fields of the high precision modes are split in single bits
+static const uint8_t SoftBC6HFields[14][25][4] = {
+	{ { 2, 1, 4, 1 }, { 2, 2, 4, 1 }, { 3, 2, 4, 1 }, { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 5 }, { 3, 1, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 5 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 5 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 5 }, { 3, 2, 2, 1 }, { 3, 0, 0, 5 }, { 3, 2, 3, 1 } },
+	{ { 2, 1, 5, 1 }, { 3, 1, 4, 1 }, { 3, 1, 5, 1 }, { 0, 0, 0, 7 }, { 3, 2, 0, 1 }, { 3, 2, 1, 1 }, { 2, 2, 4, 1 }, { 0, 1, 0, 7 }, { 2, 2, 5, 1 }, { 3, 2, 2, 1 }, { 2, 1, 4, 1 }, { 0, 2, 0, 7 }, { 3, 2, 3, 1 }, { 3, 2, 5, 1 }, { 3, 2, 4, 1 }, { 1, 0, 0, 6 }, { 2, 1, 0, 4 }, { 1, 1, 0, 6 }, { 3, 1, 0, 4 }, { 1, 2, 0, 6 }, { 2, 2, 0, 4 }, { 2, 0, 0, 6 }, { 3, 0, 0, 6 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 5 }, { 0, 0, 10, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 4 }, { 0, 1, 10, 1 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 4 }, { 0, 2, 10, 1 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 5 }, { 3, 2, 2, 1 }, { 3, 0, 0, 5 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 4 }, { 0, 0, 10, 1 }, { 3, 1, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 5 }, { 0, 1, 10, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 4 }, { 0, 2, 10, 1 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 4 }, { 3, 2, 0, 1 }, { 3, 2, 2, 1 }, { 3, 0, 0, 4 }, { 2, 1, 4, 1 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 4 }, { 0, 0, 10, 1 }, { 2, 2, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 4 }, { 0, 1, 10, 1 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 5 }, { 0, 2, 10, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 4 }, { 3, 2, 1, 1 }, { 3, 2, 2, 1 }, { 3, 0, 0, 4 }, { 3, 2, 4, 1 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 9 }, { 2, 2, 4, 1 }, { 0, 1, 0, 9 }, { 2, 1, 4, 1 }, { 0, 2, 0, 9 }, { 3, 2, 4, 1 }, { 1, 0, 0, 5 }, { 3, 1, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 5 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 5 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 5 }, { 3, 2, 2, 1 }, { 3, 0, 0, 5 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 8 }, { 3, 1, 4, 1 }, { 2, 2, 4, 1 }, { 0, 1, 0, 8 }, { 3, 2, 2, 1 }, { 2, 1, 4, 1 }, { 0, 2, 0, 8 }, { 3, 2, 3, 1 }, { 3, 2, 4, 1 }, { 1, 0, 0, 6 }, { 2, 1, 0, 4 }, { 1, 1, 0, 5 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 5 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 6 }, { 3, 0, 0, 6 } },
+	{ { 0, 0, 0, 8 }, { 3, 2, 0, 1 }, { 2, 2, 4, 1 }, { 0, 1, 0, 8 }, { 2, 1, 5, 1 }, { 2, 1, 4, 1 }, { 0, 2, 0, 8 }, { 3, 1, 5, 1 }, { 3, 2, 4, 1 }, { 1, 0, 0, 5 }, { 3, 1, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 6 }, { 3, 1, 0, 4 }, { 1, 2, 0, 5 }, { 3, 2, 1, 1 }, { 2, 2, 0, 4 }, { 2, 0, 0, 5 }, { 3, 2, 2, 1 }, { 3, 0, 0, 5 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 8 }, { 3, 2, 1, 1 }, { 2, 2, 4, 1 }, { 0, 1, 0, 8 }, { 2, 2, 5, 1 }, { 2, 1, 4, 1 }, { 0, 2, 0, 8 }, { 3, 2, 5, 1 }, { 3, 2, 4, 1 }, { 1, 0, 0, 5 }, { 3, 1, 4, 1 }, { 2, 1, 0, 4 }, { 1, 1, 0, 5 }, { 3, 2, 0, 1 }, { 3, 1, 0, 4 }, { 1, 2, 0, 6 }, { 2, 2, 0, 4 }, { 2, 0, 0, 5 }, { 3, 2, 2, 1 }, { 3, 0, 0, 5 }, { 3, 2, 3, 1 } },
+	{ { 0, 0, 0, 6 }, { 3, 1, 4, 1 }, { 3, 2, 0, 1 }, { 3, 2, 1, 1 }, { 2, 2, 4, 1 }, { 0, 1, 0, 6 }, { 2, 1, 5, 1 }, { 2, 2, 5, 1 }, { 3, 2, 2, 1 }, { 2, 1, 4, 1 }, { 0, 2, 0, 6 }, { 3, 1, 5, 1 }, { 3, 2, 3, 1 }, { 3, 2, 5, 1 }, { 3, 2, 4, 1 }, { 1, 0, 0, 6 }, { 2, 1, 0, 4 }, { 1, 1, 0, 6 }, { 3, 1, 0, 4 }, { 1, 2, 0, 6 }, { 2, 2, 0, 4 }, { 2, 0, 0, 6 }, { 3, 0, 0, 6 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 10 }, { 1, 1, 0, 10 }, { 1, 2, 0, 10 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 9 }, { 0, 0, 10, 1 }, { 1, 1, 0, 9 }, { 0, 1, 10, 1 }, { 1, 2, 0, 9 }, { 0, 2, 10, 1 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 8 }, { 0, 0, 11, 1 }, { 0, 0, 10, 1 }, { 1, 1, 0, 8 }, { 0, 1, 11, 1 }, { 0, 1, 10, 1 }, { 1, 2, 0, 8 }, { 0, 2, 11, 1 }, { 0, 2, 10, 1 } },
+	{ { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 4 }, { 0, 0, 15, 1 }, { 0, 0, 14, 1 }, { 0, 0, 13, 1 }, { 0, 0, 12, 1 }, { 0, 0, 11, 1 }, { 0, 0, 10, 1 },
+		{ 1, 1, 0, 4 }, { 0, 1, 15, 1 }, { 0, 1, 14, 1 }, { 0, 1, 13, 1 }, { 0, 1, 12, 1 }, { 0, 1, 11, 1 }, { 0, 1, 10, 1 },
+		{ 1, 2, 0, 4 }, { 0, 2, 15, 1 }, { 0, 2, 14, 1 }, { 0, 2, 13, 1 }, { 0, 2, 12, 1 }, { 0, 2, 11, 1 }, { 0, 2, 10, 1 } },
+};
+
+typedef struct SoftBC6HMode
+{
+	bool is_transformed;
+	uint8_t endpoint_bits;
+	uint8_t delta_bits[3];
+} SoftBC6HMode;
+
+// Modes 0 to 9 have two regions, 10 to 13 a single one
+static const SoftBC6HMode SoftBC6HModes[14] = {
+	{ true,  10, { 5, 5, 5 } },
+	{ true,  7,  { 6, 6, 6 } },
+	{ true,  11, { 5, 4, 4 } },
+	{ true,  11, { 4, 5, 4 } },
+	{ true,  11, { 4, 4, 5 } },
+	{ true,  9,  { 5, 5, 5 } },
+	{ true,  8,  { 6, 5, 5 } },
+	{ true,  8,  { 5, 6, 5 } },
+	{ true,  8,  { 5, 5, 6 } },
+	{ false, 6,  { 6, 6, 6 } },
+	{ false, 10, { 10, 10, 10 } },
+	{ true,  11, { 9, 9, 9 } },
+	{ true,  12, { 8, 8, 8 } },
+	{ true,  16, { 4, 4, 4 } },
+};
+
+typedef struct SoftBlockBits
+{
+	const uint8_t* data;
+	uint32_t position;
+} SoftBlockBits;
+
+static uint32_t SoftReadBlockBits(SoftBlockBits* bits, uint32_t count)
+{
+	uint32_t value = 0;
+	for(uint32_t i = 0; i < count; i++, bits->position++)
+		value |= (uint32_t)((bits->data[bits->position >> 3] >> (bits->position & 7)) & 1) << i;
+	return value;
+}
+
+static inline uint32_t SoftUnormBits(uint32_t value)
+{
+	float result = (float)value / 255.0f;
+	uint32_t bits;
+	memcpy(&bits, &result, sizeof(uint32_t));
+	return bits;
+}
+
+static inline uint32_t SoftHalfBitsToFloatBits(uint32_t half)
+{
+	uint32_t sign = (half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+	if(exponent == 0)
+	{
+		float value = (float)mantissa * (1.0f / 16777216.0f); // Subnormals are mantissa * 2^-24
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(uint32_t));
+		return sign | bits;
+	}
+	if(exponent == 0x1F)
+		return sign | 0x7F800000 | (mantissa << 13);
+	return sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+}
+
+static void SoftFillBlock(uint32_t* values, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+	{
+		values[i * 4 + 0] = r;
+		values[i * 4 + 1] = g;
+		values[i * 4 + 2] = b;
+		values[i * 4 + 3] = a;
+	}
+}
+
+// BC1 color block, BC2 and BC3 always use the four colors mode and keep their own alpha
+static void SoftDecodeBC1Colors(const uint8_t* block, uint32_t* values, bool has_alpha_mode)
+{
+	uint32_t colors[2] = { block[0] | (block[1] << 8), block[2] | (block[3] << 8) };
+	uint32_t palette[4][4];
+	for(uint32_t i = 0; i < 2; i++)
+	{
+		uint32_t r = (colors[i] >> 11) & 0x1F;
+		uint32_t g = (colors[i] >> 5) & 0x3F;
+		uint32_t b = colors[i] & 0x1F;
+		palette[i][0] = (r << 3) | (r >> 2);
+		palette[i][1] = (g << 2) | (g >> 4);
+		palette[i][2] = (b << 3) | (b >> 2);
+		palette[i][3] = 255;
+	}
+	for(uint32_t c = 0; c < 3; c++)
+	{
+		if(!has_alpha_mode || colors[0] > colors[1])
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (!has_alpha_mode || colors[0] > colors[1]) ? 255 : 0;
+
+	uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+	{
+		const uint32_t* color = palette[(indices >> (i * 2)) & 3];
+		for(uint32_t c = 0; c < 4; c++)
+			values[i * 4 + c] = SoftUnormBits(color[c]);
+	}
+}
+
+// BC4 block decoded to one channel of the output, also used for BC3 alpha and BC5
+static void SoftDecodeBC4Channel(const uint8_t* block, uint32_t* values, uint32_t channel)
+{
+	uint32_t palette[8] = { block[0], block[1] };
+	if(palette[0] > palette[1])
+	{
+		for(uint32_t i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+	}
+	else
+	{
+		for(uint32_t i = 2; i < 6; i++)
+			palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	for(uint32_t i = 0; i < 6; i++)
+		indices |= (uint64_t)block[2 + i] << (i * 8);
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+		values[i * 4 + channel] = SoftUnormBits(palette[(indices >> (i * 3)) & 7]);
+}
+
+static void SoftDecodeBC6H(const uint8_t* block, uint32_t* values, bool is_signed)
+{
+	SoftBlockBits bits = { block, 0 };
+	uint32_t mode = SoftReadBlockBits(&bits, 2);
+	if(mode >= 2)
+	{
+		mode |= SoftReadBlockBits(&bits, 3) << 2;
+		if((mode & 3) == 2)
+			mode = (mode >> 2) + 2;
+		else if((mode >> 2) < 4)
+			mode = (mode >> 2) + 10;
+		else
+		{
+			SoftFillBlock(values, 0, 0, 0, SoftUnormBits(255));
+			return;
+		}
+	}
+	const SoftBC6HMode* info = &SoftBC6HModes[mode];
+	uint32_t regions_count = mode < 10 ? 2 : 1;
+
+	int32_t endpoints[4][3] = { 0 };
+	for(uint32_t i = 0; i < 25 && SoftBC6HFields[mode][i][3] != 0; i++)
+	{
+		const uint8_t* field = SoftBC6HFields[mode][i];
+		endpoints[field[0]][field[1]] |= (int32_t)(SoftReadBlockBits(&bits, field[3]) << field[2]);
+	}
+	uint32_t partition = regions_count == 2 ? SoftReadBlockBits(&bits, 5) : 0;
+
+	// Sign extension, delta decoding then unquantization of the endpoints to 16 bits
+	for(uint32_t c = 0; c < 3; c++)
+	{
+		uint32_t endpoint_bits = info->endpoint_bits;
+		if(is_signed)
+			endpoints[0][c] = (int32_t)((uint32_t)endpoints[0][c] << (32 - endpoint_bits)) >> (32 - endpoint_bits);
+		for(uint32_t e = 1; e < regions_count * 2; e++)
+		{
+			if(info->is_transformed)
+			{
+				uint32_t delta_bits = info->delta_bits[c];
+				int32_t delta = (int32_t)((uint32_t)endpoints[e][c] << (32 - delta_bits)) >> (32 - delta_bits);
+				endpoints[e][c] = (endpoints[0][c] + delta) & (int32_t)((1u << endpoint_bits) - 1);
+			}
+			if(is_signed)
+				endpoints[e][c] = (int32_t)((uint32_t)endpoints[e][c] << (32 - endpoint_bits)) >> (32 - endpoint_bits);
+		}
+		for(uint32_t e = 0; e < regions_count * 2; e++)
+		{
+			int32_t value = endpoints[e][c];
+			if(!is_signed)
+			{
+				if(endpoint_bits >= 15)
+					continue;
+				if(value == 0)
+					endpoints[e][c] = 0;
+				else if(value == (int32_t)((1u << endpoint_bits) - 1))
+					endpoints[e][c] = 0xFFFF;
+				else
+					endpoints[e][c] = ((value << 16) + 0x8000) >> endpoint_bits;
+			}
+			else
+			{
+				if(endpoint_bits >= 16)
+					continue;
+				int32_t magnitude = value < 0 ? -value : value;
+				int32_t unquantized;
+				if(magnitude == 0)
+					unquantized = 0;
+				else if(magnitude >= (int32_t)((1u << (endpoint_bits - 1)) - 1))
+					unquantized = 0x7FFF;
+				else
+					unquantized = ((magnitude << 15) + 0x4000) >> (endpoint_bits - 1);
+				endpoints[e][c] = value < 0 ? -unquantized : unquantized;
+			}
+		}
+	}
+
+	uint32_t index_bits = regions_count == 2 ? 3 : 4;
+	const uint8_t* weights = regions_count == 2 ? SoftBCWeights3 : SoftBCWeights4;
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+	{
+		uint32_t region = regions_count == 2 ? (SoftBC7Partitions2[partition] >> i) & 1 : 0;
+		bool is_anchor = i == 0 || (regions_count == 2 && i == SoftBC7Anchors2[partition]);
+		int32_t weight = weights[SoftReadBlockBits(&bits, index_bits - (is_anchor ? 1 : 0))];
+		for(uint32_t c = 0; c < 3; c++)
+		{
+			int32_t value = ((64 - weight) * endpoints[region * 2][c] + weight * endpoints[region * 2 + 1][c] + 32) >> 6;
+			uint32_t half;
+			if(!is_signed)
+				half = (uint32_t)((value * 31) >> 6);
+			else
+				half = value < 0 ? 0x8000 | (uint32_t)(((-value) * 31) >> 5) : (uint32_t)((value * 31) >> 5);
+			values[i * 4 + c] = SoftHalfBitsToFloatBits(half);
+		}
+		values[i * 4 + 3] = SoftUnormBits(255);
+	}
+}
+
+static void SoftDecodeBC7(const uint8_t* block, uint32_t* values)
+{
+	uint32_t mode = 0;
+	while(mode < 8 && (block[0] & (1u << mode)) == 0)
+		mode++;
+	if(mode == 8)
+	{
+		SoftFillBlock(values, 0, 0, 0, 0);
+		return;
+	}
+	const SoftBC7Mode* info = &SoftBC7Modes[mode];
+	SoftBlockBits bits = { block, mode + 1 };
+
+	uint32_t partition = SoftReadBlockBits(&bits, info->partition_bits);
+	uint32_t rotation = SoftReadBlockBits(&bits, info->rotation_bits);
+	uint32_t index_selection = SoftReadBlockBits(&bits, info->index_selection_bits);
+
+	uint32_t endpoints_count = info->subsets_count * 2;
+	uint32_t endpoints[6][4];
+	for(uint32_t c = 0; c < 3; c++)
+	{
+		for(uint32_t e = 0; e < endpoints_count; e++)
+			endpoints[e][c] = SoftReadBlockBits(&bits, info->color_bits);
+	}
+	for(uint32_t e = 0; e < endpoints_count; e++)
+		endpoints[e][3] = SoftReadBlockBits(&bits, info->alpha_bits);
+
+	uint32_t color_bits = info->color_bits;
+	uint32_t alpha_bits = info->alpha_bits;
+	if(info->endpoint_pbits != 0 || info->shared_pbits != 0)
+	{
+		uint32_t pbits[6];
+		for(uint32_t e = 0; e < endpoints_count; e++)
+			pbits[e] = info->endpoint_pbits != 0 || (e & 1) == 0 ? SoftReadBlockBits(&bits, 1) : pbits[e - 1];
+		for(uint32_t e = 0; e < endpoints_count; e++)
+		{
+			for(uint32_t c = 0; c < 4; c++)
+				endpoints[e][c] = (endpoints[e][c] << 1) | pbits[e];
+		}
+		color_bits++;
+		if(alpha_bits != 0)
+			alpha_bits++;
+	}
+	for(uint32_t e = 0; e < endpoints_count; e++)
+	{
+		for(uint32_t c = 0; c < 3; c++)
+			endpoints[e][c] = (endpoints[e][c] << (8 - color_bits)) | (endpoints[e][c] >> (2 * color_bits - 8));
+		endpoints[e][3] = alpha_bits == 0 ? 255 : (endpoints[e][3] << (8 - alpha_bits)) | (endpoints[e][3] >> (2 * alpha_bits - 8));
+	}
+
+	uint32_t subsets[SOFT_PIXEL_BLOCK_TEXELS];
+	bool anchors[SOFT_PIXEL_BLOCK_TEXELS] = { true };
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+	{
+		switch(info->subsets_count)
+		{
+			case 2: subsets[i] = (SoftBC7Partitions2[partition] >> i) & 1; break;
+			case 3: subsets[i] = (SoftBC7Partitions3[partition] >> (i * 2)) & 3; break;
+			default: subsets[i] = 0; break;
+		}
+	}
+	if(info->subsets_count == 2)
+		anchors[SoftBC7Anchors2[partition]] = true;
+	else if(info->subsets_count == 3)
+	{
+		anchors[SoftBC7Anchors3Second[partition]] = true;
+		anchors[SoftBC7Anchors3Third[partition]] = true;
+	}
+
+	uint32_t indices[SOFT_PIXEL_BLOCK_TEXELS];
+	uint32_t secondary_indices[SOFT_PIXEL_BLOCK_TEXELS];
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+		indices[i] = SoftReadBlockBits(&bits, info->index_bits - (anchors[i] ? 1 : 0));
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+		secondary_indices[i] = info->secondary_index_bits != 0 ? SoftReadBlockBits(&bits, info->secondary_index_bits - (i == 0 ? 1 : 0)) : indices[i];
+
+	const uint8_t* weights_tables[5] = { PULSE_NULLPTR, PULSE_NULLPTR, SoftBCWeights2, SoftBCWeights3, SoftBCWeights4 };
+	uint32_t color_index_bits = index_selection ? info->secondary_index_bits : info->index_bits;
+	uint32_t alpha_index_bits = info->secondary_index_bits == 0 ? info->index_bits : (index_selection ? info->index_bits : info->secondary_index_bits);
+	for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+	{
+		const uint32_t* first = endpoints[subsets[i] * 2];
+		const uint32_t* second = endpoints[subsets[i] * 2 + 1];
+		uint32_t color_weight = weights_tables[color_index_bits][index_selection ? secondary_indices[i] : indices[i]];
+		uint32_t alpha_weight = weights_tables[alpha_index_bits][index_selection ? indices[i] : secondary_indices[i]];
+		uint32_t texel[4];
+		for(uint32_t c = 0; c < 3; c++)
+			texel[c] = ((64 - color_weight) * first[c] + color_weight * second[c] + 32) >> 6;
+		texel[3] = ((64 - alpha_weight) * first[3] + alpha_weight * second[3] + 32) >> 6;
+		if(rotation != 0)
+		{
+			uint32_t alpha = texel[3];
+			texel[3] = texel[rotation - 1];
+			texel[rotation - 1] = alpha;
+		}
+		for(uint32_t c = 0; c < 4; c++)
+			values[i * 4 + c] = SoftUnormBits(texel[c]);
+	}
+}
+
+void SoftDecodeBlock(PulseImageFormat format, const uint8_t* block, uint32_t values[SOFT_PIXEL_BLOCK_TEXELS * 4])
+{
+	switch(format)
+	{
+		case PULSE_IMAGE_FORMAT_BC1_RGBA_UNORM: SoftDecodeBC1Colors(block, values, true); break;
+		case PULSE_IMAGE_FORMAT_BC2_RGBA_UNORM:
+		{
+			SoftDecodeBC1Colors(block + 8, values, false);
+			for(uint32_t i = 0; i < SOFT_PIXEL_BLOCK_TEXELS; i++)
+				values[i * 4 + 3] = SoftUnormBits(((block[i >> 1] >> ((i & 1) * 4)) & 0xF) * 17);
+			break;
+		}
+		case PULSE_IMAGE_FORMAT_BC3_RGBA_UNORM:
+		{
+			SoftDecodeBC1Colors(block + 8, values, false);
+			SoftDecodeBC4Channel(block, values, 3);
+			break;
+		}
+		case PULSE_IMAGE_FORMAT_BC4_R_UNORM:
+		{
+			SoftFillBlock(values, 0, 0, 0, SoftUnormBits(255));
+			SoftDecodeBC4Channel(block, values, 0);
+			break;
+		}
+		case PULSE_IMAGE_FORMAT_BC5_RG_UNORM:
+		{
+			SoftFillBlock(values, 0, 0, 0, SoftUnormBits(255));
+			SoftDecodeBC4Channel(block, values, 0);
+			SoftDecodeBC4Channel(block + 8, values, 1);
+			break;
+		}
+		case PULSE_IMAGE_FORMAT_BC6H_RGB_FLOAT: SoftDecodeBC6H(block, values, true); break;
+		case PULSE_IMAGE_FORMAT_BC6H_RGB_UFLOAT: SoftDecodeBC6H(block, values, false); break;
+		case PULSE_IMAGE_FORMAT_BC7_RGBA_UNORM: SoftDecodeBC7(block, values); break;
+
+		default: SoftFillBlock(values, 0, 0, 0, 0); break;
+	}
+}
@@ -0,0 +1,230 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+// Row conversions, included once per instruction set by SoftPixelFormat.c with
+// SOFT_PIXEL_ROWS_DECODE, SOFT_PIXEL_ROWS_ENCODE and SOFT_PIXEL_ROWS_TARGET defined.
+// Every loop is branchless with a constant channels count so that the compiler can turn it
+// into vector code for the targeted instruction set. Loads and stores go through memcpy as
+// rows coming from buffers have no alignment guarantee.
+
+#define SOFT_PIXEL_ROWS_DECODE_LOOP(type, channels, convert) \
+	for(size_t i = 0; i < count; i++) \
+	{ \
+		for(uint32_t c = 0; c < (channels); c++) \
+		{ \
+			type raw; \
+			memcpy(&raw, src + (i * (channels) + c) * sizeof(type), sizeof(type)); \
+			values[i * 4 + c] = (convert); \
+		} \
+		for(uint32_t c = (channels); c < 4; c++) \
+			values[i * 4 + c] = defaults[c]; \
+	}
+
+#define SOFT_PIXEL_ROWS_DECODE_CHANNELS(type, convert) \
+	do { \
+		switch(info->channels_count) \
+		{ \
+			case 1: SOFT_PIXEL_ROWS_DECODE_LOOP(type, 1, convert); break; \
+			case 2: SOFT_PIXEL_ROWS_DECODE_LOOP(type, 2, convert); break; \
+			case 4: SOFT_PIXEL_ROWS_DECODE_LOOP(type, 4, convert); break; \
+			default: break; \
+		} \
+	} while(0)
+
+#define SOFT_PIXEL_ROWS_DECODE_PACKED(type, red, green, blue, alpha) \
+	for(size_t i = 0; i < count; i++) \
+	{ \
+		type packed; \
+		memcpy(&packed, src + i * sizeof(type), sizeof(type)); \
+		values[i * 4 + 0] = (red); \
+		values[i * 4 + 1] = (green); \
+		values[i * 4 + 2] = (blue); \
+		values[i * 4 + 3] = (alpha); \
+	}
+
+#define SOFT_PIXEL_ROWS_ENCODE_LOOP(type, channels, convert) \
+	for(size_t i = 0; i < count; i++) \
+	{ \
+		for(uint32_t c = 0; c < (channels); c++) \
+		{ \
+			uint32_t value = values[i * 4 + c]; \
+			type raw = (type)(convert); \
+			memcpy(dst + (i * (channels) + c) * sizeof(type), &raw, sizeof(type)); \
+		} \
+	}
+
+#define SOFT_PIXEL_ROWS_ENCODE_CHANNELS(type, convert) \
+	do { \
+		switch(info->channels_count) \
+		{ \
+			case 1: SOFT_PIXEL_ROWS_ENCODE_LOOP(type, 1, convert); break; \
+			case 2: SOFT_PIXEL_ROWS_ENCODE_LOOP(type, 2, convert); break; \
+			case 4: SOFT_PIXEL_ROWS_ENCODE_LOOP(type, 4, convert); break; \
+			default: break; \
+		} \
+	} while(0)
+
+#define SOFT_PIXEL_ROWS_ENCODE_PACKED(type, expression) \
+	for(size_t i = 0; i < count; i++) \
+	{ \
+		const uint32_t* texel = values + i * 4; \
+		type packed = (type)(expression); \
+		memcpy(dst + i * sizeof(type), &packed, sizeof(type)); \
+	}
+
+SOFT_PIXEL_ROWS_TARGET static void SOFT_PIXEL_ROWS_DECODE(PulseImageFormat format, const uint8_t* src, uint32_t* values, uint32_t count)
+{
+	const SoftPixelFormatInfo* info = SoftGetPixelFormatInfo(format);
+	const uint32_t defaults[4] = { 0, 0, 0, SoftIsPixelFormatInteger(format) ? 1 : SoftFloatBits(1.0f) };
+
+	switch(format)
+	{
+		case PULSE_IMAGE_FORMAT_A8_UNORM:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint8_t, 0, 0, 0, SoftUnpackUnorm(packed, 0xFF));
+			return;
+		case PULSE_IMAGE_FORMAT_B8G8R8A8_UNORM:
+			for(size_t i = 0; i < count; i++)
+			{
+				for(uint32_t c = 0; c < 4; c++)
+					values[i * 4 + c] = SoftUnpackUnorm(src[i * 4 + (c ^ ((~c & 1) << 1))], 0xFF); // Swaps red and blue
+			}
+			return;
+		case PULSE_IMAGE_FORMAT_R10G10B10A2_UNORM:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint32_t, SoftUnpackUnorm(packed & 0x3FF, 0x3FF), SoftUnpackUnorm((packed >> 10) & 0x3FF, 0x3FF), SoftUnpackUnorm((packed >> 20) & 0x3FF, 0x3FF), SoftUnpackUnorm(packed >> 30, 0x3));
+			return;
+		case PULSE_IMAGE_FORMAT_B5G6R5_UNORM:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint16_t, SoftUnpackUnorm((packed >> 11) & 0x1F, 0x1F), SoftUnpackUnorm((packed >> 5) & 0x3F, 0x3F), SoftUnpackUnorm(packed & 0x1F, 0x1F), defaults[3]);
+			return;
+		case PULSE_IMAGE_FORMAT_B5G5R5A1_UNORM:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint16_t, SoftUnpackUnorm((packed >> 10) & 0x1F, 0x1F), SoftUnpackUnorm((packed >> 5) & 0x1F, 0x1F), SoftUnpackUnorm(packed & 0x1F, 0x1F), SoftUnpackUnorm((packed >> 15) & 0x1, 0x1));
+			return;
+		case PULSE_IMAGE_FORMAT_B4G4R4A4_UNORM:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint16_t, SoftUnpackUnorm((packed >> 4) & 0xF, 0xF), SoftUnpackUnorm((packed >> 8) & 0xF, 0xF), SoftUnpackUnorm((packed >> 12) & 0xF, 0xF), SoftUnpackUnorm(packed & 0xF, 0xF));
+			return;
+		case PULSE_IMAGE_FORMAT_R11G11B10_UFLOAT:
+			SOFT_PIXEL_ROWS_DECODE_PACKED(uint32_t, SoftUnpackMinifloat(packed & 0x7FF, 6, false), SoftUnpackMinifloat((packed >> 11) & 0x7FF, 6, false), SoftUnpackMinifloat(packed >> 22, 5, false), defaults[3]);
+			return;
+
+		default: break;
+	}
+
+	switch(info->encoding)
+	{
+		case SOFT_PIXEL_ENCODING_UNORM:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint8_t, SoftUnpackUnorm(raw, 0xFF));
+			else
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint16_t, SoftUnpackUnorm(raw, 0xFFFF));
+			break;
+		case SOFT_PIXEL_ENCODING_SNORM:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(int8_t, SoftUnpackSnorm(raw, 0x7F));
+			else
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(int16_t, SoftUnpackSnorm(raw, 0x7FFF));
+			break;
+		case SOFT_PIXEL_ENCODING_UINT:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint8_t, (uint32_t)raw);
+			else if(info->channel_bits == 16)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint16_t, (uint32_t)raw);
+			else
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint32_t, raw);
+			break;
+		case SOFT_PIXEL_ENCODING_SINT:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(int8_t, (uint32_t)(int32_t)raw);
+			else if(info->channel_bits == 16)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(int16_t, (uint32_t)(int32_t)raw);
+			else
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint32_t, raw);
+			break;
+		case SOFT_PIXEL_ENCODING_FLOAT:
+			if(info->channel_bits == 16)
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint16_t, SoftHalfToFloatBits(raw));
+			else
+				SOFT_PIXEL_ROWS_DECODE_CHANNELS(uint32_t, raw);
+			break;
+
+		default: // Compressed texels can only be decoded a whole block at a time
+			for(size_t i = 0; i < (size_t)count * 4; i++)
+				values[i] = defaults[i & 3];
+			break;
+	}
+}
+
+SOFT_PIXEL_ROWS_TARGET static void SOFT_PIXEL_ROWS_ENCODE(PulseImageFormat format, const uint32_t* values, uint8_t* dst, uint32_t count)
+{
+	const SoftPixelFormatInfo* info = SoftGetPixelFormatInfo(format);
+
+	switch(format)
+	{
+		case PULSE_IMAGE_FORMAT_A8_UNORM:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint8_t, SoftPackUnorm(texel[3], 0xFF));
+			return;
+		case PULSE_IMAGE_FORMAT_B8G8R8A8_UNORM:
+			for(size_t i = 0; i < count; i++)
+			{
+				for(uint32_t c = 0; c < 4; c++)
+					dst[i * 4 + c] = (uint8_t)SoftPackUnorm(values[i * 4 + (c ^ ((~c & 1) << 1))], 0xFF);
+			}
+			return;
+		case PULSE_IMAGE_FORMAT_R10G10B10A2_UNORM:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint32_t, SoftPackUnorm(texel[0], 0x3FF) | (SoftPackUnorm(texel[1], 0x3FF) << 10) | (SoftPackUnorm(texel[2], 0x3FF) << 20) | (SoftPackUnorm(texel[3], 0x3) << 30));
+			return;
+		case PULSE_IMAGE_FORMAT_B5G6R5_UNORM:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint16_t, (SoftPackUnorm(texel[0], 0x1F) << 11) | (SoftPackUnorm(texel[1], 0x3F) << 5) | SoftPackUnorm(texel[2], 0x1F));
+			return;
+		case PULSE_IMAGE_FORMAT_B5G5R5A1_UNORM:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint16_t, (SoftPackUnorm(texel[0], 0x1F) << 10) | (SoftPackUnorm(texel[1], 0x1F) << 5) | SoftPackUnorm(texel[2], 0x1F) | (SoftPackUnorm(texel[3], 0x1) << 15));
+			return;
+		case PULSE_IMAGE_FORMAT_B4G4R4A4_UNORM:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint16_t, (SoftPackUnorm(texel[0], 0xF) << 4) | (SoftPackUnorm(texel[1], 0xF) << 8) | (SoftPackUnorm(texel[2], 0xF) << 12) | SoftPackUnorm(texel[3], 0xF));
+			return;
+		case PULSE_IMAGE_FORMAT_R11G11B10_UFLOAT:
+			SOFT_PIXEL_ROWS_ENCODE_PACKED(uint32_t, SoftPackMinifloat(texel[0], 6, false) | (SoftPackMinifloat(texel[1], 6, false) << 11) | (SoftPackMinifloat(texel[2], 5, false) << 22));
+			return;
+
+		default: break;
+	}
+
+	switch(info->encoding)
+	{
+		case SOFT_PIXEL_ENCODING_UNORM:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint8_t, SoftPackUnorm(value, 0xFF));
+			else
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint16_t, SoftPackUnorm(value, 0xFFFF));
+			break;
+		case SOFT_PIXEL_ENCODING_SNORM:
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint8_t, SoftPackSnorm(value, 0x7F));
+			else
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint16_t, SoftPackSnorm(value, 0x7FFF));
+			break;
+		case SOFT_PIXEL_ENCODING_UINT:
+		case SOFT_PIXEL_ENCODING_SINT: // Integer formats keep the low bits
+			if(info->channel_bits == 8)
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint8_t, value);
+			else if(info->channel_bits == 16)
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint16_t, value);
+			else
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint32_t, value);
+			break;
+		case SOFT_PIXEL_ENCODING_FLOAT:
+			if(info->channel_bits == 16)
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint16_t, SoftFloatBitsToHalf(value));
+			else
+				SOFT_PIXEL_ROWS_ENCODE_CHANNELS(uint32_t, value);
+			break;
+
+		default: break; // Compressed formats are never encoded
+	}
+}
+
+#undef SOFT_PIXEL_ROWS_DECODE_LOOP
+#undef SOFT_PIXEL_ROWS_DECODE_CHANNELS
+#undef SOFT_PIXEL_ROWS_DECODE_PACKED
+#undef SOFT_PIXEL_ROWS_ENCODE_LOOP
+#undef SOFT_PIXEL_ROWS_ENCODE_CHANNELS
+#undef SOFT_PIXEL_ROWS_ENCODE_PACKED
@@ -0,0 +1,127 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftQueue.h"
+#include "SoftCommandList.h"
+
+static bool SoftQueueHasWork(const SoftQueue* queue)
+{
+	const SoftQueueSlot* slot = &queue->slots[queue->dequeue_position & (queue->capacity - 1)];
+	return atomic_load_explicit(&slot->sequence, memory_order_acquire) == queue->dequeue_position + 1;
+}
+
+static PulseCommandList SoftQueuePop(SoftQueue* queue)
+{
+	if(!SoftQueueHasWork(queue))
+		return PULSE_NULL_HANDLE;
+	SoftQueueSlot* slot = &queue->slots[queue->dequeue_position & (queue->capacity - 1)];
+	PulseCommandList cmd = slot->cmd;
+	atomic_store_explicit(&slot->sequence, queue->dequeue_position + queue->capacity, memory_order_release); // Hand the slot back to producers one lap later
+	queue->dequeue_position++;
+	return cmd;
+}
+
+static int SoftQueueMain(void* arg)
+{
+	SoftQueue* queue = (SoftQueue*)arg;
+	for(;;)
+	{
+		PulseCommandList cmd = SoftQueuePop(queue);
+		if(cmd != PULSE_NULL_HANDLE)
+		{
+			SoftRunCommandList(cmd);
+			continue;
+		}
+		if(!atomic_load(&queue->running))
+			break;
+
+		mtx_lock(&queue->sleep_mutex);
+			atomic_store(&queue->sleeping, true);
+			atomic_thread_fence(memory_order_seq_cst); // Pairs with the fence in SoftQueueSubmit, either we see the slot or the producer sees us sleeping
+			while(!SoftQueueHasWork(queue) && atomic_load(&queue->running))
+				cnd_wait(&queue->sleep_condition, &queue->sleep_mutex);
+			atomic_store(&queue->sleeping, false);
+		mtx_unlock(&queue->sleep_mutex);
+	}
+	return 0;
+}
+
+bool SoftInitQueue(SoftQueue* queue)
+{
+	memset(queue, 0, sizeof(SoftQueue));
+	queue->slots = (SoftQueueSlot*)calloc(SOFT_QUEUE_CAPACITY, sizeof(SoftQueueSlot));
+	PULSE_CHECK_ALLOCATION_RETVAL(queue->slots, false);
+	queue->capacity = SOFT_QUEUE_CAPACITY;
+	for(uint32_t i = 0; i < queue->capacity; i++)
+		atomic_store(&queue->slots[i].sequence, i);
+	atomic_store(&queue->enqueue_position, 0);
+	atomic_store(&queue->running, true);
+	atomic_store(&queue->sleeping, false);
+	mtx_init(&queue->sleep_mutex, mtx_plain);
+	cnd_init(&queue->sleep_condition);
+
+	if(thrd_create(&queue->thread, SoftQueueMain, queue) != thrd_success)
+	{
+		cnd_destroy(&queue->sleep_condition);
+		mtx_destroy(&queue->sleep_mutex);
+		free(queue->slots);
+		memset(queue, 0, sizeof(SoftQueue));
+		return false;
+	}
+	return true;
+}
+
+void SoftQueueSubmit(SoftQueue* queue, PulseCommandList cmd)
+{
+	size_t position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+	for(;;)
+	{
+		SoftQueueSlot* slot = &queue->slots[position & (queue->capacity - 1)];
+		intptr_t difference = (intptr_t)atomic_load_explicit(&slot->sequence, memory_order_acquire) - (intptr_t)position;
+		if(difference == 0)
+		{
+			if(atomic_compare_exchange_weak_explicit(&queue->enqueue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+			{
+				slot->cmd = cmd;
+				atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+				break;
+			}
+		}
+		else
+		{
+			if(difference < 0) // Full, the queue thread is still on the slot from the previous lap
+				thrd_yield();
+			position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+		}
+	}
+
+	atomic_thread_fence(memory_order_seq_cst);
+	if(atomic_load(&queue->sleeping))
+	{
+		mtx_lock(&queue->sleep_mutex);
+			cnd_signal(&queue->sleep_condition);
+		mtx_unlock(&queue->sleep_mutex);
+	}
+}
+
+void SoftDestroyQueue(SoftQueue* queue)
+{
+	if(queue->slots == PULSE_NULLPTR)
+		return;
+	mtx_lock(&queue->sleep_mutex);
+		atomic_store(&queue->running, false);
+		cnd_signal(&queue->sleep_condition);
+	mtx_unlock(&queue->sleep_mutex);
+	thrd_join(queue->thread, PULSE_NULLPTR);
+	cnd_destroy(&queue->sleep_condition);
+	mtx_destroy(&queue->sleep_mutex);
+	free(queue->slots);
+	memset(queue, 0, sizeof(SoftQueue));
+}
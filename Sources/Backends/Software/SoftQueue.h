@@ -0,0 +1,47 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_QUEUE_H_
+#define PULSE_SOFTWARE_QUEUE_H_
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <tinycthread.h>
+
+#include "Soft.h"
+
+#define SOFT_QUEUE_CAPACITY 256
+
+typedef struct SoftQueueSlot
+{
+	atomic_size_t sequence; // Equals the position when free, position + 1 once a command list has been published
+	PulseCommandList cmd;
+} SoftQueueSlot;
+
+// Bounded multi producer single consumer ring, any thread submits and the device queue
+// thread runs the command lists one after the other in submission order
+typedef struct SoftQueue
+{
+	SoftQueueSlot* slots;
+	uint32_t capacity; // Always a power of two
+	atomic_size_t enqueue_position;
+	size_t dequeue_position; // Only touched by the queue thread
+	thrd_t thread;
+	atomic_bool running;
+	atomic_bool sleeping;
+	mtx_t sleep_mutex;
+	cnd_t sleep_condition;
+} SoftQueue;
+
+bool SoftInitQueue(SoftQueue* queue);
+void SoftQueueSubmit(SoftQueue* queue, PulseCommandList cmd); // Lock free, only yields while the ring is full
+void SoftDestroyQueue(SoftQueue* queue); // Runs the command lists left in the ring before joining the queue thread
+
+#endif // PULSE_SOFTWARE_QUEUE_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
@@ -0,0 +1,310 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE // For pthread_setaffinity_np
+#endif
+
+#include <string.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftThreadPool.h"
+
+#if defined(PULSE_PLAT_WINDOWS)
+	#include <windows.h>
+#elif defined(PULSE_PLAT_LINUX)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#define SOFT_TASK_DEQUE_BASE_CAPACITY 64
+
+static bool SoftInitTaskDeque(SoftTaskDeque* deque)
+{
+	deque->tasks = (SoftTask*)calloc(SOFT_TASK_DEQUE_BASE_CAPACITY, sizeof(SoftTask));
+	PULSE_CHECK_ALLOCATION_RETVAL(deque->tasks, false);
+	deque->capacity = SOFT_TASK_DEQUE_BASE_CAPACITY;
+	deque->front = 0;
+	deque->back = 0;
+	return mtx_init(&deque->mutex, mtx_plain) == thrd_success;
+}
+
+static void SoftDestroyTaskDeque(SoftTaskDeque* deque)
+{
+	mtx_destroy(&deque->mutex);
+	free(deque->tasks);
+}
+
+// Must be called with the deque mutex locked
+static bool SoftTaskDequeGrow(SoftTaskDeque* deque)
+{
+	uint32_t count = deque->back - deque->front;
+	SoftTask* tasks = (SoftTask*)malloc(deque->capacity * 2 * sizeof(SoftTask));
+	PULSE_CHECK_ALLOCATION_RETVAL(tasks, false);
+	for(uint32_t i = 0; i < count; i++)
+		tasks[i] = deque->tasks[(deque->front + i) & (deque->capacity - 1)];
+	free(deque->tasks);
+	deque->tasks = tasks;
+	deque->capacity *= 2;
+	deque->front = 0;
+	deque->back = count;
+	return true;
+}
+
+static bool SoftTaskDequePushBack(SoftTaskDeque* deque, SoftTask task)
+{
+	mtx_lock(&deque->mutex);
+		if(deque->back - deque->front == deque->capacity && !SoftTaskDequeGrow(deque))
+		{
+			mtx_unlock(&deque->mutex);
+			return false;
+		}
+		deque->tasks[deque->back & (deque->capacity - 1)] = task;
+		deque->back++;
+	mtx_unlock(&deque->mutex);
+	return true;
+}
+
+static bool SoftTaskDequePopFront(SoftTaskDeque* deque, SoftTask* task)
+{
+	bool found = false;
+	mtx_lock(&deque->mutex);
+		if(deque->back != deque->front)
+		{
+			*task = deque->tasks[deque->front & (deque->capacity - 1)];
+			deque->front++;
+			found = true;
+		}
+	mtx_unlock(&deque->mutex);
+	return found;
+}
+
+static bool SoftTaskDequeStealBack(SoftTaskDeque* deque, SoftTask* task)
+{
+	bool found = false;
+	mtx_lock(&deque->mutex);
+		if(deque->back != deque->front)
+		{
+			deque->back--;
+			*task = deque->tasks[deque->back & (deque->capacity - 1)];
+			found = true;
+		}
+	mtx_unlock(&deque->mutex);
+	return found;
+}
+
+static bool SoftThreadPoolSteal(SoftThreadPool* pool, SoftWorker* thief, SoftTask* task)
+{
+	for(uint32_t i = 1; i < pool->workers_count; i++)
+	{
+		SoftWorker* victim = &pool->workers[(thief->index + i) % pool->workers_count];
+		if(SoftTaskDequeStealBack(&victim->deque, task))
+			return true;
+	}
+	return false;
+}
+
+static void SoftCompleteTask(SoftTaskBatch* batch)
+{
+	if(atomic_fetch_sub(&batch->remaining, 1) == 1)
+	{
+		mtx_lock(&batch->mutex);
+			batch->done = true;
+			cnd_broadcast(&batch->condition);
+		mtx_unlock(&batch->mutex);
+	}
+}
+
+static void SoftExecuteTask(const SoftTask* task, uint32_t worker_index)
+{
+	task->batch->function(task->batch->userdata, task->index, worker_index);
+	SoftCompleteTask(task->batch);
+}
+
+// Best effort, a worker that could not be pinned still runs wherever the OS schedules it
+static void SoftPinCurrentThread(const struct cpuinfo_processor* processor)
+{
+	#if defined(PULSE_PLAT_WINDOWS)
+		GROUP_AFFINITY affinity = { 0 };
+		affinity.Group = processor->windows_group_id;
+		affinity.Mask = (KAFFINITY)1 << processor->windows_processor_id;
+		SetThreadGroupAffinity(GetCurrentThread(), &affinity, PULSE_NULLPTR);
+	#elif defined(PULSE_PLAT_LINUX)
+		if(processor->linux_id < 0 || processor->linux_id >= CPU_SETSIZE)
+			return;
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(processor->linux_id, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+	#else
+		PULSE_UNUSED(processor); // macOS has no hard affinity
+	#endif
+}
+
+static int SoftWorkerMain(void* arg)
+{
+	SoftWorker* worker = (SoftWorker*)arg;
+	SoftThreadPool* pool = worker->pool;
+
+	if(worker->processor != PULSE_NULLPTR)
+		SoftPinCurrentThread(worker->processor);
+
+	while(atomic_load(&pool->running))
+	{
+		SoftTask task;
+		if(SoftTaskDequePopFront(&worker->deque, &task) || SoftThreadPoolSteal(pool, worker, &task))
+		{
+			atomic_fetch_sub(&pool->queued_tasks, 1);
+			SoftExecuteTask(&task, worker->index);
+			continue;
+		}
+
+		mtx_lock(&pool->sleep_mutex);
+			while(atomic_load(&pool->queued_tasks) == 0 && atomic_load(&pool->running))
+				cnd_wait(&pool->sleep_condition, &pool->sleep_mutex);
+		mtx_unlock(&pool->sleep_mutex);
+	}
+	return 0;
+}
+
+bool SoftInitThreadPool(SoftThreadPool* pool, const struct cpuinfo_processor* const* processors, uint32_t workers_count)
+{
+	memset(pool, 0, sizeof(SoftThreadPool));
+	if(workers_count == 0)
+	{
+		workers_count = 1;
+		processors = PULSE_NULLPTR;
+	}
+
+	pool->workers = (SoftWorker*)calloc(workers_count, sizeof(SoftWorker));
+	PULSE_CHECK_ALLOCATION_RETVAL(pool->workers, false);
+
+	atomic_store(&pool->queued_tasks, 0);
+	atomic_store(&pool->running, true);
+	mtx_init(&pool->sleep_mutex, mtx_plain);
+	cnd_init(&pool->sleep_condition);
+
+	for(uint32_t i = 0; i < workers_count; i++)
+	{
+		SoftWorker* worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->processor = processors != PULSE_NULLPTR ? processors[i] : PULSE_NULLPTR;
+		worker->index = i;
+		if(!SoftInitTaskDeque(&worker->deque))
+		{
+			for(uint32_t j = 0; j < i; j++)
+				SoftDestroyTaskDeque(&pool->workers[j].deque);
+			cnd_destroy(&pool->sleep_condition);
+			mtx_destroy(&pool->sleep_mutex);
+			free(pool->workers);
+			memset(pool, 0, sizeof(SoftThreadPool));
+			return false;
+		}
+	}
+	// Set before any thread starts so that thieves always see every deque
+	pool->workers_count = workers_count;
+
+	for(uint32_t i = 0; i < workers_count; i++)
+	{
+		if(thrd_create(&pool->workers[i].thread, SoftWorkerMain, &pool->workers[i]) == thrd_success)
+			continue;
+		atomic_store(&pool->running, false);
+		mtx_lock(&pool->sleep_mutex);
+			cnd_broadcast(&pool->sleep_condition);
+		mtx_unlock(&pool->sleep_mutex);
+		for(uint32_t j = 0; j < i; j++)
+			thrd_join(pool->workers[j].thread, PULSE_NULLPTR);
+		for(uint32_t j = 0; j < workers_count; j++)
+			SoftDestroyTaskDeque(&pool->workers[j].deque);
+		cnd_destroy(&pool->sleep_condition);
+		mtx_destroy(&pool->sleep_mutex);
+		free(pool->workers);
+		memset(pool, 0, sizeof(SoftThreadPool));
+		return false;
+	}
+	return true;
+}
+
+void SoftThreadPoolSubmitBatch(SoftThreadPool* pool, SoftTaskBatch* batch, SoftTaskFunction function, void* userdata, uint32_t tasks_count)
+{
+	batch->function = function;
+	batch->userdata = userdata;
+	batch->done = tasks_count == 0;
+	atomic_store(&batch->remaining, tasks_count);
+	mtx_init(&batch->mutex, mtx_plain);
+	cnd_init(&batch->condition);
+
+	if(tasks_count == 0)
+		return;
+
+	atomic_fetch_add(&pool->queued_tasks, tasks_count);
+
+	// Contiguous chunks per worker so that neighbouring workgroups stay on the same core unless stolen
+	for(uint32_t w = 0; w < pool->workers_count; w++)
+	{
+		uint32_t start = (uint32_t)(((uint64_t)tasks_count * w) / pool->workers_count);
+		uint32_t end = (uint32_t)(((uint64_t)tasks_count * (w + 1)) / pool->workers_count);
+		for(uint32_t i = start; i < end; i++)
+		{
+			SoftTask task = { .batch = batch, .index = i };
+			if(!SoftTaskDequePushBack(&pool->workers[w].deque, task))
+			{
+				PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+				atomic_fetch_sub(&pool->queued_tasks, 1);
+				SoftCompleteTask(batch);
+			}
+		}
+	}
+
+	mtx_lock(&pool->sleep_mutex);
+		cnd_broadcast(&pool->sleep_condition);
+	mtx_unlock(&pool->sleep_mutex);
+}
+
+bool SoftIsTaskBatchDone(SoftTaskBatch* batch)
+{
+	return atomic_load(&batch->remaining) == 0;
+}
+
+void SoftWaitForTaskBatch(SoftTaskBatch* batch)
+{
+	mtx_lock(&batch->mutex);
+		while(!batch->done)
+			cnd_wait(&batch->condition, &batch->mutex);
+	mtx_unlock(&batch->mutex);
+
+	cnd_destroy(&batch->condition);
+	mtx_destroy(&batch->mutex);
+}
+
+void SoftThreadPoolRunBatch(SoftThreadPool* pool, SoftTaskFunction function, void* userdata, uint32_t tasks_count)
+{
+	if(tasks_count == 0)
+		return;
+
+	SoftTaskBatch batch;
+	SoftThreadPoolSubmitBatch(pool, &batch, function, userdata, tasks_count);
+	SoftWaitForTaskBatch(&batch);
+}
+
+void SoftDestroyThreadPool(SoftThreadPool* pool)
+{
+	atomic_store(&pool->running, false);
+	mtx_lock(&pool->sleep_mutex);
+		cnd_broadcast(&pool->sleep_condition);
+	mtx_unlock(&pool->sleep_mutex);
+
+	for(uint32_t i = 0; i < pool->workers_count; i++)
+	{
+		thrd_join(pool->workers[i].thread, PULSE_NULLPTR);
+		SoftDestroyTaskDeque(&pool->workers[i].deque);
+	}
+	cnd_destroy(&pool->sleep_condition);
+	mtx_destroy(&pool->sleep_mutex);
+	free(pool->workers);
+	pool->workers = PULSE_NULLPTR;
+	pool->workers_count = 0;
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_THREAD_POOL_H_
+#define PULSE_SOFTWARE_THREAD_POOL_H_
+
+#include <stdatomic.h>
+#include <tinycthread.h>
+#include <cpuinfo.h>
+
+#include "Soft.h"
+
+typedef void (*SoftTaskFunction)(void* userdata, uint32_t task_index, uint32_t worker_index);
+
+typedef struct SoftTaskBatch
+{
+	SoftTaskFunction function;
+	void* userdata;
+	atomic_uint remaining;
+	bool done;
+	mtx_t mutex;
+	cnd_t condition;
+} SoftTaskBatch;
+
+typedef struct SoftTask
+{
+	SoftTaskBatch* batch;
+	uint32_t index;
+} SoftTask;
+
+// Owner pops from the front to keep consecutive tasks together, thieves take from the back
+typedef struct SoftTaskDeque
+{
+	SoftTask* tasks;
+	uint32_t capacity; // Always a power of two
+	uint32_t front;
+	uint32_t back;
+	mtx_t mutex;
+} SoftTaskDeque;
+
+typedef struct SoftWorker
+{
+	struct SoftThreadPool* pool;
+	SoftTaskDeque deque;
+	thrd_t thread;
+	const struct cpuinfo_processor* processor; // The worker pins itself to it when not null
+	uint32_t index;
+} SoftWorker;
+
+typedef struct SoftThreadPool
+{
+	SoftWorker* workers;
+	uint32_t workers_count;
+	atomic_uint queued_tasks;
+	atomic_bool running;
+	mtx_t sleep_mutex;
+	cnd_t sleep_condition;
+} SoftThreadPool;
+
+// One worker per processor, workers sharing caches should be given next to each other as both
+// batch splitting and stealing favour neighbouring workers. Processors may be null to not pin any worker
+bool SoftInitThreadPool(SoftThreadPool* pool, const struct cpuinfo_processor* const* processors, uint32_t workers_count);
+void SoftThreadPoolRunBatch(SoftThreadPool* pool, SoftTaskFunction function, void* userdata, uint32_t tasks_count); // Blocks until every task has been executed
+void SoftThreadPoolSubmitBatch(SoftThreadPool* pool, SoftTaskBatch* batch, SoftTaskFunction function, void* userdata, uint32_t tasks_count); // The batch must outlive its tasks
+bool SoftIsTaskBatchDone(SoftTaskBatch* batch);
+void SoftWaitForTaskBatch(SoftTaskBatch* batch); // Also releases the batch synchronisation objects
+void SoftDestroyThreadPool(SoftThreadPool* pool);
+
+#endif // PULSE_SOFTWARE_THREAD_POOL_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
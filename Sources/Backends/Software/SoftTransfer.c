@@ -0,0 +1,188 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+#include <cpuinfo.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftDevice.h"
+#include "SoftImage.h"
+#include "SoftTransfer.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define SOFT_TRANSFER_STREAMING_STORES
+#endif
+
+typedef struct SoftTransferCopy
+{
+	const SoftTransferRange* ranges;
+	size_t range_starts[SOFT_TRANSFER_MAX_RANGES + 1]; // Offsets of the ranges in the stream, the last one is its size
+	uint32_t ranges_count;
+	size_t chunk_size;
+	bool non_temporal;
+} SoftTransferCopy;
+
+typedef struct SoftTransferRows
+{
+	const PulseImageRegion* region;
+	uint8_t* linear;
+	size_t linear_size;
+	uint32_t rows_count;
+	uint32_t rows_per_task;
+	bool to_image;
+} SoftTransferRows;
+
+static void SoftCopyNonTemporal(uint8_t* dst, const uint8_t* src, size_t size)
+{
+	#ifdef SOFT_TRANSFER_STREAMING_STORES
+		size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+		if(head > size)
+			head = size;
+		memcpy(dst, src, head);
+		dst += head;
+		src += head;
+		size -= head;
+		for(; size >= 64; size -= 64, dst += 64, src += 64)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i*)src);
+			__m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+			__m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+			__m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+			_mm_stream_si128((__m128i*)dst, a);
+			_mm_stream_si128((__m128i*)(dst + 16), b);
+			_mm_stream_si128((__m128i*)(dst + 32), c);
+			_mm_stream_si128((__m128i*)(dst + 48), d);
+		}
+		memcpy(dst, src, size);
+	#else
+		memcpy(dst, src, size);
+	#endif
+}
+
+// Stream offset of the chunk boundary, moved back to a destination page boundary so that no two workers write the same page
+static size_t SoftGetChunkBoundary(const SoftTransferCopy* copy, uint32_t chunk)
+{
+	size_t position = (size_t)chunk * copy->chunk_size;
+	size_t stream_size = copy->range_starts[copy->ranges_count];
+	if(position >= stream_size)
+		return stream_size;
+	uint32_t range = 0;
+	while(copy->range_starts[range + 1] <= position)
+		range++;
+	size_t offset = position - copy->range_starts[range];
+	size_t misalignment = (uintptr_t)(copy->ranges[range].dst + offset) & (SOFT_TRANSFER_PAGE_SIZE - 1);
+	return misalignment > offset ? copy->range_starts[range] : position - misalignment;
+}
+
+static void SoftCopyStream(const SoftTransferCopy* copy, size_t begin, size_t end)
+{
+	for(uint32_t i = 0; i < copy->ranges_count && begin < end; i++)
+	{
+		size_t range_begin = copy->range_starts[i];
+		size_t range_end = copy->range_starts[i + 1];
+		if(range_end <= begin)
+			continue;
+		size_t offset = begin - range_begin;
+		size_t size = (range_end < end ? range_end : end) - begin;
+		if(copy->non_temporal)
+			SoftCopyNonTemporal(copy->ranges[i].dst + offset, copy->ranges[i].src + offset, size);
+		else
+			memcpy(copy->ranges[i].dst + offset, copy->ranges[i].src + offset, size);
+		begin += size;
+	}
+	#ifdef SOFT_TRANSFER_STREAMING_STORES
+		if(copy->non_temporal)
+			_mm_sfence(); // Streaming stores are weakly ordered, they must land before the task is reported as done
+	#endif
+}
+
+static void SoftTransferCopyTask(void* userdata, uint32_t task_index, uint32_t worker_index)
+{
+	PULSE_UNUSED(worker_index);
+	const SoftTransferCopy* copy = (const SoftTransferCopy*)userdata;
+	SoftCopyStream(copy, SoftGetChunkBoundary(copy, task_index), SoftGetChunkBoundary(copy, task_index + 1));
+}
+
+static size_t SoftGetLastLevelCacheSize(const SoftDevice* device)
+{
+	const struct cpuinfo_processor* processor = device->device;
+	if(processor == PULSE_NULLPTR)
+		return 0;
+	if(processor->cache.l3 != PULSE_NULLPTR)
+		return processor->cache.l3->size;
+	if(processor->cache.l2 != PULSE_NULLPTR)
+		return processor->cache.l2->size;
+	return 0;
+}
+
+void SoftTransferCopyRanges(SoftDevice* device, const SoftTransferRange* ranges, uint32_t ranges_count)
+{
+	if(ranges_count == 0 || ranges_count > SOFT_TRANSFER_MAX_RANGES)
+		return;
+
+	SoftTransferCopy copy;
+	copy.ranges = ranges;
+	copy.ranges_count = ranges_count;
+	copy.range_starts[0] = 0;
+	for(uint32_t i = 0; i < ranges_count; i++)
+		copy.range_starts[i + 1] = copy.range_starts[i] + ranges[i].size;
+	size_t stream_size = copy.range_starts[ranges_count];
+
+	size_t cache_size = SoftGetLastLevelCacheSize(device);
+	copy.non_temporal = cache_size != 0 && stream_size >= cache_size;
+
+	uint32_t workers_count = device->thread_pool.workers_count;
+	if(stream_size < SOFT_TRANSFER_PARALLEL_THRESHOLD || workers_count <= 1)
+	{
+		SoftCopyStream(&copy, 0, stream_size);
+		return;
+	}
+
+	// A few chunks per worker so that stealing can even out NUMA and frequency differences
+	size_t chunk_size = stream_size / ((size_t)workers_count * 4);
+	if(chunk_size < SOFT_TRANSFER_CHUNK_SIZE)
+		chunk_size = SOFT_TRANSFER_CHUNK_SIZE;
+	copy.chunk_size = (chunk_size + SOFT_TRANSFER_PAGE_SIZE - 1) & ~(size_t)(SOFT_TRANSFER_PAGE_SIZE - 1);
+	uint32_t tasks_count = (uint32_t)((stream_size + copy.chunk_size - 1) / copy.chunk_size);
+	SoftThreadPoolRunBatch(&device->thread_pool, SoftTransferCopyTask, &copy, tasks_count);
+}
+
+static void SoftTransferSwizzleTask(void* userdata, uint32_t task_index, uint32_t worker_index)
+{
+	PULSE_UNUSED(worker_index);
+	const SoftTransferRows* rows = (const SoftTransferRows*)userdata;
+	SoftSwizzleRows(rows->region, rows->linear, rows->linear_size, rows->to_image, task_index * rows->rows_per_task, rows->rows_per_task);
+}
+
+// Rows cover disjoint texels, tasks sharing a tile never write the same bytes
+void SoftTransferSwizzle(SoftDevice* device, const PulseImageRegion* region, uint8_t* linear, size_t linear_size, bool to_image)
+{
+	SoftTransferRows rows;
+	size_t row_size;
+	rows.region = region;
+	rows.linear = linear;
+	rows.linear_size = linear_size;
+	rows.to_image = to_image;
+	rows.rows_count = SoftGetSwizzleRowsCount(region, &row_size);
+	if(rows.rows_count == 0)
+		return;
+
+	size_t transfer_size = row_size * rows.rows_count;
+	uint32_t workers_count = device->thread_pool.workers_count;
+	if(transfer_size < SOFT_TRANSFER_PARALLEL_THRESHOLD || workers_count <= 1 || rows.rows_count == 1)
+	{
+		SoftSwizzleRows(region, linear, linear_size, to_image, 0, rows.rows_count);
+		return;
+	}
+
+	size_t task_size = transfer_size / ((size_t)workers_count * 4);
+	if(task_size < SOFT_TRANSFER_CHUNK_SIZE)
+		task_size = SOFT_TRANSFER_CHUNK_SIZE;
+	rows.rows_per_task = (uint32_t)((task_size + row_size - 1) / row_size);
+	uint32_t tasks_count = (rows.rows_count + rows.rows_per_task - 1) / rows.rows_per_task;
+	SoftThreadPoolRunBatch(&device->thread_pool, SoftTransferSwizzleTask, &rows, tasks_count);
+}
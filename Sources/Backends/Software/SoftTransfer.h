@@ -0,0 +1,37 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_TRANSFER_H_
+#define PULSE_SOFTWARE_TRANSFER_H_
+
+#include <stddef.h>
+
+#include "Soft.h"
+
+#define SOFT_TRANSFER_PARALLEL_THRESHOLD (256 * 1024) // Smaller transfers run on the calling thread as a single task
+#define SOFT_TRANSFER_CHUNK_SIZE (256 * 1024)
+#define SOFT_TRANSFER_PAGE_SIZE 4096
+#define SOFT_TRANSFER_MAX_RANGES 64
+
+struct SoftDevice;
+
+typedef struct SoftTransferRange
+{
+	uint8_t* dst;
+	const uint8_t* src;
+	size_t size;
+} SoftTransferRange;
+
+// Ranges must not overlap each other, they are copied as a single stream cut in page aligned chunks
+// so that several small copies share a task. Streams bigger than the last level cache use non-temporal stores
+void SoftTransferCopyRanges(struct SoftDevice* device, const SoftTransferRange* ranges, uint32_t ranges_count);
+void SoftTransferSwizzle(struct SoftDevice* device, const PulseImageRegion* region, uint8_t* linear, size_t linear_size, bool to_image);
+
+#endif // PULSE_SOFTWARE_TRANSFER_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
@@ -0,0 +1,145 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+#include <tinycthread.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+#include "Soft.h"
+#include "SoftWorkgroup.h"
+
+// Interpreter callbacks only receive the state, the workgroup being run is found through the worker thread
+static _Thread_local SoftWorkgroup* soft_current_workgroup = PULSE_NULLPTR;
+
+static void SoftWorkgroupInvocationMain(void* userdata)
+{
+	SoftWorkgroupInvocation* invocation = (SoftWorkgroupInvocation*)userdata;
+	SoftWorkgroup* workgroup = invocation->workgroup;
+	for(;;) // Fibers are parked here between workgroups instead of being recreated
+	{
+		workgroup->function(workgroup->userdata, invocation->index);
+		invocation->finished = true;
+		SoftSwitchFiber(&invocation->fiber, &workgroup->scheduler_fiber);
+	}
+}
+
+static bool SoftReserveWorkgroupInvocations(SoftWorkgroup* workgroup, uint32_t invocations_count)
+{
+	if(workgroup->invocations_count >= invocations_count)
+		return true;
+
+	if(workgroup->scheduler_fiber.handle == PULSE_NULLPTR && !SoftInitThreadFiber(&workgroup->scheduler_fiber))
+		return false;
+
+	if(invocations_count > workgroup->invocations_capacity)
+	{
+		SoftWorkgroupInvocation** invocations = (SoftWorkgroupInvocation**)realloc(workgroup->invocations, sizeof(SoftWorkgroupInvocation*) * invocations_count);
+		PULSE_CHECK_ALLOCATION_RETVAL(invocations, false);
+		workgroup->invocations = invocations;
+		workgroup->invocations_capacity = invocations_count;
+	}
+
+	for(uint32_t i = workgroup->invocations_count; i < invocations_count; i++)
+	{
+		SoftWorkgroupInvocation* invocation = (SoftWorkgroupInvocation*)calloc(1, sizeof(SoftWorkgroupInvocation));
+		PULSE_CHECK_ALLOCATION_RETVAL(invocation, false);
+		invocation->workgroup = workgroup;
+		invocation->index = i;
+		if(!SoftInitFiber(&invocation->fiber, SoftWorkgroupInvocationMain, invocation))
+		{
+			free(invocation);
+			return false;
+		}
+		workgroup->invocations[i] = invocation;
+		workgroup->invocations_count++;
+	}
+	return true;
+}
+
+void SoftInitWorkgroup(SoftWorkgroup* workgroup)
+{
+	memset(workgroup, 0, sizeof(SoftWorkgroup));
+}
+
+bool SoftRunWorkgroup(SoftWorkgroup* workgroup, uint32_t invocations_count, bool cooperative, SoftInvocationFunction function, void* userdata)
+{
+	workgroup->function = function;
+	workgroup->userdata = userdata;
+	soft_current_workgroup = workgroup;
+
+	if(!cooperative || invocations_count <= 1)
+	{
+		for(uint32_t i = 0; i < invocations_count; i++)
+			function(userdata, i);
+	}
+	else
+	{
+		if(!SoftReserveWorkgroupInvocations(workgroup, invocations_count))
+		{
+			soft_current_workgroup = PULSE_NULLPTR;
+			return false;
+		}
+
+		for(uint32_t i = 0; i < invocations_count; i++)
+			workgroup->invocations[i]->finished = false;
+
+		// Round robin, each invocation runs until its next barrier so that all of them cross it together
+		uint32_t remaining = invocations_count;
+		while(remaining > 0)
+		{
+			for(uint32_t i = 0; i < invocations_count; i++)
+			{
+				SoftWorkgroupInvocation* invocation = workgroup->invocations[i];
+				if(invocation->finished)
+					continue;
+				workgroup->current_invocation = invocation;
+				SoftSwitchFiber(&workgroup->scheduler_fiber, &invocation->fiber);
+				if(invocation->finished)
+					remaining--;
+			}
+		}
+		workgroup->current_invocation = PULSE_NULLPTR;
+	}
+
+	soft_current_workgroup = PULSE_NULLPTR;
+	return true;
+}
+
+static void SoftReleaseWorkgroupInvocations(SoftWorkgroup* workgroup, uint32_t kept_invocations_count)
+{
+	for(uint32_t i = kept_invocations_count; i < workgroup->invocations_count; i++)
+	{
+		SoftDestroyFiber(&workgroup->invocations[i]->fiber);
+		free(workgroup->invocations[i]);
+		workgroup->invocations[i] = PULSE_NULLPTR;
+	}
+	if(workgroup->invocations_count > kept_invocations_count)
+		workgroup->invocations_count = kept_invocations_count;
+}
+
+void SoftTrimWorkgroup(SoftWorkgroup* workgroup)
+{
+	SoftReleaseWorkgroupInvocations(workgroup, SOFT_WORKGROUP_KEPT_INVOCATIONS);
+}
+
+void SoftDestroyWorkgroup(SoftWorkgroup* workgroup)
+{
+	SoftReleaseWorkgroupInvocations(workgroup, 0);
+	SoftDestroyFiber(&workgroup->scheduler_fiber);
+	free(workgroup->invocations);
+	memset(workgroup, 0, sizeof(SoftWorkgroup));
+}
+
+SoftWorkgroup* SoftGetCurrentWorkgroup(void)
+{
+	return soft_current_workgroup;
+}
+
+void SoftWorkgroupBarrier(SoftWorkgroup* workgroup)
+{
+	if(workgroup == PULSE_NULLPTR || workgroup->current_invocation == PULSE_NULLPTR)
+		return;
+	SoftSwitchFiber(&workgroup->current_invocation->fiber, &workgroup->scheduler_fiber);
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <Pulse.h>
+
+#ifdef PULSE_ENABLE_SOFTWARE_BACKEND
+
+#ifndef PULSE_SOFTWARE_WORKGROUP_H_
+#define PULSE_SOFTWARE_WORKGROUP_H_
+
+#include "Soft.h"
+#include "SoftFiber.h"
+
+#define SOFT_WORKGROUP_KEPT_INVOCATIONS 256
+
+typedef void (*SoftInvocationFunction)(void* userdata, uint32_t local_invocation_index);
+
+typedef struct SoftWorkgroupInvocation
+{
+	SoftFiber fiber;
+	struct SoftWorkgroup* workgroup;
+	uint32_t index;
+	bool finished;
+} SoftWorkgroupInvocation;
+
+// One per worker thread, reused for every workgroup that worker executes
+typedef struct SoftWorkgroup
+{
+	SoftFiber scheduler_fiber;
+	SoftWorkgroupInvocation** invocations; // Pointers so that fibers never move in memory
+	uint32_t invocations_count;
+	uint32_t invocations_capacity;
+	SoftWorkgroupInvocation* current_invocation;
+
+	SoftInvocationFunction function;
+	void* userdata;
+} SoftWorkgroup;
+
+void SoftInitWorkgroup(SoftWorkgroup* workgroup);
+bool SoftRunWorkgroup(SoftWorkgroup* workgroup, uint32_t invocations_count, bool cooperative, SoftInvocationFunction function, void* userdata);
+void SoftTrimWorkgroup(SoftWorkgroup* workgroup); // Releases the fibers beyond SOFT_WORKGROUP_KEPT_INVOCATIONS, the worker must be idle
+void SoftDestroyWorkgroup(SoftWorkgroup* workgroup);
+
+SoftWorkgroup* SoftGetCurrentWorkgroup(void);
+void SoftWorkgroupBarrier(SoftWorkgroup* workgroup); // Parks the current invocation until every other one reached a barrier or finished
+
+#endif // PULSE_SOFTWARE_WORKGROUP_H_
+
+#endif // PULSE_ENABLE_SOFTWARE_BACKEND
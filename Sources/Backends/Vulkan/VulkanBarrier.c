@@ -0,0 +1,343 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <string.h>
+#include <stdatomic.h>
+
+#include "Pulse.h"
+#include "Vulkan.h"
+#include "VulkanBarrier.h"
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandList.h"
+
+// Past this many buffer barriers drivers handle a single global memory barrier better
+#define VULKAN_MAX_BUFFER_BARRIERS 8
+
+// Images going back and forth between copies and dispatches this many times stay in GENERAL, which copies accept too
+#define VULKAN_IMAGE_GENERAL_TRANSITIONS_THRESHOLD 4
+
+#define VULKAN_WRITE_ACCESS (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT)
+
+void VulkanResetBarrierTracker(VulkanBarrierTracker* tracker)
+{
+	PULSE_CHECK_PTR(tracker);
+	for(uint32_t i = 0; i < tracker->states_size; i++)
+		free(tracker->states[i].layouts);
+	tracker->states_size = 0;
+	tracker->buffer_barriers_size = 0;
+	tracker->image_barriers_size = 0;
+	memset(&tracker->memory_barrier, 0, sizeof(VkMemoryBarrier));
+	tracker->memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	tracker->src_stages = 0;
+	tracker->dst_stages = 0;
+}
+
+void VulkanUninitBarrierTracker(VulkanBarrierTracker* tracker)
+{
+	PULSE_CHECK_PTR(tracker);
+	for(uint32_t i = 0; i < tracker->states_size; i++)
+		free(tracker->states[i].layouts);
+	free(tracker->states);
+	free(tracker->buffer_barriers);
+	free(tracker->image_barriers);
+	memset(tracker, 0, sizeof(VulkanBarrierTracker));
+}
+
+static VulkanResourceState* VulkanGetResourceState(VulkanBarrierTracker* tracker, const void* resource)
+{
+	for(uint32_t i = 0; i < tracker->states_size; i++)
+	{
+		if(tracker->states[i].resource == resource)
+			return &tracker->states[i];
+	}
+	PULSE_EXPAND_ARRAY_IF_NEEDED(tracker->states, VulkanResourceState, tracker->states_size, tracker->states_capacity, 16);
+	PULSE_CHECK_ALLOCATION_RETVAL(tracker->states, PULSE_NULLPTR);
+	VulkanResourceState* state = &tracker->states[tracker->states_size];
+	memset(state, 0, sizeof(VulkanResourceState));
+	state->resource = resource;
+	tracker->states_size++;
+	return state;
+}
+
+// Updates the state with the access and gives what it has to wait for, nothing if src_stages is zero
+static void VulkanResolveHazard(VulkanResourceState* state, VkPipelineStageFlags stage, VkAccessFlags access, VkPipelineStageFlags* src_stages, VkAccessFlags* src_access)
+{
+	*src_stages = 0;
+	*src_access = 0;
+	if(access & VULKAN_WRITE_ACCESS)
+	{
+		// Writes after reads only wait for the reads to be done
+		*src_stages = state->write_stages | state->read_stages;
+		*src_access = state->write_access;
+		state->write_stages = stage;
+		state->write_access = access & VULKAN_WRITE_ACCESS;
+		state->read_stages = 0;
+		state->visible_stages = 0;
+		state->visible_access = 0;
+		return;
+	}
+	if(state->write_stages != 0 && ((state->visible_stages & stage) != stage || (state->visible_access & access) != access))
+	{
+		*src_stages = state->write_stages;
+		*src_access = state->write_access;
+		state->visible_stages |= stage;
+		state->visible_access |= access;
+	}
+	state->read_stages |= stage;
+}
+
+void VulkanTrackBufferAccess(PulseCommandList cmd, PulseBuffer buffer, VkPipelineStageFlags stage, VkAccessFlags access)
+{
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
+	VulkanBuffer* vulkan_buffer = VULKAN_RETRIEVE_DRIVER_DATA_AS(buffer, VulkanBuffer*);
+	VulkanBarrierTracker* tracker = &vulkan_cmd->barriers;
+
+	VulkanResourceState* state = VulkanGetResourceState(tracker, vulkan_buffer);
+	if(state == PULSE_NULLPTR)
+		return;
+	VkPipelineStageFlags src_stages;
+	VkAccessFlags src_access;
+	VulkanResolveHazard(state, stage, access, &src_stages, &src_access);
+	if(src_stages == 0)
+		return;
+	tracker->src_stages |= src_stages;
+	tracker->dst_stages |= stage;
+	if(src_access == 0) // Execution dependency only
+		return;
+
+	for(uint32_t i = 0; i < tracker->buffer_barriers_size; i++)
+	{
+		if(tracker->buffer_barriers[i].buffer == vulkan_buffer->buffer)
+		{
+			tracker->buffer_barriers[i].srcAccessMask |= src_access;
+			tracker->buffer_barriers[i].dstAccessMask |= access;
+			return;
+		}
+	}
+
+	PULSE_EXPAND_ARRAY_IF_NEEDED(tracker->buffer_barriers, VkBufferMemoryBarrier, tracker->buffer_barriers_size, tracker->buffer_barriers_capacity, 8);
+	PULSE_CHECK_ALLOCATION(tracker->buffer_barriers);
+	VkBufferMemoryBarrier* barrier = &tracker->buffer_barriers[tracker->buffer_barriers_size];
+	memset(barrier, 0, sizeof(VkBufferMemoryBarrier));
+	barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier->srcAccessMask = src_access;
+	barrier->dstAccessMask = access;
+	barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->buffer = vulkan_buffer->buffer;
+	barrier->offset = 0;
+	barrier->size = VK_WHOLE_SIZE;
+	tracker->buffer_barriers_size++;
+}
+
+static bool VulkanIsTransferLayout(VkImageLayout layout)
+{
+	return layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL || layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+}
+
+static void VulkanAddImageBarrier(VulkanBarrierTracker* tracker, VkImage image, VkAccessFlags src_access, VkAccessFlags dst_access, VkImageLayout old_layout, VkImageLayout new_layout, uint32_t base_layer, uint32_t layers_count)
+{
+	for(uint32_t i = 0; i < tracker->image_barriers_size; i++)
+	{
+		VkImageMemoryBarrier* barrier = &tracker->image_barriers[i];
+		if(barrier->image == image && barrier->oldLayout == old_layout && barrier->newLayout == new_layout && barrier->subresourceRange.baseArrayLayer == base_layer && barrier->subresourceRange.layerCount == layers_count)
+		{
+			barrier->srcAccessMask |= src_access;
+			barrier->dstAccessMask |= dst_access;
+			return;
+		}
+	}
+
+	PULSE_EXPAND_ARRAY_IF_NEEDED(tracker->image_barriers, VkImageMemoryBarrier, tracker->image_barriers_size, tracker->image_barriers_capacity, 8);
+	PULSE_CHECK_ALLOCATION(tracker->image_barriers);
+	VkImageMemoryBarrier* barrier = &tracker->image_barriers[tracker->image_barriers_size];
+	memset(barrier, 0, sizeof(VkImageMemoryBarrier));
+	barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier->srcAccessMask = src_access;
+	barrier->dstAccessMask = dst_access;
+	barrier->oldLayout = old_layout;
+	barrier->newLayout = new_layout;
+	barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier->image = image;
+	barrier->subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier->subresourceRange.baseMipLevel = 0;
+	barrier->subresourceRange.levelCount = 1;
+	barrier->subresourceRange.baseArrayLayer = base_layer;
+	barrier->subresourceRange.layerCount = layers_count;
+	tracker->image_barriers_size++;
+}
+
+VkImageLayout VulkanTrackImageAccess(PulseCommandList cmd, PulseImage image, uint32_t base_layer, uint32_t layers_count, VkPipelineStageFlags stage, VkAccessFlags access, VkImageLayout layout)
+{
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
+	VulkanImage* vulkan_image = VULKAN_RETRIEVE_DRIVER_DATA_AS(image, VulkanImage*);
+	VulkanBarrierTracker* tracker = &vulkan_cmd->barriers;
+
+	if(atomic_load(&vulkan_image->keep_general))
+		layout = VK_IMAGE_LAYOUT_GENERAL;
+	if(base_layer >= vulkan_image->layers_count)
+		return layout;
+	if(layers_count > vulkan_image->layers_count - base_layer)
+		layers_count = vulkan_image->layers_count - base_layer;
+
+	VulkanResourceState* state = VulkanGetResourceState(tracker, vulkan_image);
+	if(state == PULSE_NULLPTR)
+		return layout;
+	if(state->layouts == PULSE_NULLPTR)
+	{
+		// A single allocation for the current and the entry layouts
+		state->layouts = (VkImageLayout*)malloc(2 * vulkan_image->layers_count * sizeof(VkImageLayout));
+		PULSE_CHECK_ALLOCATION_RETVAL(state->layouts, layout);
+		state->entry_layouts = state->layouts + vulkan_image->layers_count;
+		for(uint32_t i = 0; i < 2 * vulkan_image->layers_count; i++)
+			state->layouts[i] = VULKAN_IMAGE_LAYOUT_UNKNOWN;
+	}
+
+	// Layers first used by this command list are transitioned at submission, before it runs
+	bool needs_transition = false;
+	for(uint32_t i = base_layer; i < base_layer + layers_count; i++)
+	{
+		if(state->layouts[i] == VULKAN_IMAGE_LAYOUT_UNKNOWN)
+		{
+			state->layouts[i] = layout;
+			state->entry_layouts[i] = layout;
+		}
+		needs_transition = needs_transition || state->layouts[i] != layout;
+	}
+
+	if(!needs_transition)
+	{
+		VkPipelineStageFlags src_stages;
+		VkAccessFlags src_access;
+		VulkanResolveHazard(state, stage, access, &src_stages, &src_access);
+		if(src_stages == 0)
+			return layout;
+		tracker->src_stages |= src_stages;
+		tracker->dst_stages |= stage;
+		if(src_access != 0)
+			VulkanAddImageBarrier(tracker, vulkan_image->image, src_access, access, layout, layout, base_layer, layers_count);
+		return layout;
+	}
+
+	// Transitions read and write the subresources, they wait for every previous access and act as a write themselves
+	VkAccessFlags src_access = state->write_access;
+	tracker->src_stages |= state->write_stages | state->read_stages;
+	tracker->dst_stages |= stage;
+	bool is_write = (access & VULKAN_WRITE_ACCESS) != 0;
+	state->write_stages = stage;
+	state->write_access = access & VULKAN_WRITE_ACCESS;
+	state->read_stages = is_write ? 0 : stage;
+	state->visible_stages = is_write ? 0 : stage;
+	state->visible_access = is_write ? 0 : access;
+
+	bool is_ping_pong = false;
+	for(uint32_t i = base_layer; i < base_layer + layers_count;)
+	{
+		VkImageLayout old_layout = state->layouts[i];
+		uint32_t end = i + 1;
+		while(end < base_layer + layers_count && state->layouts[end] == old_layout)
+			end++;
+		if(old_layout != layout)
+		{
+			VulkanAddImageBarrier(tracker, vulkan_image->image, src_access, access, old_layout, layout, i, end - i);
+			is_ping_pong = is_ping_pong || (old_layout == VK_IMAGE_LAYOUT_GENERAL && VulkanIsTransferLayout(layout)) || (VulkanIsTransferLayout(old_layout) && layout == VK_IMAGE_LAYOUT_GENERAL);
+		}
+		for(; i < end; i++)
+			state->layouts[i] = layout;
+	}
+	// The decision is shared by all command lists, a stale read only costs a few more transitions
+	if(is_ping_pong && ++state->general_transitions_count + atomic_load(&vulkan_image->general_transitions_count) >= VULKAN_IMAGE_GENERAL_TRANSITIONS_THRESHOLD)
+		atomic_store(&vulkan_image->keep_general, true);
+	return layout;
+}
+
+VkResult VulkanResolveImageLayouts(PulseCommandList cmd, VkCommandBuffer resolve_cmd, bool* recorded)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd->device, VulkanDevice*);
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
+	VulkanBarrierTracker* tracker = &vulkan_cmd->barriers;
+
+	*recorded = false;
+	tracker->image_barriers_size = 0;
+	for(uint32_t i = 0; i < tracker->states_size; i++)
+	{
+		VulkanResourceState* state = &tracker->states[i];
+		if(state->layouts == PULSE_NULLPTR)
+			continue;
+		VulkanImage* vulkan_image = (VulkanImage*)state->resource;
+		for(uint32_t layer = 0; layer < vulkan_image->layers_count;)
+		{
+			VkImageLayout old_layout = vulkan_image->layouts[layer];
+			VkImageLayout new_layout = state->entry_layouts[layer];
+			uint32_t end = layer + 1;
+			while(end < vulkan_image->layers_count && vulkan_image->layouts[end] == old_layout && state->entry_layouts[end] == new_layout)
+				end++;
+			// Previous submissions are made available as a whole, the command list takes care of its own hazards
+			if(new_layout != VULKAN_IMAGE_LAYOUT_UNKNOWN && old_layout != new_layout)
+				VulkanAddImageBarrier(tracker, vulkan_image->image, VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT, old_layout, new_layout, layer, end - layer);
+			for(; layer < end; layer++)
+			{
+				if(state->layouts[layer] != VULKAN_IMAGE_LAYOUT_UNKNOWN)
+					vulkan_image->layouts[layer] = state->layouts[layer];
+			}
+		}
+		atomic_fetch_add(&vulkan_image->general_transitions_count, state->general_transitions_count);
+		state->general_transitions_count = 0;
+	}
+	if(tracker->image_barriers_size == 0)
+		return VK_SUCCESS;
+
+	VkCommandBufferBeginInfo begin_info = { 0 };
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	VkResult res = vulkan_device->vkResetCommandBuffer(resolve_cmd, 0);
+	if(res == VK_SUCCESS)
+		res = vulkan_device->vkBeginCommandBuffer(resolve_cmd, &begin_info);
+	if(res == VK_SUCCESS)
+	{
+		vulkan_device->vkCmdPipelineBarrier(resolve_cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, PULSE_NULLPTR, 0, PULSE_NULLPTR, tracker->image_barriers_size, tracker->image_barriers);
+		res = vulkan_device->vkEndCommandBuffer(resolve_cmd);
+	}
+	tracker->image_barriers_size = 0;
+	*recorded = res == VK_SUCCESS;
+	return res;
+}
+
+void VulkanFlushBarriers(PulseCommandList cmd)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd->device, VulkanDevice*);
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
+	VulkanBarrierTracker* tracker = &vulkan_cmd->barriers;
+
+	if(tracker->src_stages == 0 && tracker->image_barriers_size == 0)
+		return;
+
+	if(tracker->buffer_barriers_size > VULKAN_MAX_BUFFER_BARRIERS)
+	{
+		for(uint32_t i = 0; i < tracker->buffer_barriers_size; i++)
+		{
+			tracker->memory_barrier.srcAccessMask |= tracker->buffer_barriers[i].srcAccessMask;
+			tracker->memory_barrier.dstAccessMask |= tracker->buffer_barriers[i].dstAccessMask;
+		}
+		tracker->buffer_barriers_size = 0;
+	}
+	uint32_t memory_barriers_count = (tracker->memory_barrier.srcAccessMask != 0 ? 1 : 0);
+
+	// First uses of images only have a layout transition to wait for
+	VkPipelineStageFlags src_stages = tracker->src_stages != 0 ? tracker->src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	vulkan_device->vkCmdPipelineBarrier(vulkan_cmd->cmd, src_stages, tracker->dst_stages, 0,
+		memory_barriers_count, &tracker->memory_barrier,
+		tracker->buffer_barriers_size, tracker->buffer_barriers,
+		tracker->image_barriers_size, tracker->image_barriers);
+
+	tracker->buffer_barriers_size = 0;
+	tracker->image_barriers_size = 0;
+	tracker->memory_barrier.srcAccessMask = 0;
+	tracker->memory_barrier.dstAccessMask = 0;
+	tracker->src_stages = 0;
+	tracker->dst_stages = 0;
+}
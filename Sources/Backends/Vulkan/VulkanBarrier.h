@@ -0,0 +1,67 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifdef PULSE_ENABLE_VULKAN_BACKEND
+
+#ifndef PULSE_VULKAN_BARRIER_H_
+#define PULSE_VULKAN_BARRIER_H_
+
+#include <vulkan/vulkan_core.h>
+
+#include <Pulse.h>
+
+// Last accesses to a buffer or an image since the command list started recording
+typedef struct VulkanResourceState
+{
+	const void* resource; // VulkanBuffer or VulkanImage
+	VkPipelineStageFlags write_stages; // Also set by image layout transitions
+	VkAccessFlags write_access;
+	VkPipelineStageFlags read_stages; // Reads since the last write
+	VkPipelineStageFlags visible_stages; // Where the last write has already been made visible
+	VkAccessFlags visible_access;
+
+	// Images only, one entry per layer. Layouts are tracked per command list as others may be recorded concurrently,
+	// the layouts images have to be in before the command list runs are resolved against the device ones at submission
+	VkImageLayout* layouts;
+	VkImageLayout* entry_layouts;
+	uint32_t general_transitions_count;
+} VulkanResourceState;
+
+#define VULKAN_IMAGE_LAYOUT_UNKNOWN VK_IMAGE_LAYOUT_MAX_ENUM
+
+// Barriers are gathered lazily and recorded as a single vkCmdPipelineBarrier right before the command that needs them
+typedef struct VulkanBarrierTracker
+{
+	VulkanResourceState* states;
+	uint32_t states_size;
+	uint32_t states_capacity;
+
+	VkBufferMemoryBarrier* buffer_barriers;
+	uint32_t buffer_barriers_size;
+	uint32_t buffer_barriers_capacity;
+
+	VkImageMemoryBarrier* image_barriers;
+	uint32_t image_barriers_size;
+	uint32_t image_barriers_capacity;
+
+	VkMemoryBarrier memory_barrier;
+	VkPipelineStageFlags src_stages;
+	VkPipelineStageFlags dst_stages;
+} VulkanBarrierTracker;
+
+void VulkanResetBarrierTracker(VulkanBarrierTracker* tracker);
+void VulkanUninitBarrierTracker(VulkanBarrierTracker* tracker);
+
+// Accesses of one command are tracked before flushing the barriers and recording it
+void VulkanTrackBufferAccess(PulseCommandList cmd, PulseBuffer buffer, VkPipelineStageFlags stage, VkAccessFlags access);
+// Transitions the layers to the layout and returns the one the command has to use, images that ping-pong are kept in GENERAL
+VkImageLayout VulkanTrackImageAccess(PulseCommandList cmd, PulseImage image, uint32_t base_layer, uint32_t layers_count, VkPipelineStageFlags stage, VkAccessFlags access, VkImageLayout layout);
+void VulkanFlushBarriers(PulseCommandList cmd);
+// Records into resolve_cmd the transitions from the device image layouts to the ones the command list expects and
+// advances the device layouts to the ones it leaves, must be externally synchronised with the queue submission
+VkResult VulkanResolveImageLayouts(PulseCommandList cmd, VkCommandBuffer resolve_cmd, bool* recorded);
+
+#endif // PULSE_VULKAN_BARRIER_H_
+
+#endif // PULSE_ENABLE_VULKAN_BACKEND
@@ -43,7 +43,7 @@ PulseBuffer VulkanCreateBuffer(PulseDevice device, const PulseBufferCreateInfo*
 		allocation_create_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 	}
 	if(buffer->usage & PULSE_BUFFER_USAGE_STORAGE_READ || buffer->usage & PULSE_BUFFER_USAGE_STORAGE_WRITE)
-		vulkan_buffer->usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		vulkan_buffer->usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
 
 	VkBufferCreateInfo buffer_create_info = { 0 };
 	buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -84,6 +84,10 @@ bool VulkanCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRegion* src
 	copy_region.srcOffset = src->offset;
 	copy_region.dstOffset = dst->offset;
 	copy_region.size = (src->size < dst->size ? src->size : dst->size);
+
+	VulkanTrackBufferAccess(cmd, src->buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+	VulkanTrackBufferAccess(cmd, dst->buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+	VulkanFlushBarriers(cmd);
 	vulkan_device->vkCmdCopyBuffer(vulkan_cmd->cmd, vulkan_src_buffer->buffer, vulkan_dst_buffer->buffer, 1, &copy_region);
 
 	return true;
@@ -111,7 +115,11 @@ bool VulkanCopyBufferToImage(PulseCommandList cmd, const PulseBufferRegion* src,
 	region.imageExtent.height = dst->height;
 	region.imageExtent.depth = dst->depth;
 
-	vulkan_device->vkCmdCopyBufferToImage(vulkan_cmd->cmd, vulkan_src_buffer->buffer, vulkan_dst_image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	VulkanTrackBufferAccess(cmd, src->buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+	VkImageLayout layout = VulkanTrackImageAccess(cmd, dst->image, dst->layer, 1, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	VulkanFlushBarriers(cmd);
+
+	vulkan_device->vkCmdCopyBufferToImage(vulkan_cmd->cmd, vulkan_src_buffer->buffer, vulkan_dst_image->image, layout, 1, &region);
 
 	return true;
 }
@@ -8,6 +8,7 @@
 #include "VulkanDevice.h"
 #include "VulkanQueue.h"
 #include "VulkanComputePass.h"
+#include "VulkanBarrier.h"
 
 static void VulkanInitCommandList(VulkanCommandPool* pool, PulseCommandList cmd)
 {
@@ -18,6 +19,7 @@ static void VulkanInitCommandList(VulkanCommandPool* pool, PulseCommandList cmd)
 	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
 
 	vulkan_cmd->pool = pool;
+	VulkanInitDescriptorSetAllocator(&vulkan_cmd->descriptor_set_allocator, pool->device);
 
 	VkCommandBufferAllocateInfo info = { 0 };
 	info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -25,6 +27,12 @@ static void VulkanInitCommandList(VulkanCommandPool* pool, PulseCommandList cmd)
 	info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 	info.commandBufferCount = 1;
 	CHECK_VK(pool->device->backend, vulkan_device->vkAllocateCommandBuffers(vulkan_device->device, &info, &vulkan_cmd->cmd), PULSE_ERROR_INITIALIZATION_FAILED);
+	CHECK_VK(pool->device->backend, vulkan_device->vkAllocateCommandBuffers(vulkan_device->device, &info, &vulkan_cmd->resolve_cmd), PULSE_ERROR_INITIALIZATION_FAILED);
+
+	VkFenceCreateInfo fence_info = { 0 };
+	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	CHECK_VK(pool->device->backend, vulkan_device->vkCreateFence(vulkan_device->device, &fence_info, PULSE_NULLPTR, &vulkan_cmd->completion_fence), PULSE_ERROR_INITIALIZATION_FAILED);
+	vulkan_cmd->is_pending = false;
 
 	PULSE_EXPAND_ARRAY_IF_NEEDED(pool->available_command_lists, PulseCommandList, pool->available_command_lists_size, pool->available_command_lists_capacity, 5);
 	pool->available_command_lists[pool->available_command_lists_size] = cmd;
@@ -72,6 +80,11 @@ PulseCommandList VulkanRequestCommandList(PulseDevice device, PulseCommandListUs
 		VulkanInitCommandList(pool, cmd);
 	}
 
+	// Descriptor pools and command buffer may still be in use by a previous submission,
+	// even if it was submitted without a fence or released while still pending
+	if(!VulkanWaitForCommandListCompletion(device, cmd))
+		return PULSE_NULL_HANDLE;
+
 	cmd->pass = VulkanCreateComputePass(device, cmd);
 	cmd->state = PULSE_COMMAND_LIST_STATE_RECORDING;
 	cmd->is_available = false;
@@ -79,6 +92,9 @@ PulseCommandList VulkanRequestCommandList(PulseDevice device, PulseCommandListUs
 	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
 	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
 
+	VulkanResetBarrierTracker(&vulkan_cmd->barriers);
+	VulkanResetDescriptorSetAllocator(&vulkan_cmd->descriptor_set_allocator);
+
 	CHECK_VK_RETVAL(device->backend, vulkan_device->vkResetCommandBuffer(vulkan_cmd->cmd, 0), PULSE_ERROR_DEVICE_ALLOCATION_FAILED, PULSE_NULL_HANDLE);
 
 	VkCommandBufferBeginInfo begin_info = { 0 };
@@ -109,6 +125,9 @@ bool VulkanSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFenc
 		default: break;
 	}
 
+	if(!VulkanWaitForCommandListCompletion(device, cmd))
+		return false;
+
 	VkFence vulkan_fence = VK_NULL_HANDLE;
 	if(fence != PULSE_NULL_HANDLE)
 	{
@@ -127,11 +146,27 @@ bool VulkanSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFenc
 
 	PULSE_CHECK_PTR_RETVAL(vulkan_queue, false);
 
-	VkSubmitInfo submit_info = { 0 };
-	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submit_info.commandBufferCount = 1;
-	submit_info.pCommandBuffers = &vulkan_cmd->cmd;
-	res = vulkan_device->vkQueueSubmit(vulkan_queue->queue, 1, &submit_info, vulkan_fence);
+	// Image layouts are resolved in submission order so that the device ones stay valid for the next command lists
+	mtx_lock(&vulkan_device->submission_mutex);
+	bool has_resolve_cmd = false;
+	res = VulkanResolveImageLayouts(cmd, vulkan_cmd->resolve_cmd, &has_resolve_cmd);
+	if(res == VK_SUCCESS)
+	{
+		VkCommandBuffer command_buffers[2] = { vulkan_cmd->resolve_cmd, vulkan_cmd->cmd };
+		VkSubmitInfo submit_info = { 0 };
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.commandBufferCount = has_resolve_cmd ? 2 : 1;
+		submit_info.pCommandBuffers = has_resolve_cmd ? command_buffers : &vulkan_cmd->cmd;
+		res = vulkan_device->vkQueueSubmit(vulkan_queue->queue, 1, &submit_info, vulkan_cmd->completion_fence);
+	}
+	if(res == VK_SUCCESS)
+	{
+		vulkan_cmd->is_pending = true;
+		// An empty submission signals the user fence once all previously submitted work on the queue has completed
+		if(vulkan_fence != VK_NULL_HANDLE)
+			res = vulkan_device->vkQueueSubmit(vulkan_queue->queue, 0, PULSE_NULLPTR, vulkan_fence);
+	}
+	mtx_unlock(&vulkan_device->submission_mutex);
 	if(fence != PULSE_NULL_HANDLE)
 		cmd->state = PULSE_COMMAND_LIST_STATE_SENT;
 	else
@@ -165,3 +200,24 @@ void VulkanReleaseCommandList(PulseDevice device, PulseCommandList cmd)
 		}
 	}
 }
+
+bool VulkanWaitForCommandListCompletion(PulseDevice device, PulseCommandList cmd)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(cmd, VulkanCommandList*);
+
+	if(!vulkan_cmd->is_pending)
+		return true;
+	VkResult res = vulkan_device->vkWaitForFences(vulkan_device->device, 1, &vulkan_cmd->completion_fence, VK_TRUE, UINT64_MAX);
+	switch(res)
+	{
+		case VK_SUCCESS: break;
+		case VK_ERROR_OUT_OF_HOST_MEMORY: PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED); return false;
+		case VK_ERROR_OUT_OF_DEVICE_MEMORY: PulseSetInternalError(PULSE_ERROR_DEVICE_ALLOCATION_FAILED); return false;
+		case VK_ERROR_DEVICE_LOST: PulseSetInternalError(PULSE_ERROR_DEVICE_LOST); return false;
+		default: return false;
+	}
+	CHECK_VK_RETVAL(device->backend, vulkan_device->vkResetFences(vulkan_device->device, 1, &vulkan_cmd->completion_fence), PULSE_ERROR_DEVICE_ALLOCATION_FAILED, false);
+	vulkan_cmd->is_pending = false;
+	return true;
+}
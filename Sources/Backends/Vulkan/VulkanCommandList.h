@@ -10,6 +10,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <Pulse.h>
+#include "VulkanBarrier.h"
 #include "VulkanBuffer.h"
 #include "VulkanCommandPool.h"
 #include "VulkanDescriptor.h"
@@ -18,11 +19,17 @@ typedef struct VulkanCommandList
 {
 	VulkanCommandPool* pool;
 	VkCommandBuffer cmd;
+	VkCommandBuffer resolve_cmd; // Transitions images to the layouts cmd expects them in, recorded at submission
+	VulkanBarrierTracker barriers;
+	VulkanDescriptorSetAllocator descriptor_set_allocator;
+	VkFence completion_fence; // Internal, signalled once the last submission has completed
+	bool is_pending;
 } VulkanCommandList;
 
 PulseCommandList VulkanRequestCommandList(PulseDevice device, PulseCommandListUsage usage);
 bool VulkanSubmitCommandList(PulseDevice device, PulseCommandList cmd, PulseFence fence);
 void VulkanReleaseCommandList(PulseDevice device, PulseCommandList cmd);
+bool VulkanWaitForCommandListCompletion(PulseDevice device, PulseCommandList cmd);
 
 #endif // PULSE_VULKAN_COMMAND_LIST_H_
 
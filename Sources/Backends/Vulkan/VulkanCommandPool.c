@@ -7,6 +7,7 @@
 #include "VulkanDevice.h"
 #include "VulkanQueue.h"
 #include "VulkanComputePass.h"
+#include "VulkanCommandList.h"
 
 bool VulkanInitCommandPool(PulseDevice device, VulkanCommandPool* pool, VulkanQueueType queue_type)
 {
@@ -37,10 +38,18 @@ void VulkanUninitCommandPool(VulkanCommandPool* pool)
 {
 	PULSE_CHECK_PTR(pool);
 
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pool->device, VulkanDevice*);
+
 	for(uint32_t i = 0; i < pool->available_command_lists_size; i++)
+	{
+		VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(pool->available_command_lists[i], VulkanCommandList*);
+		VulkanWaitForCommandListCompletion(pool->device, pool->available_command_lists[i]);
+		vulkan_device->vkDestroyFence(vulkan_device->device, vulkan_cmd->completion_fence, PULSE_NULLPTR);
+		VulkanUninitBarrierTracker(&vulkan_cmd->barriers);
+		VulkanUninitDescriptorSetAllocator(&vulkan_cmd->descriptor_set_allocator);
 		VulkanDestroyComputePass(pool->device, pool->available_command_lists[i]->pass);
+	}
 
-	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pool->device, VulkanDevice*);
 	vulkan_device->vkDestroyCommandPool(vulkan_device->device, pool->pool, PULSE_NULLPTR);
 	if(pool->available_command_lists != PULSE_NULLPTR)
 		free(pool->available_command_lists);
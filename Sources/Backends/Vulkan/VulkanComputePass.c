@@ -117,16 +117,46 @@ void VulkanBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipel
 	vulkan_pass->should_recreate_uniform_descriptor_sets = true;
 }
 
+// Storage bindings of the current pipeline, read-write ones are conservatively considered written
+static void VulkanTrackPassAccesses(PulseComputePass pass)
+{
+	PulseComputePipeline pipeline = pass->current_pipeline;
+	for(uint32_t i = 0; i < pipeline->num_readonly_storage_images; i++)
+		VulkanTrackImageAccess(pass->cmd, pass->readonly_images[i], 0, UINT32_MAX, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL);
+	for(uint32_t i = 0; i < pipeline->num_readonly_storage_buffers; i++)
+		VulkanTrackBufferAccess(pass->cmd, pass->readonly_storage_buffers[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+	for(uint32_t i = 0; i < pipeline->num_readwrite_storage_images; i++)
+		VulkanTrackImageAccess(pass->cmd, pass->readwrite_images[i], 0, UINT32_MAX, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL);
+	for(uint32_t i = 0; i < pipeline->num_readwrite_storage_buffers; i++)
+		VulkanTrackBufferAccess(pass->cmd, pass->readwrite_storage_buffers[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
 void VulkanDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z)
 {
 	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pass->cmd->device, VulkanDevice*);
 	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(pass->cmd, VulkanCommandList*);
 
 	VulkanBindDescriptorSets(pass);
+	VulkanTrackPassAccesses(pass);
+	VulkanFlushBarriers(pass->cmd);
 
 	vulkan_device->vkCmdDispatch(vulkan_cmd->cmd, groupcount_x, groupcount_y, groupcount_z);
 }
 
+void VulkanDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pass->cmd->device, VulkanDevice*);
+	VulkanCommandList* vulkan_cmd = VULKAN_RETRIEVE_DRIVER_DATA_AS(pass->cmd, VulkanCommandList*);
+	VulkanBuffer* vulkan_buffer = VULKAN_RETRIEVE_DRIVER_DATA_AS(buffer, VulkanBuffer*);
+
+	VulkanBindDescriptorSets(pass);
+	VulkanTrackBufferAccess(pass->cmd, buffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+	VulkanTrackPassAccesses(pass);
+	VulkanFlushBarriers(pass->cmd);
+
+	vulkan_device->vkCmdDispatchIndirect(vulkan_cmd->cmd, vulkan_buffer->buffer, offset);
+}
+
 PulseComputePass VulkanBeginComputePass(PulseCommandList cmd)
 {
 	return cmd->pass;
@@ -134,11 +164,12 @@ PulseComputePass VulkanBeginComputePass(PulseCommandList cmd)
 
 void VulkanEndComputePass(PulseComputePass pass)
 {
+	// The sets stay alive until the command list is recycled, the next pass just allocates new ones
 	VulkanComputePass* vulkan_pass = VULKAN_RETRIEVE_DRIVER_DATA_AS(pass, VulkanComputePass*);
-	VulkanReturnDescriptorSetToPool(vulkan_pass->read_only_descriptor_set->pool, vulkan_pass->read_only_descriptor_set);
-	VulkanReturnDescriptorSetToPool(vulkan_pass->read_write_descriptor_set->pool, vulkan_pass->read_write_descriptor_set);
-	VulkanReturnDescriptorSetToPool(vulkan_pass->uniform_descriptor_set->pool, vulkan_pass->uniform_descriptor_set);
 	vulkan_pass->read_only_descriptor_set = VK_NULL_HANDLE;
 	vulkan_pass->read_write_descriptor_set = VK_NULL_HANDLE;
 	vulkan_pass->uniform_descriptor_set = VK_NULL_HANDLE;
+	vulkan_pass->should_recreate_read_only_descriptor_sets = true;
+	vulkan_pass->should_recreate_write_descriptor_sets = true;
+	vulkan_pass->should_recreate_uniform_descriptor_sets = true;
 }
@@ -16,9 +16,9 @@
 
 typedef struct VulkanComputePass
 {
-	VulkanDescriptorSet* read_only_descriptor_set;
-	VulkanDescriptorSet* read_write_descriptor_set;
-	VulkanDescriptorSet* uniform_descriptor_set;
+	VkDescriptorSet read_only_descriptor_set;
+	VkDescriptorSet read_write_descriptor_set;
+	VkDescriptorSet uniform_descriptor_set;
 	PulseBuffer uniform_buffer;
 
 	bool should_recreate_read_only_descriptor_sets;
@@ -36,6 +36,7 @@ void VulkanBindUniformData(PulseComputePass pass, uint32_t slot, const void* dat
 void VulkanBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images);
 void VulkanBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline);
 void VulkanDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z);
+void VulkanDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset);
 
 #endif // PULSE_VULKAN_COMMAND_LIST_H_
 
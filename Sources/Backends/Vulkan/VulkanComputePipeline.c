@@ -2,12 +2,47 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <string.h>
+
 #include "Vulkan.h"
 #include "VulkanDevice.h"
 #include "VulkanCommandList.h"
 #include "VulkanComputePipeline.h"
 
-PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+#define VULKAN_CHECK_PIPELINE(backend, res, vulkan_device, pipeline) \
+	do { \
+		if((res) != VK_SUCCESS) \
+		{ \
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend)) \
+				PulseLogErrorFmt(backend, "(Vulkan) call to a Vulkan function failed due to %s", VulkanVerbaliseResult(res)); \
+			PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED); \
+			VulkanReleaseComputePipeline(vulkan_device, pipeline); \
+			return PULSE_NULL_HANDLE; \
+		} \
+	} while(0)
+
+// Releases a pipeline that has never been handed to the user, hence never used by the GPU
+static void VulkanReleaseComputePipeline(VulkanDevice* vulkan_device, PulseComputePipeline pipeline)
+{
+	VulkanComputePipeline* vulkan_pipeline = VULKAN_RETRIEVE_DRIVER_DATA_AS(pipeline, VulkanComputePipeline*);
+	if(vulkan_pipeline->read_only_descriptor_set_layout != PULSE_NULLPTR)
+		vulkan_pipeline->read_only_descriptor_set_layout->is_used = false;
+	if(vulkan_pipeline->read_write_descriptor_set_layout != PULSE_NULLPTR)
+		vulkan_pipeline->read_write_descriptor_set_layout->is_used = false;
+	if(vulkan_pipeline->uniform_descriptor_set_layout != PULSE_NULLPTR)
+		vulkan_pipeline->uniform_descriptor_set_layout->is_used = false;
+	if(vulkan_pipeline->module != VK_NULL_HANDLE)
+		vulkan_device->vkDestroyShaderModule(vulkan_device->device, vulkan_pipeline->module, PULSE_NULLPTR);
+	if(vulkan_pipeline->layout != VK_NULL_HANDLE)
+		vulkan_device->vkDestroyPipelineLayout(vulkan_device->device, vulkan_pipeline->layout, PULSE_NULLPTR);
+	if(vulkan_pipeline->pipeline != VK_NULL_HANDLE)
+		vulkan_device->vkDestroyPipeline(vulkan_device->device, vulkan_pipeline->pipeline, PULSE_NULLPTR);
+	free(vulkan_pipeline);
+	free(pipeline);
+}
+
+// Creates everything but the VkPipeline itself so that pipelines can be created in batches
+static PulseComputePipeline VulkanPrepareComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info, VkComputePipelineCreateInfo* pipeline_info)
 {
 	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
 
@@ -15,7 +50,12 @@ PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const Pulse
 	PULSE_CHECK_ALLOCATION_RETVAL(pipeline, PULSE_NULL_HANDLE);
 
 	VulkanComputePipeline* vulkan_pipeline = (VulkanComputePipeline*)calloc(1, sizeof(VulkanComputePipeline));
-	PULSE_CHECK_ALLOCATION_RETVAL(vulkan_pipeline, PULSE_NULL_HANDLE);
+	if(vulkan_pipeline == PULSE_NULLPTR)
+	{
+		free(pipeline);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
 
 	pipeline->driver_data = vulkan_pipeline;
 
@@ -33,13 +73,7 @@ PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const Pulse
 	shader_module_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 	shader_module_create_info.codeSize = info->code_size;
 	shader_module_create_info.pCode = (const uint32_t*)info->code;
-	CHECK_VK_RETVAL(device->backend, vulkan_device->vkCreateShaderModule(vulkan_device->device, &shader_module_create_info, PULSE_NULLPTR, &vulkan_pipeline->module), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
-
-	VkPipelineShaderStageCreateInfo shader_stage_info = { 0 };
-	shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	shader_stage_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-	shader_stage_info.module = vulkan_pipeline->module;
-	shader_stage_info.pName = info->entrypoint;
+	VULKAN_CHECK_PIPELINE(device->backend, vulkan_device->vkCreateShaderModule(vulkan_device->device, &shader_module_create_info, PULSE_NULLPTR, &vulkan_pipeline->module), vulkan_device, pipeline);
 
 	vulkan_pipeline->read_only_descriptor_set_layout  = VulkanGetDescriptorSetLayout(&vulkan_device->descriptor_set_layout_manager, info->num_readonly_storage_images, info->num_readonly_storage_buffers, 0, 0, 0);
 	vulkan_pipeline->read_write_descriptor_set_layout = VulkanGetDescriptorSetLayout(&vulkan_device->descriptor_set_layout_manager, 0, 0, info->num_readwrite_storage_images, info->num_readwrite_storage_buffers, 0);
@@ -55,21 +89,290 @@ PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const Pulse
 	pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 	pipeline_layout_info.setLayoutCount = 3;
 	pipeline_layout_info.pSetLayouts = descriptor_set_layouts;
-	CHECK_VK_RETVAL(device->backend, vulkan_device->vkCreatePipelineLayout(vulkan_device->device, &pipeline_layout_info, PULSE_NULLPTR, &vulkan_pipeline->layout), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	VULKAN_CHECK_PIPELINE(device->backend, vulkan_device->vkCreatePipelineLayout(vulkan_device->device, &pipeline_layout_info, PULSE_NULLPTR, &vulkan_pipeline->layout), vulkan_device, pipeline);
 
-	VkComputePipelineCreateInfo pipeline_info = { 0 };
-	pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-	pipeline_info.layout = vulkan_pipeline->layout;
-	pipeline_info.stage = shader_stage_info;
+	memset(pipeline_info, 0, sizeof(VkComputePipelineCreateInfo));
+	pipeline_info->sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipeline_info->layout = vulkan_pipeline->layout;
+	pipeline_info->stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipeline_info->stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipeline_info->stage.module = vulkan_pipeline->module;
+	pipeline_info->stage.pName = info->entrypoint;
 
-	CHECK_VK_RETVAL(device->backend, vulkan_device->vkCreateComputePipelines(vulkan_device->device, VK_NULL_HANDLE, 1, &pipeline_info, PULSE_NULLPTR, &vulkan_pipeline->pipeline), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	return pipeline;
+}
 
-	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
-		PulseLogInfoFmt(device->backend, "(Vulkan) created new compute pipeline %p", pipeline);
+// Pipelines whose preparation failed have a null layout in their create info and are skipped
+static bool VulkanPrepareComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines, VkComputePipelineCreateInfo* pipeline_infos)
+{
+	bool success = true;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		pipelines[i] = VulkanPrepareComputePipeline(device, &infos[i], &pipeline_infos[i]);
+		if(pipelines[i] == PULSE_NULL_HANDLE)
+		{
+			memset(&pipeline_infos[i], 0, sizeof(VkComputePipelineCreateInfo));
+			success = false;
+		}
+	}
+	return success;
+}
+
+// Compacts the prepared create infos so that they can be given to a single vkCreateComputePipelines call
+static uint32_t VulkanGatherPreparedComputePipelines(const PulseComputePipeline* pipelines, uint32_t count, VkComputePipelineCreateInfo* pipeline_infos, uint32_t* indices)
+{
+	uint32_t prepared_count = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(pipelines[i] == PULSE_NULL_HANDLE)
+			continue;
+		pipeline_infos[prepared_count] = pipeline_infos[i];
+		indices[prepared_count] = i;
+		prepared_count++;
+	}
+	return prepared_count;
+}
+
+// Hands the created VkPipelines over to their handlers, pipelines that failed are released and set to null
+static bool VulkanFinalizeComputePipelines(PulseDevice device, PulseComputePipeline* pipelines, const VkPipeline* vk_pipelines, const uint32_t* indices, uint32_t prepared_count)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	bool success = true;
+	for(uint32_t i = 0; i < prepared_count; i++)
+	{
+		PulseComputePipeline pipeline = pipelines[indices[i]];
+		if(vk_pipelines[i] == VK_NULL_HANDLE)
+		{
+			VulkanReleaseComputePipeline(vulkan_device, pipeline);
+			pipelines[indices[i]] = PULSE_NULL_HANDLE;
+			success = false;
+			continue;
+		}
+		VULKAN_RETRIEVE_DRIVER_DATA_AS(pipeline, VulkanComputePipeline*)->pipeline = vk_pipelines[i];
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(Vulkan) created new compute pipeline %p", pipeline);
+	}
+	return success;
+}
+
+bool VulkanCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
 
+	// A single allocation for the create infos, the VkPipelines and the indices
+	uint8_t* scratch = (uint8_t*)calloc(count, sizeof(VkComputePipelineCreateInfo) + sizeof(VkPipeline) + sizeof(uint32_t));
+	if(scratch == PULSE_NULLPTR)
+	{
+		memset(pipelines, 0, count * sizeof(PulseComputePipeline));
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return false;
+	}
+	VkComputePipelineCreateInfo* pipeline_infos = (VkComputePipelineCreateInfo*)scratch;
+	VkPipeline* vk_pipelines = (VkPipeline*)(pipeline_infos + count);
+	uint32_t* indices = (uint32_t*)(vk_pipelines + count);
+
+	bool success = VulkanPrepareComputePipelines(device, infos, count, pipelines, pipeline_infos);
+	uint32_t prepared_count = VulkanGatherPreparedComputePipelines(pipelines, count, pipeline_infos, indices);
+	if(prepared_count != 0)
+	{
+		// On failure the driver sets the pipelines it could not create to VK_NULL_HANDLE
+		VkPipelineCache cache = VulkanAcquirePipelineCache(&vulkan_device->pipeline_cache_manager);
+		VkResult res = vulkan_device->vkCreateComputePipelines(vulkan_device->device, cache, prepared_count, pipeline_infos, PULSE_NULLPTR, vk_pipelines);
+		VulkanReleasePipelineCache(&vulkan_device->pipeline_cache_manager);
+		if(res != VK_SUCCESS)
+		{
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+				PulseLogErrorFmt(device->backend, "(Vulkan) call to a Vulkan function failed due to %s", VulkanVerbaliseResult(res));
+			PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		}
+		success = VulkanFinalizeComputePipelines(device, pipelines, vk_pipelines, indices, prepared_count) && success;
+	}
+	free(scratch);
+	return success;
+}
+
+PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+{
+	PulseComputePipeline pipeline;
+	VulkanCreateComputePipelines(device, info, 1, &pipeline);
 	return pipeline;
 }
 
+static void VulkanCompileComputePipelineBatchChunk(VulkanComputePipelineBatchChunk* chunk)
+{
+	VulkanComputePipelineBatch* batch = chunk->batch;
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(batch->device, VulkanDevice*);
+	chunk->result = vulkan_device->vkCreateComputePipelines(vulkan_device->device, batch->cache, chunk->count, batch->pipeline_infos + chunk->first, PULSE_NULLPTR, batch->vk_pipelines + chunk->first);
+}
+
+static int VulkanPipelineCompilationWorker(void* arg)
+{
+	VulkanPipelineCompilationWorkers* workers = (VulkanPipelineCompilationWorkers*)arg;
+	mtx_lock(&workers->mutex);
+	for(;;)
+	{
+		while(workers->queue_head == PULSE_NULLPTR && workers->is_running)
+			cnd_wait(&workers->work_condition, &workers->mutex);
+		VulkanComputePipelineBatchChunk* chunk = workers->queue_head;
+		if(chunk == PULSE_NULLPTR) // Only stops once the queue is drained
+			break;
+		workers->queue_head = chunk->next;
+		if(workers->queue_head == PULSE_NULLPTR)
+			workers->queue_tail = PULSE_NULLPTR;
+		mtx_unlock(&workers->mutex);
+
+		VulkanCompileComputePipelineBatchChunk(chunk);
+
+		mtx_lock(&workers->mutex);
+		atomic_fetch_sub(&chunk->batch->remaining_chunks, 1);
+		cnd_broadcast(&workers->done_condition);
+	}
+	mtx_unlock(&workers->mutex);
+	return 0;
+}
+
+void VulkanInitPipelineCompilationWorkers(VulkanPipelineCompilationWorkers* workers)
+{
+	memset(workers, 0, sizeof(VulkanPipelineCompilationWorkers));
+	mtx_init(&workers->mutex, mtx_plain);
+	cnd_init(&workers->work_condition);
+	cnd_init(&workers->done_condition);
+	workers->is_running = true;
+}
+
+void VulkanDestroyPipelineCompilationWorkers(VulkanPipelineCompilationWorkers* workers)
+{
+	mtx_lock(&workers->mutex);
+	workers->is_running = false;
+	cnd_broadcast(&workers->work_condition);
+	mtx_unlock(&workers->mutex);
+	for(uint32_t i = 0; i < workers->threads_count; i++)
+		thrd_join(workers->threads[i], PULSE_NULLPTR);
+	cnd_destroy(&workers->done_condition);
+	cnd_destroy(&workers->work_condition);
+	mtx_destroy(&workers->mutex);
+	memset(workers, 0, sizeof(VulkanPipelineCompilationWorkers));
+}
+
+// Returns false if no worker thread could be started at all, the mutex must be held
+static bool VulkanStartPipelineCompilationWorkers(VulkanPipelineCompilationWorkers* workers, uint32_t needed_count)
+{
+	while(workers->threads_count < needed_count && workers->threads_count < VULKAN_MAX_PIPELINE_COMPILATION_THREADS)
+	{
+		if(thrd_create(&workers->threads[workers->threads_count], VulkanPipelineCompilationWorker, workers) != thrd_success)
+			break;
+		workers->threads_count++;
+	}
+	return workers->threads_count != 0;
+}
+
+static bool VulkanFinalizeComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanComputePipelineBatch* vulkan_batch = VULKAN_RETRIEVE_DRIVER_DATA_AS(batch, VulkanComputePipelineBatch*);
+	VulkanPipelineCompilationWorkers* workers = &vulkan_device->pipeline_compilation_workers;
+	bool success = vulkan_batch->prepared;
+
+	mtx_lock(&workers->mutex);
+	while(atomic_load(&vulkan_batch->remaining_chunks) != 0)
+		cnd_wait(&workers->done_condition, &workers->mutex);
+	mtx_unlock(&workers->mutex);
+
+	for(uint32_t i = 0; i < vulkan_batch->chunks_count; i++)
+	{
+		VulkanComputePipelineBatchChunk* chunk = &vulkan_batch->chunks[i];
+		if(chunk->result != VK_SUCCESS)
+		{
+			if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+				PulseLogErrorFmt(device->backend, "(Vulkan) call to a Vulkan function failed due to %s", VulkanVerbaliseResult(chunk->result));
+			PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		}
+	}
+	VulkanReleasePipelineCache(&vulkan_device->pipeline_cache_manager);
+	success = VulkanFinalizeComputePipelines(device, batch->pipelines, vulkan_batch->vk_pipelines, vulkan_batch->indices, vulkan_batch->prepared_count) && success;
+	free(vulkan_batch);
+	batch->driver_data = PULSE_NULLPTR;
+	return success;
+}
+
+bool VulkanCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanPipelineCompilationWorkers* workers = &vulkan_device->pipeline_compilation_workers;
+	uint32_t count = batch->count;
+	uint32_t chunks_count = count < VULKAN_MAX_PIPELINE_COMPILATION_THREADS ? count : VULKAN_MAX_PIPELINE_COMPILATION_THREADS;
+
+	// A single allocation for the batch, its chunks, the create infos, the VkPipelines and the indices
+	size_t size = sizeof(VulkanComputePipelineBatch) + chunks_count * sizeof(VulkanComputePipelineBatchChunk) + count * (sizeof(VkComputePipelineCreateInfo) + sizeof(VkPipeline) + sizeof(uint32_t));
+	VulkanComputePipelineBatch* vulkan_batch = (VulkanComputePipelineBatch*)calloc(1, size);
+	PULSE_CHECK_ALLOCATION_RETVAL(vulkan_batch, false);
+	vulkan_batch->device = device;
+	vulkan_batch->chunks = (VulkanComputePipelineBatchChunk*)(vulkan_batch + 1);
+	vulkan_batch->pipeline_infos = (VkComputePipelineCreateInfo*)(vulkan_batch->chunks + chunks_count);
+	vulkan_batch->vk_pipelines = (VkPipeline*)(vulkan_batch->pipeline_infos + count);
+	vulkan_batch->indices = (uint32_t*)(vulkan_batch->vk_pipelines + count);
+	batch->driver_data = vulkan_batch;
+
+	// Shader modules and layouts are created here as the layout manager is not thread safe, only the compilations are deferred.
+	// vkCreateComputePipelines is internally synchronised on the cache so that all the workers can share the device one
+	vulkan_batch->prepared = VulkanPrepareComputePipelines(device, batch->infos, count, batch->pipelines, vulkan_batch->pipeline_infos);
+	vulkan_batch->prepared_count = VulkanGatherPreparedComputePipelines(batch->pipelines, count, vulkan_batch->pipeline_infos, vulkan_batch->indices);
+	vulkan_batch->cache = VulkanAcquirePipelineCache(&vulkan_device->pipeline_cache_manager);
+
+	chunks_count = vulkan_batch->prepared_count < chunks_count ? vulkan_batch->prepared_count : chunks_count;
+	vulkan_batch->chunks_count = chunks_count;
+	atomic_store(&vulkan_batch->remaining_chunks, chunks_count);
+
+	uint32_t first = 0;
+	for(uint32_t i = 0; i < chunks_count; i++)
+	{
+		VulkanComputePipelineBatchChunk* chunk = &vulkan_batch->chunks[i];
+		chunk->batch = vulkan_batch;
+		chunk->first = first;
+		chunk->count = vulkan_batch->prepared_count / chunks_count + (i < vulkan_batch->prepared_count % chunks_count ? 1 : 0);
+		first += chunk->count;
+	}
+	if(chunks_count == 0)
+		return true;
+
+	mtx_lock(&workers->mutex);
+	if(!VulkanStartPipelineCompilationWorkers(workers, chunks_count))
+	{
+		mtx_unlock(&workers->mutex);
+		// Compiles it right away rather than failing the whole batch
+		for(uint32_t i = 0; i < chunks_count; i++)
+			VulkanCompileComputePipelineBatchChunk(&vulkan_batch->chunks[i]);
+		atomic_store(&vulkan_batch->remaining_chunks, 0);
+		return true;
+	}
+	for(uint32_t i = 0; i < chunks_count; i++)
+	{
+		VulkanComputePipelineBatchChunk* chunk = &vulkan_batch->chunks[i];
+		if(workers->queue_tail != PULSE_NULLPTR)
+			workers->queue_tail->next = chunk;
+		else
+			workers->queue_head = chunk;
+		workers->queue_tail = chunk;
+	}
+	cnd_broadcast(&workers->work_condition);
+	mtx_unlock(&workers->mutex);
+	return true;
+}
+
+bool VulkanIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	VulkanComputePipelineBatch* vulkan_batch = VULKAN_RETRIEVE_DRIVER_DATA_AS(batch, VulkanComputePipelineBatch*);
+	if(atomic_load(&vulkan_batch->remaining_chunks) != 0)
+		return false;
+	batch->succeeded = VulkanFinalizeComputePipelineBatch(device, batch);
+	return true;
+}
+
+void VulkanWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	batch->succeeded = VulkanFinalizeComputePipelineBatch(device, batch);
+}
+
 void VulkanDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline)
 {
 	if(pipeline == PULSE_NULL_HANDLE)
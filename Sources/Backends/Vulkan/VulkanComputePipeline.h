@@ -7,7 +7,10 @@
 #ifndef PULSE_VULKAN_COMPUTE_PIPELINE_H_
 #define PULSE_VULKAN_COMPUTE_PIPELINE_H_
 
+#include <stdatomic.h>
+
 #include <vulkan/vulkan_core.h>
+#include <tinycthread.h>
 
 #include <Pulse.h>
 #include "VulkanDescriptor.h"
@@ -23,8 +26,54 @@ typedef struct VulkanComputePipeline
 	VulkanDescriptorSetLayout* uniform_descriptor_set_layout;
 } VulkanComputePipeline;
 
+// Asynchronous batches are split evenly across a fixed set of compilation threads owned by the device
+#define VULKAN_MAX_PIPELINE_COMPILATION_THREADS 8
+
+typedef struct VulkanComputePipelineBatchChunk
+{
+	struct VulkanComputePipelineBatch* batch;
+	struct VulkanComputePipelineBatchChunk* next;
+	uint32_t first;
+	uint32_t count;
+	VkResult result;
+} VulkanComputePipelineBatchChunk;
+
+// Threads are started on demand by the first asynchronous batches and live as long as the device
+typedef struct VulkanPipelineCompilationWorkers
+{
+	thrd_t threads[VULKAN_MAX_PIPELINE_COMPILATION_THREADS];
+	mtx_t mutex;
+	cnd_t work_condition;
+	cnd_t done_condition;
+	VulkanComputePipelineBatchChunk* queue_head;
+	VulkanComputePipelineBatchChunk* queue_tail;
+	uint32_t threads_count;
+	bool is_running;
+} VulkanPipelineCompilationWorkers;
+
+typedef struct VulkanComputePipelineBatch
+{
+	PulseDevice device;
+	VkPipelineCache cache;
+	VulkanComputePipelineBatchChunk* chunks;
+	VkComputePipelineCreateInfo* pipeline_infos;
+	VkPipeline* vk_pipelines;
+	uint32_t* indices; // Index in the user's array of each prepared pipeline
+	atomic_uint remaining_chunks;
+	uint32_t chunks_count;
+	uint32_t prepared_count;
+	bool prepared; // False if some pipelines already failed before compilation
+} VulkanComputePipelineBatch;
+
+void VulkanInitPipelineCompilationWorkers(VulkanPipelineCompilationWorkers* workers);
+void VulkanDestroyPipelineCompilationWorkers(VulkanPipelineCompilationWorkers* workers); // Waits for the queued compilations
+
 PulseComputePipeline VulkanCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info);
 void VulkanDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline);
+bool VulkanCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines);
+bool VulkanCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch);
+bool VulkanIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch);
+void VulkanWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch);
 
 #endif // PULSE_VULKAN_COMPUTE_PIPELINE_H_
 
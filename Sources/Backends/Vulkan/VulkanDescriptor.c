@@ -144,113 +144,97 @@ void VulkanDestroyDescriptorSetLayoutManager(VulkanDescriptorSetLayoutManager* m
 	for(uint32_t i = 0; i < manager->layouts_size; i++)
 		VulkanDestroyDescriptorSetLayout(manager->layouts[i], manager->device);
 	free(manager->layouts);
-	memset(manager, 0, sizeof(VulkanDescriptorSetPoolManager));
+	memset(manager, 0, sizeof(VulkanDescriptorSetLayoutManager));
 }
 
-void VulkanInitDescriptorSetPool(VulkanDescriptorSetPool* pool, PulseDevice device)
+static VkDescriptorPool VulkanCreateDescriptorPool(PulseDevice device)
 {
 	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
-	memset(pool, 0, sizeof(VulkanDescriptorSetPool));
-	pool->device = device;
-	pool->thread_id = PulseGetThreadID();
-
-	VkDescriptorPoolSize pool_sizes[PULSE_MAX_READ_BUFFERS_BOUND + PULSE_MAX_READ_TEXTURES_BOUND + PULSE_MAX_WRITE_BUFFERS_BOUND + PULSE_MAX_WRITE_TEXTURES_BOUND + PULSE_MAX_UNIFORM_BUFFERS_BOUND] = { 0 };
-
-	uint32_t i = 0;
-
-	for(uint32_t start = i; i < start + PULSE_MAX_READ_TEXTURES_BOUND; i++)
-	{
-		pool_sizes[i].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-		pool_sizes[i].descriptorCount = VULKAN_POOL_SIZE;
-	}
-
-	for(uint32_t start = i; i < start + PULSE_MAX_READ_BUFFERS_BOUND; i++)
-	{
-		pool_sizes[i].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		pool_sizes[i].descriptorCount = VULKAN_POOL_SIZE;
-	}
 
-	for(uint32_t start = i; i < start + PULSE_MAX_WRITE_TEXTURES_BOUND; i++)
-	{
-		pool_sizes[i].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-		pool_sizes[i].descriptorCount = VULKAN_POOL_SIZE;
-	}
-
-	for(uint32_t start = i; i < start + PULSE_MAX_WRITE_BUFFERS_BOUND; i++)
-	{
-		pool_sizes[i].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-		pool_sizes[i].descriptorCount = VULKAN_POOL_SIZE;
-	}
-
-	for(uint32_t start = i; i < start + PULSE_MAX_UNIFORM_BUFFERS_BOUND; i++)
-	{
-		pool_sizes[i].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		pool_sizes[i].descriptorCount = VULKAN_POOL_SIZE;
-	}
+	// Sized so that the pool always runs out of sets before running out of descriptors
+	VkDescriptorPoolSize pool_sizes[4] = { 0 };
+	pool_sizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	pool_sizes[0].descriptorCount = VULKAN_POOL_SIZE * PULSE_MAX_READ_TEXTURES_BOUND;
+	pool_sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	pool_sizes[1].descriptorCount = VULKAN_POOL_SIZE * PULSE_MAX_WRITE_TEXTURES_BOUND;
+	pool_sizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	pool_sizes[2].descriptorCount = VULKAN_POOL_SIZE * (PULSE_MAX_READ_BUFFERS_BOUND > PULSE_MAX_WRITE_BUFFERS_BOUND ? PULSE_MAX_READ_BUFFERS_BOUND : PULSE_MAX_WRITE_BUFFERS_BOUND);
+	pool_sizes[3].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	pool_sizes[3].descriptorCount = VULKAN_POOL_SIZE * PULSE_MAX_UNIFORM_BUFFERS_BOUND;
 
 	VkDescriptorPoolCreateInfo pool_info = { 0 };
 	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	pool_info.poolSizeCount = i;
+	pool_info.poolSizeCount = 4;
 	pool_info.pPoolSizes = pool_sizes;
 	pool_info.maxSets = VULKAN_POOL_SIZE;
-	CHECK_VK(device->backend, vulkan_device->vkCreateDescriptorPool(vulkan_device->device, &pool_info, PULSE_NULLPTR, &pool->pool), PULSE_ERROR_INITIALIZATION_FAILED);
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	CHECK_VK_RETVAL(device->backend, vulkan_device->vkCreateDescriptorPool(vulkan_device->device, &pool_info, PULSE_NULLPTR, &pool), PULSE_ERROR_INITIALIZATION_FAILED, VK_NULL_HANDLE);
+	return pool;
 }
 
-VulkanDescriptorSet* VulkanRequestDescriptorSetFromPool(VulkanDescriptorSetPool* pool, const VulkanDescriptorSetLayout* layout)
+void VulkanInitDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator, PulseDevice device)
 {
-	for(size_t i = 0; i < VULKAN_POOL_SIZE; i++)
-	{
-		if(pool->free_sets[i] == PULSE_NULLPTR)
-			break; // Due to defragmentation we are sure not to find valid sets after the first NULL one
-		if(pool->free_sets[i]->layout == layout)
-		{
-			VulkanDescriptorSet* set = pool->free_sets[i];
-			PULSE_DEFRAG_ARRAY(pool->free_sets, VULKAN_POOL_SIZE, i);
-			pool->free_index--;
-			pool->used_sets[pool->used_index] = set;
-			pool->used_index++;
-			return set;
-		}
-	}
+	memset(allocator, 0, sizeof(VulkanDescriptorSetAllocator));
+	allocator->device = device;
+}
 
-	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pool->device, VulkanDevice*);
+VkDescriptorSet VulkanAllocateDescriptorSet(VulkanDescriptorSetAllocator* allocator, const VulkanDescriptorSetLayout* layout)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(allocator->device, VulkanDevice*);
 
-	VulkanDescriptorSet* set = (VulkanDescriptorSet*)calloc(1, sizeof(VulkanDescriptorSet));
-	PULSE_CHECK_ALLOCATION_RETVAL(set, PULSE_NULLPTR);
+	if(allocator->current_pool_allocations_count == VULKAN_POOL_SIZE)
+	{
+		allocator->current_pool++;
+		allocator->current_pool_allocations_count = 0;
+	}
 
-	set->device = pool->device;
-	set->pool = pool;
-	set->layout = (VulkanDescriptorSetLayout*)layout;
+	// Pools are kept across resets so the chain only grows when a command list needs more sets than ever before
+	if(allocator->current_pool == allocator->pools_size)
+	{
+		PULSE_EXPAND_ARRAY_IF_NEEDED(allocator->pools, VkDescriptorPool, allocator->pools_size, allocator->pools_capacity, 1);
+		PULSE_CHECK_ALLOCATION_RETVAL(allocator->pools, VK_NULL_HANDLE);
+		VkDescriptorPool pool = VulkanCreateDescriptorPool(allocator->device);
+		if(pool == VK_NULL_HANDLE)
+			return VK_NULL_HANDLE;
+		allocator->pools[allocator->pools_size] = pool;
+		allocator->pools_size++;
+	}
 
 	VkDescriptorSetAllocateInfo alloc_info = { 0 };
 	alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	alloc_info.descriptorPool = pool->pool;
+	alloc_info.descriptorPool = allocator->pools[allocator->current_pool];
 	alloc_info.descriptorSetCount = 1;
 	alloc_info.pSetLayouts = &layout->layout;
-	CHECK_VK_RETVAL(pool->device->backend, vulkan_device->vkAllocateDescriptorSets(vulkan_device->device, &alloc_info, &set->set), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULLPTR);
-
-	pool->used_sets[pool->used_index] = set;
-	pool->used_index++;
 
-	pool->allocations_count++;
+	VkDescriptorSet set = VK_NULL_HANDLE;
+	CHECK_VK_RETVAL(allocator->device->backend, vulkan_device->vkAllocateDescriptorSets(vulkan_device->device, &alloc_info, &set), PULSE_ERROR_INITIALIZATION_FAILED, VK_NULL_HANDLE);
+	allocator->current_pool_allocations_count++;
 	return set;
 }
 
-void VulkanReturnDescriptorSetToPool(VulkanDescriptorSetPool* pool, const VulkanDescriptorSet* set)
+void VulkanResetDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator)
 {
-	for(size_t i = 0; i < VULKAN_POOL_SIZE; i++)
-	{
-		if(pool->used_sets[i] == PULSE_NULLPTR)
-			break; // Due to defragmentation we are sure not to find valid sets after the first NULL one
-		if(pool->used_sets[i] == set)
-		{
-			PULSE_DEFRAG_ARRAY(pool->used_sets, VULKAN_POOL_SIZE, i);
-			pool->used_index--;
-			pool->free_sets[pool->free_index] = (VulkanDescriptorSet*)set;
-			pool->free_index++;
-			return;
-		}
-	}
+	if(allocator->pools_size == 0)
+		return;
+
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(allocator->device, VulkanDevice*);
+
+	// Only the pools that have been allocated from since the last reset
+	uint32_t used_pools_count = allocator->current_pool < allocator->pools_size ? allocator->current_pool + 1 : allocator->pools_size;
+	for(uint32_t i = 0; i < used_pools_count; i++)
+		vulkan_device->vkResetDescriptorPool(vulkan_device->device, allocator->pools[i], 0);
+	allocator->current_pool = 0;
+	allocator->current_pool_allocations_count = 0;
+}
+
+void VulkanUninitDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(allocator->device, VulkanDevice*);
+	for(uint32_t i = 0; i < allocator->pools_size; i++)
+		vulkan_device->vkDestroyDescriptorPool(vulkan_device->device, allocator->pools[i], PULSE_NULLPTR);
+	free(allocator->pools);
+	memset(allocator, 0, sizeof(VulkanDescriptorSetAllocator));
 }
 
 void VulkanBindDescriptorSets(PulseComputePass pass)
@@ -272,9 +256,10 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 
 	if(vulkan_pass->should_recreate_read_only_descriptor_sets)
 	{
-		if(vulkan_pass->read_only_descriptor_set != PULSE_NULLPTR)
-			VulkanReturnDescriptorSetToPool(vulkan_pass->read_only_descriptor_set->pool, vulkan_pass->read_only_descriptor_set);
-		vulkan_pass->read_only_descriptor_set = VulkanRequestDescriptorSetFromPool(VulkanGetAvailableDescriptorSetPool(&vulkan_device->descriptor_set_pool_manager), vulkan_pipeline->read_only_descriptor_set_layout);
+		// Sets still in use by previous dispatches are left untouched, they are all recycled with the command list
+		vulkan_pass->read_only_descriptor_set = VulkanAllocateDescriptorSet(&vulkan_cmd->descriptor_set_allocator, vulkan_pipeline->read_only_descriptor_set_layout);
+		if(vulkan_pass->read_only_descriptor_set == VK_NULL_HANDLE)
+			return;
 
 		for(uint32_t i = 0; i < pass->current_pipeline->num_readonly_storage_images; i++)
 		{
@@ -286,7 +271,7 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 			write_descriptor_set->descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE; // Wtf shaders ?
 			write_descriptor_set->dstArrayElement = 0;
 			write_descriptor_set->dstBinding = i;
-			write_descriptor_set->dstSet = vulkan_pass->read_only_descriptor_set->set;
+			write_descriptor_set->dstSet = vulkan_pass->read_only_descriptor_set;
 			write_descriptor_set->pTexelBufferView = PULSE_NULLPTR;
 			write_descriptor_set->pBufferInfo = PULSE_NULLPTR;
 
@@ -312,7 +297,7 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 			write_descriptor_set->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			write_descriptor_set->dstArrayElement = 0;
 			write_descriptor_set->dstBinding = pass->current_pipeline->num_readonly_storage_images + i;
-			write_descriptor_set->dstSet = vulkan_pass->read_only_descriptor_set->set;
+			write_descriptor_set->dstSet = vulkan_pass->read_only_descriptor_set;
 			write_descriptor_set->pTexelBufferView = PULSE_NULLPTR;
 			write_descriptor_set->pBufferInfo = PULSE_NULLPTR;
 
@@ -333,9 +318,9 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 
 	if(vulkan_pass->should_recreate_write_descriptor_sets)
 	{
-		if(vulkan_pass->read_write_descriptor_set != PULSE_NULLPTR)
-			VulkanReturnDescriptorSetToPool(vulkan_pass->read_write_descriptor_set->pool, vulkan_pass->read_write_descriptor_set);
-		vulkan_pass->read_write_descriptor_set = VulkanRequestDescriptorSetFromPool(VulkanGetAvailableDescriptorSetPool(&vulkan_device->descriptor_set_pool_manager), vulkan_pipeline->read_write_descriptor_set_layout);
+		vulkan_pass->read_write_descriptor_set = VulkanAllocateDescriptorSet(&vulkan_cmd->descriptor_set_allocator, vulkan_pipeline->read_write_descriptor_set_layout);
+		if(vulkan_pass->read_write_descriptor_set == VK_NULL_HANDLE)
+			return;
 
 		for(uint32_t i = 0; i < pass->current_pipeline->num_readwrite_storage_images; i++)
 		{
@@ -347,7 +332,7 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 			write_descriptor_set->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
 			write_descriptor_set->dstArrayElement = 0;
 			write_descriptor_set->dstBinding = i;
-			write_descriptor_set->dstSet = vulkan_pass->read_write_descriptor_set->set;
+			write_descriptor_set->dstSet = vulkan_pass->read_write_descriptor_set;
 			write_descriptor_set->pTexelBufferView = PULSE_NULLPTR;
 			write_descriptor_set->pBufferInfo = PULSE_NULLPTR;
 
@@ -373,7 +358,7 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 			write_descriptor_set->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			write_descriptor_set->dstArrayElement = 0;
 			write_descriptor_set->dstBinding = pass->current_pipeline->num_readwrite_storage_images + i;
-			write_descriptor_set->dstSet = vulkan_pass->read_write_descriptor_set->set;
+			write_descriptor_set->dstSet = vulkan_pass->read_write_descriptor_set;
 			write_descriptor_set->pTexelBufferView = PULSE_NULLPTR;
 			write_descriptor_set->pBufferInfo = PULSE_NULLPTR;
 
@@ -394,9 +379,9 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 
 	if(vulkan_pass->should_recreate_uniform_descriptor_sets)
 	{
-		if(vulkan_pass->uniform_descriptor_set != PULSE_NULLPTR)
-			VulkanReturnDescriptorSetToPool(vulkan_pass->uniform_descriptor_set->pool, vulkan_pass->uniform_descriptor_set);
-		vulkan_pass->uniform_descriptor_set = VulkanRequestDescriptorSetFromPool(VulkanGetAvailableDescriptorSetPool(&vulkan_device->descriptor_set_pool_manager), vulkan_pipeline->uniform_descriptor_set_layout);
+		vulkan_pass->uniform_descriptor_set = VulkanAllocateDescriptorSet(&vulkan_cmd->descriptor_set_allocator, vulkan_pipeline->uniform_descriptor_set_layout);
+		if(vulkan_pass->uniform_descriptor_set == VK_NULL_HANDLE)
+			return;
 
 		for(uint32_t i = 0; i < pass->current_pipeline->num_uniform_buffers; i++)
 		{
@@ -408,7 +393,7 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 			write_descriptor_set->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 			write_descriptor_set->dstArrayElement = 0;
 			write_descriptor_set->dstBinding = i;
-			write_descriptor_set->dstSet = vulkan_pass->uniform_descriptor_set->set;
+			write_descriptor_set->dstSet = vulkan_pass->uniform_descriptor_set;
 			write_descriptor_set->pTexelBufferView = PULSE_NULLPTR;
 			write_descriptor_set->pBufferInfo = PULSE_NULLPTR;
 
@@ -430,71 +415,9 @@ void VulkanBindDescriptorSets(PulseComputePass pass)
 	vulkan_device->vkUpdateDescriptorSets(vulkan_device->device, write_count, writes, 0, PULSE_NULLPTR);
 
 	VkDescriptorSet sets[3];
-	sets[0] = vulkan_pass->read_only_descriptor_set->set;
-	sets[1] = vulkan_pass->read_write_descriptor_set->set;
-	sets[2] = vulkan_pass->uniform_descriptor_set->set;
+	sets[0] = vulkan_pass->read_only_descriptor_set;
+	sets[1] = vulkan_pass->read_write_descriptor_set;
+	sets[2] = vulkan_pass->uniform_descriptor_set;
 
 	vulkan_device->vkCmdBindDescriptorSets(vulkan_cmd->cmd, VK_PIPELINE_BIND_POINT_COMPUTE, vulkan_pipeline->layout, 0, 3, sets, 0, PULSE_NULLPTR);
 }
-
-void VulkanDestroyDescriptorSetPool(VulkanDescriptorSetPool* pool)
-{
-	if(pool->pool == VK_NULL_HANDLE)
-		return;
-
-	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(pool->device, VulkanDevice*);
-
-	for(size_t i = 0; i < VULKAN_POOL_SIZE; i++)
-	{
-		if(pool->used_sets[i] != PULSE_NULLPTR)
-		{
-			free(pool->used_sets[i]);
-			pool->used_sets[i] = PULSE_NULLPTR;
-		}
-		if(pool->free_sets[i] != PULSE_NULLPTR)
-		{
-			free(pool->free_sets[i]);
-			pool->free_sets[i] = PULSE_NULLPTR;
-		}
-		if(pool->free_sets[i] == PULSE_NULLPTR && pool->used_sets[i] == PULSE_NULLPTR)
-			break; // Due to defragmentation we are sure not to find valid sets after the first NULL one
-	}
-	vulkan_device->vkDestroyDescriptorPool(vulkan_device->device, pool->pool, PULSE_NULLPTR);
-	memset(pool, 0, sizeof(VulkanDescriptorSetPool));
-}
-
-void VulkanInitDescriptorSetPoolManager(VulkanDescriptorSetPoolManager* manager, PulseDevice device)
-{
-	memset(manager, 0, sizeof(VulkanDescriptorSetPoolManager));
-	manager->device = device;
-}
-
-VulkanDescriptorSetPool* VulkanGetAvailableDescriptorSetPool(VulkanDescriptorSetPoolManager* manager)
-{
-	PulseThreadID thread_id = PulseGetThreadID();
-	for(uint32_t i = 0; i < manager->pools_size; i++)
-	{
-		if(thread_id == manager->pools[i]->thread_id && (manager->pools[i]->allocations_count < VULKAN_POOL_SIZE || manager->pools[i]->free_sets[0] != PULSE_NULLPTR))
-			return manager->pools[i];
-	}
-	PULSE_EXPAND_ARRAY_IF_NEEDED(manager->pools, VulkanDescriptorSetPool*, manager->pools_size, manager->pools_capacity, 1);
-	PULSE_CHECK_ALLOCATION_RETVAL(manager->pools, PULSE_NULLPTR);
-
-	manager->pools[manager->pools_size] = (VulkanDescriptorSetPool*)calloc(1, sizeof(VulkanDescriptorSetPool));
-	PULSE_CHECK_ALLOCATION_RETVAL(manager->pools[manager->pools_size], PULSE_NULLPTR);
-
-	VulkanInitDescriptorSetPool(manager->pools[manager->pools_size], manager->device);
-	manager->pools_size++;
-	return manager->pools[manager->pools_size - 1];
-}
-
-void VulkanDestroyDescriptorSetPoolManager(VulkanDescriptorSetPoolManager* manager)
-{
-	for(uint32_t i = 0; i < manager->pools_size; i++)
-	{
-		VulkanDestroyDescriptorSetPool(manager->pools[i]);
-		free(manager->pools[i]);
-	}
-	free(manager->pools);
-	memset(manager, 0, sizeof(VulkanDescriptorSetPoolManager));
-}
@@ -14,7 +14,7 @@
 
 #include "VulkanEnums.h"
 
-#define VULKAN_POOL_SIZE 128
+#define VULKAN_POOL_SIZE 1024 // Sets per descriptor pool
 
 typedef struct VulkanDescriptorSetLayout
 {
@@ -41,33 +41,17 @@ typedef struct VulkanDescriptorSetLayout
 	bool is_used;
 } VulkanDescriptorSetLayout;
 
-typedef struct VulkanDescriptorSet
+// Descriptor sets are bump allocated from a chain of pools owned by a command list.
+// The whole chain is reset at once when the command list is recycled, which requires its submission to be over
+typedef struct VulkanDescriptorSetAllocator
 {
 	PulseDevice device;
-	VulkanDescriptorSetLayout* layout;
-	struct VulkanDescriptorSetPool* pool;
-	VkDescriptorSet set;
-} VulkanDescriptorSet;
-
-typedef struct VulkanDescriptorSetPool
-{
-	VulkanDescriptorSet* used_sets[VULKAN_POOL_SIZE];
-	VulkanDescriptorSet* free_sets[VULKAN_POOL_SIZE];
-	uint32_t used_index;
-	uint32_t free_index;
-	PulseDevice device;
-	VkDescriptorPool pool;
-	PulseThreadID thread_id;
-	uint32_t allocations_count;
-} VulkanDescriptorSetPool;
-
-typedef struct VulkanDescriptorSetPoolManager
-{
-	PulseDevice device;
-	VulkanDescriptorSetPool** pools;
+	VkDescriptorPool* pools;
 	uint32_t pools_capacity;
 	uint32_t pools_size;
-} VulkanDescriptorSetPoolManager;
+	uint32_t current_pool;
+	uint32_t current_pool_allocations_count;
+} VulkanDescriptorSetAllocator;
 
 typedef struct VulkanDescriptorSetLayoutManager
 {
@@ -86,15 +70,13 @@ VulkanDescriptorSetLayout* VulkanGetDescriptorSetLayout(VulkanDescriptorSetLayou
 														uint32_t uniform_buffers_count);
 void VulkanDestroyDescriptorSetLayoutManager(VulkanDescriptorSetLayoutManager* manager);
 
-VulkanDescriptorSet* VulkanRequestDescriptorSetFromPool(VulkanDescriptorSetPool* pool, const VulkanDescriptorSetLayout* layout);
-void VulkanReturnDescriptorSetToPool(VulkanDescriptorSetPool* pool, const VulkanDescriptorSet* set);
+void VulkanInitDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator, PulseDevice device);
+VkDescriptorSet VulkanAllocateDescriptorSet(VulkanDescriptorSetAllocator* allocator, const VulkanDescriptorSetLayout* layout);
+void VulkanResetDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator);
+void VulkanUninitDescriptorSetAllocator(VulkanDescriptorSetAllocator* allocator);
 
 void VulkanBindDescriptorSets(PulseComputePass pass);
 
-void VulkanInitDescriptorSetPoolManager(VulkanDescriptorSetPoolManager* manager, PulseDevice device);
-VulkanDescriptorSetPool* VulkanGetAvailableDescriptorSetPool(VulkanDescriptorSetPoolManager* manager);
-void VulkanDestroyDescriptorSetPoolManager(VulkanDescriptorSetPoolManager* manager);
-
 #endif // PULSE_VULKAN_DESCRIPTOR_H_
 
 #endif // PULSE_ENABLE_VULKAN_BACKEND
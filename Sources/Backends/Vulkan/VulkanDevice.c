@@ -14,6 +14,7 @@
 #include "VulkanBuffer.h"
 #include "VulkanImage.h"
 #include "VulkanComputePass.h"
+#include "VulkanPipelineCache.h"
 #include "../../PulseInternal.h"
 
 #include <string.h>
@@ -232,9 +233,18 @@ PulseDevice VulkanCreateDevice(PulseBackend backend, PulseDevice* forbiden_devic
 	pulse_device->driver_data = device;
 	pulse_device->backend = backend;
 	PULSE_LOAD_DRIVER_DEVICE(Vulkan);
+	pulse_device->PFN_SetPipelineCachePath = VulkanSetPipelineCachePath; // Optional, other backends leave them NULL
+	pulse_device->PFN_GetPipelineCacheData = VulkanGetPipelineCacheData;
+	pulse_device->PFN_MergePipelineCacheData = VulkanMergePipelineCacheData;
+	pulse_device->PFN_CreateComputePipelines = VulkanCreateComputePipelines;
+	pulse_device->PFN_CreateComputePipelinesAsync = VulkanCreateComputePipelinesAsync;
+	pulse_device->PFN_IsComputePipelineBatchReady = VulkanIsComputePipelineBatchReady;
+	pulse_device->PFN_WaitForComputePipelineBatch = VulkanWaitForComputePipelineBatch;
 
-	VulkanInitDescriptorSetPoolManager(&device->descriptor_set_pool_manager, pulse_device);
 	VulkanInitDescriptorSetLayoutManager(&device->descriptor_set_layout_manager, pulse_device);
+	VulkanInitPipelineCacheManager(&device->pipeline_cache_manager, pulse_device);
+	VulkanInitPipelineCompilationWorkers(&device->pipeline_compilation_workers);
+	mtx_init(&device->submission_mutex, mtx_plain);
 
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
 		PulseLogInfoFmt(backend, "(Vulkan) created device from %s", device->properties.deviceName);
@@ -246,15 +256,17 @@ void VulkanDestroyDevice(PulseDevice device)
 	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
 	if(vulkan_device == PULSE_NULLPTR || vulkan_device->device == VK_NULL_HANDLE)
 		return;
-	VulkanDestroyDescriptorSetPoolManager(&vulkan_device->descriptor_set_pool_manager);
+	VulkanDestroyPipelineCompilationWorkers(&vulkan_device->pipeline_compilation_workers);
 	VulkanDestroyDescriptorSetLayoutManager(&vulkan_device->descriptor_set_layout_manager);
+	VulkanDestroyPipelineCacheManager(&vulkan_device->pipeline_cache_manager);
 	for(uint32_t i = 0; i < vulkan_device->cmd_pools_size; i++)
 	{
-		vulkan_device->vkDestroyCommandPool(vulkan_device->device, vulkan_device->cmd_pools[i]->pool, PULSE_NULLPTR);
+		VulkanUninitCommandPool(vulkan_device->cmd_pools[i]); // Also releases the descriptor pools of its command lists
 		free(vulkan_device->cmd_pools[i]);
 	}
 	vmaDestroyAllocator(vulkan_device->allocator);
 	vulkan_device->vkDestroyDevice(vulkan_device->device, PULSE_NULLPTR);
+	mtx_destroy(&vulkan_device->submission_mutex);
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
 		PulseLogInfoFmt(device->backend, "(Vulkan) destroyed device created from %s", vulkan_device->properties.deviceName);
 	free(vulkan_device->cmd_pools);
@@ -8,6 +8,7 @@
 #define PULSE_VULKAN_DEVICE_H_
 
 #include <vulkan/vulkan_core.h>
+#include <tinycthread.h>
 
 #define VMA_STATIC_VULKAN_FUNCTIONS 0
 #define VMA_DYNAMIC_VULKAN_FUNCTIONS 0
@@ -19,13 +20,17 @@
 #include "VulkanEnums.h"
 #include "VulkanDescriptor.h"
 #include "VulkanCommandPool.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanComputePipeline.h"
 
 struct VulkanQueue;
 
 typedef struct VulkanDevice
 {
-	VulkanDescriptorSetPoolManager descriptor_set_pool_manager;
 	VulkanDescriptorSetLayoutManager descriptor_set_layout_manager;
+	VulkanPipelineCacheManager pipeline_cache_manager;
+	VulkanPipelineCompilationWorkers pipeline_compilation_workers;
+	mtx_t submission_mutex; // Keeps image layouts consistent with the submission order
 
 	VulkanCommandPool** cmd_pools;
 	uint32_t cmd_pools_size;
@@ -64,6 +64,7 @@
 	PULSE_VULKAN_DEVICE_FUNCTION(vkGetDeviceQueue)
 	PULSE_VULKAN_DEVICE_FUNCTION(vkGetFenceStatus)
 	PULSE_VULKAN_DEVICE_FUNCTION(vkGetImageMemoryRequirements)
+	PULSE_VULKAN_DEVICE_FUNCTION(vkGetPipelineCacheData)
 	PULSE_VULKAN_DEVICE_FUNCTION(vkInvalidateMappedMemoryRanges)
 	PULSE_VULKAN_DEVICE_FUNCTION(vkMapMemory)
 	PULSE_VULKAN_DEVICE_FUNCTION(vkMergePipelineCaches)
@@ -110,6 +110,19 @@ PulseImage VulkanCreateImage(PulseDevice device, const PulseImageCreateInfo* cre
 
 	image->driver_data = vulkan_image;
 
+	// Images start undefined, copies and dispatches transition the layers they use
+	vulkan_image->layers_count = layer_count;
+	vulkan_image->layouts = (VkImageLayout*)malloc(layer_count * sizeof(VkImageLayout));
+	if(vulkan_image->layouts == PULSE_NULLPTR)
+	{
+		free(vulkan_image);
+		free(image);
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULL_HANDLE;
+	}
+	for(uint32_t i = 0; i < layer_count; i++)
+		vulkan_image->layouts[i] = VK_IMAGE_LAYOUT_UNDEFINED;
+
 	VmaAllocationCreateInfo allocation_create_info = { 0 };
 	allocation_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
@@ -136,7 +149,14 @@ PulseImage VulkanCreateImage(PulseDevice device, const PulseImageCreateInfo* cre
 	image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	image_create_info.flags = flags;
 
-	CHECK_VK_RETVAL(device->backend, vmaCreateImage(vulkan_device->allocator, &image_create_info, &allocation_create_info, &vulkan_image->image, &vulkan_image->allocation, PULSE_NULLPTR), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	VkResult res = vmaCreateImage(vulkan_device->allocator, &image_create_info, &allocation_create_info, &vulkan_image->image, &vulkan_image->allocation, PULSE_NULLPTR);
+	if(res != VK_SUCCESS)
+	{
+		free(vulkan_image->layouts);
+		free(vulkan_image);
+		free(image);
+		CHECK_VK_RETVAL(device->backend, res, PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	}
 	vmaGetAllocationInfo(vulkan_device->allocator, vulkan_image->allocation, &vulkan_image->allocation_info);
 
 	VkImageViewCreateInfo image_view_create_info = { 0 };
@@ -161,7 +181,15 @@ PulseImage VulkanCreateImage(PulseDevice device, const PulseImageCreateInfo* cre
 	else
 		image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
 
-	CHECK_VK_RETVAL(device->backend, vulkan_device->vkCreateImageView(vulkan_device->device, &image_view_create_info, PULSE_NULLPTR, &vulkan_image->view), PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	res = vulkan_device->vkCreateImageView(vulkan_device->device, &image_view_create_info, PULSE_NULLPTR, &vulkan_image->view);
+	if(res != VK_SUCCESS)
+	{
+		vmaDestroyImage(vulkan_device->allocator, vulkan_image->image, vulkan_image->allocation);
+		free(vulkan_image->layouts);
+		free(vulkan_image);
+		free(image);
+		CHECK_VK_RETVAL(device->backend, res, PULSE_ERROR_INITIALIZATION_FAILED, PULSE_NULL_HANDLE);
+	}
 
 	return image;
 }
@@ -193,11 +221,16 @@ bool VulkanCopyImageToBuffer(PulseCommandList cmd, const PulseImageRegion* src,
 	region.bufferImageHeight = 0;
 	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.baseArrayLayer = src->layer;
 	region.imageSubresource.layerCount = 1;
 	region.imageOffset = offset;
 	region.imageExtent = extent;
-	vulkan_device->vkCmdCopyImageToBuffer(vulkan_cmd->cmd, vulkan_image->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vulkan_buffer->buffer, 1, &region);
+
+	VkImageLayout layout = VulkanTrackImageAccess(cmd, src->image, src->layer, 1, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+	VulkanTrackBufferAccess(cmd, dst->buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+	VulkanFlushBarriers(cmd);
+
+	vulkan_device->vkCmdCopyImageToBuffer(vulkan_cmd->cmd, vulkan_image->image, layout, vulkan_buffer->buffer, 1, &region);
 	return true;
 }
 
@@ -211,6 +244,7 @@ void VulkanDestroyImage(PulseDevice device, PulseImage image)
 	VulkanImage* vulkan_image = VULKAN_RETRIEVE_DRIVER_DATA_AS(image, VulkanImage*);
 	vulkan_device->vkDestroyImageView(vulkan_device->device, vulkan_image->view, PULSE_NULLPTR);
 	vmaDestroyImage(vulkan_device->allocator, vulkan_image->image, vulkan_image->allocation);
+	free(vulkan_image->layouts);
 	free(vulkan_image);
 	free(image);
 }
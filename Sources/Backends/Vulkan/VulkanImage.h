@@ -7,6 +7,8 @@
 #ifndef PULSE_VULKAN_IMAGE_H_
 #define PULSE_VULKAN_IMAGE_H_
 
+#include <stdatomic.h>
+
 #include <vulkan/vulkan_core.h>
 #include <vk_mem_alloc.h>
 
@@ -21,6 +23,13 @@ typedef struct VulkanImage
 	VkImageUsageFlags usage;
 	VmaAllocation allocation;
 	VmaAllocationInfo allocation_info;
+
+	// One layout per array layer as images have a single mip level, only valid in submission order
+	// and only accessed under the device submission mutex, command lists track their own while recording
+	VkImageLayout* layouts;
+	uint32_t layers_count;
+	atomic_uint general_transitions_count;
+	atomic_bool keep_general;
 } VulkanImage;
 
 PulseImage VulkanCreateImage(PulseDevice device, const PulseImageCreateInfo* create_infos);
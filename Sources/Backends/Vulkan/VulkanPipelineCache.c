@@ -0,0 +1,348 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Pulse.h"
+#include "Vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanPipelineCache.h"
+
+#define VULKAN_PIPELINE_CACHE_MAGIC 0x43505550 // "PUPC"
+#define VULKAN_PIPELINE_CACHE_VERSION 1
+
+// Drivers already validate their own header but not the driver version, a driver update would silently drop the whole cache anyway
+typedef struct VulkanPipelineCacheFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vendor_id;
+	uint32_t device_id;
+	uint32_t driver_version;
+	uint8_t uuid[VK_UUID_SIZE];
+	uint64_t data_size;
+} VulkanPipelineCacheFileHeader;
+
+static void VulkanFillPipelineCacheFileHeader(const VulkanDevice* vulkan_device, VulkanPipelineCacheFileHeader* header, size_t data_size)
+{
+	memset(header, 0, sizeof(VulkanPipelineCacheFileHeader));
+	header->magic = VULKAN_PIPELINE_CACHE_MAGIC;
+	header->version = VULKAN_PIPELINE_CACHE_VERSION;
+	header->vendor_id = vulkan_device->properties.vendorID;
+	header->device_id = vulkan_device->properties.deviceID;
+	header->driver_version = vulkan_device->properties.driverVersion;
+	memcpy(header->uuid, vulkan_device->properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header->data_size = data_size;
+}
+
+static bool VulkanFindDefaultPipelineCachePath(const VulkanDevice* vulkan_device, char* path)
+{
+	char directory[VULKAN_PIPELINE_CACHE_PATH_MAX];
+	if(!PulseFindCacheDirectory("PULSE_VULKAN_CACHE_DIR", directory, sizeof(directory)))
+		return false;
+	char uuid[VK_UUID_SIZE * 2 + 1];
+	for(uint32_t i = 0; i < VK_UUID_SIZE; i++)
+		snprintf(uuid + i * 2, 3, "%02x", vulkan_device->properties.pipelineCacheUUID[i]);
+	int length = snprintf(path, VULKAN_PIPELINE_CACHE_PATH_MAX, "%s/pulse_vulkan_%04x_%04x_%08x_%s.bin", directory, vulkan_device->properties.vendorID, vulkan_device->properties.deviceID, vulkan_device->properties.driverVersion, uuid);
+	return length > 0 && length < VULKAN_PIPELINE_CACHE_PATH_MAX;
+}
+
+// Returns PULSE_NULLPTR when the file is missing or was written for another device or driver
+static void* VulkanReadPipelineCacheFile(const VulkanDevice* vulkan_device, const char* path, size_t* data_size)
+{
+	FILE* file = fopen(path, "rb");
+	if(file == PULSE_NULLPTR)
+		return PULSE_NULLPTR;
+
+	VulkanPipelineCacheFileHeader expected;
+	VulkanFillPipelineCacheFileHeader(vulkan_device, &expected, 0);
+
+	VulkanPipelineCacheFileHeader header;
+	void* data = PULSE_NULLPTR;
+	if(fread(&header, sizeof(VulkanPipelineCacheFileHeader), 1, file) == 1 &&
+		header.magic == expected.magic &&
+		header.version == expected.version &&
+		header.vendor_id == expected.vendor_id &&
+		header.device_id == expected.device_id &&
+		header.driver_version == expected.driver_version &&
+		memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) == 0 &&
+		header.data_size != 0 && header.data_size == (size_t)header.data_size)
+	{
+		data = malloc((size_t)header.data_size);
+		if(data != PULSE_NULLPTR && fread(data, 1, (size_t)header.data_size, file) != (size_t)header.data_size)
+		{
+			free(data);
+			data = PULSE_NULLPTR;
+		}
+	}
+	fclose(file);
+	if(data != PULSE_NULLPTR)
+		*data_size = (size_t)header.data_size;
+	return data;
+}
+
+static bool VulkanWritePipelineCacheFile(const VulkanDevice* vulkan_device, const char* path, const void* data, size_t data_size)
+{
+	PulseCreateParentDirectories(path);
+
+	char temporary_path[VULKAN_PIPELINE_CACHE_PATH_MAX + 32];
+	if(!PulseMakeTemporaryPath(path, ".tmp", temporary_path, sizeof(temporary_path)))
+		return false;
+	FILE* file = fopen(temporary_path, "wb");
+	if(file == PULSE_NULLPTR)
+		return false;
+
+	VulkanPipelineCacheFileHeader header;
+	VulkanFillPipelineCacheFileHeader(vulkan_device, &header, data_size);
+	bool written = fwrite(&header, sizeof(VulkanPipelineCacheFileHeader), 1, file) == 1 && fwrite(data, 1, data_size, file) == data_size;
+	written = (fclose(file) == 0) && written;
+
+	written = written && PulseReplaceFile(temporary_path, path);
+	if(!written)
+		remove(temporary_path);
+	return written;
+}
+
+static VkPipelineCache VulkanCreatePipelineCacheFromData(const VulkanDevice* vulkan_device, const void* data, size_t data_size)
+{
+	VkPipelineCacheCreateInfo create_info = { 0 };
+	create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	create_info.initialDataSize = data_size;
+	create_info.pInitialData = data;
+	VkPipelineCache cache = VK_NULL_HANDLE;
+	if(vulkan_device->vkCreatePipelineCache(vulkan_device->device, &create_info, PULSE_NULLPTR, &cache) != VK_SUCCESS)
+		return VK_NULL_HANDLE;
+	return cache;
+}
+
+// Snapshots the shared cache into a blob, the manager mutex must be held
+static void* VulkanGatherPipelineCacheData(VulkanPipelineCacheManager* manager, size_t* data_size)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(manager->device, VulkanDevice*);
+
+	if(manager->cache == VK_NULL_HANDLE)
+		return PULSE_NULLPTR;
+
+	// Creations may keep growing the shared cache, a private copy keeps the size stable between both queries
+	VkPipelineCache snapshot = VulkanCreatePipelineCacheFromData(vulkan_device, PULSE_NULLPTR, 0);
+	if(snapshot == VK_NULL_HANDLE)
+		return PULSE_NULLPTR;
+
+	void* data = PULSE_NULLPTR;
+	size_t size = 0;
+	bool success = vulkan_device->vkMergePipelineCaches(vulkan_device->device, snapshot, 1, &manager->cache) == VK_SUCCESS;
+	if(success && vulkan_device->vkGetPipelineCacheData(vulkan_device->device, snapshot, &size, PULSE_NULLPTR) == VK_SUCCESS && size != 0)
+	{
+		data = malloc(size);
+		if(data != PULSE_NULLPTR && vulkan_device->vkGetPipelineCacheData(vulkan_device->device, snapshot, &size, data) != VK_SUCCESS)
+		{
+			free(data);
+			data = PULSE_NULLPTR;
+		}
+	}
+	vulkan_device->vkDestroyPipelineCache(vulkan_device->device, snapshot, PULSE_NULLPTR);
+	if(data != PULSE_NULLPTR)
+		*data_size = size;
+	return data;
+}
+
+// Builds a private cache from the blob and the shared one, then swaps it in. The manager mutex must be held
+static bool VulkanMergeIntoPipelineCache(VulkanPipelineCacheManager* manager, const void* data, size_t data_size)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(manager->device, VulkanDevice*);
+
+	VkPipelineCache merged = VulkanCreatePipelineCacheFromData(vulkan_device, data, data_size);
+	if(merged == VK_NULL_HANDLE)
+		return false;
+	// The shared cache is only a source here, which needs no external synchronisation against ongoing creations
+	if(manager->cache != VK_NULL_HANDLE && vulkan_device->vkMergePipelineCaches(vulkan_device->device, merged, 1, &manager->cache) != VK_SUCCESS)
+	{
+		vulkan_device->vkDestroyPipelineCache(vulkan_device->device, merged, PULSE_NULLPTR);
+		return false;
+	}
+
+	if(manager->cache != VK_NULL_HANDLE)
+	{
+		if(manager->users_count == 0)
+			vulkan_device->vkDestroyPipelineCache(vulkan_device->device, manager->cache, PULSE_NULLPTR);
+		else
+		{
+			PULSE_EXPAND_ARRAY_IF_NEEDED(manager->retired_caches, VkPipelineCache, manager->retired_caches_size, manager->retired_caches_capacity, 4);
+			if(manager->retired_caches == PULSE_NULLPTR)
+			{
+				manager->retired_caches_size = 0;
+				manager->retired_caches_capacity = 0;
+				vulkan_device->vkDestroyPipelineCache(vulkan_device->device, merged, PULSE_NULLPTR);
+				return false;
+			}
+			manager->retired_caches[manager->retired_caches_size] = manager->cache;
+			manager->retired_caches_size++;
+		}
+	}
+	manager->cache = merged;
+	manager->is_dirty = true;
+	return true;
+}
+
+// The manager mutex must be held
+static void VulkanDestroyRetiredPipelineCaches(VulkanPipelineCacheManager* manager)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(manager->device, VulkanDevice*);
+	for(uint32_t i = 0; i < manager->retired_caches_size; i++)
+		vulkan_device->vkDestroyPipelineCache(vulkan_device->device, manager->retired_caches[i], PULSE_NULLPTR);
+	manager->retired_caches_size = 0;
+}
+
+void VulkanInitPipelineCacheManager(VulkanPipelineCacheManager* manager, PulseDevice device)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	memset(manager, 0, sizeof(VulkanPipelineCacheManager));
+	manager->device = device;
+	mtx_init(&manager->mutex, mtx_plain);
+
+	size_t data_size = 0;
+	void* data = PULSE_NULLPTR;
+	if(VulkanFindDefaultPipelineCachePath(vulkan_device, manager->path))
+		data = VulkanReadPipelineCacheFile(vulkan_device, manager->path, &data_size);
+	else
+		manager->path[0] = '\0';
+
+	manager->cache = VulkanCreatePipelineCacheFromData(vulkan_device, data, data_size); // Pipelines are still created without a cache if this failed
+	if(data != PULSE_NULLPTR)
+	{
+		if(manager->cache != VK_NULL_HANDLE && PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(Vulkan) loaded pipeline cache from %s (%zu bytes)", manager->path, data_size);
+		free(data);
+	}
+}
+
+VkPipelineCache VulkanAcquirePipelineCache(VulkanPipelineCacheManager* manager)
+{
+	mtx_lock(&manager->mutex);
+	VkPipelineCache cache = manager->cache;
+	manager->users_count++;
+	manager->is_dirty = true;
+	mtx_unlock(&manager->mutex);
+	return cache;
+}
+
+void VulkanReleasePipelineCache(VulkanPipelineCacheManager* manager)
+{
+	mtx_lock(&manager->mutex);
+	manager->users_count--;
+	if(manager->users_count == 0)
+		VulkanDestroyRetiredPipelineCaches(manager);
+	mtx_unlock(&manager->mutex);
+}
+
+void VulkanDestroyPipelineCacheManager(VulkanPipelineCacheManager* manager)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(manager->device, VulkanDevice*);
+
+	// Nothing can have been added to the cache if no pipeline was created through it and nothing was merged
+	if(manager->path[0] != '\0' && manager->is_dirty)
+	{
+		size_t data_size = 0;
+		void* data = VulkanGatherPipelineCacheData(manager, &data_size);
+		if(data != PULSE_NULLPTR)
+		{
+			if(VulkanWritePipelineCacheFile(vulkan_device, manager->path, data, data_size))
+			{
+				if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(manager->device->backend))
+					PulseLogInfoFmt(manager->device->backend, "(Vulkan) saved pipeline cache to %s (%zu bytes)", manager->path, data_size);
+			}
+			else if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(manager->device->backend))
+				PulseLogWarningFmt(manager->device->backend, "(Vulkan) could not write pipeline cache to %s", manager->path);
+			free(data);
+		}
+	}
+
+	VulkanDestroyRetiredPipelineCaches(manager);
+	if(manager->cache != VK_NULL_HANDLE)
+		vulkan_device->vkDestroyPipelineCache(vulkan_device->device, manager->cache, PULSE_NULLPTR);
+	free(manager->retired_caches);
+	mtx_destroy(&manager->mutex);
+	memset(manager, 0, sizeof(VulkanPipelineCacheManager));
+}
+
+bool VulkanSetPipelineCachePath(PulseDevice device, const char* path)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanPipelineCacheManager* manager = &vulkan_device->pipeline_cache_manager;
+
+	if(path != PULSE_NULLPTR && strlen(path) >= VULKAN_PIPELINE_CACHE_PATH_MAX)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogErrorFmt(device->backend, "(Vulkan) pipeline cache path is too long (max %d characters)", VULKAN_PIPELINE_CACHE_PATH_MAX - 1);
+		PulseSetInternalError(PULSE_ERROR_INVALID_INTERNAL_POINTER);
+		return false;
+	}
+
+	mtx_lock(&manager->mutex);
+	PulseStrlcpy(manager->path, path != PULSE_NULLPTR ? path : "", VULKAN_PIPELINE_CACHE_PATH_MAX);
+	size_t data_size = 0;
+	void* data = manager->path[0] != '\0' ? VulkanReadPipelineCacheFile(vulkan_device, manager->path, &data_size) : PULSE_NULLPTR;
+	if(data != PULSE_NULLPTR)
+		VulkanMergeIntoPipelineCache(manager, data, data_size);
+	mtx_unlock(&manager->mutex);
+
+	if(data != PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(Vulkan) merged pipeline cache from %s (%zu bytes)", manager->path, data_size);
+		free(data);
+	}
+	return true;
+}
+
+bool VulkanGetPipelineCacheData(PulseDevice device, void* data, size_t* data_size)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanPipelineCacheManager* manager = &vulkan_device->pipeline_cache_manager;
+
+	mtx_lock(&manager->mutex);
+	size_t size = 0;
+	void* gathered = VulkanGatherPipelineCacheData(manager, &size);
+	mtx_unlock(&manager->mutex);
+
+	if(data == PULSE_NULLPTR)
+	{
+		*data_size = size;
+		free(gathered);
+		return true;
+	}
+	if(*data_size < size)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogErrorFmt(device->backend, "(Vulkan) pipeline cache data needs %zu bytes but only %zu were given", size, *data_size);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		free(gathered);
+		return false;
+	}
+	if(gathered != PULSE_NULLPTR)
+		memcpy(data, gathered, size);
+	*data_size = size;
+	free(gathered);
+	return true;
+}
+
+bool VulkanMergePipelineCacheData(PulseDevice device, const void* data, size_t data_size)
+{
+	VulkanDevice* vulkan_device = VULKAN_RETRIEVE_DRIVER_DATA_AS(device, VulkanDevice*);
+	VulkanPipelineCacheManager* manager = &vulkan_device->pipeline_cache_manager;
+
+	// Data from another device or driver is silently ignored by vkCreatePipelineCache
+	mtx_lock(&manager->mutex);
+	bool success = VulkanMergeIntoPipelineCache(manager, data, data_size);
+	mtx_unlock(&manager->mutex);
+	if(!success)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "(Vulkan) could not merge pipeline cache data");
+		PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+	}
+	return success;
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2025 kanel
+// This file is part of "Pulse"
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifdef PULSE_ENABLE_VULKAN_BACKEND
+
+#ifndef PULSE_VULKAN_PIPELINE_CACHE_H_
+#define PULSE_VULKAN_PIPELINE_CACHE_H_
+
+#include <vulkan/vulkan_core.h>
+#include <tinycthread.h>
+
+#include <Pulse.h>
+#include "../../PulseInternal.h"
+
+#define VULKAN_PIPELINE_CACHE_PATH_MAX 1024
+
+// All pipelines are created through a single cache as vkCreateComputePipelines is internally synchronised on it.
+// Merges need external synchronisation on their destination so they go into a private copy that then replaces the shared cache
+typedef struct VulkanPipelineCacheManager
+{
+	PulseDevice device;
+	mtx_t mutex;
+	VkPipelineCache cache;
+	VkPipelineCache* retired_caches; // Replaced by merges while creations were still using them
+	uint32_t retired_caches_capacity;
+	uint32_t retired_caches_size;
+	uint32_t users_count;
+	bool is_dirty;
+	char path[VULKAN_PIPELINE_CACHE_PATH_MAX]; // Empty when the cache is not persisted
+} VulkanPipelineCacheManager;
+
+void VulkanInitPipelineCacheManager(VulkanPipelineCacheManager* manager, PulseDevice device);
+VkPipelineCache VulkanAcquirePipelineCache(VulkanPipelineCacheManager* manager); // Must be released once the creations using it are done
+void VulkanReleasePipelineCache(VulkanPipelineCacheManager* manager);
+void VulkanDestroyPipelineCacheManager(VulkanPipelineCacheManager* manager); // Writes the cache back to its file
+
+bool VulkanSetPipelineCachePath(PulseDevice device, const char* path);
+bool VulkanGetPipelineCacheData(PulseDevice device, void* data, size_t* data_size);
+bool VulkanMergePipelineCacheData(PulseDevice device, const void* data, size_t data_size);
+
+#endif // PULSE_VULKAN_PIPELINE_CACHE_H_
+
+#endif // PULSE_ENABLE_VULKAN_BACKEND
@@ -251,3 +251,11 @@ void WebGPUDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, ui
 	WebGPUBindBindGroups(pass);
 	wgpuComputePassEncoderDispatchWorkgroups(webgpu_pass->encoder, groupcount_x, groupcount_y, groupcount_z);
 }
+
+void WebGPUDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset)
+{
+	WebGPUComputePass* webgpu_pass = WEBGPU_RETRIEVE_DRIVER_DATA_AS(pass, WebGPUComputePass*);
+	WebGPUBuffer* webgpu_buffer = WEBGPU_RETRIEVE_DRIVER_DATA_AS(buffer, WebGPUBuffer*);
+	WebGPUBindBindGroups(pass);
+	wgpuComputePassEncoderDispatchWorkgroupsIndirect(webgpu_pass->encoder, webgpu_buffer->buffer, offset);
+}
@@ -35,6 +35,7 @@ void WebGPUBindUniformData(PulseComputePass pass, uint32_t slot, const void* dat
 void WebGPUBindStorageImages(PulseComputePass pass, const PulseImage* images, uint32_t num_images);
 void WebGPUBindComputePipeline(PulseComputePass pass, PulseComputePipeline pipeline);
 void WebGPUDispatchComputations(PulseComputePass pass, uint32_t groupcount_x, uint32_t groupcount_y, uint32_t groupcount_z);
+void WebGPUDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset);
 
 #endif // PULSE_WEBGPU_COMPUTE_PASS_H_
 
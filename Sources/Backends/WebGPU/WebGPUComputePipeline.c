@@ -316,7 +316,8 @@ static WGPUBindGroupLayout WebGPUCreateBindGroupLayout(PulseDevice device, const
 	return wgpuDeviceCreateBindGroupLayout(webgpu_device->device, &descriptor);
 }
 
-PulseComputePipeline WebGPUCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+// Creates everything but the WGPUComputePipeline itself so that it can be created asynchronously
+static PulseComputePipeline WebGPUPrepareComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info, WGPUComputePipelineDescriptor* pipeline_descriptor)
 {
 	WebGPUDevice* webgpu_device = WEBGPU_RETRIEVE_DRIVER_DATA_AS(device, WebGPUDevice*);
 
@@ -367,18 +368,126 @@ PulseComputePipeline WebGPUCreateComputePipeline(PulseDevice device, const Pulse
 	layout_descriptor.bindGroupLayouts = bind_group_layouts;
 	webgpu_pipeline->layout = wgpuDeviceCreatePipelineLayout(webgpu_device->device, &layout_descriptor);
 
-	WGPUComputePipelineDescriptor pipeline_descriptor = { 0 };
-	pipeline_descriptor.compute.module = webgpu_pipeline->shader;
-	pipeline_descriptor.compute.entryPoint.length = WGPU_STRLEN;
-	pipeline_descriptor.compute.entryPoint.data = info->entrypoint;
-	pipeline_descriptor.layout = webgpu_pipeline->layout;
-	webgpu_pipeline->pipeline = wgpuDeviceCreateComputePipeline(webgpu_device->device, &pipeline_descriptor);
+	memset(pipeline_descriptor, 0, sizeof(WGPUComputePipelineDescriptor));
+	pipeline_descriptor->compute.module = webgpu_pipeline->shader;
+	pipeline_descriptor->compute.entryPoint.length = WGPU_STRLEN;
+	pipeline_descriptor->compute.entryPoint.data = info->entrypoint;
+	pipeline_descriptor->layout = webgpu_pipeline->layout;
+	return pipeline;
+}
+
+static void WebGPUReleaseComputePipeline(PulseComputePipeline pipeline)
+{
+	WebGPUComputePipeline* webgpu_pipeline = WEBGPU_RETRIEVE_DRIVER_DATA_AS(pipeline, WebGPUComputePipeline*);
+	wgpuBindGroupLayoutRelease(webgpu_pipeline->readonly_group);
+	wgpuBindGroupLayoutRelease(webgpu_pipeline->readwrite_group);
+	wgpuBindGroupLayoutRelease(webgpu_pipeline->uniform_group);
+	wgpuPipelineLayoutRelease(webgpu_pipeline->layout);
+	if(webgpu_pipeline->pipeline != PULSE_NULLPTR)
+		wgpuComputePipelineRelease(webgpu_pipeline->pipeline);
+	wgpuShaderModuleRelease(webgpu_pipeline->shader);
+	free(webgpu_pipeline);
+	free(pipeline);
+}
+
+PulseComputePipeline WebGPUCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
+{
+	WebGPUDevice* webgpu_device = WEBGPU_RETRIEVE_DRIVER_DATA_AS(device, WebGPUDevice*);
+
+	WGPUComputePipelineDescriptor pipeline_descriptor;
+	PulseComputePipeline pipeline = WebGPUPrepareComputePipeline(device, info, &pipeline_descriptor);
+	if(pipeline == PULSE_NULL_HANDLE)
+		return PULSE_NULL_HANDLE;
+	WEBGPU_RETRIEVE_DRIVER_DATA_AS(pipeline, WebGPUComputePipeline*)->pipeline = wgpuDeviceCreateComputePipeline(webgpu_device->device, &pipeline_descriptor);
 
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
 		PulseLogInfoFmt(device->backend, "(WebGPU) created new compute pipeline %p", pipeline);
 	return pipeline;
 }
 
+static void WebGPUCreateComputePipelineCallback(WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline webgpu_compute_pipeline, WGPUStringView message, void* userdata1, void* userdata2)
+{
+	PulseComputePipeline pipeline = (PulseComputePipeline)userdata1;
+	WebGPUComputePipelineBatch* batch = (WebGPUComputePipelineBatch*)userdata2;
+	if(status == WGPUCreatePipelineAsyncStatus_Success)
+		WEBGPU_RETRIEVE_DRIVER_DATA_AS(pipeline, WebGPUComputePipeline*)->pipeline = webgpu_compute_pipeline;
+	else if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(batch->device->backend))
+		PulseLogErrorFmt(batch->device->backend, "(WebGPU) compute pipeline could not be created. %.*s", message.length, message.data);
+	atomic_fetch_sub(&batch->remaining, 1);
+}
+
+bool WebGPUCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	WebGPUDevice* webgpu_device = WEBGPU_RETRIEVE_DRIVER_DATA_AS(device, WebGPUDevice*);
+
+	WebGPUComputePipelineBatch* webgpu_batch = (WebGPUComputePipelineBatch*)calloc(1, sizeof(WebGPUComputePipelineBatch));
+	PULSE_CHECK_ALLOCATION_RETVAL(webgpu_batch, false);
+	webgpu_batch->device = device;
+	atomic_store(&webgpu_batch->remaining, batch->count);
+	batch->driver_data = webgpu_batch;
+
+	for(uint32_t i = 0; i < batch->count; i++)
+	{
+		WGPUComputePipelineDescriptor pipeline_descriptor;
+		batch->pipelines[i] = WebGPUPrepareComputePipeline(device, &batch->infos[i], &pipeline_descriptor);
+		if(batch->pipelines[i] == PULSE_NULL_HANDLE)
+		{
+			atomic_fetch_sub(&webgpu_batch->remaining, 1);
+			continue;
+		}
+
+		WGPUCreateComputePipelineAsyncCallbackInfo callback_info = { 0 };
+		callback_info.mode = WGPUCallbackMode_AllowSpontaneous;
+		callback_info.callback = WebGPUCreateComputePipelineCallback;
+		callback_info.userdata1 = batch->pipelines[i];
+		callback_info.userdata2 = webgpu_batch;
+		wgpuDeviceCreateComputePipelineAsync(webgpu_device->device, &pipeline_descriptor, callback_info);
+	}
+	return true;
+}
+
+static void WebGPUFinalizeComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	batch->succeeded = true;
+	for(uint32_t i = 0; i < batch->count; i++)
+	{
+		PulseComputePipeline pipeline = batch->pipelines[i];
+		if(pipeline != PULSE_NULL_HANDLE && WEBGPU_RETRIEVE_DRIVER_DATA_AS(pipeline, WebGPUComputePipeline*)->pipeline == PULSE_NULLPTR)
+		{
+			WebGPUReleaseComputePipeline(pipeline);
+			batch->pipelines[i] = PULSE_NULL_HANDLE;
+			PulseSetInternalError(PULSE_ERROR_INITIALIZATION_FAILED);
+		}
+		if(batch->pipelines[i] == PULSE_NULL_HANDLE)
+			batch->succeeded = false;
+		else if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
+			PulseLogInfoFmt(device->backend, "(WebGPU) created new compute pipeline %p", batch->pipelines[i]);
+	}
+	free(batch->driver_data);
+	batch->driver_data = PULSE_NULLPTR;
+}
+
+bool WebGPUIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	WebGPUComputePipelineBatch* webgpu_batch = WEBGPU_RETRIEVE_DRIVER_DATA_AS(batch, WebGPUComputePipelineBatch*);
+	WebGPUDeviceTick(device);
+	if(atomic_load(&webgpu_batch->remaining) != 0)
+		return false;
+	WebGPUFinalizeComputePipelineBatch(device, batch);
+	return true;
+}
+
+void WebGPUWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	WebGPUComputePipelineBatch* webgpu_batch = WEBGPU_RETRIEVE_DRIVER_DATA_AS(batch, WebGPUComputePipelineBatch*);
+	while(atomic_load(&webgpu_batch->remaining) != 0)
+	{
+		WebGPUDeviceTick(device);
+		PulseSleep(1); // 1ms
+	}
+	WebGPUFinalizeComputePipelineBatch(device, batch);
+}
+
 void WebGPUDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline)
 {
 	if(pipeline == PULSE_NULL_HANDLE)
@@ -388,18 +497,8 @@ void WebGPUDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipel
 		return;
 	}
 
-	PULSE_UNUSED(device);
-	WebGPUComputePipeline* webgpu_pipeline = WEBGPU_RETRIEVE_DRIVER_DATA_AS(pipeline, WebGPUComputePipeline*);
-	wgpuBindGroupLayoutRelease(webgpu_pipeline->readonly_group);
-	wgpuBindGroupLayoutRelease(webgpu_pipeline->readwrite_group);
-	wgpuBindGroupLayoutRelease(webgpu_pipeline->uniform_group);
-	wgpuPipelineLayoutRelease(webgpu_pipeline->layout);
-	wgpuComputePipelineRelease(webgpu_pipeline->pipeline);
-	wgpuShaderModuleRelease(webgpu_pipeline->shader);
-	free(webgpu_pipeline);
-
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(device->backend))
 		PulseLogInfoFmt(device->backend, "(WebGPU) destroyed compute pipeline %p", pipeline);
 
-	free(pipeline);
+	WebGPUReleaseComputePipeline(pipeline);
 }
@@ -7,6 +7,8 @@
 #ifndef PULSE_WEBGPU_COMPUTE_PIPELINE_H_
 #define PULSE_WEBGPU_COMPUTE_PIPELINE_H_
 
+#include <stdatomic.h>
+
 #include <webgpu/webgpu.h>
 
 #include <Pulse.h>
@@ -21,8 +23,17 @@ typedef struct WebGPUComputePipeline
 	WGPUBindGroupLayout uniform_group;
 } WebGPUComputePipeline;
 
+typedef struct WebGPUComputePipelineBatch
+{
+	PulseDevice device;
+	atomic_uint remaining; // Pipelines whose creation callback has not been called yet
+} WebGPUComputePipelineBatch;
+
 PulseComputePipeline WebGPUCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info);
 void WebGPUDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline);
+bool WebGPUCreateComputePipelinesAsync(PulseDevice device, PulseComputePipelineBatch batch);
+bool WebGPUIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch);
+void WebGPUWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch);
 
 #endif // PULSE_WEBGPU_COMPUTE_PIPELINE_H_
 
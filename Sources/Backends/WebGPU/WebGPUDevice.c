@@ -229,6 +229,9 @@ PulseDevice WebGPUCreateDevice(PulseBackend backend, PulseDevice* forbiden_devic
 	pulse_device->driver_data = device;
 	pulse_device->backend = backend;
 	PULSE_LOAD_DRIVER_DEVICE(WebGPU);
+	pulse_device->PFN_CreateComputePipelinesAsync = WebGPUCreateComputePipelinesAsync; // Optional, other backends leave them NULL
+	pulse_device->PFN_IsComputePipelineBatchReady = WebGPUIsComputePipelineBatchReady;
+	pulse_device->PFN_WaitForComputePipelineBatch = WebGPUWaitForComputePipelineBatch;
 
 	if(PULSE_IS_BACKEND_HIGH_LEVEL_DEBUG(backend))
 	{
@@ -128,7 +128,7 @@ PULSE_API bool PulseCopyBufferToBuffer(PulseCommandList cmd, const PulseBufferRe
 		return false;
 	}
 
-	if(src->buffer == dst->buffer)
+	if(src->buffer == dst->buffer && src->offset == dst->offset)
 		return true;
 
 	return src->buffer->device->PFN_CopyBufferToBuffer(cmd, src, dst);
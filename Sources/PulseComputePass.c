@@ -77,11 +77,51 @@ PULSE_API void PulseDispatchComputations(PulseComputePass pass, uint32_t groupco
 		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
 			PulseLogWarning(pass->cmd->device->backend, "cannot dispatch computations, no pipeline bound");
 		PulseSetInternalError(PULSE_ERROR_INVALID_HANDLE);
+		return;
 	}
 
 	pass->cmd->device->PFN_DispatchComputations(pass, groupcount_x, groupcount_y, groupcount_z);
 }
 
+PULSE_API void PulseDispatchComputationsIndirect(PulseComputePass pass, PulseBuffer buffer, uint32_t offset)
+{
+	PULSE_CHECK_HANDLE(pass);
+	PULSE_CHECK_HANDLE(buffer);
+
+	PULSE_CHECK_COMMAND_LIST_STATE(pass->cmd);
+
+	if(pass->current_pipeline == PULSE_NULL_HANDLE)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+			PulseLogWarning(pass->cmd->device->backend, "cannot dispatch computations, no pipeline bound");
+		PulseSetInternalError(PULSE_ERROR_INVALID_HANDLE);
+		return;
+	}
+	if((buffer->usage & (PULSE_BUFFER_USAGE_STORAGE_READ | PULSE_BUFFER_USAGE_STORAGE_WRITE)) == 0)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+			PulseLogError(pass->cmd->device->backend, "indirect dispatch buffer must be a storage buffer");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BUFFER_USAGE);
+		return;
+	}
+	if(offset % sizeof(uint32_t) != 0 || offset + 3 * sizeof(uint32_t) > buffer->size)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+			PulseLogErrorFmt(pass->cmd->device->backend, "indirect dispatch offset %u is misaligned or out of the buffer", offset);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		return;
+	}
+	if(pass->cmd->device->PFN_DispatchComputationsIndirect == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(pass->cmd->device->backend))
+			PulseLogError(pass->cmd->device->backend, "indirect dispatches are not supported by this backend");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BACKEND);
+		return;
+	}
+
+	pass->cmd->device->PFN_DispatchComputationsIndirect(pass, buffer, offset);
+}
+
 PULSE_API void PulseEndComputePass(PulseComputePass pass)
 {
 	if(pass == PULSE_NULL_HANDLE)
@@ -2,9 +2,29 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <string.h>
+
 #include "PulseDefs.h"
 #include "PulseInternal.h"
 
+static void PulseSetComputePipelineBindings(PulseComputePipeline pipeline, const PulseComputePipelineCreateInfo* info)
+{
+	pipeline->num_readonly_storage_images = info->num_readonly_storage_images;
+	pipeline->num_readonly_storage_buffers = info->num_readonly_storage_buffers;
+	pipeline->num_readwrite_storage_images = info->num_readwrite_storage_images;
+	pipeline->num_readwrite_storage_buffers = info->num_readwrite_storage_buffers;
+	pipeline->num_uniform_buffers = info->num_uniform_buffers;
+}
+
+static void PulseSetComputePipelinesBindings(const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(pipelines[i] != PULSE_NULL_HANDLE)
+			PulseSetComputePipelineBindings(pipelines[i], &infos[i]);
+	}
+}
+
 PULSE_API PulseComputePipeline PulseCreateComputePipeline(PulseDevice device, const PulseComputePipelineCreateInfo* info)
 {
 	PULSE_CHECK_HANDLE_RETVAL(device, PULSE_NULL_HANDLE);
@@ -14,14 +34,113 @@ PULSE_API PulseComputePipeline PulseCreateComputePipeline(PulseDevice device, co
 	PulseComputePipeline pipeline = device->PFN_CreateComputePipeline(device, info);
 	if(pipeline == PULSE_NULL_HANDLE)
 		return PULSE_NULL_HANDLE;
-	pipeline->num_readonly_storage_images = info->num_readonly_storage_images;
-	pipeline->num_readonly_storage_buffers = info->num_readonly_storage_buffers;
-	pipeline->num_readwrite_storage_images = info->num_readwrite_storage_images;
-	pipeline->num_readwrite_storage_buffers = info->num_readwrite_storage_buffers;
-	pipeline->num_uniform_buffers = info->num_uniform_buffers;
+	PulseSetComputePipelineBindings(pipeline, info);
 	return pipeline;
 }
 
+PULSE_API bool PulseCreateComputePipelines(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	if(count == 0)
+		return true;
+	if(infos == PULSE_NULLPTR && PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+		PulseLogError(device->backend, "null infos pointer");
+	PULSE_CHECK_PTR_RETVAL(infos, false);
+	PULSE_CHECK_PTR_RETVAL(pipelines, false);
+
+	bool success = true;
+	if(device->PFN_CreateComputePipelines != PULSE_NULLPTR)
+		success = device->PFN_CreateComputePipelines(device, infos, count, pipelines);
+	else
+	{
+		for(uint32_t i = 0; i < count; i++)
+		{
+			pipelines[i] = device->PFN_CreateComputePipeline(device, &infos[i]);
+			success = success && pipelines[i] != PULSE_NULL_HANDLE;
+		}
+	}
+	PulseSetComputePipelinesBindings(infos, count, pipelines);
+	return success;
+}
+
+PULSE_API PulseComputePipelineBatch PulseCreateComputePipelinesAsync(PulseDevice device, const PulseComputePipelineCreateInfo* infos, uint32_t count, PulseComputePipeline* pipelines)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, PULSE_NULL_HANDLE);
+	if(count != 0)
+	{
+		if(infos == PULSE_NULLPTR && PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "null infos pointer");
+		PULSE_CHECK_PTR_RETVAL(infos, PULSE_NULL_HANDLE);
+		PULSE_CHECK_PTR_RETVAL(pipelines, PULSE_NULL_HANDLE);
+	}
+
+	// Backends fill the handles as they go, the user's array is only written once the whole batch is ready
+	PulseComputePipelineBatch batch = (PulseComputePipelineBatchHandler*)calloc(1, sizeof(PulseComputePipelineBatchHandler) + count * sizeof(PulseComputePipeline));
+	PULSE_CHECK_ALLOCATION_RETVAL(batch, PULSE_NULL_HANDLE);
+	batch->infos = infos;
+	batch->pipelines = (PulseComputePipeline*)(batch + 1);
+	batch->user_pipelines = pipelines;
+	batch->count = count;
+
+	// Backends without asynchronous compilation build everything right away
+	if(device->PFN_CreateComputePipelinesAsync == PULSE_NULLPTR || count == 0)
+	{
+		batch->succeeded = PulseCreateComputePipelines(device, infos, count, pipelines);
+		batch->is_ready = true;
+		return batch;
+	}
+	if(!device->PFN_CreateComputePipelinesAsync(device, batch))
+	{
+		free(batch);
+		return PULSE_NULL_HANDLE;
+	}
+	return batch;
+}
+
+static void PulseCompleteComputePipelineBatch(PulseComputePipelineBatch batch)
+{
+	PulseSetComputePipelinesBindings(batch->infos, batch->count, batch->pipelines);
+	memcpy(batch->user_pipelines, batch->pipelines, batch->count * sizeof(PulseComputePipeline));
+	batch->is_ready = true;
+}
+
+PULSE_API bool PulseIsComputePipelineBatchReady(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	PULSE_CHECK_HANDLE_RETVAL(batch, false);
+	if(!batch->is_ready && device->PFN_IsComputePipelineBatchReady(device, batch))
+		PulseCompleteComputePipelineBatch(batch);
+	return batch->is_ready;
+}
+
+PULSE_API bool PulseWaitForComputePipelineBatch(PulseDevice device, PulseComputePipelineBatch batch)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	PULSE_CHECK_HANDLE_RETVAL(batch, false);
+	if(batch->driver_data != PULSE_NULLPTR)
+		device->PFN_WaitForComputePipelineBatch(device, batch);
+	if(!batch->is_ready)
+		PulseCompleteComputePipelineBatch(batch);
+	bool succeeded = batch->succeeded;
+	free(batch);
+	return succeeded;
+}
+
+PULSE_API bool PulseGetComputePipelineStatistics(PulseDevice device, PulseComputePipeline pipeline, PulseComputePipelineStatistics* statistics)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	PULSE_CHECK_HANDLE_RETVAL(pipeline, false);
+	PULSE_CHECK_PTR_RETVAL(statistics, false);
+	if(device->PFN_GetComputePipelineStatistics == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "pipeline statistics are not supported by this backend");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BACKEND);
+		return false;
+	}
+	return device->PFN_GetComputePipelineStatistics(device, pipeline, statistics);
+}
+
 PULSE_API void PulseDestroyComputePipeline(PulseDevice device, PulseComputePipeline pipeline)
 {
 	PULSE_CHECK_HANDLE(device);
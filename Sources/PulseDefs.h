@@ -107,6 +107,7 @@
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(CreateComputePipeline, _namespace) \
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(DestroyComputePipeline, _namespace) \
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(DispatchComputations, _namespace) \
+	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(DispatchComputationsIndirect, _namespace) \
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(CreateFence, _namespace) \
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(DestroyFence, _namespace) \
 	PULSE_LOAD_DRIVER_DEVICE_FUNCTION(IsFenceReady, _namespace) \
@@ -27,6 +27,47 @@ PULSE_API void PulseDestroyDevice(PulseDevice device)
 	device->PFN_DestroyDevice(device);
 }
 
+PULSE_API bool PulseSetPipelineCachePath(PulseDevice device, const char* path)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	if(device->PFN_SetPipelineCachePath == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "pipeline caches are not supported by this backend");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BACKEND);
+		return false;
+	}
+	return device->PFN_SetPipelineCachePath(device, path);
+}
+
+PULSE_API bool PulseGetPipelineCacheData(PulseDevice device, void* data, size_t* data_size)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	PULSE_CHECK_PTR_RETVAL(data_size, false);
+	if(device->PFN_GetPipelineCacheData == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "pipeline caches are not supported by this backend");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BACKEND);
+		return false;
+	}
+	return device->PFN_GetPipelineCacheData(device, data, data_size);
+}
+
+PULSE_API bool PulseMergePipelineCacheData(PulseDevice device, const void* data, size_t data_size)
+{
+	PULSE_CHECK_HANDLE_RETVAL(device, false);
+	PULSE_CHECK_PTR_RETVAL(data, false);
+	if(device->PFN_MergePipelineCacheData == PULSE_NULLPTR)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(device->backend))
+			PulseLogError(device->backend, "pipeline caches are not supported by this backend");
+		PulseSetInternalError(PULSE_ERROR_INVALID_BACKEND);
+		return false;
+	}
+	return device->PFN_MergePipelineCacheData(device, data, data_size);
+}
+
 PULSE_API PulseBackendBits PulseGetBackendInUseByDevice(PulseDevice device)
 {
 	PULSE_CHECK_HANDLE_RETVAL(device, PULSE_BACKEND_INVALID);
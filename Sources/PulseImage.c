@@ -174,6 +174,38 @@ PULSE_API bool PulseCopyImageToBuffer(PulseCommandList cmd, const PulseImageRegi
 
 PULSE_API bool PulseBlitImage(PulseCommandList cmd, const PulseImageRegion* src, const PulseImageRegion* dst)
 {
+	PULSE_CHECK_PTR_RETVAL(src, false);
+	PULSE_CHECK_HANDLE_RETVAL(src->image, false);
+	PULSE_CHECK_PTR_RETVAL(dst, false);
+	PULSE_CHECK_HANDLE_RETVAL(dst->image, false);
+
+	PulseBackend backend = src->image->device->backend;
+
+	if(src->image->device != dst->image->device)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogErrorFmt(backend, "source image has been created on a different device (%p) than the destination image (%p)", src->image->device, dst->image->device);
+		PulseSetInternalError(PULSE_ERROR_INVALID_DEVICE);
+		return false;
+	}
+
+	if(src->width > src->image->width || src->height > src->image->height)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogErrorFmt(backend, "source image region (%lld, %lld) is bigger than the image (%lld, %lld)", src->width, src->height, src->image->width, src->image->height);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		return false;
+	}
+
+	if(dst->width > dst->image->width || dst->height > dst->image->height)
+	{
+		if(PULSE_IS_BACKEND_LOW_LEVEL_DEBUG(backend))
+			PulseLogErrorFmt(backend, "destination image region (%lld, %lld) is bigger than the image (%lld, %lld)", dst->width, dst->height, dst->image->width, dst->image->height);
+		PulseSetInternalError(PULSE_ERROR_INVALID_REGION);
+		return false;
+	}
+
+	return src->image->device->PFN_BlitImage(cmd, src, dst);
 }
 
 PULSE_API void PulseDestroyImage(PulseDevice device, PulseImage image)
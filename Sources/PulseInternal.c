@@ -2,11 +2,29 @@
 // This file is part of "Pulse"
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <PulseProfile.h>
 #include "PulseInternal.h"
 
+#ifdef PULSE_PLAT_WINDOWS
+	#include <direct.h>
+	#include <process.h>
+	#define PulseMakeDirectory(path) _mkdir(path)
+	#define PulseGetProcessID() _getpid()
+#elif !defined(PULSE_PLAT_WASM)
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define PulseMakeDirectory(path) mkdir(path, 0755)
+	#define PulseGetProcessID() getpid()
+#else
+	#define PulseMakeDirectory(path) ((void)(path))
+	#define PulseGetProcessID() 0
+#endif
+
 #ifndef PULSE_PLAT_WASM
 	#include <tinycthread.h>
 
@@ -111,6 +129,60 @@ size_t PulseStrlcpy(char* dst, const char* src, size_t maxlen)
 	return srclen;
 }
 
+bool PulseFindCacheDirectory(const char* env_name, char* directory, size_t size)
+{
+	const char* base = getenv(env_name);
+	if(base != PULSE_NULLPTR && base[0] != '\0')
+		return PulseStrlcpy(directory, base, size) < size;
+	const char* suffix = "pulse";
+	#ifdef PULSE_PLAT_WINDOWS
+		base = getenv("LOCALAPPDATA");
+		suffix = "Pulse";
+	#else
+		base = getenv("XDG_CACHE_HOME");
+		if(base == PULSE_NULLPTR || base[0] == '\0')
+		{
+			base = getenv("HOME");
+			suffix = ".cache/pulse";
+		}
+	#endif
+	if(base == PULSE_NULLPTR || base[0] == '\0')
+		return false;
+	int length = snprintf(directory, size, "%s/%s", base, suffix);
+	return length > 0 && (size_t)length < size;
+}
+
+void PulseCreateParentDirectories(const char* path)
+{
+	char partial[1024];
+	if(PulseStrlcpy(partial, path, sizeof(partial)) >= sizeof(partial))
+		return;
+	for(char* c = partial + 1; *c != '\0'; c++)
+	{
+		if(*c != '/' && *c != '\\')
+			continue;
+		char separator = *c;
+		*c = '\0';
+		PulseMakeDirectory(partial); // Existing directories are fine, unusable ones make the writes fail later
+		*c = separator;
+	}
+}
+
+bool PulseMakeTemporaryPath(const char* path, const char* extension, char* temporary_path, size_t size)
+{
+	unsigned long tag = (unsigned long)PulseGetProcessID() ^ ((unsigned long)time(PULSE_NULLPTR) << 16) ^ (unsigned long)PulseGetThreadID();
+	int length = snprintf(temporary_path, size, "%s.%lx%s", path, tag, extension);
+	return length > 0 && (size_t)length < size;
+}
+
+bool PulseReplaceFile(const char* temporary_path, const char* path)
+{
+	if(rename(temporary_path, path) == 0)
+		return true;
+	remove(path); // Windows does not replace existing files
+	return rename(temporary_path, path) == 0;
+}
+
 char* PulseStrtokR(char* str, const char* delim, char** saveptr)
 {
 	if(str != PULSE_NULLPTR)
@@ -123,6 +195,75 @@ char* PulseStrtokR(char* str, const char* delim, char** saveptr)
 	return token;
 }
 
+#define PULSE_ARENA_MIN_BLOCK_SIZE 4096
+
+void* PulseArenaAllocate(PulseArena* arena, size_t size, size_t alignment)
+{
+	PulseArenaBlock* block = arena->current;
+	while(block != PULSE_NULLPTR)
+	{
+		uintptr_t base = (uintptr_t)(block + 1);
+		uintptr_t address = (base + block->size + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		if(address + size <= base + block->capacity)
+		{
+			block->size = address + size - base;
+			arena->current = block;
+			return (void*)address;
+		}
+		block = block->next;
+	}
+
+	// Blocks grow geometrically so that a warm arena ends up with a few large ones
+	size_t capacity = PULSE_ARENA_MIN_BLOCK_SIZE;
+	for(PulseArenaBlock* last = arena->first; last != PULSE_NULLPTR; last = last->next)
+	{
+		if(last->capacity * 2 > capacity)
+			capacity = last->capacity * 2;
+	}
+	while(capacity < size + alignment)
+		capacity *= 2;
+	block = (PulseArenaBlock*)malloc(sizeof(PulseArenaBlock) + capacity);
+	if(block == PULSE_NULLPTR)
+	{
+		PulseSetInternalError(PULSE_ERROR_CPU_ALLOCATION_FAILED);
+		return PULSE_NULLPTR;
+	}
+	block->next = PULSE_NULLPTR;
+	block->size = 0;
+	block->capacity = capacity;
+	if(arena->first == PULSE_NULLPTR)
+		arena->first = block;
+	else
+	{
+		PulseArenaBlock* last = arena->current;
+		while(last->next != PULSE_NULLPTR)
+			last = last->next;
+		last->next = block;
+	}
+	arena->current = block;
+	return PulseArenaAllocate(arena, size, alignment);
+}
+
+void PulseArenaReset(PulseArena* arena)
+{
+	for(PulseArenaBlock* block = arena->first; block != PULSE_NULLPTR; block = block->next)
+		block->size = 0;
+	arena->current = arena->first;
+}
+
+void PulseArenaFree(PulseArena* arena)
+{
+	PulseArenaBlock* block = arena->first;
+	while(block != PULSE_NULLPTR)
+	{
+		PulseArenaBlock* next = block->next;
+		free(block);
+		block = next;
+	}
+	arena->first = PULSE_NULLPTR;
+	arena->current = PULSE_NULLPTR;
+}
+
 static int PulseIsSpace(int x)
 {
 	return ((x) == ' ') || ((x) == '\t') || ((x) == '\r') || ((x) == '\n') || ((x) == '\f') || ((x) == '\v');
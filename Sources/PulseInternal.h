@@ -74,13 +74,33 @@ typedef struct PulseComputePipelineHandler
 	uint32_t num_uniform_buffers;
 } PulseComputePipelineHandler;
 
+typedef struct PulseComputePipelineBatchHandler
+{
+	void* driver_data; // Released by the backend once waited for
+	const PulseComputePipelineCreateInfo* infos;
+	PulseComputePipeline* pipelines; // Written by the backend, stored after the handler until the batch is ready
+	PulseComputePipeline* user_pipelines;
+	uint32_t count;
+	bool is_ready;
+	bool succeeded; // Set by the backend when the pipelines are written
+} PulseComputePipelineBatchHandler;
+
 typedef struct PulseDeviceHandler
 {
 	// PFNs
 	PulseDestroyDevicePFN PFN_DestroyDevice;
+	PulseSetPipelineCachePathPFN PFN_SetPipelineCachePath;
+	PulseGetPipelineCacheDataPFN PFN_GetPipelineCacheData;
+	PulseMergePipelineCacheDataPFN PFN_MergePipelineCacheData;
 	PulseCreateComputePipelinePFN PFN_CreateComputePipeline;
+	PulseCreateComputePipelinesPFN PFN_CreateComputePipelines;
+	PulseCreateComputePipelinesAsyncPFN PFN_CreateComputePipelinesAsync;
+	PulseIsComputePipelineBatchReadyPFN PFN_IsComputePipelineBatchReady;
+	PulseWaitForComputePipelineBatchPFN PFN_WaitForComputePipelineBatch;
 	PulseDispatchComputationsPFN PFN_DispatchComputations;
+	PulseDispatchComputationsIndirectPFN PFN_DispatchComputationsIndirect;
 	PulseDestroyComputePipelinePFN PFN_DestroyComputePipeline;
+	PulseGetComputePipelineStatisticsPFN PFN_GetComputePipelineStatistics;
 	PulseCreateFencePFN PFN_CreateFence;
 	PulseDestroyFencePFN PFN_DestroyFence;
 	PulseIsFenceReadyPFN PFN_IsFenceReady;
@@ -193,6 +213,24 @@ void PulseUnloadLibrary(PulseLibModule module);
 
 void PulseSetInternalError(PulseErrorType error);
 
+// Linear allocator made of chained blocks, allocations never move. Resetting keeps every block for the next use
+typedef struct PulseArenaBlock
+{
+	struct PulseArenaBlock* next;
+	size_t size;
+	size_t capacity;
+} PulseArenaBlock;
+
+typedef struct PulseArena
+{
+	PulseArenaBlock* first;
+	PulseArenaBlock* current;
+} PulseArena;
+
+void* PulseArenaAllocate(PulseArena* arena, size_t size, size_t alignment); // Alignment must be a power of two, returns PULSE_NULLPTR in case of failure
+void PulseArenaReset(PulseArena* arena);
+void PulseArenaFree(PulseArena* arena);
+
 uint32_t PulseHashString(const char* str);
 uint32_t PulseHashCombine(uint32_t lhs, uint32_t rhs);
 
@@ -200,6 +238,13 @@ size_t PulseStrlcpy(char* dst, const char* src, size_t maxlen);
 char* PulseStrtokR(char* str, const char* delim, char** saveptr);
 void PulseTrimString(char* str);
 
+// On-disk caches shared by the backends. Files are written under a temporary path next to
+// their final one and renamed over it so that concurrent processes never read a partial file
+bool PulseFindCacheDirectory(const char* env_name, char* directory, size_t size); // env_name overrides the user cache directory, returns false if none could be found
+void PulseCreateParentDirectories(const char* path); // Every directory leading to the last component of path
+bool PulseMakeTemporaryPath(const char* path, const char* extension, char* temporary_path, size_t size); // Unique to the calling process and thread
+bool PulseReplaceFile(const char* temporary_path, const char* path);
+
 void PulseLogBackend(PulseBackend backend, PulseDebugMessageSeverity type, const char* message, const char* file, const char* function, int line, ...);
 
 #define PulseLogError(backend, msg) PulseLogBackend(backend, PULSE_DEBUG_MESSAGE_SEVERITY_ERROR, msg, __FILE__, __FUNCTION__, __LINE__)
@@ -14,9 +14,18 @@ typedef void (*PulseUnloadBackendPFN)(PulseBackend);
 typedef PulseDevice (*PulseCreateDevicePFN)(PulseBackend, PulseDevice*, uint32_t);
 
 typedef void (*PulseDestroyDevicePFN)(PulseDevice);
+typedef bool (*PulseSetPipelineCachePathPFN)(PulseDevice, const char*);
+typedef bool (*PulseGetPipelineCacheDataPFN)(PulseDevice, void*, size_t*);
+typedef bool (*PulseMergePipelineCacheDataPFN)(PulseDevice, const void*, size_t);
 typedef PulseComputePipeline (*PulseCreateComputePipelinePFN)(PulseDevice, const PulseComputePipelineCreateInfo*);
+typedef bool (*PulseCreateComputePipelinesPFN)(PulseDevice, const PulseComputePipelineCreateInfo*, uint32_t, PulseComputePipeline*);
+typedef bool (*PulseCreateComputePipelinesAsyncPFN)(PulseDevice, PulseComputePipelineBatch);
+typedef bool (*PulseIsComputePipelineBatchReadyPFN)(PulseDevice, PulseComputePipelineBatch);
+typedef void (*PulseWaitForComputePipelineBatchPFN)(PulseDevice, PulseComputePipelineBatch);
 typedef void (*PulseDispatchComputationsPFN)(PulseComputePass, uint32_t, uint32_t, uint32_t);
+typedef void (*PulseDispatchComputationsIndirectPFN)(PulseComputePass, PulseBuffer, uint32_t);
 typedef void (*PulseDestroyComputePipelinePFN)(PulseDevice, PulseComputePipeline);
+typedef bool (*PulseGetComputePipelineStatisticsPFN)(PulseDevice, PulseComputePipeline, PulseComputePipelineStatistics*);
 typedef PulseFence (*PulseCreateFencePFN)(PulseDevice);
 typedef void (*PulseDestroyFencePFN)(PulseDevice, PulseFence);
 typedef bool (*PulseIsFenceReadyPFN)(PulseDevice, PulseFence);
@@ -19,6 +19,8 @@ void TestBackendSupport()
 		if(!PulseSupportsBackend(PULSE_BACKEND_OPENGL, PULSE_SHADER_FORMAT_GLSL_BIT))
 	#elif defined(OPENGLES_ENABLED)
 		if(!PulseSupportsBackend(PULSE_BACKEND_OPENGL_ES, PULSE_SHADER_FORMAT_GLSL_BIT))
+	#elif defined(SOFTWARE_ENABLED)
+		if(!PulseSupportsBackend(PULSE_BACKEND_SOFTWARE, PULSE_SHADER_FORMAT_SPIRV_BIT))
 	#endif
 	{
 		TEST_MESSAGE("Backend is not supported");
@@ -36,6 +38,8 @@ void TestBackendSetup()
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_OPENGL, PULSE_SHADER_FORMAT_GLSL_BIT, PULSE_HIGH_DEBUG);
 	#elif defined(OPENGLES_ENABLED)
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_OPENGL_ES, PULSE_SHADER_FORMAT_GLSL_BIT, PULSE_HIGH_DEBUG);
+	#elif defined(SOFTWARE_ENABLED)
+		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_SOFTWARE, PULSE_SHADER_FORMAT_SPIRV_BIT, PULSE_HIGH_DEBUG);
 	#endif
 	TEST_ASSERT_NOT_EQUAL_MESSAGE(backend, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
 	PulseSetDebugCallback(backend, DumbDebugCallBack);
@@ -44,7 +48,7 @@ void TestBackendSetup()
 
 void TestBackendAnySetup()
 {
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_ANY, PULSE_SHADER_FORMAT_SPIRV_BIT, PULSE_HIGH_DEBUG);
 	#elif defined(WEBGPU_ENABLED)
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_ANY, PULSE_SHADER_FORMAT_WGSL_BIT, PULSE_HIGH_DEBUG);
@@ -60,6 +64,10 @@ void TestBackendAnySetup()
 		PulseBackendFlags backend_type = PulseGetBackendType(backend);
 		if(backend_type != PULSE_BACKEND_OPENGL && backend_type != PULSE_BACKEND_OPENGL_ES)
 			TEST_FAIL();
+	#elif defined(SOFTWARE_ENABLED)
+		PulseBackendFlags backend_type = PulseGetBackendType(backend);
+		if(backend_type != PULSE_BACKEND_VULKAN && backend_type != PULSE_BACKEND_SOFTWARE)
+			TEST_FAIL();
 	#endif
 	PulseSetDebugCallback(backend, DumbDebugCallBack);
 	PulseUnloadBackend(backend);
@@ -75,6 +83,8 @@ void TestWrongBackendSetup()
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_OPENGL, PULSE_SHADER_FORMAT_MSL_BIT, PULSE_HIGH_DEBUG);
 	#elif defined(OPENGLES_ENABLED)
 		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_OPENGL_ES, PULSE_SHADER_FORMAT_MSL_BIT, PULSE_HIGH_DEBUG);
+	#elif defined(SOFTWARE_ENABLED)
+		PulseBackend backend = PulseLoadBackend(PULSE_BACKEND_SOFTWARE, PULSE_SHADER_FORMAT_MSL_BIT, PULSE_HIGH_DEBUG);
 	#endif
 	TEST_ASSERT_EQUAL(backend, PULSE_NULL_HANDLE);
 	PulseSetDebugCallback(backend, DumbDebugCallBack);
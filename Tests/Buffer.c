@@ -269,7 +269,7 @@ void TestBufferComputeWrite()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/SimpleBufferWrite.spv.h"
 		};
@@ -340,7 +340,7 @@ void TestBufferComputeCopy()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/BufferCopy.spv.h"
 		};
@@ -28,6 +28,8 @@ void SetupPulse(PulseBackend* backend)
 		*backend = PulseLoadBackend(PULSE_BACKEND_OPENGL, PULSE_SHADER_FORMAT_GLSL_BIT, PULSE_PARANOID_DEBUG);
 	#elif defined(OPENGLES_ENABLED)
 		*backend = PulseLoadBackend(PULSE_BACKEND_OPENGL_ES, PULSE_SHADER_FORMAT_GLSL_BIT, PULSE_PARANOID_DEBUG);
+	#elif defined(SOFTWARE_ENABLED)
+		*backend = PulseLoadBackend(PULSE_BACKEND_SOFTWARE, PULSE_SHADER_FORMAT_SPIRV_BIT | PULSE_SHADER_FORMAT_NATIVE_BIT, PULSE_PARANOID_DEBUG);
 	#endif
 	if(*backend == PULSE_NULL_HANDLE)
 	{
@@ -70,7 +72,7 @@ void LoadComputePipeline(PulseDevice device, PulseComputePipeline* pipeline, con
 	#endif
 	info.code = code;
 	info.entrypoint = "main";
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		info.format = PULSE_SHADER_FORMAT_SPIRV_BIT;
 	#elif defined(WEBGPU_ENABLED)
 		info.format = PULSE_SHADER_FORMAT_WGSL_BIT;
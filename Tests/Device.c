@@ -2,6 +2,7 @@
 
 #include <unity/unity.h>
 #include <Pulse.h>
+#include <stdlib.h>
 
 void TestDeviceSetup()
 {
@@ -50,6 +51,8 @@ void TestBackendInUse()
 		TEST_ASSERT_EQUAL(PulseGetBackendInUseByDevice(device), PULSE_BACKEND_VULKAN);
 	#elif defined(WEBGPU_ENABLED)
 		TEST_ASSERT_EQUAL(PulseGetBackendInUseByDevice(device), PULSE_BACKEND_WEBGPU);
+	#elif defined(SOFTWARE_ENABLED)
+		TEST_ASSERT_EQUAL(PulseGetBackendInUseByDevice(device), PULSE_BACKEND_SOFTWARE);
 	#endif
 	PulseDestroyDevice(device);
 
@@ -63,7 +66,7 @@ void TestShaderFormatSupport()
 
 	PulseDevice device = PulseCreateDevice(backend, NULL, 0);
 	TEST_ASSERT_NOT_EQUAL_MESSAGE(device, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		TEST_ASSERT_TRUE(PulseDeviceSupportsShaderFormats(device, PULSE_SHADER_FORMAT_SPIRV_BIT));
 	#elif defined(WEBGPU_ENABLED)
 		TEST_ASSERT_TRUE(PulseDeviceSupportsShaderFormats(device, PULSE_SHADER_FORMAT_WGSL_BIT));
@@ -73,6 +76,34 @@ void TestShaderFormatSupport()
 	CleanupPulse(backend);
 }
 
+void TestPipelineCache()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+
+	PulseDevice device = PulseCreateDevice(backend, NULL, 0);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(device, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	#if defined(VULKAN_ENABLED)
+		TEST_ASSERT_TRUE_MESSAGE(PulseSetPipelineCachePath(device, NULL), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		size_t size = 0;
+		TEST_ASSERT_TRUE_MESSAGE(PulseGetPipelineCacheData(device, NULL, &size), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_EQUAL(size, 0);
+		void* data = malloc(size);
+		TEST_ASSERT_NOT_NULL(data);
+		TEST_ASSERT_TRUE_MESSAGE(PulseGetPipelineCacheData(device, data, &size), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_TRUE_MESSAGE(PulseMergePipelineCacheData(device, data, size), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		free(data);
+	#else
+		size_t size = 0;
+		DISABLE_ERRORS;
+			TEST_ASSERT_FALSE(PulseGetPipelineCacheData(device, NULL, &size));
+		ENABLE_ERRORS;
+	#endif
+	PulseDestroyDevice(device);
+
+	CleanupPulse(backend);
+}
+
 void TestDevice()
 {
 	RUN_TEST(TestDeviceSetup);
@@ -80,4 +111,5 @@ void TestDevice()
 	RUN_TEST(TestInvalidBackendDeviceSetup);
 	RUN_TEST(TestBackendInUse);
 	RUN_TEST(TestShaderFormatSupport);
+	RUN_TEST(TestPipelineCache);
 }
@@ -10,7 +10,7 @@ void TestPipelineSetup()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/Simple.spv.h"
 		};
@@ -55,7 +55,7 @@ void TestPipelineReadOnlyBindings()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/ReadOnlyBindings.spv.h"
 		};
@@ -120,7 +120,7 @@ void TestPipelineWriteOnlyBindings()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/WriteOnlyBindings.spv.h"
 		};
@@ -185,7 +185,7 @@ void TestPipelineReadWriteBindings()
 	PulseDevice device;
 	SetupDevice(backend, &device);
 
-	#if defined(VULKAN_ENABLED)
+	#if defined(VULKAN_ENABLED) || defined(SOFTWARE_ENABLED)
 		const uint8_t shader_bytecode[] = {
 			#include "Shaders/Vulkan-OpenGL/ReadWriteBindings.spv.h"
 		};
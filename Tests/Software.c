@@ -0,0 +1,1432 @@
+#include "Common.h"
+
+#include <unity/unity.h>
+#include <Pulse.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(SOFTWARE_ENABLED)
+
+#include "../Sources/PulseInternal.h"
+#include "../Sources/Backends/Software/Soft.h"
+#include "../Sources/Backends/Software/SoftIR.h"
+#include "../Sources/Backends/Software/SoftCompiler.h"
+#include "../Sources/Backends/Software/SoftTransfer.h"
+
+#define CONFORMANCE_INVOCATIONS_COUNT 100
+
+static uint64_t RunConformanceShader(const SoftIRProgram* program, const SoftCompiledKernel* kernel, uint32_t lanes_count, uint32_t* output)
+{
+	SoftIRContext context;
+	TEST_ASSERT_TRUE(SoftInitIRContext(program, &context, lanes_count));
+	TEST_ASSERT_EQUAL_UINT32(1, program->resources_count);
+	context.regions[SOFT_IR_REGION_RESOURCES].data = (uint8_t*)output;
+	context.regions[SOFT_IR_REGION_RESOURCES].size = CONFORMANCE_INVOCATIONS_COUNT * sizeof(uint32_t);
+
+	for(uint32_t first = 0; first < CONFORMANCE_INVOCATIONS_COUNT; first += lanes_count)
+	{
+		uint32_t active_lanes_count = CONFORMANCE_INVOCATIONS_COUNT - first < lanes_count ? CONFORMANCE_INVOCATIONS_COUNT - first : lanes_count;
+		for(uint32_t lane = 0; lane < active_lanes_count; lane++)
+		{
+			uint32_t global_id[3] = { first + lane, 0, 0 };
+			SoftIRSetBuiltin(program, &context, lane, SOFT_IR_BUILTIN_GLOBAL_INVOCATION_ID, global_id, 3);
+		}
+		if(kernel != NULL)
+			SoftRunCompiledKernel(kernel, &context);
+		else if(lanes_count == 1)
+			SoftIRExecute(program, &context);
+		else
+			SoftIRExecuteLanes(program, &context, active_lanes_count);
+	}
+	uint64_t executed_instructions_count = context.executed_instructions_count;
+	SoftDestroyIRContext(&context);
+	return executed_instructions_count;
+}
+
+void TestSoftwareSimdConformance()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+
+	_Alignas(uint32_t) const uint8_t shader_bytecode[] = {
+		#include "Shaders/Vulkan-OpenGL/SimdConformance.spv.h"
+	};
+
+	SoftIRProgram* program = SoftLowerSpirv(backend, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main");
+	TEST_ASSERT_NOT_NULL(program);
+
+	uint32_t expected[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+	RunConformanceShader(program, NULL, 1, expected);
+
+	const uint32_t lanes_counts[] = { 4, 8, 16 };
+	for(uint32_t i = 0; i < sizeof(lanes_counts) / sizeof(lanes_counts[0]); i++)
+	{
+		if(!SoftIRSupportsLanesCount(lanes_counts[i]))
+			continue;
+		uint32_t result[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+		RunConformanceShader(program, NULL, lanes_counts[i], result);
+		TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, result, CONFORMANCE_INVOCATIONS_COUNT);
+	}
+
+	SoftDestroyIRProgram(program);
+	CleanupPulse(backend);
+}
+
+void TestSoftwareIROptimizer()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+
+	_Alignas(uint32_t) const uint8_t shader_bytecode[] = {
+		#include "Shaders/Vulkan-OpenGL/SimdConformance.spv.h"
+	};
+
+	SoftIRProgram* reference = SoftLowerSpirv(backend, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main");
+	SoftIRProgram* program = SoftLowerSpirv(backend, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main");
+	TEST_ASSERT_NOT_NULL(reference);
+	TEST_ASSERT_NOT_NULL(program);
+	SoftOptimizeIRProgram(program);
+	TEST_ASSERT_EQUAL_UINT32(SoftGetIRInstructionsCount(reference), program->lowered_instructions_count);
+	TEST_ASSERT_LESS_THAN_UINT32(program->lowered_instructions_count, SoftGetIRInstructionsCount(program));
+
+	uint32_t expected[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+	uint64_t reference_executed_count = RunConformanceShader(reference, NULL, 1, expected);
+
+	uint32_t result[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+	uint64_t executed_count = RunConformanceShader(program, NULL, 1, result);
+	TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, result, CONFORMANCE_INVOCATIONS_COUNT);
+	TEST_ASSERT_LESS_THAN_UINT64(reference_executed_count, executed_count);
+
+	if(SoftIRSupportsLanesCount(8))
+	{
+		memset(result, 0, sizeof(result));
+		RunConformanceShader(program, NULL, 8, result);
+		TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, result, CONFORMANCE_INVOCATIONS_COUNT);
+	}
+
+	SoftDestroyIRProgram(program);
+	SoftDestroyIRProgram(reference);
+	CleanupPulse(backend);
+}
+
+// Native compilation is opt-in, tests use PULSE_SOFTWARE_CC or the system compiler with a cache directory of their own
+static bool InitTestCompiler(SoftCompiler* compiler)
+{
+	const char* command = getenv("PULSE_SOFTWARE_CC");
+	if(command == NULL || command[0] == '\0')
+		command = "cc";
+	#ifdef PULSE_PLAT_WINDOWS
+		const char* temp_directory = getenv("TEMP");
+	#else
+		const char* temp_directory = getenv("TMPDIR");
+		if(temp_directory == NULL || temp_directory[0] == '\0')
+			temp_directory = "/tmp";
+	#endif
+	if(temp_directory == NULL || temp_directory[0] == '\0')
+		return false;
+	char cache_directory[SOFT_COMPILER_PATH_MAX];
+	snprintf(cache_directory, sizeof(cache_directory), "%s/pulse-tests-cache", temp_directory);
+	SoftInitCompiler(compiler, command, cache_directory);
+	return compiler->available;
+}
+
+void TestSoftwareNativeConformance()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+
+	SoftCompiler compiler;
+	if(!InitTestCompiler(&compiler))
+	{
+		CleanupPulse(backend);
+		TEST_IGNORE_MESSAGE("No system compiler available");
+	}
+
+	_Alignas(uint32_t) const uint8_t shader_bytecode[] = {
+		#include "Shaders/Vulkan-OpenGL/SimdConformance.spv.h"
+	};
+
+	SoftIRProgram* program = SoftLowerSpirv(backend, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main");
+	TEST_ASSERT_NOT_NULL(program);
+
+	SoftCompiledKernel kernel;
+	TEST_ASSERT_TRUE(SoftCompileIRProgram(backend, &compiler, program, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main", &kernel));
+
+	uint32_t expected[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+	uint32_t result[CONFORMANCE_INVOCATIONS_COUNT] = { 0 };
+	RunConformanceShader(program, NULL, 1, expected);
+	RunConformanceShader(program, &kernel, 1, result);
+	TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, result, CONFORMANCE_INVOCATIONS_COUNT);
+
+	// Second request is served by the on-disk cache
+	SoftDestroyCompiledKernel(&kernel);
+	TEST_ASSERT_TRUE(SoftCompileIRProgram(backend, &compiler, program, (const uint32_t*)shader_bytecode, sizeof(shader_bytecode) / sizeof(uint32_t), "main", &kernel));
+	SoftDestroyCompiledKernel(&kernel);
+
+	SoftDestroyIRProgram(program);
+	CleanupPulse(backend);
+}
+
+#define BINDINGS_INVOCATIONS_COUNT 1024
+
+void TestSoftwareBufferBindings()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	const uint8_t shader_bytecode[] = {
+		#include "Shaders/Vulkan-OpenGL/BufferBindings.spv.h"
+	};
+
+	uint32_t input[BINDINGS_INVOCATIONS_COUNT];
+	for(uint32_t i = 0; i < BINDINGS_INVOCATIONS_COUNT; i++)
+		input[i] = i;
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = sizeof(input);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD;
+	PulseBuffer upload_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(upload_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(upload_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, input, sizeof(input));
+		PulseUnmapBuffer(upload_buffer);
+	}
+
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_READ;
+	PulseBuffer read_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(read_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	CopySameSizeBufferToBuffer(device, upload_buffer, read_buffer, sizeof(input));
+
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_READ | PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer write_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(write_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseComputePipeline pipeline;
+	LoadComputePipeline(device, &pipeline, shader_bytecode, sizeof(shader_bytecode), 0, 1, 0, 1, 1);
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	const uint32_t params[2] = { 3, 7 }; // scale, offset
+	PulseComputePass pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &read_buffer, 1);
+		PulseBindStorageBuffers(pass, &write_buffer, 1);
+		PulseBindUniformData(pass, 0, params, sizeof(params));
+		PulseBindComputePipeline(pass, pipeline);
+		PulseDispatchComputations(pass, BINDINGS_INVOCATIONS_COUNT / 32, 1, 1);
+	PulseEndComputePass(pass);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseComputePipelineStatistics statistics;
+	TEST_ASSERT_TRUE_MESSAGE(PulseGetComputePipelineStatistics(device, pipeline, &statistics), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_EQUAL_UINT64(BINDINGS_INVOCATIONS_COUNT, statistics.invocations_count);
+	TEST_ASSERT_NOT_EQUAL_UINT32(0, statistics.instructions_count);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(statistics.source_instructions_count, statistics.instructions_count);
+
+	{
+		buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+		PulseBuffer mappable_buffer = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(mappable_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+		CopySameSizeBufferToBuffer(device, write_buffer, mappable_buffer, sizeof(input));
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(mappable_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		for(uint32_t i = 0; i < BINDINGS_INVOCATIONS_COUNT; i++)
+			TEST_ASSERT_EQUAL_UINT32(input[i] * params[0] + params[1], ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(mappable_buffer);
+
+		PulseDestroyBuffer(device, mappable_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyComputePipeline(device, pipeline);
+	PulseDestroyBuffer(device, write_buffer);
+	PulseDestroyBuffer(device, read_buffer);
+	PulseDestroyBuffer(device, upload_buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define NATIVE_WORKGROUP_SIZE 8
+#define NATIVE_WORKGROUPS_COUNT 4
+
+static void NativeFillShader(const PulseNativeComputeContext* context)
+{
+	uint32_t* output = (uint32_t*)context->readwrite_storage_buffers[0];
+	uint32_t base = *(const uint32_t*)context->uniform_data[0];
+	for(uint32_t x = context->local_id_begin[0]; x < context->local_id_end[0]; x++)
+	{
+		uint32_t index = context->workgroup_id[0] * NATIVE_WORKGROUP_SIZE + x;
+		output[index] = base + index;
+	}
+}
+
+void TestSoftwareNativePipeline()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = NATIVE_WORKGROUP_SIZE * NATIVE_WORKGROUPS_COUNT * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseNativeComputeShader shader = { 0 };
+	shader.function = NativeFillShader;
+	shader.workgroup_size[0] = NATIVE_WORKGROUP_SIZE;
+	shader.workgroup_size[1] = 1;
+	shader.workgroup_size[2] = 1;
+
+	PulseComputePipelineCreateInfo info = { 0 };
+	info.code_size = sizeof(shader);
+	info.code = (const uint8_t*)&shader;
+	info.entrypoint = "main";
+	info.format = PULSE_SHADER_FORMAT_NATIVE_BIT;
+	info.num_readwrite_storage_buffers = 1;
+	info.num_uniform_buffers = 1;
+	PulseComputePipeline pipeline = PulseCreateComputePipeline(device, &info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pipeline, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	const uint32_t base = 42;
+	PulseComputePass pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &buffer, 1);
+		PulseBindUniformData(pass, 0, &base, sizeof(base));
+		PulseBindComputePipeline(pass, pipeline);
+		PulseDispatchComputations(pass, NATIVE_WORKGROUPS_COUNT, 1, 1);
+	PulseEndComputePass(pass);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+		PulseBuffer mappable_buffer = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(mappable_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+		CopySameSizeBufferToBuffer(device, buffer, mappable_buffer, buffer_create_info.size);
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(mappable_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		for(uint32_t i = 0; i < NATIVE_WORKGROUP_SIZE * NATIVE_WORKGROUPS_COUNT; i++)
+			TEST_ASSERT_EQUAL_UINT32(base + i, ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(mappable_buffer);
+
+		PulseDestroyBuffer(device, mappable_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyComputePipeline(device, pipeline);
+	PulseDestroyBuffer(device, buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define SNAPSHOTS_DISPATCHES_COUNT 256
+
+static void NativeSnapshotShader(const PulseNativeComputeContext* context)
+{
+	uint32_t* output = (uint32_t*)context->readwrite_storage_buffers[0];
+	const uint32_t* params = (const uint32_t*)context->uniform_data[0]; // index, value
+	output[params[0]] = params[1];
+}
+
+// Every dispatch must see the uniform data bound when it was recorded
+void TestSoftwareUniformSnapshots()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = SNAPSHOTS_DISPATCHES_COUNT * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseNativeComputeShader shader = { 0 };
+	shader.function = NativeSnapshotShader;
+	shader.workgroup_size[0] = 1;
+	shader.workgroup_size[1] = 1;
+	shader.workgroup_size[2] = 1;
+
+	PulseComputePipelineCreateInfo info = { 0 };
+	info.code_size = sizeof(shader);
+	info.code = (const uint8_t*)&shader;
+	info.entrypoint = "main";
+	info.format = PULSE_SHADER_FORMAT_NATIVE_BIT;
+	info.num_readwrite_storage_buffers = 1;
+	info.num_uniform_buffers = 1;
+	PulseComputePipeline pipeline = PulseCreateComputePipeline(device, &info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pipeline, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseComputePass pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &buffer, 1);
+		PulseBindComputePipeline(pass, pipeline);
+		for(uint32_t i = 0; i < SNAPSHOTS_DISPATCHES_COUNT; i++)
+		{
+			const uint32_t params[2] = { i, i * 3 + 1 };
+			PulseBindUniformData(pass, 0, params, sizeof(params));
+			PulseDispatchComputations(pass, 1, 1, 1);
+		}
+	PulseEndComputePass(pass);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+		PulseBuffer mappable_buffer = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(mappable_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+		CopySameSizeBufferToBuffer(device, buffer, mappable_buffer, buffer_create_info.size);
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(mappable_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		for(uint32_t i = 0; i < SNAPSHOTS_DISPATCHES_COUNT; i++)
+			TEST_ASSERT_EQUAL_UINT32(i * 3 + 1, ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(mappable_buffer);
+
+		PulseDestroyBuffer(device, mappable_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyComputePipeline(device, pipeline);
+	PulseDestroyBuffer(device, buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define REUSE_ROUNDS_COUNT 4
+#define REUSE_COPIES_COUNT 1024
+
+void TestSoftwareCommandListReuse()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = REUSE_COPIES_COUNT * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD | PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+	PulseBuffer src_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(src_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseBuffer dst_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(dst_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseCommandList first_cmd = PULSE_NULL_HANDLE;
+	for(uint32_t round = 0; round < REUSE_ROUNDS_COUNT; round++)
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(src_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		for(uint32_t i = 0; i < REUSE_COPIES_COUNT; i++)
+			((uint32_t*)ptr)[i] = i ^ (round << 16);
+		PulseUnmapBuffer(src_buffer);
+
+		PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		// Released lists go back to the device pool
+		if(round == 0)
+			first_cmd = cmd;
+		else
+			TEST_ASSERT_EQUAL_PTR(first_cmd, cmd);
+
+		// One copy per element so the command array and the regions go through several growths
+		for(uint32_t i = 0; i < REUSE_COPIES_COUNT; i++)
+		{
+			PulseBufferRegion src_region = { 0 };
+			src_region.buffer = src_buffer;
+			src_region.offset = (REUSE_COPIES_COUNT - 1 - i) * sizeof(uint32_t);
+			src_region.size = sizeof(uint32_t);
+
+			PulseBufferRegion dst_region = { 0 };
+			dst_region.buffer = dst_buffer;
+			dst_region.offset = i * sizeof(uint32_t);
+			dst_region.size = sizeof(uint32_t);
+
+			TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToBuffer(cmd, &src_region, &dst_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		}
+
+		TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseReleaseCommandList(device, cmd);
+
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(dst_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		for(uint32_t i = 0; i < REUSE_COPIES_COUNT; i++)
+			TEST_ASSERT_EQUAL_UINT32((REUSE_COPIES_COUNT - 1 - i) ^ (round << 16), ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(dst_buffer);
+	}
+
+	PulseDestroyFence(device, fence);
+	PulseDestroyBuffer(device, src_buffer);
+	PulseDestroyBuffer(device, dst_buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define MAP_HAZARD_ELEMENTS_COUNT (4 * 1024 * 1024)
+
+void TestSoftwareMapWaitsForPendingCopies()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = MAP_HAZARD_ELEMENTS_COUNT * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD | PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+	PulseBuffer src_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(src_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseBuffer dst_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(dst_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	void* ptr;
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(src_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	for(uint32_t i = 0; i < MAP_HAZARD_ELEMENTS_COUNT; i++)
+		((uint32_t*)ptr)[i] = i * 7;
+	PulseUnmapBuffer(src_buffer);
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseBufferRegion src_region = { 0 };
+	src_region.buffer = src_buffer;
+	src_region.size = buffer_create_info.size;
+
+	PulseBufferRegion dst_region = { 0 };
+	dst_region.buffer = dst_buffer;
+	dst_region.size = buffer_create_info.size;
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToBuffer(cmd, &src_region, &dst_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	// No fence wait, mapping the destination has to wait for the copy on its own
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(dst_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	for(uint32_t i = 0; i < MAP_HAZARD_ELEMENTS_COUNT; i++)
+		TEST_ASSERT_EQUAL_UINT32(i * 7, ((uint32_t*)ptr)[i]);
+	PulseUnmapBuffer(dst_buffer);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyBuffer(device, src_buffer);
+	PulseDestroyBuffer(device, dst_buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define TRANSFER_BUFFER_SIZE (4 * 1024 * 1024 + 4099)
+#define TRANSFER_BUFFERS_COUNT 3
+
+typedef struct TransferCopy
+{
+	uint32_t src;
+	size_t src_offset;
+	uint32_t dst;
+	size_t dst_offset;
+	size_t size;
+} TransferCopy;
+
+// Executed in order, every copy is big enough to be split across the workers
+static const TransferCopy transfer_copies[] = {
+	// Independent and unaligned, batched into one stream whose chunks snap back to destination pages
+	{ 0, 13, 1, 4093, 6 * SOFT_TRANSFER_PARALLEL_THRESHOLD + 7 },
+	{ 0, 2 * 1024 * 1024 + 1, 1, 2 * 1024 * 1024 + 777, 2 * SOFT_TRANSFER_PARALLEL_THRESHOLD + 187 },
+	{ 0, 3 * 1024 * 1024 + 5, 2, 3 * 1024 * 1024 + 3, SOFT_TRANSFER_PARALLEL_THRESHOLD + 31 },
+	// Reads bytes written by the first copy
+	{ 1, 100, 2, 5, 2 * SOFT_TRANSFER_PARALLEL_THRESHOLD + 3 },
+	// Overwrites part of the previous destination
+	{ 0, 1024 * 1024 + 9, 2, 300000, SOFT_TRANSFER_PARALLEL_THRESHOLD + 1 },
+	// Overlapping regions of a same buffer, forwards then backwards
+	{ 2, 1000, 2, 1000 + 4097, 4 * SOFT_TRANSFER_PARALLEL_THRESHOLD },
+	{ 2, 2 * 1024 * 1024 + 4097, 2, 2 * 1024 * 1024 + 11, 2 * SOFT_TRANSFER_PARALLEL_THRESHOLD + 3 },
+	// Writes to the source of the first batch
+	{ 1, 3 * 1024 * 1024 + 17, 0, 3, SOFT_TRANSFER_PARALLEL_THRESHOLD + 4321 },
+};
+
+static uint8_t TransferPattern(uint32_t buffer, size_t i)
+{
+	return (uint8_t)(((uint32_t)i * 2654435761u) >> 24) + (uint8_t)(buffer * 85);
+}
+
+void TestSoftwareTransferCopies()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = TRANSFER_BUFFER_SIZE;
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD | PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+
+	PulseBuffer buffers[TRANSFER_BUFFERS_COUNT];
+	uint8_t* references[TRANSFER_BUFFERS_COUNT];
+	for(uint32_t i = 0; i < TRANSFER_BUFFERS_COUNT; i++)
+	{
+		buffers[i] = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(buffers[i], PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		references[i] = (uint8_t*)malloc(TRANSFER_BUFFER_SIZE);
+		TEST_ASSERT_NOT_NULL(references[i]);
+		for(size_t j = 0; j < TRANSFER_BUFFER_SIZE; j++)
+			references[i][j] = TransferPattern(i, j);
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(buffers[i], PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, references[i], TRANSFER_BUFFER_SIZE);
+		PulseUnmapBuffer(buffers[i]);
+	}
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	for(uint32_t i = 0; i < sizeof(transfer_copies) / sizeof(transfer_copies[0]); i++)
+	{
+		const TransferCopy* copy = &transfer_copies[i];
+
+		PulseBufferRegion src_region = { 0 };
+		src_region.buffer = buffers[copy->src];
+		src_region.offset = copy->src_offset;
+		src_region.size = copy->size;
+
+		PulseBufferRegion dst_region = { 0 };
+		dst_region.buffer = buffers[copy->dst];
+		dst_region.offset = copy->dst_offset;
+		dst_region.size = copy->size;
+
+		TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToBuffer(cmd, &src_region, &dst_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memmove(references[copy->dst] + copy->dst_offset, references[copy->src] + copy->src_offset, copy->size);
+	}
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	for(uint32_t i = 0; i < TRANSFER_BUFFERS_COUNT; i++)
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(buffers[i], PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_EQUAL_MEMORY(references[i], ptr, TRANSFER_BUFFER_SIZE);
+		PulseUnmapBuffer(buffers[i]);
+		PulseDestroyBuffer(device, buffers[i]);
+		free(references[i]);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define TRANSFER_IMAGE_WIDTH 600
+#define TRANSFER_IMAGE_HEIGHT 500
+#define TRANSFER_REGION_X 5
+#define TRANSFER_REGION_Y 3
+#define TRANSFER_REGION_WIDTH 517
+#define TRANSFER_REGION_HEIGHT 471
+#define TRANSFER_REGION_OFFSET 12 // Unaligned start of the region texels in the upload buffer
+
+// Both uploads are split in rows across the workers, the second one only covers part of the tiles
+void TestSoftwareTransferSwizzle()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	const size_t image_size = TRANSFER_IMAGE_WIDTH * TRANSFER_IMAGE_HEIGHT * sizeof(uint32_t);
+	const size_t region_size = TRANSFER_REGION_WIDTH * TRANSFER_REGION_HEIGHT * sizeof(uint32_t);
+	TEST_ASSERT_TRUE(region_size >= SOFT_TRANSFER_PARALLEL_THRESHOLD);
+
+	uint32_t* image_texels = (uint32_t*)malloc(image_size);
+	uint32_t* region_texels = (uint32_t*)malloc(region_size);
+	uint32_t* expected = (uint32_t*)malloc(image_size);
+	TEST_ASSERT_NOT_NULL(image_texels);
+	TEST_ASSERT_NOT_NULL(region_texels);
+	TEST_ASSERT_NOT_NULL(expected);
+	for(uint32_t i = 0; i < TRANSFER_IMAGE_WIDTH * TRANSFER_IMAGE_HEIGHT; i++)
+		image_texels[i] = i * 2654435761u;
+	for(uint32_t i = 0; i < TRANSFER_REGION_WIDTH * TRANSFER_REGION_HEIGHT; i++)
+		region_texels[i] = ~(i * 40503u);
+	memcpy(expected, image_texels, image_size);
+	for(uint32_t y = 0; y < TRANSFER_REGION_HEIGHT; y++)
+		memcpy(&expected[(TRANSFER_REGION_Y + y) * TRANSFER_IMAGE_WIDTH + TRANSFER_REGION_X], &region_texels[y * TRANSFER_REGION_WIDTH], TRANSFER_REGION_WIDTH * sizeof(uint32_t));
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = image_size + TRANSFER_REGION_OFFSET + region_size;
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD;
+	PulseBuffer upload_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(upload_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(upload_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, image_texels, image_size);
+		memcpy((uint8_t*)ptr + image_size + TRANSFER_REGION_OFFSET, region_texels, region_size);
+		PulseUnmapBuffer(upload_buffer);
+	}
+
+	buffer_create_info.size = image_size;
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+	PulseBuffer download_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(download_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageCreateInfo image_create_info = { 0 };
+	image_create_info.type = PULSE_IMAGE_TYPE_2D;
+	image_create_info.format = PULSE_IMAGE_FORMAT_R8G8B8A8_UINT;
+	image_create_info.usage = PULSE_IMAGE_USAGE_STORAGE_READ;
+	image_create_info.width = TRANSFER_IMAGE_WIDTH;
+	image_create_info.height = TRANSFER_IMAGE_HEIGHT;
+	image_create_info.layer_count_or_depth = 1;
+	PulseImage image = PulseCreateImage(device, &image_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(image, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageRegion image_region = { 0 };
+	image_region.image = image;
+	image_region.width = TRANSFER_IMAGE_WIDTH;
+	image_region.height = TRANSFER_IMAGE_HEIGHT;
+	image_region.depth = 1;
+
+	PulseImageRegion partial_region = image_region;
+	partial_region.x = TRANSFER_REGION_X;
+	partial_region.y = TRANSFER_REGION_Y;
+	partial_region.width = TRANSFER_REGION_WIDTH;
+	partial_region.height = TRANSFER_REGION_HEIGHT;
+
+	PulseBufferRegion image_upload_region = { 0 };
+	image_upload_region.buffer = upload_buffer;
+	image_upload_region.size = image_size;
+	PulseBufferRegion partial_upload_region = { 0 };
+	partial_upload_region.buffer = upload_buffer;
+	partial_upload_region.offset = image_size + TRANSFER_REGION_OFFSET;
+	partial_upload_region.size = region_size;
+	PulseBufferRegion download_region = { 0 };
+	download_region.buffer = download_buffer;
+	download_region.size = image_size;
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToImage(cmd, &image_upload_region, &image_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToImage(cmd, &partial_upload_region, &partial_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyImageToBuffer(cmd, &image_region, &download_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(download_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		TEST_ASSERT_EQUAL_MEMORY(expected, ptr, image_size);
+		PulseUnmapBuffer(download_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyImage(device, image);
+	PulseDestroyBuffer(device, download_buffer);
+	PulseDestroyBuffer(device, upload_buffer);
+	free(expected);
+	free(region_texels);
+	free(image_texels);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define INDIRECT_WORKGROUPS_COUNT 5
+
+static void NativeWriteGroupCountsShader(const PulseNativeComputeContext* context)
+{
+	uint32_t* arguments = (uint32_t*)context->readwrite_storage_buffers[0];
+	arguments[1] = INDIRECT_WORKGROUPS_COUNT;
+	arguments[2] = 1;
+	arguments[3] = 1;
+}
+
+static void NativeCountWorkgroupsShader(const PulseNativeComputeContext* context)
+{
+	uint32_t* output = (uint32_t*)context->readwrite_storage_buffers[0];
+	output[context->workgroup_id[0]] = context->workgroup_count[0];
+}
+
+static PulseComputePipeline CreateNativePipeline(PulseDevice device, PulseNativeComputeShader* shader, PulseNativeComputeFunctionPFN function)
+{
+	shader->function = function;
+	shader->workgroup_size[0] = 1;
+	shader->workgroup_size[1] = 1;
+	shader->workgroup_size[2] = 1;
+
+	PulseComputePipelineCreateInfo info = { 0 };
+	info.code_size = sizeof(*shader);
+	info.code = (const uint8_t*)shader;
+	info.entrypoint = "main";
+	info.format = PULSE_SHADER_FORMAT_NATIVE_BIT;
+	info.num_readwrite_storage_buffers = 1;
+	PulseComputePipeline pipeline = PulseCreateComputePipeline(device, &info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pipeline, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	return pipeline;
+}
+
+// The first dispatch sizes the second one without going through the CPU
+void TestSoftwareIndirectDispatch()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = 4 * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_READ | PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer arguments_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(arguments_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	buffer_create_info.size = 8 * sizeof(uint32_t);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseNativeComputeShader arguments_shader = { 0 };
+	PulseNativeComputeShader count_shader = { 0 };
+	PulseComputePipeline arguments_pipeline = CreateNativePipeline(device, &arguments_shader, NativeWriteGroupCountsShader);
+	PulseComputePipeline count_pipeline = CreateNativePipeline(device, &count_shader, NativeCountWorkgroupsShader);
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseComputePass pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &arguments_buffer, 1);
+		PulseBindComputePipeline(pass, arguments_pipeline);
+		PulseDispatchComputations(pass, 1, 1, 1);
+		PulseBindStorageBuffers(pass, &buffer, 1);
+		PulseBindComputePipeline(pass, count_pipeline);
+		PulseDispatchComputationsIndirect(pass, arguments_buffer, sizeof(uint32_t));
+	PulseEndComputePass(pass);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+		PulseBuffer mappable_buffer = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(mappable_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+		CopySameSizeBufferToBuffer(device, buffer, mappable_buffer, buffer_create_info.size);
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(mappable_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		for(uint32_t i = 0; i < 8; i++)
+			TEST_ASSERT_EQUAL_UINT32(i < INDIRECT_WORKGROUPS_COUNT ? INDIRECT_WORKGROUPS_COUNT : 0, ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(mappable_buffer);
+
+		PulseDestroyBuffer(device, mappable_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+
+	// An indirect dispatch without any pipeline bound must be rejected before reaching the backend
+	cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &buffer, 1);
+		PulseGetLastErrorType(); // Clears the last error
+		DISABLE_ERRORS;
+			PulseDispatchComputationsIndirect(pass, arguments_buffer, sizeof(uint32_t));
+			TEST_ASSERT_EQUAL(PULSE_ERROR_INVALID_HANDLE, PulseGetLastErrorType());
+		ENABLE_ERRORS;
+	PulseEndComputePass(pass);
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseReleaseCommandList(device, cmd);
+
+	PulseDestroyFence(device, fence);
+	PulseDestroyComputePipeline(device, count_pipeline);
+	PulseDestroyComputePipeline(device, arguments_pipeline);
+	PulseDestroyBuffer(device, buffer);
+	PulseDestroyBuffer(device, arguments_buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define IMAGE_WIDTH 37
+#define IMAGE_HEIGHT 13
+#define IMAGE_LAYERS 3
+
+// Odd sizes so that rows and layers end in partially filled tiles
+void TestSoftwareImageRoundTrip()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	uint32_t input[IMAGE_WIDTH * IMAGE_HEIGHT * IMAGE_LAYERS];
+	for(uint32_t i = 0; i < IMAGE_WIDTH * IMAGE_HEIGHT * IMAGE_LAYERS; i++)
+		input[i] = i * 2654435761u;
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = sizeof(input);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD;
+	PulseBuffer upload_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(upload_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(upload_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, input, sizeof(input));
+		PulseUnmapBuffer(upload_buffer);
+	}
+
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+	PulseBuffer download_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(download_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageCreateInfo image_create_info = { 0 };
+	image_create_info.type = PULSE_IMAGE_TYPE_2D_ARRAY;
+	image_create_info.format = PULSE_IMAGE_FORMAT_R8G8B8A8_UINT;
+	image_create_info.usage = PULSE_IMAGE_USAGE_STORAGE_READ;
+	image_create_info.width = IMAGE_WIDTH;
+	image_create_info.height = IMAGE_HEIGHT;
+	image_create_info.layer_count_or_depth = IMAGE_LAYERS;
+	PulseImage image = PulseCreateImage(device, &image_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(image, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageRegion image_region = { 0 };
+	image_region.image = image;
+	image_region.width = IMAGE_WIDTH;
+	image_region.height = IMAGE_HEIGHT;
+	image_region.depth = IMAGE_LAYERS;
+
+	PulseBufferRegion upload_region = { 0 };
+	upload_region.buffer = upload_buffer;
+	upload_region.size = sizeof(input);
+	PulseBufferRegion download_region = { 0 };
+	download_region.buffer = download_buffer;
+	download_region.size = sizeof(input);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToImage(cmd, &upload_region, &image_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyImageToBuffer(cmd, &image_region, &download_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(download_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		TEST_ASSERT_EQUAL_MEMORY(input, ptr, sizeof(input));
+		PulseUnmapBuffer(download_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyImage(device, image);
+	PulseDestroyBuffer(device, download_buffer);
+	PulseDestroyBuffer(device, upload_buffer);
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+// Uploads the texels, blits them to RGBA32F and, when encoded is given, back to the source format
+static void BlitThroughFloats(PulseDevice device, PulseImageFormat format, uint32_t width, uint32_t height, const void* data, uint32_t size, float* floats, void* encoded)
+{
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = size;
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD;
+	PulseBuffer upload_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(upload_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(upload_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, data, size);
+		PulseUnmapBuffer(upload_buffer);
+	}
+
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+	PulseBuffer encoded_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(encoded_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	buffer_create_info.size = width * height * 4 * sizeof(float);
+	PulseBuffer floats_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(floats_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageCreateInfo image_create_info = { 0 };
+	image_create_info.type = PULSE_IMAGE_TYPE_2D;
+	image_create_info.format = format;
+	image_create_info.width = width;
+	image_create_info.height = height;
+	image_create_info.layer_count_or_depth = 1;
+	PulseImage image = PulseCreateImage(device, &image_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(image, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseImage encoded_image = PULSE_NULL_HANDLE;
+	if(encoded != NULL)
+	{
+		encoded_image = PulseCreateImage(device, &image_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(encoded_image, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	}
+	image_create_info.format = PULSE_IMAGE_FORMAT_R32G32B32A32_FLOAT;
+	PulseImage floats_image = PulseCreateImage(device, &image_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(floats_image, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_TRANSFER_ONLY);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseImageRegion image_region = { 0 };
+	image_region.image = image;
+	image_region.width = width;
+	image_region.height = height;
+	image_region.depth = 1;
+	PulseImageRegion floats_region = image_region;
+	floats_region.image = floats_image;
+	PulseImageRegion encoded_region = image_region;
+	encoded_region.image = encoded_image;
+
+	PulseBufferRegion upload_region = { 0 };
+	upload_region.buffer = upload_buffer;
+	upload_region.size = size;
+	PulseBufferRegion encoded_download_region = { 0 };
+	encoded_download_region.buffer = encoded_buffer;
+	encoded_download_region.size = size;
+	PulseBufferRegion floats_download_region = { 0 };
+	floats_download_region.buffer = floats_buffer;
+	floats_download_region.size = width * height * 4 * sizeof(float);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyBufferToImage(cmd, &upload_region, &image_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseBlitImage(cmd, &image_region, &floats_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseCopyImageToBuffer(cmd, &floats_region, &floats_download_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	if(encoded != NULL)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(PulseBlitImage(cmd, &floats_region, &encoded_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_TRUE_MESSAGE(PulseCopyImageToBuffer(cmd, &encoded_region, &encoded_download_region), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	}
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(floats_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		memcpy(floats, ptr, width * height * 4 * sizeof(float));
+		PulseUnmapBuffer(floats_buffer);
+	}
+	if(encoded != NULL)
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(encoded_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		memcpy(encoded, ptr, size);
+		PulseUnmapBuffer(encoded_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyImage(device, floats_image);
+	if(encoded_image != PULSE_NULL_HANDLE)
+		PulseDestroyImage(device, encoded_image);
+	PulseDestroyImage(device, image);
+	PulseDestroyBuffer(device, floats_buffer);
+	PulseDestroyBuffer(device, encoded_buffer);
+	PulseDestroyBuffer(device, upload_buffer);
+}
+
+typedef struct CompressedBlockCase
+{
+	PulseImageFormat format;
+	uint8_t block[16];
+	float first_row[16]; // Every texel past the first row uses the first endpoint, as texel 0 does
+} CompressedBlockCase;
+
+void TestSoftwareCompressedBlit()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	const CompressedBlockCase cases[] = {
+		// Red and blue endpoints with the four palette entries on the first row
+		{ PULSE_IMAGE_FORMAT_BC1_RGBA_UNORM, { 0x00, 0xF8, 0x1F, 0x00, 0xE4 }, {
+			1.0f, 0.0f, 0.0f, 1.0f,
+			0.0f, 0.0f, 1.0f, 1.0f,
+			170.0f / 255.0f, 0.0f, 85.0f / 255.0f, 1.0f,
+			85.0f / 255.0f, 0.0f, 170.0f / 255.0f, 1.0f,
+		} },
+		// Eight values red channel, six values green channel with its 0 and 255 constants
+		{ PULSE_IMAGE_FORMAT_BC5_RG_UNORM, { 200, 100, 0x08, 0, 0, 0, 0, 0, 0, 255, 0x3E }, {
+			200.0f / 255.0f, 0.0f, 0.0f, 1.0f,
+			100.0f / 255.0f, 1.0f, 0.0f, 1.0f,
+			200.0f / 255.0f, 0.0f, 0.0f, 1.0f,
+			200.0f / 255.0f, 0.0f, 0.0f, 1.0f,
+		} },
+		// Mode 6, endpoints (0x7F, 0, 0x40, 0x7F) and 0 with p-bits 1 and 0, indices 0, 15 and 8
+		{ PULSE_IMAGE_FORMAT_BC7_RGBA_UNORM, { 0xC0, 0x3F, 0x00, 0x00, 0x00, 0x02, 0xFE, 0x80, 0xF0, 0x08 }, {
+			1.0f, 1.0f / 255.0f, 129.0f / 255.0f, 1.0f,
+			0.0f, 0.0f, 0.0f, 0.0f,
+			120.0f / 255.0f, 0.0f, 60.0f / 255.0f, 120.0f / 255.0f,
+			1.0f, 1.0f / 255.0f, 129.0f / 255.0f, 1.0f,
+		} },
+		// Mode 11, endpoints 0 and (0x3FF, 0x3FF, 0x200), indices 0, 15 and 8
+		{ PULSE_IMAGE_FORMAT_BC6H_RGB_UFLOAT, { 0x03, 0x00, 0x00, 0x00, 0xF8, 0xFF, 0x7F, 0x00, 0xF1, 0x08 }, {
+			0.0f, 0.0f, 0.0f, 1.0f,
+			65504.0f, 65504.0f, 1.5146484375f, 1.0f,
+			2.935546875f, 2.935546875f, 0.00970458984375f, 1.0f,
+			0.0f, 0.0f, 0.0f, 1.0f,
+		} },
+	};
+
+	for(uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		uint32_t size = cases[i].format == PULSE_IMAGE_FORMAT_BC1_RGBA_UNORM ? 8 : 16;
+		float floats[4 * 4 * 4];
+		BlitThroughFloats(device, cases[i].format, 4, 4, cases[i].block, size, floats, NULL);
+		TEST_ASSERT_EQUAL_FLOAT_ARRAY(cases[i].first_row, floats, 16);
+		for(uint32_t texel = 4; texel < 16; texel++)
+			TEST_ASSERT_EQUAL_FLOAT_ARRAY(cases[i].first_row, floats + texel * 4, 4);
+	}
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+typedef struct PixelFormatCase
+{
+	PulseImageFormat format;
+	const void* texels;
+	uint32_t texel_size;
+	float expected[8];
+} PixelFormatCase;
+
+void TestSoftwarePixelFormatRoundTrip()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	const uint16_t half_texels[8] = { 0x3C00, 0xC000, 0x7BFF, 0x3555, 0x0001, 0x8400, 0x0000, 0x7C00 }; // Subnormal, smallest normal and infinity on the second texel
+	const uint16_t snorm16_texels[8] = { 0x7FFF, 0x8001, 0x0000, 0x4000, 0xC000, 0x0001, 0x8002, 0x7FFF };
+	const uint8_t snorm8_texels[8] = { 0x7F, 0x81, 0x00, 0x40, 0xC0, 0x01, 0xFF, 0x7F };
+	const uint32_t r10g10b10a2_texels[2] = { 1023u | (0u << 10) | (512u << 20) | (3u << 30), 1u | (341u << 10) | (1022u << 20) | (1u << 30) };
+	const uint16_t b5g6r5_texels[2] = { (31u << 11) | (0u << 5) | 16u, (1u << 11) | (42u << 5) | 31u };
+	const uint32_t r11g11b10_texels[2] = { 0x3C0u | (0x7BFu << 11) | (0x1E0u << 22), 0x001u | (0x000u << 11) | (0x03Fu << 22) };
+
+	const PixelFormatCase cases[] = {
+		{ PULSE_IMAGE_FORMAT_R16G16B16A16_FLOAT, half_texels, 8, { 1.0f, -2.0f, 65504.0f, 0.333251953125f, 5.9604644775390625e-08f, -6.103515625e-05f, 0.0f, INFINITY } },
+		{ PULSE_IMAGE_FORMAT_R16G16B16A16_SNORM, snorm16_texels, 8, { 1.0f, -1.0f, 0.0f, 16384.0f / 32767.0f, -16384.0f / 32767.0f, 1.0f / 32767.0f, -32766.0f / 32767.0f, 1.0f } },
+		{ PULSE_IMAGE_FORMAT_R8G8B8A8_SNORM, snorm8_texels, 4, { 1.0f, -1.0f, 0.0f, 64.0f / 127.0f, -64.0f / 127.0f, 1.0f / 127.0f, -1.0f / 127.0f, 1.0f } },
+		{ PULSE_IMAGE_FORMAT_R10G10B10A2_UNORM, r10g10b10a2_texels, 4, { 1.0f, 0.0f, 512.0f / 1023.0f, 1.0f, 1.0f / 1023.0f, 341.0f / 1023.0f, 1022.0f / 1023.0f, 1.0f / 3.0f } },
+		{ PULSE_IMAGE_FORMAT_B5G6R5_UNORM, b5g6r5_texels, 2, { 1.0f, 0.0f, 16.0f / 31.0f, 1.0f, 1.0f / 31.0f, 42.0f / 63.0f, 1.0f, 1.0f } },
+		{ PULSE_IMAGE_FORMAT_R11G11B10_UFLOAT, r11g11b10_texels, 4, { 1.0f, 65024.0f, 1.0f, 1.0f, 9.5367431640625e-07f, 0.0f, 1.201629638671875e-04f, 1.0f } },
+	};
+
+	for(uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		float floats[8];
+		uint8_t encoded[16];
+		BlitThroughFloats(device, cases[i].format, 2, 1, cases[i].texels, cases[i].texel_size * 2, floats, encoded);
+		TEST_ASSERT_EQUAL_MEMORY(cases[i].expected, floats, sizeof(floats)); // Bit exact, the conversions are deterministic
+		TEST_ASSERT_EQUAL_MEMORY(cases[i].texels, encoded, cases[i].texel_size * 2);
+	}
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define PIPELINE_BATCH_SIZE 6
+
+void TestSoftwarePipelineBatches()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	const uint8_t shader_bytecode[] = {
+		#include "Shaders/Vulkan-OpenGL/BufferBindings.spv.h"
+	};
+
+	PulseComputePipelineCreateInfo infos[PIPELINE_BATCH_SIZE] = { 0 };
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+	{
+		infos[i].code_size = sizeof(shader_bytecode);
+		infos[i].code = shader_bytecode;
+		infos[i].entrypoint = "main";
+		infos[i].format = PULSE_SHADER_FORMAT_SPIRV_BIT;
+		infos[i].num_readonly_storage_buffers = 1;
+		infos[i].num_readwrite_storage_buffers = 1;
+		infos[i].num_uniform_buffers = 1;
+	}
+
+	PulseComputePipeline pipelines[PIPELINE_BATCH_SIZE];
+	TEST_ASSERT_TRUE_MESSAGE(PulseCreateComputePipelines(device, infos, PIPELINE_BATCH_SIZE, pipelines), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+	{
+		TEST_ASSERT_NOT_EQUAL(pipelines[i], PULSE_NULL_HANDLE);
+		PulseDestroyComputePipeline(device, pipelines[i]);
+	}
+
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+		pipelines[i] = PULSE_NULL_HANDLE;
+	PulseComputePipelineBatch batch = PulseCreateComputePipelinesAsync(device, infos, PIPELINE_BATCH_SIZE, pipelines);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(batch, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	// The array is left alone until the batch is found ready
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+		TEST_ASSERT_EQUAL(pipelines[i], PULSE_NULL_HANDLE);
+	while(!PulseIsComputePipelineBatchReady(device, batch));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForComputePipelineBatch(device, batch), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+	{
+		TEST_ASSERT_NOT_EQUAL(pipelines[i], PULSE_NULL_HANDLE);
+		PulseDestroyComputePipeline(device, pipelines[i]);
+	}
+
+	// A broken pipeline does not prevent the others from being created
+	PulseNativeComputeShader broken_shader = { 0 };
+	infos[1].code_size = sizeof(broken_shader);
+	infos[1].code = (const uint8_t*)&broken_shader;
+	infos[1].format = PULSE_SHADER_FORMAT_NATIVE_BIT;
+	DISABLE_ERRORS;
+		TEST_ASSERT_FALSE(PulseCreateComputePipelines(device, infos, PIPELINE_BATCH_SIZE, pipelines));
+	ENABLE_ERRORS;
+	for(uint32_t i = 0; i < PIPELINE_BATCH_SIZE; i++)
+	{
+		if(i == 1)
+		{
+			TEST_ASSERT_EQUAL(pipelines[i], PULSE_NULL_HANDLE);
+			continue;
+		}
+		TEST_ASSERT_NOT_EQUAL(pipelines[i], PULSE_NULL_HANDLE);
+		PulseDestroyComputePipeline(device, pipelines[i]);
+	}
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+#define HISTOGRAM_BINS_COUNT 16
+#define HISTOGRAM_WORKGROUP_SIZE 64
+#define HISTOGRAM_WORKGROUPS_COUNT 256
+
+// NZSL has no atomics, this is the SPIR-V 1.0 module of
+//   layout(local_size_x = 64) in;
+//   layout(set = 1, binding = 0) buffer Histogram { uint bins[]; };
+//   void main() { atomicAdd(bins[gl_GlobalInvocationID.x & 15], 1); }
+static const uint32_t histogram_shader[] = {
+	0x07230203, 0x00010000, 0x00000000, 22, 0x00000000,
+	(2 << 16) | 17, 1, // OpCapability Shader
+	(3 << 16) | 14, 0, 1, // OpMemoryModel Logical GLSL450
+	(6 << 16) | 15, 5, 1, 0x6E69616D, 0x00000000, 2, // OpEntryPoint GLCompute %1 "main" %2
+	(6 << 16) | 16, 1, 17, HISTOGRAM_WORKGROUP_SIZE, 1, 1, // OpExecutionMode %1 LocalSize 64 1 1
+	(4 << 16) | 71, 2, 11, 28, // OpDecorate %2 BuiltIn GlobalInvocationId
+	(4 << 16) | 71, 8, 6, 4, // OpDecorate %8 ArrayStride 4
+	(5 << 16) | 72, 9, 0, 35, 0, // OpMemberDecorate %9 0 Offset 0
+	(3 << 16) | 71, 9, 3, // OpDecorate %9 BufferBlock
+	(4 << 16) | 71, 11, 34, 1, // OpDecorate %11 DescriptorSet 1
+	(4 << 16) | 71, 11, 33, 0, // OpDecorate %11 Binding 0
+	(2 << 16) | 19, 3, // %3 = OpTypeVoid
+	(3 << 16) | 33, 4, 3, // %4 = OpTypeFunction %3
+	(4 << 16) | 21, 5, 32, 0, // %5 = OpTypeInt 32 0
+	(4 << 16) | 23, 6, 5, 3, // %6 = OpTypeVector %5 3
+	(4 << 16) | 32, 7, 1, 6, // %7 = OpTypePointer Input %6
+	(4 << 16) | 59, 7, 2, 1, // %2 = OpVariable %7 Input
+	(3 << 16) | 29, 8, 5, // %8 = OpTypeRuntimeArray %5
+	(3 << 16) | 30, 9, 8, // %9 = OpTypeStruct %8
+	(4 << 16) | 32, 10, 2, 9, // %10 = OpTypePointer Uniform %9
+	(4 << 16) | 59, 10, 11, 2, // %11 = OpVariable %10 Uniform
+	(4 << 16) | 32, 12, 2, 5, // %12 = OpTypePointer Uniform %5
+	(4 << 16) | 43, 5, 13, 0, // %13 = OpConstant %5 0
+	(4 << 16) | 43, 5, 14, 1, // %14 = OpConstant %5 1
+	(4 << 16) | 43, 5, 15, HISTOGRAM_BINS_COUNT - 1, // %15 = OpConstant %5 15
+	(5 << 16) | 54, 3, 1, 0, 4, // %1 = OpFunction %3 None %4
+	(2 << 16) | 248, 16, // %16 = OpLabel
+	(4 << 16) | 61, 6, 17, 2, // %17 = OpLoad %6 %2
+	(5 << 16) | 81, 5, 18, 17, 0, // %18 = OpCompositeExtract %5 %17 0
+	(5 << 16) | 199, 5, 19, 18, 15, // %19 = OpBitwiseAnd %5 %18 %15
+	(6 << 16) | 65, 12, 20, 11, 13, 19, // %20 = OpAccessChain %12 %11 %13 %19
+	(7 << 16) | 234, 5, 21, 20, 14, 13, 14, // %21 = OpAtomicIAdd %5 %20 Device Relaxed %14
+	(1 << 16) | 253, // OpReturn
+	(1 << 16) | 56, // OpFunctionEnd
+};
+
+static void RunHistogramShader(PulseDevice device)
+{
+	const uint32_t zeros[HISTOGRAM_BINS_COUNT] = { 0 };
+
+	PulseBufferCreateInfo buffer_create_info = { 0 };
+	buffer_create_info.size = sizeof(zeros);
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_UPLOAD;
+	PulseBuffer upload_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(upload_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	{
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(upload_buffer, PULSE_MAP_WRITE, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		memcpy(ptr, zeros, sizeof(zeros));
+		PulseUnmapBuffer(upload_buffer);
+	}
+
+	buffer_create_info.usage = PULSE_BUFFER_USAGE_STORAGE_READ | PULSE_BUFFER_USAGE_STORAGE_WRITE;
+	PulseBuffer bins_buffer = PulseCreateBuffer(device, &buffer_create_info);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(bins_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	CopySameSizeBufferToBuffer(device, upload_buffer, bins_buffer, sizeof(zeros));
+
+	PulseComputePipeline pipeline;
+	LoadComputePipeline(device, &pipeline, (const uint8_t*)histogram_shader, sizeof(histogram_shader), 0, 0, 0, 1, 0);
+
+	PulseFence fence = PulseCreateFence(device);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(fence, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	PulseCommandList cmd = PulseRequestCommandList(device, PULSE_COMMAND_LIST_GENERAL);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(cmd, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	PulseComputePass pass = PulseBeginComputePass(cmd);
+	TEST_ASSERT_NOT_EQUAL_MESSAGE(pass, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		PulseBindStorageBuffers(pass, &bins_buffer, 1);
+		PulseBindComputePipeline(pass, pipeline);
+		PulseDispatchComputations(pass, HISTOGRAM_WORKGROUPS_COUNT, 1, 1);
+	PulseEndComputePass(pass);
+
+	TEST_ASSERT_TRUE_MESSAGE(PulseSubmitCommandList(device, cmd, fence), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_TRUE_MESSAGE(PulseWaitForFences(device, &fence, 1, true), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+	// Lowered to the bytecode executor, the interpreter reports no instructions
+	PulseComputePipelineStatistics statistics;
+	TEST_ASSERT_TRUE_MESSAGE(PulseGetComputePipelineStatistics(device, pipeline, &statistics), PulseVerbaliseErrorType(PulseGetLastErrorType()));
+	TEST_ASSERT_NOT_EQUAL_UINT32(0, statistics.instructions_count);
+
+	{
+		buffer_create_info.usage = PULSE_BUFFER_USAGE_TRANSFER_DOWNLOAD;
+		PulseBuffer mappable_buffer = PulseCreateBuffer(device, &buffer_create_info);
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(mappable_buffer, PULSE_NULL_HANDLE, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+
+		CopySameSizeBufferToBuffer(device, bins_buffer, mappable_buffer, sizeof(zeros));
+
+		void* ptr;
+		TEST_ASSERT_NOT_EQUAL_MESSAGE(PulseMapBuffer(mappable_buffer, PULSE_MAP_READ, &ptr), false, PulseVerbaliseErrorType(PulseGetLastErrorType()));
+		TEST_ASSERT_NOT_NULL(ptr);
+		for(uint32_t i = 0; i < HISTOGRAM_BINS_COUNT; i++)
+			TEST_ASSERT_EQUAL_UINT32(HISTOGRAM_WORKGROUPS_COUNT * HISTOGRAM_WORKGROUP_SIZE / HISTOGRAM_BINS_COUNT, ((uint32_t*)ptr)[i]);
+		PulseUnmapBuffer(mappable_buffer);
+
+		PulseDestroyBuffer(device, mappable_buffer);
+	}
+
+	PulseReleaseCommandList(device, cmd);
+	PulseDestroyFence(device, fence);
+	PulseDestroyComputePipeline(device, pipeline);
+	PulseDestroyBuffer(device, bins_buffer);
+	PulseDestroyBuffer(device, upload_buffer);
+}
+
+void TestSoftwareAtomicHistogram()
+{
+	PulseBackend backend;
+	SetupPulse(&backend);
+	PulseDevice device;
+	SetupDevice(backend, &device);
+
+	// Pipelines pick their path from the driver data when they are created
+	SoftDriverData* driver_data = SOFT_RETRIEVE_DRIVER_DATA_AS(backend, SoftDriverData*);
+	uint32_t lanes_count = driver_data->lanes_count;
+	bool compiler_available = driver_data->compiler->available;
+
+	SoftCompiler compiler;
+	if(InitTestCompiler(&compiler))
+	{
+		SoftCompiler* backend_compiler = driver_data->compiler;
+		driver_data->compiler = &compiler;
+		RunHistogramShader(device); // Native kernel
+		driver_data->compiler = backend_compiler;
+	}
+	driver_data->compiler->available = false;
+	if(lanes_count >= 4)
+		RunHistogramShader(device); // Lockstep lanes
+	driver_data->lanes_count = 1;
+	RunHistogramShader(device); // Scalar bytecode
+
+	driver_data->lanes_count = lanes_count;
+	driver_data->compiler->available = compiler_available;
+
+	CleanupDevice(device);
+	CleanupPulse(backend);
+}
+
+void TestSoftware()
+{
+	RUN_TEST(TestSoftwareSimdConformance);
+	RUN_TEST(TestSoftwareIROptimizer);
+	RUN_TEST(TestSoftwareNativeConformance);
+	RUN_TEST(TestSoftwareBufferBindings);
+	RUN_TEST(TestSoftwareNativePipeline);
+	RUN_TEST(TestSoftwareUniformSnapshots);
+	RUN_TEST(TestSoftwareCommandListReuse);
+	RUN_TEST(TestSoftwareMapWaitsForPendingCopies);
+	RUN_TEST(TestSoftwareTransferCopies);
+	RUN_TEST(TestSoftwareTransferSwizzle);
+	RUN_TEST(TestSoftwareIndirectDispatch);
+	RUN_TEST(TestSoftwareImageRoundTrip);
+	RUN_TEST(TestSoftwareCompressedBlit);
+	RUN_TEST(TestSoftwarePixelFormatRoundTrip);
+	RUN_TEST(TestSoftwarePipelineBatches);
+	RUN_TEST(TestSoftwareAtomicHistogram);
+}
+
+#endif
@@ -90,6 +90,9 @@ extern void TestDevice();
 extern void TestBuffer();
 extern void TestImage();
 extern void TestPipeline();
+#if defined(SOFTWARE_ENABLED)
+	extern void TestSoftware();
+#endif
 
 int main(void)
 {
@@ -109,5 +112,8 @@ int main(void)
 	TestBuffer();
 	TestImage();
 	TestPipeline();
+	#if defined(SOFTWARE_ENABLED)
+		TestSoftware();
+	#endif
 	return UNITY_END();
 }
@@ -144,6 +144,18 @@ local tests = {
 			add_files("**.nzsl")
 		end
 	},
+	Software = {
+		option = "software",
+		global_custom = function()
+			nzsl(Backend.VULKAN)
+		end,
+		custom = function()
+			add_rules("nzsl_compile_shaders_vulkan")
+			add_packages("nzsl")
+			add_files("**.nzsl")
+			add_defines("PULSE_ENABLE_SOFTWARE_BACKEND") -- Software.c drives the IR directly
+		end
+	},
 	WebGPU = {
 		option = "webgpu",
 		global_custom = function()